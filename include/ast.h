@@ -0,0 +1,101 @@
+#ifndef AST_H
+#define AST_H
+
+#include <stdbool.h>
+#include "lexer.h"
+#include "types.h"
+
+// ==============================================
+// ÁRVORE SINTÁTICA ABSTRATA - C.SHORT
+// ==============================================
+//
+// O parser constrói a árvore; a análise semântica percorre a árvore e
+// anota tipos (tipoExpr) e símbolos resolvidos (simbolo).
+
+typedef enum {
+    NO_PROGRAMA,      // filhos[0] = lista de declarações de nível superior
+
+    // Declarações
+    NO_DECL_VAR,      // nome, tipoDecl, ehVetor, tamanho; filhos[0] = expressão do
+                      // tamanho, até a análise semântica calcular o valor
+    NO_FUNCAO,        // nome, tipoDecl (retorno); filhos[0] = parâmetros,
+                      // filhos[1] = variáveis locais, filhos[2] = comandos
+    NO_PARAM,         // nome, tipoDecl, ehVetor, porReferencia
+
+    // Comandos
+    NO_IF,            // filhos[0] = condição, filhos[1] = então, filhos[2] = senão
+    NO_WHILE,         // filhos[0] = condição, filhos[1] = corpo
+    NO_FOR,           // filhos[0] = inicialização, filhos[1] = condição,
+                      // filhos[2] = passo, filhos[3] = corpo (todos opcionais menos o corpo);
+                      // valor.boolVal = 'parallel for' (voltas declaradas independentes)
+    NO_SWITCH,        // filhos[0] = expressão, filhos[1] = lista de NO_CASE
+    NO_CASE,          // filhos[0] = rótulo (NULL no default), filhos[1] = comandos;
+                      // valor.intVal = valor do rótulo (preenchido pelo semântico)
+    NO_BREAK,         // 'break'
+    NO_RETURN,        // filhos[0] = expressão (opcional)
+    NO_ATRIB,         // nome; filhos[0] = índice (opcional), filhos[1] = expressão
+    NO_CMD_CHAMADA,   // nome; filhos[0] = argumentos
+    NO_BLOCO,         // filhos[0] = comandos
+    NO_VAZIO,         // ';'
+
+    // Expressões
+    NO_ID,            // nome
+    NO_INDEXACAO,     // nome; filhos[0] = índice
+    NO_CHAMADA,       // nome; filhos[0] = argumentos
+    NO_CONST_INT,     // valor.intVal
+    NO_CONST_REAL,    // valor.realVal
+    NO_CONST_CHAR,    // valor.charVal
+    NO_CONST_BOOL,    // valor.boolVal
+    NO_CONST_STRING,  // valor.intVal = identificador no pool de constantes
+    NO_BINARIO,       // op; filhos[0] = esquerda, filhos[1] = direita
+    NO_UNARIO         // op (+, - ou !); filhos[0] = operando
+} TipoNo;
+
+typedef struct NoAst NoAst;
+
+struct NoAst {
+    TipoNo tipo;        // espécie do nó
+    int linha;          // posição no fonte (para mensagens)
+    int coluna;
+    long offset;        // deslocamento do token inicial
+    long offsetFim;     // NO_FUNCAO: deslocamento do '}' ou ';' final
+
+    char* nome;         // identificador (variável, função, parâmetro)
+    TokenType op;       // operador em NO_BINARIO / NO_UNARIO
+
+    union {
+        int intVal;
+        float realVal;
+        char charVal;
+        bool boolVal;
+    } valor;
+
+    // Declarações
+    TipoId tipoDecl;    // tipo declarado (variável, parâmetro ou retorno)
+    bool ehVetor;       // decl_var com '[n]' ou parâmetro 'id[]'
+    int tamanho;        // tamanho do vetor declarado
+    bool porReferencia; // parâmetro '&id'
+    bool temCorpo;      // NO_FUNCAO: definição (true) ou protótipo (false)
+    bool paramsVoid;    // NO_FUNCAO: lista de parâmetros declarada como 'void'
+
+    NoAst* filhos[4];   // filhos conforme o tipo do nó (ver TipoNo)
+    NoAst* prox;        // próximo elemento em listas (declarações, comandos, argumentos)
+
+    // Anotações da análise semântica
+    TipoId tipoExpr;    // tipo da expressão
+    int simbolo;        // índice do símbolo resolvido/declarado (-1 se nenhum)
+};
+
+// Cria um nó do tipo dado com a posição do token
+NoAst* novoNo(TipoNo tipo, Token token);
+
+// Acrescenta 'no' ao fim da lista descrita por (inicio, fim)
+void anexarNo(NoAst** inicio, NoAst** fim, NoAst* no);
+
+// Quantidade de elementos de uma lista encadeada por 'prox'
+int tamanhoLista(const NoAst* lista);
+
+// Libera a árvore inteira (incluindo listas encadeadas)
+void liberarAst(NoAst* no);
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef CODEGEN_H
+#define CODEGEN_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include "ir.h"
+
+// ==============================================
+// GERAÇÃO DE CÓDIGO x86-64 - C.SHORT
+// ==============================================
+//
+// Gera assembly GNU (sintaxe AT&T) a partir da IR do programa (ir.h).
+// Valores int, char e bool passam por %eax; float usa instruções escalares
+// SSE2 (movss, addss, ucomiss, cvtsi2ss...) em %xmm0. Os símbolos do
+// programa recebem o prefixo "cs_"; se houver uma função 'main', é gerado
+// um 'main' de entrada que a chama. Strings usam o runtime (csrt_*) de
+// runtime/cshort_rt.c.
+
+// Convenção de chamada do código gerado
+typedef enum {
+    ABI_SYSV,    // Linux, macOS, BSD
+    ABI_WIN64    // Windows (MSYS2 / MinGW)
+} AbiAlvo;
+
+// Define a convenção de chamada (o padrão é a da plataforma do compilador)
+void definirAbiAlvo(AbiAlvo abi);
+
+// Converte "sysv" / "win64" na convenção correspondente; retorna false se desconhecida
+bool abiDeNome(const char* nome, AbiAlvo* abi);
+
+// Gera o assembly do programa; retorna false (com mensagem) se algo não for suportado
+bool gerarCodigo(const ProgramaIr* programa, FILE* saida);
+
+// ----------------------------------------------
+// Quadro de pilha (quadro.c)
+// ----------------------------------------------
+
+// Dá um deslocamento (negativo, a partir de %rbp) a cada slot, a cada valor
+// com lugar[id] e à entrada de cada phi com lugar. Objetos que nunca estão
+// vivos ao mesmo tempo dividem os mesmos bytes. Devolve os bytes usados
+int montarQuadroIr(const FuncaoIr* f, const bool* lugar, int* offsetSlot, int* offsetValor, int* offsetEntrada);
+
+#endif
@@ -0,0 +1,21 @@
+#ifndef CONSTANTES_H
+#define CONSTANTES_H
+
+// ==============================================
+// POOL DE CONSTANTES STRING - C.SHORT
+// ==============================================
+//
+// Cada literal string distinto do programa é guardado uma única vez;
+// literais iguais recebem o mesmo identificador e viram um único dado
+// somente leitura no código gerado.
+
+// Interna o conteúdo (pode conter '\0') e devolve seu identificador
+int internarString(const char* dados, int tam);
+
+// Quantidade de strings distintas no pool
+int numStringsConstantes(void);
+
+// Conteúdo da string de identificador 'id' (tamanho em *tam)
+const char* stringConstante(int id, int* tam);
+
+#endif
@@ -0,0 +1,281 @@
+#ifndef IR_H
+#define IR_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "ast.h"
+#include "types.h"
+#include "symbols.h"
+
+// ==============================================
+// REPRESENTAÇÃO INTERMEDIÁRIA (SSA) - C.SHORT
+// ==============================================
+//
+// Cada função vira um grafo de blocos básicos. Toda instrução que produz
+// valor define um valor SSA (%n) com tipo próprio. Variáveis escalares
+// locais viram valores SSA durante a construção (com phi nas junções); o
+// que precisa de endereço (globais, vetores, strings e variáveis passadas
+// por referência) fica em memória e é acessado com load/store.
+//
+// Strings não têm tipo na IR: são objetos de 16 bytes em memória
+// manipulados por chamadas ao runtime (csrt_*). Uma função que devolve
+// string recebe como primeiro parâmetro o endereço do resultado.
+
+// Tipos dos valores
+typedef enum {
+    IR_VOID,
+    IR_I1,      // bool (0 ou 1)
+    IR_I8,      // char (com sinal)
+    IR_I32,     // int
+    IR_F32,     // float
+    IR_PTR,     // endereço
+
+    // Vetores de 16 bytes (SSE2), criados pela vetorização de laços
+    IR_V16I8,   // 16 x char
+    IR_V4I32,   // 4 x int
+    IR_V4F32    // 4 x float
+} TipoIr;
+
+typedef enum {
+    // Valores
+    IR_CONST,       // imm
+    IR_PARAM,       // indice = posição do parâmetro
+    IR_PHI,         // um operando por predecessor, na ordem de bloco->preds
+
+    // Aritmética e lógica (operandos do tipo do resultado)
+    IR_ADD,
+    IR_SUB,
+    IR_MUL,
+    IR_DIV,
+    IR_NEG,
+    IR_NOT,         // i1: 0 <-> 1
+    IR_CMP,         // cond; dois operandos do mesmo tipo; resultado i1
+    IR_CONV,        // converte o operando para o tipo do resultado
+
+    // Vetores (aritmética, load e store também aceitam os tipos vetoriais)
+    IR_REPLICAR,    // args: escalar; o valor em todas as faixas
+    IR_MIN,         // por faixa: a < b ? a : b
+    IR_MAX,         // por faixa: a > b ? a : b
+    IR_REDUZIR,     // args: vetor; combina as faixas com 'indice' (IR_ADD, IR_MIN ou IR_MAX)
+
+    // Memória
+    IR_LOCAL,       // endereço do slot 'indice' do quadro
+    IR_GLOBAL,      // endereço da variável global 'simbolo'
+    IR_CONST_STR,   // endereço da constante 'indice' do pool de strings
+    IR_FUNCAO,      // endereço da função 'simbolo' (para o runtime chamar)
+    IR_ELEM,        // args: base, índice i32; base + índice * escala (escala 0: bit 'índice', só para load/store i1)
+    IR_LOAD,        // args: endereço; lê um valor do tipo do resultado
+    IR_STORE,       // args: endereço, valor
+    IR_ZERAR,       // args: endereço; zera 'tamanho' bytes
+    IR_COPIAR,      // args: destino, origem; copia 'tamanho' bytes
+    IR_LIMITE,      // args: índice i32; interrompe o programa se não estiver em [0, tamanho)
+
+    // Chamadas: função do programa (simbolo >= 0) ou do runtime (nome em 'runtime')
+    IR_CALL,
+
+    // Terminadores
+    IR_JMP,         // alvos[0]
+    IR_BR,          // args: condição i1; alvos[0] se verdadeira, alvos[1] se falsa
+    IR_RET,         // args: valor (opcional)
+
+    NUM_OPS_IR
+} OpIr;
+
+// Condição de IR_CMP
+typedef enum {
+    COND_EQ,
+    COND_NE,
+    COND_LT,
+    COND_GT,
+    COND_LE,
+    COND_GE
+} CondIr;
+
+typedef struct InstrIr InstrIr;
+typedef struct BlocoIr BlocoIr;
+
+// Valor de um escalar constante (i1/i8/i32 em 'i', f32 em 'f')
+typedef union {
+    int32_t i;
+    float f;
+} ValorIr;
+
+struct InstrIr {
+    OpIr op;
+    TipoIr tipo;            // tipo do resultado (IR_VOID se não produz valor)
+    int id;                 // número do valor na função (%id)
+
+    InstrIr** args;         // operandos
+    int nArgs;
+    int capArgs;
+
+    InstrIr** usos;         // instruções que usam este valor (uma entrada por operando)
+    int nUsos;
+    int capUsos;
+
+    ValorIr imm;            // IR_CONST
+    CondIr cond;            // IR_CMP
+    int indice;             // IR_PARAM, IR_LOCAL, IR_CONST_STR, IR_REDUZIR
+    int simbolo;            // IR_GLOBAL, IR_FUNCAO, IR_CALL (-1 = runtime)
+    const char* runtime;    // IR_CALL ao runtime
+    bool cauda;             // IR_CALL seguida de ret do seu valor: vira salto na geração
+    int escala;             // IR_ELEM: bytes por elemento (0 nos vetores bool, guardados um bit por elemento)
+    int tamanho;            // IR_ELEM, IR_LIMITE: nº de elementos (0 = desconhecido); IR_ZERAR/IR_COPIAR: bytes
+    BlocoIr* alvos[2];      // IR_JMP, IR_BR
+    int linha;              // linha do fonte que originou a instrução (para avisos)
+
+    BlocoIr* bloco;
+    InstrIr* ant;
+    InstrIr* prox;
+};
+
+struct BlocoIr {
+    int id;
+    InstrIr* primeira;
+    InstrIr* ultima;        // terminador, depois que o bloco é fechado
+
+    BlocoIr** preds;
+    int nPreds;
+    int capPreds;
+
+    bool paralelo;          // cabeçalho de um 'parallel for'
+
+    // Preenchidos por calcularDominadoresIr
+    BlocoIr* idom;          // dominador imediato (a entrada domina a si mesma)
+    int rpo;                // posição em pós-ordem reversa (-1 se inalcançável)
+};
+
+// Objeto do quadro de pilha (variável em memória ou temporário string)
+typedef struct {
+    int tamanho;            // bytes
+    int alinhamento;
+    int simbolo;            // variável correspondente (-1 para temporários)
+} SlotIr;
+
+typedef struct {
+    char* nome;
+    int simbolo;                            // símbolo da função na tabela
+    TipoIr retorno;
+    int nParams;
+    TipoIr tiposParams[MAX_PARAM + 1];      // inclui o endereço oculto do retorno string
+
+    BlocoIr** blocos;                       // blocos[0] é a entrada
+    int nBlocos;
+    int capBlocos;
+
+    SlotIr* slots;
+    int nSlots;
+    int capSlots;
+
+    int nValores;                           // próximo id de valor livre
+} FuncaoIr;
+
+typedef struct {
+    FuncaoIr** funcoes;
+    int nFuncoes;
+    int* globais;                           // símbolos das variáveis globais, na ordem do fonte
+    int nGlobais;
+} ProgramaIr;
+
+// ----------------------------------------------
+// Construção a partir da árvore (irgen.c)
+// ----------------------------------------------
+
+// Constrói a IR do programa já verificado; retorna NULL (com mensagem) se algo não for suportado
+ProgramaIr* construirIr(NoAst* programa);
+
+// Confere o índice de todo acesso a vetor de tamanho conhecido (-fbounds-check)
+void definirVerificacaoLimites(bool ativa);
+
+// ----------------------------------------------
+// Estruturas (ir.c)
+// ----------------------------------------------
+
+TipoIr tipoIrDe(TipoId t);
+const char* nomeTipoIr(TipoIr t);
+
+// Bytes de um vetor da linguagem com 'tamanho' elementos (bool: bits em palavras de 64)
+int bytesVetorIr(TipoId t, int tamanho);
+
+// Tipos vetoriais: elemento, número de faixas e o vetor de um escalar (IR_VOID se não há)
+bool ehVetorIr(TipoIr t);
+TipoIr elementoIr(TipoIr t);
+int faixasIr(TipoIr t);
+TipoIr vetorDeIr(TipoIr elemento);
+
+// Calcula uma operação escalar (aritmética, IR_NOT, IR_CMP, IR_CONV) sobre constantes
+// exatamente como o código gerado; 'tipoArgs' é o tipo dos operandos. Retorna false
+// se a operação interromperia o programa (divisão inteira por zero, INT_MIN / -1)
+bool calcularOperacaoIr(OpIr op, CondIr cond, TipoIr tipo, TipoIr tipoArgs, const ValorIr* args, ValorIr* r);
+
+FuncaoIr* novaFuncaoIr(const char* nome, int simbolo);
+BlocoIr* novoBlocoIr(FuncaoIr* f);
+int novoSlotIr(FuncaoIr* f, int tamanho, int alinhamento, int simbolo);
+
+// Cria uma instrução solta (ainda fora de qualquer bloco)
+InstrIr* novaInstrIr(FuncaoIr* f, OpIr op, TipoIr tipo);
+void adicionarArgIr(InstrIr* instr, InstrIr* arg);
+void trocarArgIr(InstrIr* instr, int i, InstrIr* novo);
+
+// Posiciona a instrução no fim do bloco / antes de outra instrução
+void anexarInstrIr(BlocoIr* b, InstrIr* instr);
+void inserirAntesIr(InstrIr* pos, InstrIr* instr);
+
+// Muda a instrução de lugar (para antes de 'pos'), mantendo operandos e usos
+void moverInstrIr(InstrIr* instr, InstrIr* pos);
+
+// Tira a instrução do bloco e dos usos dos operandos e a libera (não pode ter usos)
+void removerInstrIr(InstrIr* instr);
+
+// Mesmo que removerInstrIr, em duas etapas (a instrução desligada ainda pode ser consultada)
+void desligarInstrIr(InstrIr* instr);
+void liberarInstrIr(InstrIr* instr);
+
+// Faz todos os usos de 'antigo' passarem a usar 'novo'
+void substituirUsosIr(InstrIr* antigo, InstrIr* novo);
+
+void adicionarPredIr(BlocoIr* b, BlocoIr* pred);
+
+// Tira o predecessor de índice i (e o operando correspondente dos phi)
+void removerPredIr(BlocoIr* b, int i);
+int indicePredIr(const BlocoIr* b, const BlocoIr* pred);
+InstrIr* terminadorIr(const BlocoIr* b);
+int sucessoresIr(const BlocoIr* b, BlocoIr* succ[2]);
+bool ehTerminadorIr(OpIr op);
+
+// Se a instrução tem efeito além do valor que produz (memória, chamada, desvio)
+bool temEfeitoIr(const InstrIr* instr);
+
+// Remove os blocos que não são alcançados a partir da entrada
+void removerBlocosInalcancaveisIr(FuncaoIr* f);
+
+// Tira da função um bloco sem arestas (as instruções restantes são liberadas; os ids, renumerados)
+void removerBlocoIr(FuncaoIr* f, BlocoIr* b);
+
+// Divide o bloco antes de 'pos': 'pos' e as instruções seguintes vão para um bloco novo,
+// sem arestas de entrada (quem chama liga os dois)
+BlocoIr* dividirBlocoIr(FuncaoIr* f, InstrIr* pos);
+
+// Pós-ordem reversa e dominadores imediatos
+void calcularDominadoresIr(FuncaoIr* f);
+bool dominaIr(const BlocoIr* a, const BlocoIr* b);
+
+// Cópia independente da função, com outro nome e símbolo
+FuncaoIr* copiarFuncaoIr(const FuncaoIr* f, const char* nome, int simbolo);
+
+void liberarFuncaoIr(FuncaoIr* f);
+void liberarProgramaIr(ProgramaIr* p);
+
+// ----------------------------------------------
+// Impressão e verificação (ir.c)
+// ----------------------------------------------
+
+// Forma textual da IR (--emit-ir)
+void imprimirIr(const ProgramaIr* p, FILE* saida);
+
+// Confere a consistência da função (tipos, blocos, phi, dominância); mensagens "[ERRO IR]"
+bool verificarIr(FuncaoIr* f);
+bool verificarProgramaIr(ProgramaIr* p);
+
+#endif
@@ -43,6 +43,7 @@ typedef enum {
     TOKEN_RBRACE,     // }
     TOKEN_SEMICOLON,  // ;
     TOKEN_COMMA,      // ,
+    TOKEN_COLON,      // :
 
     TOKEN_BOOLCON,   // ✅ suporte a true e false
 
@@ -63,6 +64,7 @@ typedef enum {
     TOKEN_KEYWORD_SWITCH,
     TOKEN_KEYWORD_CASE,
     TOKEN_KEYWORD_DEFAULT,
+    TOKEN_KEYWORD_PARALLEL,
     TOKEN_KEYWORD_STRING,
 
     // Outros
@@ -78,12 +80,14 @@ typedef struct {
         int intVal;       // Se TOKEN_INTCON
         float realVal;    // Se TOKEN_REALCON
         char charVal;     // Se TOKEN_CHARCON
-        char* strVal;     // Se TOKEN_STRINGCON, TOKEN_ID ou palavra-chave
+        char* strVal;     // Se TOKEN_STRINGCON (conteúdo sem aspas, escapes resolvidos), TOKEN_ID ou palavra-chave
     };
+    int tamStr;           // Se TOKEN_STRINGCON: tamanho do conteúdo (sem limite de TAM_MAX_LEXEMA)
 
     char lexeme[TAM_MAX_LEXEMA]; // Lexema original
     int line;           // Linha de origem
     int column;         // Coluna inicial
+    long offset;        // Deslocamento (em bytes) do início do token no arquivo
 } Token;
 
 // Variável global para controle de linha 
@@ -0,0 +1,183 @@
+#ifndef OTIMIZACAO_H
+#define OTIMIZACAO_H
+
+#include <stdbool.h>
+#include "ir.h"
+
+// ==============================================
+// OTIMIZAÇÕES SOBRE A IR - C.SHORT
+// ==============================================
+//
+// Cada passe recebe uma função já em SSA, a deixa válida para o
+// verificador e devolve se mudou alguma coisa. otimizarPrograma repete
+// os passes de cada função até nenhum deles mudar nada.
+
+// Nível de otimização (0 desliga todos os passes)
+void definirNivelOtimizacao(int nivel);
+
+// Limite de custo da expansão de chamadas (-finline-limit)
+void definirLimiteExpansao(int limite);
+
+// Relatório da vetorização em stderr (-fopt-info-vec)
+void definirRelatorioVetorizacao(bool ativo);
+
+// Relatório da paralelização em stderr (-fopt-info-par)
+void definirRelatorioParalelizacao(bool ativo);
+
+// Aplica os passes ativos a todas as funções do programa
+void otimizarPrograma(ProgramaIr* p);
+
+// ----------------------------------------------
+// Grafo de chamadas (chamadas.c)
+// ----------------------------------------------
+
+// Efeitos de uma função, somados aos das funções que ela chama
+#define EFEITO_LE_GLOBAIS           0x01
+#define EFEITO_GRAVA_GLOBAIS        0x02
+#define EFEITO_LE_REFERENCIAS       0x04    // lê por parâmetros &id / id[]
+#define EFEITO_GRAVA_REFERENCIAS    0x08
+#define EFEITO_EXTERNO              0x10    // chama o runtime ou uma função só declarada
+#define EFEITO_PODE_NAO_VOLTAR      0x20    // laço, recursão ou erro em tempo de execução
+
+typedef struct {
+    int nFuncoes;
+    int** chamados;         // funções chamadas por cada uma (índices em p->funcoes, sem repetição)
+    int* nChamados;
+    int* nChamadas;         // quantas chamadas cada função recebe no programa
+    int* componente;        // componente fortemente conexo (índice da raiz)
+    bool* recursiva;        // faz parte de um ciclo de chamadas (inclusive consigo mesma)
+    int* ordem;             // toda função vem depois das que chama (fora de ciclos)
+    int* nivel;             // pela raiz do componente: 1 + o maior nível dos componentes chamados
+    int* efeitos;           // EFEITO_* de cada função
+} GrafoChamadas;
+
+GrafoChamadas* construirGrafoChamadas(const ProgramaIr* p);
+void liberarGrafoChamadas(GrafoChamadas* g);
+
+// Recalcula os efeitos do componente de 'funcao' depois que ele foi otimizado
+void atualizarEfeitos(const ProgramaIr* p, GrafoChamadas* g, int funcao);
+
+// Grafo consultado pelos passes (NULL: toda chamada pode fazer qualquer coisa)
+void definirGrafoChamadas(const ProgramaIr* p, const GrafoChamadas* g);
+
+// Corpo da função do programa chamada (NULL: runtime, só declarada ou sem grafo)
+FuncaoIr* funcaoChamada(const InstrIr* call);
+
+// Efeitos da função chamada; chamada pura (só depende dos argumentos) e
+// chamada que pode sair se o resultado não é usado
+int efeitosDeChamada(const InstrIr* call);
+bool chamadaPura(const InstrIr* call);
+bool chamadaRemovivel(const InstrIr* call);
+
+// Chamada ao runtime que recebe o endereço de uma função do programa e a
+// executa (csrt_paralelo): pode ler e gravar tudo o que aquela função alcança
+bool chamadaExecutaFuncao(const InstrIr* call);
+
+// Índice em p->funcoes da função com o símbolo dado (-1 se só declarada)
+int funcaoDeSimbolo(const ProgramaIr* p, int simbolo);
+
+// ----------------------------------------------
+// Sobreposição de memória (alias.c)
+// ----------------------------------------------
+
+// Calcula para onde cada parâmetro &id / id[] pode apontar (pelas chamadas
+// do programa) e o que cada função pode gravar. Sem análise, as consultas
+// abaixo usam só o que se vê dentro da função.
+void analisarAliasPrograma(const ProgramaIr* p);
+void liberarAliasPrograma(void);
+
+// Os endereços 'a' e 'b' da função podem atingir a mesma memória?
+bool podemSobreporIr(const FuncaoIr* f, const InstrIr* a, const InstrIr* b);
+
+// A chamada pode gravar na memória de 'endereco'?
+bool chamadaPodeGravarIr(const FuncaoIr* f, const InstrIr* call, const InstrIr* endereco);
+
+// ----------------------------------------------
+// Laços naturais (lacos.c)
+// ----------------------------------------------
+
+typedef struct LacoIr LacoIr;
+
+struct LacoIr {
+    BlocoIr* cabecalho;
+    BlocoIr* preCabecalho;  // único predecessor de fora; termina em jmp para o cabeçalho
+    BlocoIr** blocos;       // em pós-ordem reversa (o cabeçalho primeiro)
+    int nBlocos;
+    bool* contem;           // pelo id do bloco (blocos criados depois ficam de fora)
+    LacoIr* pai;            // laço que contém este (NULL no nível mais externo)
+};
+
+// Laços da função, dos internos para os externos; cria os pré-cabeçalhos que faltam
+LacoIr** encontrarLacosIr(FuncaoIr* f, int* nLacos);
+void liberarLacosIr(LacoIr** lacos, int n);
+
+// Ler do endereço não falha mesmo antes de conferir a condição do laço
+// (variáveis e elementos constantes dentro do vetor)
+bool enderecoValidoIr(const InstrIr* end);
+
+// ----------------------------------------------
+// Passes
+// ----------------------------------------------
+
+// Avalia operações com operandos constantes, aplica identidades algébricas
+// (x+0, x*1, x*0, !!b...) e troca desvios com condição constante por saltos
+bool dobrarConstantes(FuncaoIr* f);
+
+// Troca cálculos repetidos (e leituras de memória sem gravação no meio)
+// pelo valor já calculado num bloco dominante
+bool numerarValores(FuncaoIr* f);
+
+// Executa na compilação chamadas a funções puras com argumentos constantes
+// (avaliacao.c) e troca cada uma pelo valor devolvido
+bool avaliarChamadas(FuncaoIr* f);
+
+// Remove as verificações de índice (-fbounds-check) que a faixa de valores
+// do índice, tirada de constantes, laços e comparações dominantes, já garante
+bool eliminarVerificacoesLimite(FuncaoIr* f);
+
+// Remove valores sem uso, stores que nenhum caminho lê, blocos inalcançáveis
+// e slots abandonados; junta blocos ligados por um único salto
+bool eliminarCodigoMorto(FuncaoIr* f);
+
+// Tira dos laços o que não muda entre as voltas e troca i*k por somas
+bool otimizarLacos(FuncaoIr* f);
+
+// Junta dois laços seguidos com a mesma variável e os mesmos limites quando
+// nenhum elemento passa a ser lido ou gravado fora de ordem
+bool fundirLacos(FuncaoIr* f);
+
+// Mantém num valor, durante o laço, a global ou elemento constante que o
+// laço lê e grava; a memória é atualizada na saída e antes de chamadas
+bool promoverEscalares(FuncaoIr* f);
+
+// Troca laços que preenchem ou copiam um trecho de vetor, ou contam os
+// elementos de um vetor bool, por chamadas ao runtime que fazem tudo em blocos
+bool reconhecerIdiomas(FuncaoIr* f);
+
+// Troca recursão direta em posição de cauda por um laço e marca as outras
+// chamadas de cauda para virarem saltos
+bool otimizarChamadasCauda(FuncaoIr* f);
+
+// Copia no lugar das chamadas o corpo de funções pequenas e não recursivas
+bool expandirChamadas(const ProgramaIr* p, FuncaoIr* f, const GrafoChamadas* g);
+
+// Instruções da função que viram código, e se o custo de copiar 'chamada'
+// no lugar de 'call' cabe no limite da expansão
+int tamanhoFuncaoIr(const FuncaoIr* f);
+bool expansaoCompensa(const InstrIr* call, const FuncaoIr* chamada);
+
+// Cria cópias de funções para chamadas com argumentos constantes ou vetores
+// de tamanho conhecido e passa essas chamadas para as cópias
+bool especializarFuncoes(ProgramaIr* p);
+
+// Cria versões SSE2 de laços contados simples; o laço original faz o resto
+bool vetorizarLacos(FuncaoIr* f);
+
+// Passa laços contados sem dependência entre as voltas para funções novas
+// (acrescentadas a p) executadas em trechos pelas threads do runtime
+bool paralelizarLacos(ProgramaIr* p, FuncaoIr* f);
+
+// Avisa divisões inteiras cujo divisor é a constante zero
+void avisarDivisaoPorZero(const FuncaoIr* f);
+
+#endif
@@ -3,50 +3,46 @@
 
 #include <stdio.h>
 #include "lexer.h"
-#include "symbols.h"
+#include "ast.h"
 
 #define MAX_PARAMS_FUNCAO 32
 
-extern char tiposParamsTemp[MAX_PARAMS_FUNCAO][10];
-extern char nomesParamsTemp[MAX_PARAMS_FUNCAO][256];
-extern int numParamsTemp;
-
 // ==============================
 // Inicialização
 // ==============================
 
 /**
- * Inicia o analisador sintático com o arquivo fonte.
+ * Inicia o analisador sintático com o arquivo fonte e devolve a árvore do programa.
  */
-void startParser(FILE* f);
+NoAst* startParser(FILE* f);
 
 // ==============================
 // Regras da gramática principal
 // ==============================
 
-void parseProg(void);         // prog ::= { decl ';' | func }
-void parseDecl(void);         // decl ::= tipo decl_var {...} | tipo id(...) {...} | void id(...) {...}
-void parseDeclVar(const char* tipo, Escopo escopo);      // decl_var ::= id [ '[' intcon ']' ]
-void parseTipo(void);         // tipo ::= char | int | float | bool
-void parseTiposParam(void);   // tipos_param ::= void | tipo (id | &id | id[]){, tipo (...)}
+NoAst* parseProg(void);         // prog ::= { decl ';' | func }
+NoAst* parseDecl(void);         // decl ::= tipo decl_var {...} | tipo id(...) {...} | void id(...) {...}
+NoAst* parseDeclVar(TipoId tipo);      // decl_var ::= id [ '[' expr ']' ]
+void parseTipo(void);           // tipo ::= char | int | float | bool | string
+void parseTiposParam(NoAst* func);     // tipos_param ::= void | tipo (id | &id | id[]){, tipo (...)}
 
-void parseFunc(void);         // func ::= tipo/void id(...) '{' {decl_var} {cmd} '}' 
-void parseCmd(void);          // cmd ::= if, while, for, return, atrib, chamada, bloco, ';'
-void parseAtrib(void);        // atrib ::= id [ '[' expr ']' ] = expr
+void parseFunc(NoAst* func);    // func ::= tipo/void id(...) '{' {decl_var} {cmd} '}'
+NoAst* parseCmd(void);          // cmd ::= if, while, [parallel] for, switch, break, return, atrib, chamada, bloco, ';'
+NoAst* parseAtrib(void);        // atrib ::= id [ '[' expr ']' ] = expr
 
-void parseExpr(void);         // expr ::= expr_simp [ op_rel expr_simp ]
-void parseExprSimp(void);     // expr_simp ::= [+|-] termo {(+|-|or) termo}
-void parseTermo(void);        // termo ::= fator {(*|/|and) fator}
-void parseFator(void);        // fator ::= id[...] | constantes | chamada | (!fator)
+NoAst* parseExpr(void);         // expr ::= expr_simp [ op_rel expr_simp ]
+NoAst* parseExprSimp(void);     // expr_simp ::= [+|-] termo {(+|-|or) termo}
+NoAst* parseTermo(void);        // termo ::= fator {(*|/|and) fator}
+NoAst* parseFator(void);        // fator ::= id[...] | constantes | chamada | (!fator)
 
 // ==============================
 // Funções auxiliares de análise
 // ==============================
 
-void parseTipoParam(void);            // tipo (id | &id | id[])
-void parseDeclVarPrimeiro(const char* tipo, Escopo escopo);       // primeira variável da lista
-void parseDeclVarResto(const char* tipo, Escopo escopo);         // demais variáveis após vírgula
-void parseDeclVarLista(const char* tipo, Escopo escopo);        // lista de variáveis tipo v1, v2, v3;
+NoAst* parseTipoParam(void);                  // tipo (id | &id | id[])
+NoAst* parseDeclVarPrimeiro(TipoId tipo);     // primeira variável da lista
+NoAst* parseDeclVarResto(TipoId tipo);        // demais variáveis após vírgula
+NoAst* parseDeclVarLista(TipoId tipo);        // lista de variáveis tipo v1, v2, v3;
 
 // ==============================
 // Utilitários de parsing
@@ -61,6 +57,9 @@ void ungetToken(Token t);             // "devolve" token ao fluxo léxico
 void parseEat(int expectedType);     // consome token, erro se diferente
 
 // Retorna em 'dest' o nome do tipo correspondente ao token atual
-void obterTipoString(char* dest); 
+void obterTipoString(char* dest);
+
+// Retorna o identificador do tipo correspondente ao token atual
+TipoId obterTipoId(void);
 
-#endif // PARSER_H
\ No newline at end of file
+#endif // PARSER_H
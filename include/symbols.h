@@ -1,7 +1,11 @@
 #ifndef SYMBOLS_H
 
 #define SYMBOLS_H
-#define MAX_TABELA 1000
+
+#include <stdbool.h>
+#include "types.h"
+
+#define MAX_TABELA 1000   // capacidade inicial da tabela (cresce sob demanda)
 #define MAX_SIMBOLOS 1024
 #define MAX_PARAM 10
 
@@ -20,6 +24,13 @@ typedef enum {
     CLASSE_PARAM      // parâmetro (normal, por referência ou vetor)  
 } Classe;
 
+// Forma de passagem de um parâmetro
+typedef enum {
+    PARAM_VALOR,        // tipo id
+    PARAM_REFERENCIA,   // tipo &id
+    PARAM_VETOR         // tipo id[]
+} ModoParam;
+
 // Estado de validade do símbolo (se ainda está "vivo" no escopo)
 typedef enum {
     ESTADO_VIVO,  // Símbolo ativo e acessível
@@ -30,14 +41,26 @@ typedef enum {
 typedef struct {
     char nome[64];     // identificador (nome da variável, função, etc.)
     char tipo[10];     // tipo associado: "int", "float", "char", "bool", "void"
+    TipoId tipoId;     // identificador do tipo (vetores usam o tipo vetor correspondente)
     Classe classe;     // tipo de entidade (variável, função, etc.)
     Escopo escopo;     // escopo onde foi declarado (global/local)
     Estado estado;     // se ainda pode ser usado (vivo ou zumbi)
     int tamanho;       // tamanho usado em vetores; 1 para var simples; 0 para função/ref
     bool foiDefinida;
+    bool embutida;     // função da biblioteca da linguagem (strlen, strcmp, strcat)
+    int declaracao;    // índice da declaração de nível superior que criou o símbolo
 
     int nParams;                   // número de parâmetros
     char tiposParams[MAX_PARAM][10];  // tipo de cada parâmetro, na ordem
+    ModoParam modosParams[MAX_PARAM]; // forma de passagem de cada parâmetro
+
+    int posParam;        // parâmetros: posição na lista da função (-1 nos demais)
+    ModoParam modoParam; // parâmetros: forma de passagem
+
+    // Uso no programa (contado pela análise semântica)
+    int leituras;        // usos como valor, inclusive como argumento
+    int escritas;        // atribuições
+    int chamadas;        // funções: chamadas no programa
 } Simbolo;
 
 // Escopo atual do compilador (global ou local)
@@ -55,9 +78,13 @@ void inicializarTabela();
 // Insere um novo símbolo na tabela, retorna índice ou erro
 int inserirSimbolo(const char* nome, const char* tipo, Classe classe, Escopo escopo, int tamanho);
 
-// Busca um símbolo com nome e escopo exatos
+// Busca um símbolo ativo visível a partir do escopo dado
+// (locais vivos ficam sempre no fim da tabela; globais são indexados por nome)
 Simbolo* buscarSimbolo(const char* nome, Escopo escopo);
 
+// Índice do símbolo global com o nome dado, ou -1 (consulta em tempo constante)
+int buscarIndiceGlobal(const char* nome);
+
 // Remove todos os símbolos do escopo fornecido (usado para limpar escopo local)
 void limparEscopo(Escopo escopo);
 
@@ -75,6 +102,9 @@ void registrarFuncao(const char* tipo, const char* nome, int nParams, char tipos
 // Registra um parâmetro de função (normal, por ref, ou vetor)
 void registrarParametro(const char* tipo, const char* nome, Classe classe, Escopo escopo, int tamanho);
 
+// Define posição e forma de passagem do parâmetro recém-registrado com o nome dado
+void definirModoParametro(const char* nome, int posicao, ModoParam modo);
+
 // Registra uma variável local (tipo, nome, se é vetor e tamanho)
 void registrarVariavelLocal(const char* tipo, const char* nome, int isVetor, int tamanho);
 
@@ -0,0 +1,27 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+// ==============================================
+// POOL DE THREADS DO COMPILADOR
+// ==============================================
+//
+// As threads são criadas na primeira chamada e reaproveitadas depois.
+// Cada lote distribui os índices [0, n) dinamicamente entre as threads
+// (a thread que chama também trabalha) e só retorna quando todos terminam.
+
+// Função executada para cada índice do lote
+typedef void (*TarefaParalela)(int indice, void* arg);
+
+// Define quantas threads usar (0 = número de processadores)
+void definirNumThreads(int n);
+
+// Número de threads efetivamente usado
+int obterNumThreads(void);
+
+// Executa tarefa(i, arg) para todo i em [0, n) e espera todas terminarem
+void executarEmParalelo(int n, TarefaParalela tarefa, void* arg);
+
+// Encerra as threads do pool (opcional, ao final do programa)
+void encerrarThreads(void);
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef TYPES_H
+#define TYPES_H
+
+#include <stdbool.h>
+
+// ==============================================
+// TABELA DE TIPOS - C.SHORT
+// ==============================================
+//
+// Cada tipo da linguagem é identificado por um inteiro pequeno. As regras
+// de compatibilidade, promoção aritmética e tipo de elemento ficam em
+// tabelas pré-calculadas, então cada verificação é uma leitura de vetor.
+
+// TIPO_ERRO vale 0 para que as entradas omitidas das tabelas signifiquem erro
+typedef enum {
+    TIPO_ERRO,         // expressão mal tipada (nunca é compatível)
+    TIPO_NENHUM,       // nenhum tipo registrado ainda
+    TIPO_INDEFINIDO,   // função definida sem protótipo ainda sem tipo ("tipo")
+    TIPO_VOID,
+    TIPO_INT,
+    TIPO_CHAR,
+    TIPO_FLOAT,
+    TIPO_BOOL,
+    TIPO_STRING,       // texto imutável (representação compacta no runtime)
+    TIPO_INT_VETOR,
+    TIPO_CHAR_VETOR,
+    TIPO_FLOAT_VETOR,
+    TIPO_BOOL_VETOR,
+    NUM_TIPOS
+} TipoId;
+
+// Converte o nome textual ("int", "char[]", ...) no identificador do tipo
+TipoId tipoIdDeNome(const char* nome);
+
+// Nome textual do tipo (para mensagens e impressão)
+const char* nomeTipo(TipoId t);
+
+// Se um valor do tipo 'origem' pode ser atribuído a um destino do tipo 'destino'
+bool tipoCompativel(TipoId destino, TipoId origem);
+
+// Tipo resultante de + - * / entre t1 e t2 (TIPO_ERRO se inválido)
+TipoId tipoAritmetico(TipoId t1, TipoId t2);
+
+// Tipo resultante de == != < > <= >= entre t1 e t2 (TIPO_ERRO se inválido)
+TipoId tipoRelacional(TipoId t1, TipoId t2);
+
+// Tipo resultante de && e || entre t1 e t2 (TIPO_ERRO se inválido)
+TipoId tipoLogico(TipoId t1, TipoId t2);
+
+// Tipo do elemento de um vetor (char para string; o próprio tipo para escalares)
+TipoId tipoElemento(TipoId t);
+
+// Tipo vetor cujo elemento é 't' (TIPO_ERRO se não existir)
+TipoId tipoVetorDe(TipoId t);
+
+// Se o tipo é um vetor
+bool tipoIdEhVetor(TipoId t);
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef XREF_H
+#define XREF_H
+
+#include <stdbool.h>
+#include "symbols.h"
+
+// ==============================================
+// ÍNDICE DE REFERÊNCIAS CRUZADAS - C.SHORT
+// ==============================================
+//
+// Durante a análise, cada resolução de identificador é registrada como
+// uma ocorrência (deslocamento no fonte + tipo de uso). Ao final, o índice
+// invertido símbolo -> ocorrências ordenadas é gravado em formato binário
+// (opção --xref) e pode ser consultado com --xref-query.
+
+// Tipo de ocorrência de um símbolo no código-fonte
+typedef enum {
+    XREF_DECLARACAO,  // declaração (variável, vetor, parâmetro ou função)
+    XREF_LEITURA,     // uso como valor em expressão
+    XREF_ESCRITA,     // lado esquerdo de atribuição
+    XREF_CHAMADA      // chamada de função
+} TipoRefXref;
+
+// Liga a coleta de referências (desligada por padrão)
+void ativarXref(void);
+
+// Retorna se a coleta de referências está ligada
+bool xrefAtivo(void);
+
+// Marca o início do corpo (ou protótipo) de uma função: símbolos locais
+// registrados a partir daqui pertencem a ela
+void xrefEntrarFuncao(const char* nome, long offsetInicio);
+
+// Marca o fim da função atual (deslocamento do '}' ou ';' final)
+void xrefSairFuncao(long offsetFim);
+
+// Registra uma ocorrência de um símbolo da tabela
+void registrarReferenciaXref(const Simbolo* s, long offset, TipoRefXref tipo);
+
+// Grava o índice em formato binário; retorna 1 em caso de sucesso
+int gravarXref(const char* caminhoSaida, const char* caminhoFonte);
+
+// Consulta um índice gravado e imprime as ocorrências de 'nome'; retorna 1 se encontrou
+int consultarXref(const char* caminhoIndice, const char* nome);
+
+#endif
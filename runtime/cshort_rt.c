@@ -0,0 +1,378 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <pthread.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "cshort_rt.h"
+
+// ===================
+// Representação
+// ===================
+
+static int ehLonga(const CsString* s) {
+    return s->bytes[15] == CS_STR_LONGA;
+}
+
+static uint32_t tamanho(const CsString* s) {
+    return ehLonga(s) ? s->texto->tam : s->bytes[15];
+}
+
+static const char* dados(const CsString* s) {
+    return ehLonga(s) ? s->texto->dados : (const char*)s->bytes;
+}
+
+static CsTexto* novoTexto(uint32_t cap) {
+    CsTexto* t = malloc(sizeof(CsTexto) + cap);
+    if (!t) {
+        fprintf(stderr, "[ERRO EXECUÇÃO] Memória insuficiente para string\n");
+        exit(1);
+    }
+    t->refs = 1;
+    t->tam = 0;
+    t->cap = cap;
+    return t;
+}
+
+// Monta em 'dest' (não inicializada) a string com os bytes de a seguidos dos de b
+static void montar(CsString* dest, const char* a, uint32_t tamA, const char* b, uint32_t tamB) {
+    uint32_t total = tamA + tamB;
+
+    if (total <= CS_STR_CURTA_MAX) {
+        memset(dest->bytes, 0, sizeof(dest->bytes));
+        memcpy(dest->bytes, a, tamA);
+        memcpy(dest->bytes + tamA, b, tamB);
+        dest->bytes[15] = (unsigned char)total;
+        return;
+    }
+
+    CsTexto* t = novoTexto(total);
+    memcpy(t->dados, a, tamA);
+    memcpy(t->dados + tamA, b, tamB);
+    t->tam = total;
+
+    memset(dest->bytes, 0, sizeof(dest->bytes));
+    dest->texto = t;
+    dest->bytes[15] = CS_STR_LONGA;
+}
+
+// ===================
+// Posse
+// ===================
+
+void csrt_str_liberar(CsString* s) {
+    if (ehLonga(s) && s->texto->refs > 0 && --s->texto->refs == 0) {
+        free(s->texto);
+    }
+    memset(s->bytes, 0, sizeof(s->bytes));
+}
+
+void csrt_str_iniciar(CsString* dest, const CsString* orig) {
+    if (ehLonga(orig) && orig->texto->refs > 0) orig->texto->refs++;
+    memcpy(dest, orig, sizeof(CsString));
+}
+
+void csrt_str_copiar(CsString* dest, const CsString* orig) {
+    CsString antiga = *dest;   // 'orig' pode ser o próprio 'dest'
+    csrt_str_iniciar(dest, orig);
+    csrt_str_liberar(&antiga);
+}
+
+void csrt_str_mover(CsString* dest, CsString* orig) {
+    csrt_str_liberar(dest);
+    memcpy(dest, orig, sizeof(CsString));
+    memset(orig->bytes, 0, sizeof(orig->bytes));
+}
+
+// ===================
+// Funções embutidas
+// ===================
+
+int32_t csrt_strlen(const CsString* s) {
+    return (int32_t)tamanho(s);
+}
+
+int32_t csrt_strcmp(const CsString* a, const CsString* b) {
+    uint32_t tamA = tamanho(a), tamB = tamanho(b);
+    int r = memcmp(dados(a), dados(b), tamA < tamB ? tamA : tamB);
+
+    if (r == 0) r = (tamA > tamB) - (tamA < tamB);
+    return (r > 0) - (r < 0);
+}
+
+void csrt_strcat(CsString* res, const CsString* a, const CsString* b) {
+    montar(res, dados(a), tamanho(a), dados(b), tamanho(b));
+}
+
+void csrt_str_anexar(CsString* dest, const CsString* b) {
+    uint32_t tamB = tamanho(b);
+    if (tamB == 0) return;
+
+    uint32_t tamA = tamanho(dest);
+    uint32_t total = tamA + tamB;
+
+    // Buffer próprio: cresce no lugar (capacidade dobra), sem nova string
+    if (ehLonga(dest) && dest->texto->refs == 1) {
+        CsTexto* t = dest->texto;
+
+        if (total > t->cap) {
+            uint32_t cap = t->cap * 2 > total ? t->cap * 2 : total;
+            t = realloc(t, sizeof(CsTexto) + cap);
+            if (!t) {
+                fprintf(stderr, "[ERRO EXECUÇÃO] Memória insuficiente para string\n");
+                exit(1);
+            }
+            t->cap = cap;
+            dest->texto = t;
+        }
+
+        // s = strcat(s, s): a origem é o próprio buffer, talvez realocado
+        const char* origem = b == dest ? t->dados : dados(b);
+        memmove(t->dados + tamA, origem, tamB);
+        t->tam = total;
+        return;
+    }
+
+    // Curta que continua curta
+    if (!ehLonga(dest) && total <= CS_STR_CURTA_MAX) {
+        memmove(dest->bytes + tamA, dados(b), tamB);
+        dest->bytes[15] = (unsigned char)total;
+        return;
+    }
+
+    // Passa a ter buffer próprio, já com folga para as próximas concatenações
+    uint32_t cap = total * 2;
+    CsTexto* t = novoTexto(cap);
+    memcpy(t->dados, dados(dest), tamA);
+    memcpy(t->dados + tamA, dados(b), tamB);
+    t->tam = total;
+
+    csrt_str_liberar(dest);
+    dest->texto = t;
+    dest->bytes[15] = CS_STR_LONGA;
+}
+
+int32_t csrt_str_char(const CsString* s, int32_t i) {
+    if (i < 0 || (uint32_t)i >= tamanho(s)) return 0;
+    return (signed char)dados(s)[i];
+}
+
+// ===================
+// Vetores bool
+// ===================
+
+// Uma palavra de 64 bits por vez; as pontas do trecho usam máscaras.
+// As palavras são copiadas com memcpy: o vetor pode vir de C sem alinhamento
+
+static uint64_t lerPalavra(const void* v, int32_t k) {
+    uint64_t w;
+    memcpy(&w, (const char*)v + (size_t)k * 8, 8);
+    return w;
+}
+
+static void gravarPalavra(void* v, int32_t k, uint64_t w) {
+    memcpy((char*)v + (size_t)k * 8, &w, 8);
+}
+
+// Bits de [inicio, fim) que caem na palavra k
+static uint64_t mascaraPalavra(int32_t k, int32_t inicio, int32_t fim) {
+    uint64_t m = ~(uint64_t)0;
+    if (inicio > k * 64) m &= m << (inicio - k * 64);
+    if (fim < k * 64 + 64) m &= ~(uint64_t)0 >> (k * 64 + 64 - fim);
+    return m;
+}
+
+void csrt_bits_preencher(void* v, int32_t inicio, int32_t fim, int32_t valor) {
+    if (inicio >= fim) return;
+    int32_t primeira = inicio / 64, ultima = (fim - 1) / 64;
+
+    for (int32_t k = primeira; k <= ultima; k++) {
+        uint64_t m = mascaraPalavra(k, inicio, fim);
+        uint64_t w = m == ~(uint64_t)0 ? 0 : lerPalavra(v, k);
+        gravarPalavra(v, k, valor ? w | m : w & ~m);
+    }
+}
+
+int32_t csrt_bits_contar(const void* v, int32_t inicio, int32_t fim, int32_t valor) {
+    if (inicio >= fim) return 0;
+    int32_t primeira = inicio / 64, ultima = (fim - 1) / 64;
+
+    int32_t uns = 0;
+    for (int32_t k = primeira; k <= ultima; k++) {
+        uns += __builtin_popcountll(lerPalavra(v, k) & mascaraPalavra(k, inicio, fim));
+    }
+    return valor ? uns : (fim - inicio) - uns;
+}
+
+// ===================
+// Trechos de vetores
+// ===================
+
+// Laços que preenchem ou copiam um trecho inteiro (n <= 0: o laço não rodaria)
+
+void csrt_mem_preencher(void* dest, int32_t byte, int32_t n, int32_t tamanho) {
+    if (n > 0) memset(dest, (unsigned char)byte, (size_t)n * (size_t)tamanho);
+}
+
+void csrt_mem_copiar(void* dest, const void* orig, int32_t n, int32_t tamanho) {
+    if (n > 0) memcpy(dest, orig, (size_t)n * (size_t)tamanho);
+}
+
+// ===================
+// Laços paralelos
+// ===================
+
+// As threads auxiliares são criadas na primeira chamada e ficam esperando o
+// próximo lote; a thread que chama também executa trechos. Cada thread pega
+// o próximo trecho livre, então um trecho mais lento não segura os outros.
+
+#define TRECHOS_POR_THREAD 4
+
+typedef void (*CsCorpo)(int32_t, int32_t, void*);
+
+static pthread_once_t poolCriado = PTHREAD_ONCE_INIT;
+static pthread_mutex_t poolTrava = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t poolTemLote = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t poolConcluido = PTHREAD_COND_INITIALIZER;
+static int poolThreads = 1;            // inclui a thread que chama
+
+// Lote atual (protegido por poolTrava)
+static CsCorpo loteCorpo;
+static void* loteEnv;
+static int64_t loteInicio, loteFim, loteAlinhamento;
+static int loteTrechos, loteProximo, loteEmExecucao;
+static unsigned long loteGeracao;
+static bool loteAtivo;                 // outra chamada ao mesmo tempo roda sozinha
+
+static int contarProcessadores(void) {
+    const char* pedido = getenv("CSRT_THREADS");
+    if (pedido && atoi(pedido) > 0) return atoi(pedido);
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (int)info.dwNumberOfProcessors;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+#endif
+}
+
+// Começo do trecho k: a divisão em partes iguais, arredondada para baixo até o alinhamento
+static int64_t limiteTrecho(int k) {
+    if (k == 0) return loteInicio;
+    if (k == loteTrechos) return loteFim;
+
+    int64_t x = loteInicio + (loteFim - loteInicio) * k / loteTrechos;
+    int64_t resto = x % loteAlinhamento;
+    x -= resto < 0 ? resto + loteAlinhamento : resto;
+    return x < loteInicio ? loteInicio : x;
+}
+
+// Executa trechos livres do lote atual; chamada com poolTrava adquirida
+static void processarTrechos(void) {
+    loteEmExecucao++;
+    while (loteProximo < loteTrechos) {
+        int k = loteProximo++;
+        int64_t a = limiteTrecho(k), b = limiteTrecho(k + 1);
+        CsCorpo corpo = loteCorpo;
+        void* env = loteEnv;
+        pthread_mutex_unlock(&poolTrava);
+
+        if (a < b) corpo((int32_t)a, (int32_t)b, env);
+
+        pthread_mutex_lock(&poolTrava);
+    }
+    if (--loteEmExecucao == 0) pthread_cond_broadcast(&poolConcluido);
+}
+
+static void* executarAuxiliar(void* arg) {
+    (void)arg;
+    unsigned long vista = 0;
+
+    pthread_mutex_lock(&poolTrava);
+    for (;;) {
+        while (loteGeracao == vista) pthread_cond_wait(&poolTemLote, &poolTrava);
+        vista = loteGeracao;
+        processarTrechos();
+    }
+    return NULL;
+}
+
+static void criarPool(void) {
+    int n = contarProcessadores();
+    for (int i = 1; i < n; i++) {
+        pthread_t t;
+        if (pthread_create(&t, NULL, executarAuxiliar, NULL) != 0) break;
+        pthread_detach(t);
+        poolThreads++;
+    }
+}
+
+void csrt_paralelo(CsCorpo corpo, int32_t inicio, int32_t fim, void* env, int32_t alinhamento, int32_t minimo) {
+    int64_t voltas = (int64_t)fim - inicio;
+    if (voltas <= 0) return;
+
+    if (voltas >= minimo) pthread_once(&poolCriado, criarPool);
+
+    pthread_mutex_lock(&poolTrava);
+    if (voltas < minimo || poolThreads == 1 || loteAtivo) {
+        pthread_mutex_unlock(&poolTrava);
+        corpo(inicio, fim, env);
+        return;
+    }
+
+    int64_t trechos = (int64_t)poolThreads * TRECHOS_POR_THREAD;
+    loteAtivo = true;
+    loteCorpo = corpo;
+    loteEnv = env;
+    loteInicio = inicio;
+    loteFim = fim;
+    loteAlinhamento = alinhamento > 0 ? alinhamento : 1;
+    loteTrechos = (int)(trechos < voltas ? trechos : voltas);
+    loteProximo = 0;
+    loteGeracao++;
+    pthread_cond_broadcast(&poolTemLote);
+
+    processarTrechos();
+    while (loteEmExecucao > 0 || loteProximo < loteTrechos) {
+        pthread_cond_wait(&poolConcluido, &poolTrava);
+    }
+
+    loteAtivo = false;
+    pthread_mutex_unlock(&poolTrava);
+}
+
+void csrt_reduzir_soma(int32_t* acumulador, int32_t parcial) {
+    // Em unsigned: o transbordo dá a mesma volta que a soma do programa
+    __atomic_fetch_add((uint32_t*)acumulador, (uint32_t)parcial, __ATOMIC_RELAXED);
+}
+
+void csrt_reduzir_min(int32_t* acumulador, int32_t parcial) {
+    int32_t atual = __atomic_load_n(acumulador, __ATOMIC_RELAXED);
+    while (parcial < atual
+           && !__atomic_compare_exchange_n(acumulador, &atual, parcial, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+void csrt_reduzir_max(int32_t* acumulador, int32_t parcial) {
+    int32_t atual = __atomic_load_n(acumulador, __ATOMIC_RELAXED);
+    while (parcial > atual
+           && !__atomic_compare_exchange_n(acumulador, &atual, parcial, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+// ===================
+// Verificações
+// ===================
+
+void csrt_fora_dos_limites(int32_t linha, int32_t indice, int32_t tamanho) {
+    fflush(stdout);
+    fprintf(stderr, "[ERRO EXECUÇÃO] linha %d: índice %d fora do vetor de %d elementos\n", linha, indice, tamanho);
+    abort();
+}
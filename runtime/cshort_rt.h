@@ -0,0 +1,97 @@
+#ifndef CSHORT_RT_H
+#define CSHORT_RT_H
+
+#include <stdint.h>
+
+// ==============================================
+// RUNTIME DOS PROGRAMAS C.SHORT
+// ==============================================
+//
+// Ligado ao assembly gerado (gcc programa.s build/cshort_rt.o -pthread).
+//
+// Uma string ocupa 16 bytes:
+//
+//   curta  (até 15 bytes): dados em bytes[0..14], tamanho em bytes[15]
+//   longa:                 ponteiro para um CsTexto em bytes[0..7], bytes[15] = 0xFF
+//
+// Uma string zerada é a string vazia, então variáveis não precisam de
+// inicialização especial. Textos longos têm contagem de referências:
+// cópias compartilham o buffer e a concatenação acumulada (s = strcat(s, x))
+// cresce o próprio buffer quando ele não é compartilhado. Literais longos
+// ficam no executável com refs = -1 e nunca são liberados.
+//
+// Um vetor bool guarda um bit por elemento: o elemento i é o bit i % 8 do
+// byte i / 8, e o vetor ocupa palavras inteiras de 64 bits.
+
+#define CS_STR_CURTA_MAX 15
+#define CS_STR_LONGA     0xFF
+
+// Buffer de uma string longa, prefixado pelo tamanho
+typedef struct {
+    int32_t refs;      // -1 = constante do programa
+    uint32_t tam;
+    uint32_t cap;
+    char dados[];
+} CsTexto;
+
+typedef union {
+    CsTexto* texto;
+    unsigned char bytes[16];
+} CsString;
+
+// Tamanho da string
+int32_t csrt_strlen(const CsString* s);
+
+// Comparação lexicográfica dos bytes: -1, 0 ou 1
+int32_t csrt_strcmp(const CsString* a, const CsString* b);
+
+// res = a + b ('res' não inicializada)
+void csrt_strcat(CsString* res, const CsString* a, const CsString* b);
+
+// dest = dest + b, reaproveitando o buffer de 'dest' quando possível
+void csrt_str_anexar(CsString* dest, const CsString* b);
+
+// Caractere na posição i (0 fora dos limites)
+int32_t csrt_str_char(const CsString* s, int32_t i);
+
+// dest = orig ('dest' não inicializada)
+void csrt_str_iniciar(CsString* dest, const CsString* orig);
+
+// dest = orig ('dest' já contém uma string)
+void csrt_str_copiar(CsString* dest, const CsString* orig);
+
+// dest = orig, transferindo a posse de 'orig' (que deixa de ser usada)
+void csrt_str_mover(CsString* dest, CsString* orig);
+
+// Libera a string e a deixa vazia
+void csrt_str_liberar(CsString* s);
+
+// Elementos [inicio, fim) do vetor bool 'v' recebem 'valor'
+void csrt_bits_preencher(void* v, int32_t inicio, int32_t fim, int32_t valor);
+
+// Quantos elementos [inicio, fim) do vetor bool 'v' são iguais a 'valor'
+int32_t csrt_bits_contar(const void* v, int32_t inicio, int32_t fim, int32_t valor);
+
+// 'n' elementos de 'tamanho' bytes a partir de 'dest' recebem o byte 'byte' em todos os bytes
+void csrt_mem_preencher(void* dest, int32_t byte, int32_t n, int32_t tamanho);
+
+// Copia 'n' elementos de 'tamanho' bytes de 'orig' para 'dest' (sem memória em comum)
+void csrt_mem_copiar(void* dest, const void* orig, int32_t n, int32_t tamanho);
+
+// Chama corpo(a, b, env) para trechos [a, b) que cobrem [inicio, fim), em
+// paralelo nas threads do runtime (uma por processador, ou CSRT_THREADS).
+// Os limites dos trechos são múltiplos de 'alinhamento' (menos inicio e
+// fim); com menos de 'minimo' voltas, o corpo roda inteiro na thread atual
+void csrt_paralelo(void (*corpo)(int32_t, int32_t, void*), int32_t inicio, int32_t fim, void* env,
+                   int32_t alinhamento, int32_t minimo);
+
+// Junta a parcial de um trecho de uma redução int ao acumulador comum dos
+// trechos (operação atômica: os trechos terminam em qualquer ordem)
+void csrt_reduzir_soma(int32_t* acumulador, int32_t parcial);
+void csrt_reduzir_min(int32_t* acumulador, int32_t parcial);
+void csrt_reduzir_max(int32_t* acumulador, int32_t parcial);
+
+// Índice fora do vetor (-fbounds-check): mostra a linha e interrompe o programa
+void csrt_fora_dos_limites(int32_t linha, int32_t indice, int32_t tamanho);
+
+#endif
@@ -0,0 +1,296 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "otimizacao.h"
+
+// ==============================================
+// ANÁLISE DE SOBREPOSIÇÃO (ALIAS)
+// ==============================================
+//
+// Todo endereço da IR sai de um objeto: uma global, um slot do quadro
+// (IR_LOCAL) ou um parâmetro &id / id[] (IR_PARAM), mais deslocamentos
+// (IR_ELEM). Dois endereços de objetos diferentes nunca se sobrepõem:
+//
+// - globais diferentes são variáveis diferentes;
+// - um slot do quadro só é alcançado de fora pelo endereço passado numa
+//   chamada (o Cshort não tem ponteiros), então um parâmetro nunca aponta
+//   para um slot da própria ativação;
+// - um parâmetro aponta para o que as chamadas do programa passam nele.
+//   Os alvos de cada parâmetro são a união dos argumentos de todas as
+//   chamadas, repetida até parar de mudar (um parâmetro repassado leva os
+//   alvos do parâmetro de quem chama). Funções que ninguém do programa
+//   chama, como main, recebem qualquer coisa.
+//
+// Cada função também tem um resumo do que grava: globais, parâmetros
+// (pelo índice) e, se gravar por um endereço desconhecido, tudo. Uma
+// chamada só muda a memória que esse resumo e os seus argumentos alcançam.
+//
+// Os fatos valem para o programa inteiro compilado junto. A expansão de
+// chamadas só troca argumentos por outros que já estavam entre os alvos,
+// então eles continuam valendo até a próxima análise.
+
+// Global (funcao == -1, indice = símbolo) ou slot 'indice' de p->funcoes[funcao]
+typedef struct {
+    int funcao;
+    int indice;
+} Objeto;
+
+typedef struct {
+    Objeto* itens;
+    int n;
+    int cap;
+    bool desconhecido;      // pode ser qualquer lugar
+} Alvos;
+
+typedef struct {
+    Alvos globais;          // desconhecido = grava em qualquer lugar
+    unsigned params;        // bit k: grava pelo parâmetro k
+} Gravacoes;
+
+typedef struct {
+    const ProgramaIr* p;
+    int nFuncoes;                       // as criadas depois da análise ficam de fora
+    Alvos (*params)[MAX_PARAM + 1];     // por função e parâmetro
+    Gravacoes* gravacoes;               // por função
+} Analise;
+
+static Analise analise = { 0 };
+
+// ===================
+// Conjuntos de objetos
+// ===================
+
+static bool contem(const Alvos* a, Objeto o) {
+    for (int k = 0; k < a->n; k++) {
+        if (a->itens[k].funcao == o.funcao && a->itens[k].indice == o.indice) return true;
+    }
+    return false;
+}
+
+static bool incluir(Alvos* a, Objeto o) {
+    if (a->desconhecido || contem(a, o)) return false;
+    if (a->n == a->cap) {
+        a->cap = a->cap ? a->cap * 2 : 4;
+        a->itens = realloc(a->itens, a->cap * sizeof(Objeto));
+    }
+    a->itens[a->n++] = o;
+    return true;
+}
+
+static bool tornarDesconhecido(Alvos* a) {
+    if (a->desconhecido) return false;
+    a->desconhecido = true;
+    a->n = 0;
+    return true;
+}
+
+static bool unir(Alvos* a, const Alvos* b) {
+    if (b->desconhecido) return tornarDesconhecido(a);
+    bool mudou = false;
+    for (int k = 0; k < b->n; k++) mudou |= incluir(a, b->itens[k]);
+    return mudou;
+}
+
+static bool intersecta(const Alvos* a, const Alvos* b) {
+    if (a->desconhecido || b->desconhecido) return true;
+    for (int k = 0; k < a->n; k++) {
+        if (contem(b, a->itens[k])) return true;
+    }
+    return false;
+}
+
+// ===================
+// Origem dos endereços
+// ===================
+
+static const InstrIr* raiz(const InstrIr* endereco) {
+    while (endereco->op == IR_ELEM) endereco = endereco->args[0];
+    return endereco;
+}
+
+static int indiceFuncao(const FuncaoIr* f) {
+    if (!analise.p) return -1;
+    for (int k = 0; k < analise.nFuncoes; k++) {
+        if (analise.p->funcoes[k] == f) return k;
+    }
+    return -1;
+}
+
+// Alvos do endereço visto de fora da função 'k' (slots viram objetos de k)
+static void alvosDe(int k, const InstrIr* endereco, Alvos* a) {
+    const InstrIr* r = raiz(endereco);
+    a->itens = NULL;
+    a->n = a->cap = 0;
+    a->desconhecido = false;
+
+    if (r->op == IR_GLOBAL) {
+        incluir(a, (Objeto){ -1, r->simbolo });
+    } else if (r->op == IR_LOCAL && k >= 0) {
+        incluir(a, (Objeto){ k, r->indice });
+    } else if (r->op == IR_PARAM && k >= 0) {
+        unir(a, &analise.params[k][r->indice]);
+    } else {
+        a->desconhecido = true;
+    }
+}
+
+// ===================
+// Construção
+// ===================
+
+static bool gravarEm(int k, const InstrIr* endereco) {
+    Gravacoes* g = &analise.gravacoes[k];
+    const InstrIr* r = raiz(endereco);
+
+    if (r->op == IR_LOCAL) return false;
+    if (r->op == IR_PARAM) {
+        if (g->params & (1u << r->indice)) return false;
+        g->params |= 1u << r->indice;
+        return true;
+    }
+    if (r->op == IR_GLOBAL) return incluir(&g->globais, (Objeto){ -1, r->simbolo });
+    return tornarDesconhecido(&g->globais);
+}
+
+// Alvos dos parâmetros e gravações que a chamada acrescenta
+static bool propagarChamada(int k, const InstrIr* call) {
+    bool mudou = false;
+
+    // Runtime: pode gravar em tudo que recebe (ou, executando uma função do
+    // programa com endereços guardados na memória, em qualquer lugar)
+    if (chamadaExecutaFuncao(call)) return tornarDesconhecido(&analise.gravacoes[k].globais);
+    if (call->simbolo < 0) {
+        for (int a = 0; a < call->nArgs; a++) {
+            if (call->args[a]->tipo == IR_PTR) mudou |= gravarEm(k, call->args[a]);
+        }
+        return mudou;
+    }
+
+    int alvo = funcaoDeSimbolo(analise.p, call->simbolo);
+    if (alvo < 0) return tornarDesconhecido(&analise.gravacoes[k].globais);
+
+    const Gravacoes* chamada = &analise.gravacoes[alvo];
+    mudou |= unir(&analise.gravacoes[k].globais, &chamada->globais);
+
+    for (int a = 0; a < call->nArgs; a++) {
+        if (call->args[a]->tipo != IR_PTR) continue;
+        if (chamada->params & (1u << a)) mudou |= gravarEm(k, call->args[a]);
+
+        Alvos arg;
+        alvosDe(k, call->args[a], &arg);
+        mudou |= unir(&analise.params[alvo][a], &arg);
+        free(arg.itens);
+    }
+    return mudou;
+}
+
+static bool propagarFuncao(int k) {
+    FuncaoIr* f = analise.p->funcoes[k];
+    bool mudou = false;
+
+    for (int b = 0; b < f->nBlocos; b++) {
+        for (InstrIr* i = f->blocos[b]->primeira; i; i = i->prox) {
+            switch (i->op) {
+                case IR_STORE:
+                case IR_ZERAR:
+                case IR_COPIAR:
+                    mudou |= gravarEm(k, i->args[0]);
+                    break;
+                case IR_CALL:
+                    mudou |= propagarChamada(k, i);
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+    return mudou;
+}
+
+void liberarAliasPrograma(void) {
+    if (!analise.p) return;
+    for (int k = 0; k < analise.nFuncoes; k++) {
+        for (int a = 0; a <= MAX_PARAM; a++) free(analise.params[k][a].itens);
+        free(analise.gravacoes[k].globais.itens);
+    }
+    free(analise.params);
+    free(analise.gravacoes);
+    analise.p = NULL;
+}
+
+void analisarAliasPrograma(const ProgramaIr* p) {
+    liberarAliasPrograma();
+
+    int n = p->nFuncoes;
+    GrafoChamadas* g = construirGrafoChamadas(p);
+    analise.p = p;
+    analise.nFuncoes = n;
+    analise.params = calloc(n > 0 ? n : 1, sizeof(*analise.params));
+    analise.gravacoes = calloc(n > 0 ? n : 1, sizeof(Gravacoes));
+
+    for (int k = 0; k < n; k++) {
+        if (g->nChamadas[k] > 0) continue;
+        for (int a = 0; a <= MAX_PARAM; a++) analise.params[k][a].desconhecido = true;
+    }
+    liberarGrafoChamadas(g);
+
+    // Os conjuntos só crescem: a repetição termina
+    bool mudou = true;
+    while (mudou) {
+        mudou = false;
+        for (int k = 0; k < n; k++) mudou |= propagarFuncao(k);
+    }
+}
+
+// ===================
+// Consultas
+// ===================
+
+bool podemSobreporIr(const FuncaoIr* f, const InstrIr* a, const InstrIr* b) {
+    if (a == b) return true;
+
+    const InstrIr* ra = raiz(a);
+    const InstrIr* rb = raiz(b);
+
+    // Slots da própria ativação: só o mesmo slot
+    if (ra->op == IR_LOCAL || rb->op == IR_LOCAL) {
+        if (ra->op == IR_LOCAL && rb->op == IR_LOCAL) return ra->indice == rb->indice;
+        const InstrIr* outra = ra->op == IR_LOCAL ? rb : ra;
+        return outra->op != IR_GLOBAL && outra->op != IR_PARAM;
+    }
+    if (ra->op == IR_GLOBAL && rb->op == IR_GLOBAL) return ra->simbolo == rb->simbolo;
+
+    int k = indiceFuncao(f);
+    Alvos x, y;
+    alvosDe(k, a, &x);
+    alvosDe(k, b, &y);
+    bool resultado = intersecta(&x, &y);
+    free(x.itens);
+    free(y.itens);
+    return resultado;
+}
+
+bool chamadaPodeGravarIr(const FuncaoIr* f, const InstrIr* call, const InstrIr* endereco) {
+    unsigned params = ~0u;
+
+    if (chamadaExecutaFuncao(call)) return true;
+    if (call->simbolo >= 0) {
+        int alvo = analise.p ? funcaoDeSimbolo(analise.p, call->simbolo) : -1;
+        if (alvo < 0 || alvo >= analise.nFuncoes) return true;
+
+        const Gravacoes* g = &analise.gravacoes[alvo];
+        Alvos x;
+        alvosDe(indiceFuncao(f), endereco, &x);
+        bool global = intersecta(&x, &g->globais);
+        free(x.itens);
+        if (global) return true;
+        params = g->params;
+    }
+
+    // O resto só pelos argumentos gravados
+    for (int a = 0; a < call->nArgs; a++) {
+        if (call->args[a]->tipo != IR_PTR || !(params & (1u << a))) continue;
+        if (podemSobreporIr(f, call->args[a], endereco)) return true;
+    }
+    return false;
+}
@@ -0,0 +1,55 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ast.h"
+
+// Cria um nó do tipo dado com a posição do token
+NoAst* novoNo(TipoNo tipo, Token token) {
+    NoAst* no = calloc(1, sizeof(NoAst));
+    if (!no) {
+        fprintf(stderr, "Erro: memória insuficiente para a árvore sintática.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    no->tipo = tipo;
+    no->linha = token.line;
+    no->coluna = token.column;
+    no->offset = token.offset;
+    no->tipoExpr = TIPO_NENHUM;
+    no->simbolo = -1;
+    return no;
+}
+
+// Acrescenta 'no' ao fim da lista descrita por (inicio, fim)
+void anexarNo(NoAst** inicio, NoAst** fim, NoAst* no) {
+    if (!no) return;
+
+    if (*fim) {
+        (*fim)->prox = no;
+    } else {
+        *inicio = no;
+    }
+
+    // 'no' pode ser o começo de uma lista já encadeada
+    while (no->prox) no = no->prox;
+    *fim = no;
+}
+
+// Quantidade de elementos de uma lista encadeada por 'prox'
+int tamanhoLista(const NoAst* lista) {
+    int n = 0;
+    for (; lista; lista = lista->prox) n++;
+    return n;
+}
+
+// Libera a árvore inteira (incluindo listas encadeadas)
+void liberarAst(NoAst* no) {
+    while (no) {
+        NoAst* prox = no->prox;
+        for (int i = 0; i < 4; i++) liberarAst(no->filhos[i]);
+        free(no->nome);
+        free(no);
+        no = prox;
+    }
+}
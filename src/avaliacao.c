@@ -0,0 +1,365 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "otimizacao.h"
+
+// ==============================================
+// AVALIAÇÃO DE CHAMADAS NA COMPILAÇÃO
+// ==============================================
+//
+// Uma chamada a função pura (não lê nem grava memória fora do próprio
+// quadro) com todos os argumentos constantes devolve sempre o mesmo valor:
+// um interpretador da IR executa a função durante a compilação e a chamada
+// vira a constante. A aritmética é a do código gerado (calcularOperacaoIr)
+// e os vetores locais da função são simulados byte a byte (os vetores bool,
+// bit a bit).
+//
+// A avaliação desiste (e a chamada fica) quando passa de PASSOS_MAXIMOS
+// instruções ou PROFUNDIDADE_MAXIMA chamadas aninhadas, quando o programa
+// seria interrompido (divisão por zero, índice fora do vetor) e quando lê
+// um elemento local que ainda não foi gravado.
+
+#define PASSOS_MAXIMOS 1000000
+#define PROFUNDIDADE_MAXIMA 200
+
+typedef struct {
+    ValorIr v;
+    int slot;               // endereços: slot do quadro
+    int desloc;             // endereços: bytes desde o início do slot
+    int bit;                // elementos de vetor bool: bit do byte 'desloc' (-1 nos outros)
+} Celula;
+
+typedef struct {
+    const FuncaoIr* f;
+    Celula* valores;        // pelo id
+    Celula* temp;           // valores novos dos phi, antes de atribuir
+    unsigned char** memoria;
+    unsigned char** escrito;    // por byte, os bits já gravados
+} Quadro;
+
+typedef enum {
+    SEGUE,
+    SALTA,
+    VOLTA,
+    DESISTE
+} Resultado;
+
+static int bytesDe(TipoIr t) {
+    switch (t) {
+        case IR_I1:
+        case IR_I8:  return 1;
+        case IR_I32:
+        case IR_F32: return 4;
+        default:     return 0;
+    }
+}
+
+static bool executar(const FuncaoIr* f, const ValorIr* args, int profundidade, long* passos, ValorIr* resultado);
+
+// ===================
+// Memória do quadro
+// ===================
+
+static bool dentro(const Quadro* q, const Celula* end, int n) {
+    if (end->slot < 0 || end->slot >= q->f->nSlots || n <= 0) return false;
+    return end->desloc >= 0 && end->desloc + n <= q->f->slots[end->slot].tamanho;
+}
+
+static bool ler(const Quadro* q, const Celula* end, TipoIr tipo, ValorIr* v) {
+    int n = bytesDe(tipo);
+    if (!dentro(q, end, n)) return false;
+
+    if (end->bit >= 0) {
+        if (!(q->escrito[end->slot][end->desloc] & (1u << end->bit))) return false;
+        v->i = (q->memoria[end->slot][end->desloc] >> end->bit) & 1;
+        return true;
+    }
+    for (int k = 0; k < n; k++) {
+        if (q->escrito[end->slot][end->desloc + k] != 0xFF) return false;
+    }
+
+    const unsigned char* m = q->memoria[end->slot] + end->desloc;
+    if (n == 1) v->i = tipo == IR_I8 ? (int8_t)m[0] : m[0];
+    else memcpy(v, m, 4);
+    return true;
+}
+
+static bool gravar(Quadro* q, const Celula* end, TipoIr tipo, ValorIr v) {
+    int n = bytesDe(tipo);
+    if (!dentro(q, end, n)) return false;
+
+    unsigned char* m = q->memoria[end->slot] + end->desloc;
+    if (end->bit >= 0) {
+        m[0] = (unsigned char)((m[0] & ~(1u << end->bit)) | ((v.i & 1) << end->bit));
+        q->escrito[end->slot][end->desloc] |= 1u << end->bit;
+        return true;
+    }
+    if (n == 1) m[0] = (unsigned char)v.i;
+    else memcpy(m, &v, 4);
+    memset(q->escrito[end->slot] + end->desloc, 0xFF, n);
+    return true;
+}
+
+// ===================
+// Instruções
+// ===================
+
+static Resultado executarChamada(Quadro* q, const InstrIr* i, int profundidade, long* passos) {
+    const FuncaoIr* chamada = funcaoChamada(i);
+    if (!chamada || !chamadaPura(i) || i->nArgs > MAX_PARAM + 1) return DESISTE;
+
+    ValorIr args[MAX_PARAM + 1];
+    for (int a = 0; a < i->nArgs; a++) {
+        if (!bytesDe(i->args[a]->tipo)) return DESISTE;
+        args[a] = q->valores[i->args[a]->id].v;
+    }
+    return executar(chamada, args, profundidade + 1, passos, &q->valores[i->id].v) ? SEGUE : DESISTE;
+}
+
+// Trechos de vetores locais: n elementos de 'tamanho' bytes (nada se n <= 0)
+static Resultado executarMemoria(Quadro* q, const InstrIr* i, long* passos) {
+    bool copia = strcmp(i->runtime, "csrt_mem_copiar") == 0;
+    const Celula* dest = &q->valores[i->args[0]->id];
+    const Celula* orig = &q->valores[i->args[1]->id];
+    int32_t n = q->valores[i->args[2]->id].v.i;
+    int32_t tamanho = q->valores[i->args[3]->id].v.i;
+    if (n <= 0) return SEGUE;
+
+    *passos += n;
+    if (*passos > PASSOS_MAXIMOS) return DESISTE;
+    int bytes = n * tamanho;
+    if (!dentro(q, dest, bytes) || (copia && !dentro(q, orig, bytes))) return DESISTE;
+
+    unsigned char* m = q->memoria[dest->slot] + dest->desloc;
+    unsigned char* escrito = q->escrito[dest->slot] + dest->desloc;
+    if (copia) {
+        memmove(m, q->memoria[orig->slot] + orig->desloc, bytes);
+        memmove(escrito, q->escrito[orig->slot] + orig->desloc, bytes);
+    } else {
+        memset(m, (unsigned char)orig->v.i, bytes);
+        memset(escrito, 0xFF, bytes);
+    }
+    return SEGUE;
+}
+
+// Só as funções do runtime sobre vetores, bit a bit ou byte a byte
+static Resultado executarRuntime(Quadro* q, const InstrIr* i, long* passos) {
+    if (strcmp(i->runtime, "csrt_mem_copiar") == 0 || strcmp(i->runtime, "csrt_mem_preencher") == 0) {
+        return executarMemoria(q, i, passos);
+    }
+
+    bool preencher = strcmp(i->runtime, "csrt_bits_preencher") == 0;
+    if (!preencher && strcmp(i->runtime, "csrt_bits_contar") != 0) return DESISTE;
+
+    const Celula* v = &q->valores[i->args[0]->id];
+    int32_t inicio = q->valores[i->args[1]->id].v.i;
+    int32_t fim = q->valores[i->args[2]->id].v.i;
+    int32_t valor = q->valores[i->args[3]->id].v.i & 1;
+    if (v->bit >= 0 || inicio < 0) return DESISTE;
+
+    int32_t iguais = 0;
+    for (int32_t k = inicio; k < fim; k++) {
+        if (++*passos > PASSOS_MAXIMOS) return DESISTE;
+        Celula bit = { .slot = v->slot, .desloc = v->desloc + (k >> 3), .bit = k & 7 };
+        ValorIr x = { .i = valor };
+        if (preencher) {
+            if (!gravar(q, &bit, IR_I1, x)) return DESISTE;
+        } else {
+            if (!ler(q, &bit, IR_I1, &x)) return DESISTE;
+            iguais += x.i == valor;
+        }
+    }
+    if (!preencher) q->valores[i->id].v.i = iguais;
+    return SEGUE;
+}
+
+static Resultado executarInstr(Quadro* q, const InstrIr* i, const ValorIr* args, int profundidade, long* passos,
+                               const BlocoIr** proximo, ValorIr* resultado) {
+    Celula* c = &q->valores[i->id];
+    const Celula* a = i->nArgs > 0 ? &q->valores[i->args[0]->id] : NULL;
+    const Celula* b = i->nArgs > 1 ? &q->valores[i->args[1]->id] : NULL;
+
+    switch (i->op) {
+        case IR_CONST:
+            c->v = i->imm;
+            return SEGUE;
+
+        case IR_PARAM:
+            c->v = args[i->indice];
+            return SEGUE;
+
+        case IR_ADD:
+        case IR_SUB:
+        case IR_MUL:
+        case IR_DIV:
+        case IR_NEG:
+        case IR_NOT:
+        case IR_CMP:
+        case IR_CONV: {
+            ValorIr operandos[2] = { a->v, b ? b->v : a->v };
+            if (ehVetorIr(i->tipo) || ehVetorIr(i->args[0]->tipo)) return DESISTE;
+            return calcularOperacaoIr(i->op, i->cond, i->tipo, i->args[0]->tipo, operandos, &c->v) ? SEGUE : DESISTE;
+        }
+
+        case IR_LOCAL:
+            c->slot = i->indice;
+            c->desloc = 0;
+            c->bit = -1;
+            return SEGUE;
+
+        case IR_ELEM: {
+            long long desloc = i->escala == 0 ? (long long)a->desloc + (b->v.i >> 3)
+                                              : (long long)a->desloc + (long long)b->v.i * i->escala;
+            if (a->slot < 0 || desloc < 0 || desloc > q->f->slots[a->slot].tamanho) return DESISTE;
+            c->slot = a->slot;
+            c->desloc = (int)desloc;
+            c->bit = i->escala == 0 ? b->v.i & 7 : -1;
+            return SEGUE;
+        }
+
+        case IR_LOAD:
+            return ler(q, a, i->tipo, &c->v) ? SEGUE : DESISTE;
+
+        case IR_STORE:
+            return gravar(q, a, i->args[1]->tipo, b->v) ? SEGUE : DESISTE;
+
+        case IR_ZERAR:
+            if (!dentro(q, a, i->tamanho)) return DESISTE;
+            memset(q->memoria[a->slot] + a->desloc, 0, i->tamanho);
+            memset(q->escrito[a->slot] + a->desloc, 0xFF, i->tamanho);
+            return SEGUE;
+
+        case IR_COPIAR:
+            if (!dentro(q, a, i->tamanho) || !dentro(q, b, i->tamanho)) return DESISTE;
+            memmove(q->memoria[a->slot] + a->desloc, q->memoria[b->slot] + b->desloc, i->tamanho);
+            memmove(q->escrito[a->slot] + a->desloc, q->escrito[b->slot] + b->desloc, i->tamanho);
+            return SEGUE;
+
+        case IR_LIMITE:
+            return a->v.i >= 0 && a->v.i < i->tamanho ? SEGUE : DESISTE;
+
+        case IR_CALL:
+            if (i->simbolo < 0) return executarRuntime(q, i, passos);
+            if (i->tipo == IR_VOID && chamadaPura(i)) return SEGUE;   // pura e sem valor: não faz nada
+            return executarChamada(q, i, profundidade, passos);
+
+        case IR_JMP:
+            *proximo = i->alvos[0];
+            return SALTA;
+
+        case IR_BR:
+            *proximo = a->v.i ? i->alvos[0] : i->alvos[1];
+            return SALTA;
+
+        case IR_RET:
+            if (a) *resultado = a->v;
+            return VOLTA;
+
+        default:
+            // Globais, strings e vetores SSE não aparecem em função pura avaliável
+            return DESISTE;
+    }
+}
+
+// ===================
+// Execução
+// ===================
+
+static void liberarQuadro(Quadro* q) {
+    for (int s = 0; s < q->f->nSlots; s++) {
+        free(q->memoria[s]);
+        free(q->escrito[s]);
+    }
+    free(q->memoria);
+    free(q->escrito);
+    free(q->valores);
+    free(q->temp);
+}
+
+static bool executar(const FuncaoIr* f, const ValorIr* args, int profundidade, long* passos, ValorIr* resultado) {
+    if (profundidade > PROFUNDIDADE_MAXIMA) return false;
+
+    Quadro q;
+    int nValores = f->nValores > 0 ? f->nValores : 1;
+    int nSlots = f->nSlots > 0 ? f->nSlots : 1;
+    q.f = f;
+    q.valores = calloc(nValores, sizeof(Celula));
+    q.temp = calloc(nValores, sizeof(Celula));
+    q.memoria = calloc(nSlots, sizeof(unsigned char*));
+    q.escrito = calloc(nSlots, sizeof(unsigned char*));
+    for (int s = 0; s < f->nSlots; s++) {
+        q.memoria[s] = calloc(f->slots[s].tamanho + 1, 1);
+        q.escrito[s] = calloc(f->slots[s].tamanho + 1, 1);
+    }
+    for (int v = 0; v < nValores; v++) q.valores[v].slot = -1;
+
+    const BlocoIr* bloco = f->blocos[0];
+    const BlocoIr* anterior = NULL;
+    Resultado r = SALTA;
+
+    while (r == SALTA) {
+        // Os phi leem os valores da aresta de onde veio, todos ao mesmo tempo
+        int p = anterior ? indicePredIr(bloco, anterior) : -1;
+        const InstrIr* i = bloco->primeira;
+        int nPhis = 0;
+        for (const InstrIr* phi = i; phi && phi->op == IR_PHI && p >= 0; phi = phi->prox) {
+            q.temp[nPhis++] = q.valores[phi->args[p]->id];
+        }
+        for (int k = 0; k < nPhis; k++, i = i->prox) q.valores[i->id] = q.temp[k];
+
+        const BlocoIr* proximo = NULL;
+        r = i && i->op == IR_PHI ? DESISTE : SEGUE;
+        for (; i && r == SEGUE; i = i->prox) {
+            if (++*passos > PASSOS_MAXIMOS) r = DESISTE;
+            else r = executarInstr(&q, i, args, profundidade, passos, &proximo, resultado);
+        }
+        if (r == SEGUE) r = DESISTE;    // bloco sem terminador
+        anterior = bloco;
+        bloco = proximo;
+    }
+
+    liberarQuadro(&q);
+    return r == VOLTA;
+}
+
+// ===================
+// Passe
+// ===================
+
+bool avaliarChamadas(FuncaoIr* f) {
+    bool mudou = false;
+
+    for (int b = 0; b < f->nBlocos; b++) {
+        InstrIr* i = f->blocos[b]->primeira;
+        while (i) {
+            InstrIr* prox = i->prox;
+            if (i->op != IR_CALL || !bytesDe(i->tipo) || i->nArgs > MAX_PARAM + 1 || !chamadaPura(i)) {
+                i = prox;
+                continue;
+            }
+
+            const FuncaoIr* chamada = funcaoChamada(i);
+            ValorIr args[MAX_PARAM + 1];
+            bool constantes = chamada != NULL;
+            for (int a = 0; a < i->nArgs && constantes; a++) {
+                constantes = i->args[a]->op == IR_CONST;
+                if (constantes) args[a] = i->args[a]->imm;
+            }
+
+            ValorIr valor;
+            long passos = 0;
+            if (constantes && executar(chamada, args, 0, &passos, &valor)) {
+                InstrIr* c = novaInstrIr(f, IR_CONST, i->tipo);
+                c->imm = valor;
+                c->linha = i->linha;
+                inserirAntesIr(i, c);
+                substituirUsosIr(i, c);
+                removerInstrIr(i);
+                mudou = true;
+            }
+            i = prox;
+        }
+    }
+    return mudou;
+}
@@ -0,0 +1,165 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "otimizacao.h"
+
+// ==============================================
+// CHAMADAS DE CAUDA
+// ==============================================
+//
+// Uma chamada está em posição de cauda quando o ret logo depois devolve o
+// seu valor ('return f(...)') ou, numa função void, quando ela é a última
+// coisa antes do fim, inclusive no fim de um if ('if (n > 0) f(n - 1);':
+// o salto para um bloco que só tem o ret dá lugar a uma cópia do ret).
+// Nesse ponto o quadro de quem chama não serve mais:
+//
+// - recursão direta vira laço: o bloco de entrada passa a ter só os
+//   parâmetros e salta para um cabeçalho com um phi por parâmetro, e cada
+//   chamada de cauda salta para ele com os novos argumentos;
+// - chamadas a outras funções do programa são marcadas e a geração de
+//   código troca 'call' + 'ret' por 'leave' + 'jmp' quando os argumentos
+//   cabem em registradores.
+//
+// Endereços de slots do próprio quadro não podem ser argumentos: o quadro
+// é reaproveitado pela próxima volta ou desfeito antes do salto.
+
+// Ret que devolve o valor da chamada (ou ret void depois de qualquer chamada)
+static bool emCauda(const FuncaoIr* f, const InstrIr* call) {
+    const InstrIr* ret = call->prox;
+    if (!ret || ret->op != IR_RET) return false;
+    if (ret->nArgs == 0) return f->retorno == IR_VOID;
+    return ret->args[0] == call && call->nUsos == 1;
+}
+
+// O endereço pode apontar para o quadro desta função?
+static bool apontaParaQuadro(const InstrIr* v) {
+    while (v->op == IR_ELEM) v = v->args[0];
+    return v->op != IR_PARAM && v->op != IR_GLOBAL && v->op != IR_CONST_STR && v->op != IR_FUNCAO;
+}
+
+static bool argumentosSeguros(const InstrIr* call) {
+    for (int a = 0; a < call->nArgs; a++) {
+        if (call->args[a]->tipo == IR_PTR && apontaParaQuadro(call->args[a])) return false;
+    }
+    return true;
+}
+
+// ===================
+// Recursão direta
+// ===================
+
+// Separa os parâmetros do resto da entrada; devolve o cabeçalho com um phi por parâmetro
+static BlocoIr* criarCabecalho(FuncaoIr* f, InstrIr** phis) {
+    BlocoIr* entrada = f->blocos[0];
+    InstrIr* params[MAX_PARAM + 1] = { NULL };
+
+    for (InstrIr* i = entrada->primeira; i; i = i->prox) {
+        if (i->op == IR_PARAM) params[i->indice] = i;
+    }
+    for (int p = f->nParams - 1; p >= 0; p--) {
+        if (params[p] && params[p] != entrada->primeira) moverInstrIr(params[p], entrada->primeira);
+    }
+
+    InstrIr* pos = entrada->primeira;
+    while (pos->op == IR_PARAM) pos = pos->prox;
+    BlocoIr* cabecalho = dividirBlocoIr(f, pos);
+
+    InstrIr* jmp = novaInstrIr(f, IR_JMP, IR_VOID);
+    jmp->alvos[0] = cabecalho;
+    jmp->linha = pos->linha;
+    anexarInstrIr(entrada, jmp);
+    adicionarPredIr(cabecalho, entrada);
+
+    for (int p = 0; p < f->nParams; p++) {
+        phis[p] = NULL;
+        if (!params[p]) continue;
+        phis[p] = novaInstrIr(f, IR_PHI, params[p]->tipo);
+        phis[p]->linha = params[p]->linha;
+        inserirAntesIr(cabecalho->primeira, phis[p]);
+        substituirUsosIr(params[p], phis[p]);
+        adicionarArgIr(phis[p], params[p]);
+    }
+    return cabecalho;
+}
+
+static bool eliminarRecursao(FuncaoIr* f) {
+    InstrIr* phis[MAX_PARAM + 1];
+    BlocoIr* cabecalho = NULL;
+    bool mudou = false;
+
+    // Um laço de volta para a entrada deixaria os parâmetros fora de qualquer cabeçalho
+    if (f->blocos[0]->nPreds > 0) return false;
+
+    int nb = f->nBlocos;
+    for (int b = 0; b < nb; b++) {
+        BlocoIr* bloco = f->blocos[b];
+        InstrIr* ret = terminadorIr(bloco);
+        InstrIr* call = ret && ret->op == IR_RET ? ret->ant : NULL;
+        if (!call || call->op != IR_CALL || call->simbolo != f->simbolo) continue;
+        if (!emCauda(f, call) || !argumentosSeguros(call)) continue;
+
+        if (!cabecalho) cabecalho = criarCabecalho(f, phis);
+
+        // A entrada pode ter sido dividida: a chamada está agora no cabeçalho
+        bloco = call->bloco;
+        int linha = call->linha;
+        for (int p = 0; p < f->nParams; p++) {
+            if (phis[p]) adicionarArgIr(phis[p], call->args[p]);
+        }
+        removerInstrIr(ret);
+        removerInstrIr(call);
+
+        InstrIr* jmp = novaInstrIr(f, IR_JMP, IR_VOID);
+        jmp->alvos[0] = cabecalho;
+        jmp->linha = linha;
+        anexarInstrIr(bloco, jmp);
+        adicionarPredIr(cabecalho, bloco);
+        mudou = true;
+    }
+    return mudou;
+}
+
+// ===================
+// Passe
+// ===================
+
+// 'call; jmp bN' com bN só 'ret' numa função void: o bloco da chamada
+// termina com o seu próprio ret, que o resto do passe já reconhece
+static bool trazerRets(FuncaoIr* f) {
+    bool mudou = false;
+    for (int b = 0; b < f->nBlocos; b++) {
+        BlocoIr* bloco = f->blocos[b];
+        InstrIr* jmp = terminadorIr(bloco);
+        InstrIr* call = jmp && jmp->op == IR_JMP ? jmp->ant : NULL;
+        if (!call || call->op != IR_CALL || call->simbolo < 0 || !argumentosSeguros(call)) continue;
+
+        BlocoIr* destino = jmp->alvos[0];
+        InstrIr* ret = destino->primeira;
+        if (ret->op != IR_RET || ret->nArgs > 0) continue;
+
+        InstrIr* novo = novaInstrIr(f, IR_RET, IR_VOID);
+        novo->linha = ret->linha;
+        removerPredIr(destino, indicePredIr(destino, bloco));
+        removerInstrIr(jmp);
+        anexarInstrIr(bloco, novo);
+        mudou = true;
+    }
+    if (mudou) removerBlocosInalcancaveisIr(f);
+    return mudou;
+}
+
+bool otimizarChamadasCauda(FuncaoIr* f) {
+    bool mudou = trazerRets(f);
+    mudou |= eliminarRecursao(f);
+
+    // O que sobrou em posição de cauda são chamadas a outras funções do programa
+    for (int b = 0; b < f->nBlocos; b++) {
+        InstrIr* ret = terminadorIr(f->blocos[b]);
+        InstrIr* call = ret && ret->op == IR_RET ? ret->ant : NULL;
+        if (!call || call->op != IR_CALL || call->simbolo < 0 || call->cauda) continue;
+        if (!emCauda(f, call) || !argumentosSeguros(call)) continue;
+        call->cauda = true;
+        mudou = true;
+    }
+    return mudou;
+}
@@ -0,0 +1,328 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "otimizacao.h"
+
+// ==============================================
+// GRAFO DE CHAMADAS
+// ==============================================
+//
+// Arestas entre funções do programa (chamadas ao runtime não entram).
+// Os componentes fortemente conexos saem do algoritmo de Tarjan já na
+// ordem em que uma função aparece depois de todas as que ela chama, a não
+// ser quando estão no mesmo ciclo.
+//
+// O nível de um componente diz quando ele pode ser otimizado: os de nível
+// 0 não chamam ninguém de fora, e todos os de um nível só chamam
+// componentes de níveis menores, então podem ser tratados em paralelo.
+//
+// Efeitos: o que a função lê e grava fora do próprio quadro, se chama o
+// runtime e se pode não voltar. Saem das instruções e das chamadas, de
+// baixo para cima; o que a função chamada faz por um parâmetro vale para o
+// argumento (gravar num vetor local de quem chama não é efeito de quem
+// chama). Num ciclo, todas ficam com a união do ciclo.
+
+int funcaoDeSimbolo(const ProgramaIr* p, int simbolo) {
+    for (int k = 0; k < p->nFuncoes; k++) {
+        if (p->funcoes[k]->simbolo == simbolo) return k;
+    }
+    return -1;
+}
+
+// Estado do algoritmo de Tarjan
+typedef struct {
+    GrafoChamadas* g;
+    int* indice;        // ordem de descoberta (-1 = não visitada)
+    int* menor;         // menor índice alcançável
+    bool* naPilha;
+    int* pilha;
+    int topo;
+    int contador;
+    int nOrdem;
+} Tarjan;
+
+static void visitar(Tarjan* t, int v) {
+    GrafoChamadas* g = t->g;
+
+    t->indice[v] = t->menor[v] = t->contador++;
+    t->pilha[t->topo++] = v;
+    t->naPilha[v] = true;
+
+    for (int k = 0; k < g->nChamados[v]; k++) {
+        int w = g->chamados[v][k];
+        if (t->indice[w] < 0) {
+            visitar(t, w);
+            if (t->menor[w] < t->menor[v]) t->menor[v] = t->menor[w];
+        } else if (t->naPilha[w] && t->indice[w] < t->menor[v]) {
+            t->menor[v] = t->indice[w];
+        }
+    }
+
+    if (t->menor[v] != t->indice[v]) return;
+
+    // v é a raiz de um componente: desempilha até ela
+    int inicio = t->nOrdem;
+    int w;
+    do {
+        w = t->pilha[--t->topo];
+        t->naPilha[w] = false;
+        g->componente[w] = v;
+        g->ordem[t->nOrdem++] = w;
+    } while (w != v);
+
+    bool ciclo = t->nOrdem - inicio > 1;
+    for (int k = 0; k < g->nChamados[v] && !ciclo; k++) {
+        if (g->chamados[v][k] == v) ciclo = true;
+    }
+    for (int k = inicio; k < t->nOrdem; k++) g->recursiva[g->ordem[k]] = ciclo;
+}
+
+// ===================
+// Efeitos
+// ===================
+
+// Efeito de acessar o endereço: 'global' ou 'referencia' conforme a origem
+static int efeitoDeEndereco(const InstrIr* end, int global, int referencia) {
+    while (end->op == IR_ELEM) end = end->args[0];
+    if (end->op == IR_LOCAL || end->op == IR_CONST_STR) return 0;
+    if (end->op == IR_GLOBAL) return global;
+    if (end->op == IR_PARAM) return referencia;
+    return global | referencia;
+}
+
+// Funções do runtime que só acessam os vetores recebidos: o que cada uma faz
+// com a memória do argumento 'a' (-1 nas outras chamadas)
+static int efeitosDoRuntime(const InstrIr* call, int a) {
+    if (call->simbolo >= 0) return -1;
+    if (strcmp(call->runtime, "csrt_bits_preencher") == 0) return a == 0 ? EFEITO_GRAVA_REFERENCIAS : 0;
+    if (strcmp(call->runtime, "csrt_bits_contar") == 0) return a == 0 ? EFEITO_LE_REFERENCIAS : 0;
+    if (strcmp(call->runtime, "csrt_mem_preencher") == 0) return a == 0 ? EFEITO_GRAVA_REFERENCIAS : 0;
+    if (strcmp(call->runtime, "csrt_mem_copiar") == 0) {
+        return a == 0 ? EFEITO_GRAVA_REFERENCIAS : a == 1 ? EFEITO_LE_REFERENCIAS : 0;
+    }
+    return -1;
+}
+
+bool chamadaExecutaFuncao(const InstrIr* call) {
+    for (int a = 0; a < call->nArgs && call->simbolo < 0; a++) {
+        if (call->args[a]->op == IR_FUNCAO) return true;
+    }
+    return false;
+}
+
+// O que ler ou gravar pelo argumento 'end' (efeitos em 'e') faz para quem chama
+static int efeitosDoArgumento(const InstrIr* end, int e) {
+    int r = 0;
+    if (e & EFEITO_LE_REFERENCIAS) r |= efeitoDeEndereco(end, EFEITO_LE_GLOBAIS, EFEITO_LE_REFERENCIAS);
+    if (e & EFEITO_GRAVA_REFERENCIAS) r |= efeitoDeEndereco(end, EFEITO_GRAVA_GLOBAIS, EFEITO_GRAVA_REFERENCIAS);
+    return r;
+}
+
+static int efeitosDaChamada(const ProgramaIr* p, const GrafoChamadas* g, const InstrIr* call) {
+    if (efeitosDoRuntime(call, 0) >= 0) {
+        int r = 0;
+        for (int a = 0; a < call->nArgs; a++) r |= efeitosDoArgumento(call->args[a], efeitosDoRuntime(call, a));
+        return r;
+    }
+
+    int alvo = call->simbolo >= 0 ? funcaoDeSimbolo(p, call->simbolo) : -1;
+    if (alvo < 0) return EFEITO_EXTERNO;
+
+    int e = g->efeitos[alvo];
+    int r = e & ~(EFEITO_LE_REFERENCIAS | EFEITO_GRAVA_REFERENCIAS);
+    for (int a = 0; a < call->nArgs; a++) {
+        if (call->args[a]->tipo == IR_PTR) r |= efeitosDoArgumento(call->args[a], e);
+    }
+    return r;
+}
+
+static int efeitosDaFuncao(const ProgramaIr* p, const GrafoChamadas* g, FuncaoIr* f) {
+    int e = 0;
+    calcularDominadoresIr(f);
+
+    for (int b = 0; b < f->nBlocos; b++) {
+        BlocoIr* bloco = f->blocos[b];
+        if (bloco->rpo < 0) continue;
+
+        // Aresta para trás: a função tem um laço
+        BlocoIr* succ[2];
+        int ns = sucessoresIr(bloco, succ);
+        for (int s = 0; s < ns; s++) {
+            if (succ[s]->rpo <= bloco->rpo) e |= EFEITO_PODE_NAO_VOLTAR;
+        }
+
+        for (InstrIr* i = bloco->primeira; i; i = i->prox) {
+            switch (i->op) {
+                case IR_LOAD:
+                    e |= efeitoDeEndereco(i->args[0], EFEITO_LE_GLOBAIS, EFEITO_LE_REFERENCIAS);
+                    break;
+                case IR_COPIAR:
+                    e |= efeitoDeEndereco(i->args[1], EFEITO_LE_GLOBAIS, EFEITO_LE_REFERENCIAS);
+                    // fallthrough
+                case IR_STORE:
+                case IR_ZERAR:
+                    e |= efeitoDeEndereco(i->args[0], EFEITO_GRAVA_GLOBAIS, EFEITO_GRAVA_REFERENCIAS);
+                    break;
+                case IR_LIMITE:
+                    e |= EFEITO_PODE_NAO_VOLTAR;
+                    break;
+                case IR_DIV:
+                    if (temEfeitoIr(i) && !(i->args[1]->op == IR_CONST && i->args[1]->imm.i != 0 && i->args[1]->imm.i != -1)) {
+                        e |= EFEITO_PODE_NAO_VOLTAR;
+                    }
+                    break;
+                case IR_CALL:
+                    e |= efeitosDaChamada(p, g, i);
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+    return e;
+}
+
+// Todas as funções do componente ficam com a união dos efeitos (repetida até estabilizar)
+static void calcularEfeitosComponente(const ProgramaIr* p, GrafoChamadas* g, int raiz) {
+    int uniao = g->recursiva[raiz] ? EFEITO_PODE_NAO_VOLTAR : 0;
+    bool mudou = true;
+
+    while (mudou) {
+        for (int k = 0; k < g->nFuncoes; k++) {
+            if (g->componente[k] == raiz) g->efeitos[k] = uniao;
+        }
+        int nova = uniao;
+        for (int k = 0; k < g->nFuncoes; k++) {
+            if (g->componente[k] == raiz) nova |= efeitosDaFuncao(p, g, p->funcoes[k]);
+        }
+        mudou = nova != uniao;
+        uniao = nova;
+    }
+}
+
+GrafoChamadas* construirGrafoChamadas(const ProgramaIr* p) {
+    int n = p->nFuncoes;
+    GrafoChamadas* g = calloc(1, sizeof(GrafoChamadas));
+    g->nFuncoes = n;
+    g->chamados = calloc(n, sizeof(int*));
+    g->nChamados = calloc(n, sizeof(int));
+    g->nChamadas = calloc(n, sizeof(int));
+    g->componente = calloc(n, sizeof(int));
+    g->recursiva = calloc(n, sizeof(bool));
+    g->ordem = calloc(n, sizeof(int));
+    g->nivel = calloc(n, sizeof(int));
+    g->efeitos = calloc(n, sizeof(int));
+
+    for (int k = 0; k < n; k++) {
+        FuncaoIr* f = p->funcoes[k];
+        int cap = 0;
+
+        for (int b = 0; b < f->nBlocos; b++) {
+            for (InstrIr* i = f->blocos[b]->primeira; i; i = i->prox) {
+                if (i->op != IR_CALL || i->simbolo < 0) continue;
+                int alvo = funcaoDeSimbolo(p, i->simbolo);
+                if (alvo < 0) continue;
+                g->nChamadas[alvo]++;
+
+                bool repetida = false;
+                for (int c = 0; c < g->nChamados[k] && !repetida; c++) repetida = g->chamados[k][c] == alvo;
+                if (repetida) continue;
+
+                if (g->nChamados[k] == cap) {
+                    cap = cap ? cap * 2 : 4;
+                    g->chamados[k] = realloc(g->chamados[k], cap * sizeof(int));
+                }
+                g->chamados[k][g->nChamados[k]++] = alvo;
+            }
+        }
+    }
+
+    Tarjan t = { 0 };
+    t.g = g;
+    t.indice = malloc((n > 0 ? n : 1) * sizeof(int));
+    t.menor = malloc((n > 0 ? n : 1) * sizeof(int));
+    t.naPilha = calloc(n > 0 ? n : 1, sizeof(bool));
+    t.pilha = malloc((n > 0 ? n : 1) * sizeof(int));
+    for (int k = 0; k < n; k++) t.indice[k] = -1;
+
+    for (int k = 0; k < n; k++) {
+        if (t.indice[k] < 0) visitar(&t, k);
+    }
+
+    free(t.indice);
+    free(t.menor);
+    free(t.naPilha);
+    free(t.pilha);
+
+    // Na ordem de Tarjan os componentes chamados já estão prontos
+    for (int k = 0; k < n; k++) {
+        int v = g->ordem[k];
+        int raiz = g->componente[v];
+        for (int c = 0; c < g->nChamados[v]; c++) {
+            int outro = g->componente[g->chamados[v][c]];
+            if (outro != raiz && g->nivel[outro] + 1 > g->nivel[raiz]) g->nivel[raiz] = g->nivel[outro] + 1;
+        }
+        if (k + 1 == n || g->componente[g->ordem[k + 1]] != raiz) calcularEfeitosComponente(p, g, raiz);
+    }
+    return g;
+}
+
+void liberarGrafoChamadas(GrafoChamadas* g) {
+    for (int k = 0; k < g->nFuncoes; k++) free(g->chamados[k]);
+    free(g->chamados);
+    free(g->nChamados);
+    free(g->nChamadas);
+    free(g->componente);
+    free(g->recursiva);
+    free(g->ordem);
+    free(g->nivel);
+    free(g->efeitos);
+    free(g);
+}
+
+void atualizarEfeitos(const ProgramaIr* p, GrafoChamadas* g, int funcao) {
+    calcularEfeitosComponente(p, g, g->componente[funcao]);
+}
+
+// ===================
+// Consultas
+// ===================
+
+static const ProgramaIr* programaAtual = NULL;
+static const GrafoChamadas* grafoAtual = NULL;
+
+void definirGrafoChamadas(const ProgramaIr* p, const GrafoChamadas* g) {
+    programaAtual = p;
+    grafoAtual = g;
+}
+
+FuncaoIr* funcaoChamada(const InstrIr* call) {
+    int alvo = grafoAtual && call->simbolo >= 0 ? funcaoDeSimbolo(programaAtual, call->simbolo) : -1;
+    return alvo >= 0 ? programaAtual->funcoes[alvo] : NULL;
+}
+
+int efeitosDeChamada(const InstrIr* call) {
+    if (efeitosDoRuntime(call, 0) >= 0) {
+        int e = 0;
+        for (int a = 0; a < call->nArgs; a++) e |= efeitosDoRuntime(call, a);
+        return e;
+    }
+
+    int alvo = grafoAtual && call->simbolo >= 0 ? funcaoDeSimbolo(programaAtual, call->simbolo) : -1;
+    if (alvo < 0 || alvo >= grafoAtual->nFuncoes) {
+        return EFEITO_LE_GLOBAIS | EFEITO_GRAVA_GLOBAIS | EFEITO_LE_REFERENCIAS | EFEITO_GRAVA_REFERENCIAS
+               | EFEITO_EXTERNO | EFEITO_PODE_NAO_VOLTAR;
+    }
+    return grafoAtual->efeitos[alvo];
+}
+
+// Sem ler nem gravar memória: a mesma chamada com os mesmos argumentos dá o mesmo valor
+bool chamadaPura(const InstrIr* call) {
+    return (efeitosDeChamada(call) & ~EFEITO_PODE_NAO_VOLTAR) == 0;
+}
+
+// Sem gravar nada e sempre voltando: se ninguém usa o valor, a chamada não faz falta
+bool chamadaRemovivel(const InstrIr* call) {
+    return (efeitosDeChamada(call) & ~(EFEITO_LE_GLOBAIS | EFEITO_LE_REFERENCIAS)) == 0;
+}
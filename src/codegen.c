@@ -0,0 +1,1318 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stdint.h>
+
+#include "codegen.h"
+#include "symbols.h"
+#include "constantes.h"
+
+// ==============================================
+// LAYOUT DO QUADRO DE PILHA
+// ==============================================
+//
+//   16(%rbp) ...           argumentos passados na pilha
+//   -16(%rbp) ...          slots da IR (variáveis em memória, temporários string)
+//   abaixo dos slots       um valor SSA por bloco de 8 bytes (16 para vetores), e a entrada de cada phi
+//   0(%rsp) ...            área de saída dos argumentos das chamadas
+//
+// O código é gerado a partir da IR (veja ir.h). Cada instrução lê seus
+// operandos dos blocos de 8 bytes e grava ali o resultado; constantes e
+// endereços (slots, globais, pool de strings) viram operandos imediatos.
+// Um phi tem dois blocos: o predecessor grava na "entrada" antes de
+// desviar e o bloco copia a entrada para o valor ao começar, então todos
+// os phi de um bloco mudam ao mesmo tempo.
+//
+// %rsp fica fixo no corpo da função (alinhado em 16), então toda chamada
+// já está alinhada. Só registradores voláteis nas duas convenções são
+// usados (rax, rcx, rdx, r8-r11, xmm0-xmm5, mais rdi/rsi na SysV).
+
+#ifdef _WIN32
+static AbiAlvo abiAlvo = ABI_WIN64;
+#else
+static AbiAlvo abiAlvo = ABI_SYSV;
+#endif
+
+// Texto do corpo da função atual (o prólogo depende do tamanho final do quadro)
+typedef struct {
+    char* dados;
+    size_t tam;
+    size_t cap;
+} Buffer;
+
+static Buffer corpo;
+
+// Estado da função em geração
+static int* offsetValor = NULL;     // deslocamento (%rbp) do valor de cada instrução
+static int* offsetEntrada = NULL;   // deslocamento (%rbp) da entrada de cada phi
+static int* offsetSlot = NULL;      // deslocamento (%rbp) de cada slot da IR
+static int maxSaida = 0;            // maior área de argumentos de saída
+static int contRotulos = 0;
+static int contLimites = 0;         // rótulos .LlimN das verificações de índice
+static int contMemoria = 0;         // rótulos .LmemN dos laços de cópia e zeramento
+static int contCadeias = 0;         // rótulos .LswN das cadeias de comparações
+static int baseRotulos = 0;         // rótulo do bloco b: .L(baseRotulos + b)
+
+typedef enum { RAX, RCX, RDX, RDI, RSI, R8, R9, R10, R11 } Reg;
+
+static const char* regs64[] = { "%rax", "%rcx", "%rdx", "%rdi", "%rsi", "%r8", "%r9", "%r10", "%r11" };
+static const char* regs32[] = { "%eax", "%ecx", "%edx", "%edi", "%esi", "%r8d", "%r9d", "%r10d", "%r11d" };
+
+static const Reg regsIntSysV[6] = { RDI, RSI, RDX, RCX, R8, R9 };
+static const Reg regsIntWin64[4] = { RCX, RDX, R8, R9 };
+
+// ===================
+// Configuração
+// ===================
+
+void definirAbiAlvo(AbiAlvo abi) {
+    abiAlvo = abi;
+}
+
+bool abiDeNome(const char* nome, AbiAlvo* abi) {
+    if (strcmp(nome, "sysv") == 0) {
+        *abi = ABI_SYSV;
+    } else if (strcmp(nome, "win64") == 0) {
+        *abi = ABI_WIN64;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// ===================
+// Emissão
+// ===================
+
+// Acrescenta uma linha formatada ao corpo da função
+static void emitir(const char* formato, ...) {
+    va_list args;
+    va_start(args, formato);
+    va_list copia;
+    va_copy(copia, args);
+    int n = vsnprintf(NULL, 0, formato, copia);
+    va_end(copia);
+
+    if (corpo.tam + n + 2 > corpo.cap) {
+        size_t novaCap = corpo.cap ? corpo.cap * 2 : 4096;
+        while (novaCap < corpo.tam + n + 2) novaCap *= 2;
+        corpo.dados = realloc(corpo.dados, novaCap);
+        corpo.cap = novaCap;
+    }
+
+    vsnprintf(corpo.dados + corpo.tam, n + 1, formato, args);
+    corpo.tam += n;
+    corpo.dados[corpo.tam++] = '\n';
+    corpo.dados[corpo.tam] = '\0';
+
+    va_end(args);
+}
+
+static Simbolo* simbolo(int idx) {
+    return &getTabela()[idx];
+}
+
+static int tamanhoElemento(TipoId t) {
+    switch (tipoElemento(t)) {
+        case TIPO_CHAR:
+        case TIPO_BOOL:
+            return 1;
+        default:
+            return 4;
+    }
+}
+
+static int rotuloBloco(const BlocoIr* b) {
+    return baseRotulos + b->id;
+}
+
+// ===================
+// Operandos
+// ===================
+
+// Constantes e endereços não ocupam bloco: são refeitos em cada uso
+static bool ehImediato(const InstrIr* v) {
+    switch (v->op) {
+        case IR_CONST:
+        case IR_LOCAL:
+        case IR_GLOBAL:
+        case IR_CONST_STR:
+        case IR_FUNCAO:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Carrega um valor inteiro ou endereço no registrador
+static void carregar(const InstrIr* v, Reg r) {
+    switch (v->op) {
+        case IR_CONST:
+            emitir("    movl $%d, %s", v->imm.i, regs32[r]);
+            break;
+        case IR_LOCAL:
+            emitir("    leaq %d(%%rbp), %s", offsetSlot[v->indice], regs64[r]);
+            break;
+        case IR_GLOBAL:
+            emitir("    leaq cs_%s(%%rip), %s", simbolo(v->simbolo)->nome, regs64[r]);
+            break;
+        case IR_CONST_STR:
+            emitir("    leaq .LCS%d(%%rip), %s", v->indice, regs64[r]);
+            break;
+        case IR_FUNCAO:
+            emitir("    leaq cs_%s(%%rip), %s", simbolo(v->simbolo)->nome, regs64[r]);
+            break;
+        default:
+            if (v->tipo == IR_PTR) emitir("    movq %d(%%rbp), %s", offsetValor[v->id], regs64[r]);
+            else emitir("    movl %d(%%rbp), %s", offsetValor[v->id], regs32[r]);
+            break;
+    }
+}
+
+// Carrega um valor float em %xmm<n>
+static void carregarFloat(const InstrIr* v, int xmm) {
+    if (v->op == IR_CONST) {
+        // O padrão de bits vai por um registrador inteiro (sem tabela de constantes)
+        uint32_t bits;
+        memcpy(&bits, &v->imm.f, sizeof(bits));
+        emitir("    movl $0x%08x, %%r11d", bits);
+        emitir("    movd %%r11d, %%xmm%d", xmm);
+    } else {
+        emitir("    movss %d(%%rbp), %%xmm%d", offsetValor[v->id], xmm);
+    }
+}
+
+// Carrega um vetor (bloco de 16 bytes alinhado) em %xmm<n>
+static void carregarVetor(const InstrIr* v, int xmm) {
+    emitir("    movdqa %d(%%rbp), %%xmm%d", offsetValor[v->id], xmm);
+}
+
+// Grava o resultado da instrução (%eax/%rax ou %xmm0) no seu bloco
+static void guardar(const InstrIr* i) {
+    switch (i->tipo) {
+        case IR_VOID: break;
+        case IR_F32:  emitir("    movss %%xmm0, %d(%%rbp)", offsetValor[i->id]); break;
+        case IR_PTR:  emitir("    movq %%rax, %d(%%rbp)", offsetValor[i->id]); break;
+        case IR_V16I8:
+        case IR_V4I32:
+        case IR_V4F32:
+            emitir("    movdqa %%xmm0, %d(%%rbp)", offsetValor[i->id]);
+            break;
+        default:      emitir("    movl %%eax, %d(%%rbp)", offsetValor[i->id]); break;
+    }
+}
+
+// ===================
+// Instruções
+// ===================
+
+static void gerarAritmetica(const InstrIr* i) {
+    if (i->tipo == IR_F32) {
+        const char* instr = i->op == IR_ADD ? "addss" :
+                            i->op == IR_SUB ? "subss" :
+                            i->op == IR_MUL ? "mulss" : "divss";
+        carregarFloat(i->args[0], 0);
+        carregarFloat(i->args[1], 1);
+        emitir("    %s %%xmm1, %%xmm0", instr);
+        return;
+    }
+
+    carregar(i->args[0], RAX);
+    carregar(i->args[1], RCX);
+    switch (i->op) {
+        case IR_ADD: emitir("    addl %%ecx, %%eax"); break;
+        case IR_SUB: emitir("    subl %%ecx, %%eax"); break;
+        case IR_MUL: emitir("    imull %%ecx, %%eax"); break;
+        default:
+            emitir("    cltd");
+            emitir("    idivl %%ecx");
+            break;
+    }
+
+    // char op char continua char (trunca para 8 bits com sinal)
+    if (i->tipo == IR_I8) emitir("    movsbl %%al, %%eax");
+}
+
+// Comparação; resultado i1 em %eax
+static void gerarComparacao(const InstrIr* i) {
+    if (i->args[0]->tipo == IR_F32) {
+        // esquerda em %xmm0, direita em %xmm1; < e <= invertem os operandos
+        // para que comparações com NaN resultem falsas
+        carregarFloat(i->args[0], 0);
+        carregarFloat(i->args[1], 1);
+        switch (i->cond) {
+            case COND_EQ:
+                emitir("    ucomiss %%xmm1, %%xmm0");
+                emitir("    sete %%al");
+                emitir("    setnp %%cl");
+                emitir("    andb %%cl, %%al");
+                break;
+            case COND_NE:
+                emitir("    ucomiss %%xmm1, %%xmm0");
+                emitir("    setne %%al");
+                emitir("    setp %%cl");
+                emitir("    orb %%cl, %%al");
+                break;
+            case COND_GT: emitir("    ucomiss %%xmm1, %%xmm0"); emitir("    seta %%al"); break;
+            case COND_GE: emitir("    ucomiss %%xmm1, %%xmm0"); emitir("    setae %%al"); break;
+            case COND_LT: emitir("    ucomiss %%xmm0, %%xmm1"); emitir("    seta %%al"); break;
+            default:      emitir("    ucomiss %%xmm0, %%xmm1"); emitir("    setae %%al"); break;
+        }
+    } else if (i->args[0]->tipo == IR_PTR) {
+        // Endereços comparam sem sinal
+        const char* set = i->cond == COND_EQ ? "sete"  :
+                          i->cond == COND_NE ? "setne" :
+                          i->cond == COND_LT ? "setb"  :
+                          i->cond == COND_GT ? "seta"  :
+                          i->cond == COND_LE ? "setbe" : "setae";
+        carregar(i->args[0], RAX);
+        carregar(i->args[1], RCX);
+        emitir("    cmpq %%rcx, %%rax");
+        emitir("    %s %%al", set);
+    } else {
+        const char* set = i->cond == COND_EQ ? "sete"  :
+                          i->cond == COND_NE ? "setne" :
+                          i->cond == COND_LT ? "setl"  :
+                          i->cond == COND_GT ? "setg"  :
+                          i->cond == COND_LE ? "setle" : "setge";
+        carregar(i->args[0], RAX);
+        carregar(i->args[1], RCX);
+        emitir("    cmpl %%ecx, %%eax");
+        emitir("    %s %%al", set);
+    }
+    emitir("    movzbl %%al, %%eax");
+}
+
+static void gerarConversao(const InstrIr* i) {
+    const InstrIr* v = i->args[0];
+
+    if (v->tipo == IR_F32) carregarFloat(v, 0);
+    else carregar(v, RAX);
+
+    switch (i->tipo) {
+        case IR_F32:
+            // i1/i8/i32 → float
+            emitir("    cvtsi2ssl %%eax, %%xmm0");
+            break;
+
+        case IR_I32:
+            if (v->tipo == IR_F32) emitir("    cvttss2si %%xmm0, %%eax");
+            break;
+
+        case IR_I8:
+            if (v->tipo == IR_F32) emitir("    cvttss2si %%xmm0, %%eax");
+            if (v->tipo != IR_I1) emitir("    movsbl %%al, %%eax");
+            break;
+
+        case IR_I1:
+            if (v->tipo == IR_F32) {
+                // NaN também é verdadeiro (diferente de zero)
+                emitir("    xorps %%xmm1, %%xmm1");
+                emitir("    ucomiss %%xmm1, %%xmm0");
+                emitir("    setne %%al");
+                emitir("    setp %%cl");
+                emitir("    orb %%cl, %%al");
+            } else {
+                emitir("    testl %%eax, %%eax");
+                emitir("    setne %%al");
+            }
+            emitir("    movzbl %%al, %%eax");
+            break;
+
+        default:
+            break;
+    }
+}
+
+// ===================
+// Bits de vetores bool
+// ===================
+//
+// Um elemento de vetor bool (elem de escala 0) vale base * 8 + índice: o
+// endereço do bit, que cabe em 64 bits porque os endereços do processo
+// ficam abaixo de 2^47. Ler ou gravar separa o byte (%rax) e a posição do
+// bit nele (%ecx); as palavras de 64 bits do vetor são little-endian,
+// então o bit i fica no byte i / 8.
+
+static bool ehBit(const InstrIr* endereco) {
+    return endereco->op == IR_ELEM && endereco->escala == 0;
+}
+
+static void gerarElementoBit(const InstrIr* i) {
+    carregar(i->args[0], RAX);
+    carregar(i->args[1], RCX);
+    emitir("    movslq %%ecx, %%rcx");
+    emitir("    shlq $3, %%rax");
+    emitir("    addq %%rcx, %%rax");
+}
+
+static void separarBit(const InstrIr* endereco) {
+    carregar(endereco, RAX);
+    emitir("    movl %%eax, %%ecx");
+    emitir("    shrq $3, %%rax");
+    emitir("    andl $7, %%ecx");
+}
+
+static void gerarLoadBit(const InstrIr* i) {
+    separarBit(i->args[0]);
+    emitir("    movzbl (%%rax), %%eax");
+    emitir("    shrl %%cl, %%eax");
+    emitir("    andl $1, %%eax");
+}
+
+static void gerarStoreBit(const InstrIr* i) {
+    const InstrIr* v = i->args[1];
+
+    separarBit(i->args[0]);
+    emitir("    movl $1, %%r11d");
+    emitir("    shll %%cl, %%r11d");
+    if (v->op == IR_CONST) {
+        if (v->imm.i) {
+            emitir("    orb %%r11b, (%%rax)");
+        } else {
+            emitir("    notl %%r11d");
+            emitir("    andb %%r11b, (%%rax)");
+        }
+        return;
+    }
+
+    // Sem desvio: limpa o bit e põe de volta (máscara & -valor)
+    carregar(v, R10);
+    emitir("    negl %%r10d");
+    emitir("    andl %%r11d, %%r10d");
+    emitir("    notl %%r11d");
+    emitir("    andb %%r11b, (%%rax)");
+    emitir("    orb %%r10b, (%%rax)");
+}
+
+static void gerarLoad(const InstrIr* i) {
+    if (ehBit(i->args[0])) {
+        gerarLoadBit(i);
+        return;
+    }
+
+    carregar(i->args[0], RAX);
+    switch (i->tipo) {
+        case IR_F32: emitir("    movss (%%rax), %%xmm0"); break;
+        case IR_I8:  emitir("    movsbl (%%rax), %%eax"); break;
+        case IR_I1:  emitir("    movzbl (%%rax), %%eax"); break;
+        case IR_PTR: emitir("    movq (%%rax), %%rax"); break;
+        default:     emitir("    movl (%%rax), %%eax"); break;
+    }
+}
+
+static void gerarStore(const InstrIr* i) {
+    const InstrIr* v = i->args[1];
+    if (ehBit(i->args[0])) {
+        gerarStoreBit(i);
+        return;
+    }
+
+    carregar(i->args[0], RAX);
+    switch (v->tipo) {
+        case IR_F32:
+            carregarFloat(v, 0);
+            emitir("    movss %%xmm0, (%%rax)");
+            break;
+        case IR_I8:
+        case IR_I1:
+            carregar(v, RCX);
+            emitir("    movb %%cl, (%%rax)");
+            break;
+        case IR_PTR:
+            carregar(v, RCX);
+            emitir("    movq %%rcx, (%%rax)");
+            break;
+        default:
+            carregar(v, RCX);
+            emitir("    movl %%ecx, (%%rax)");
+            break;
+    }
+}
+
+// Acima de BYTES_AVULSOS, um laço move 16 bytes por volta (%rax e %r11
+// avançam); devolve quantos bytes sobram para as instruções avulsas
+#define BYTES_AVULSOS 64
+
+static int gerarLacoMemoria(int tamanho, bool copia) {
+    if (tamanho <= BYTES_AVULSOS) return tamanho;
+
+    int rotulo = contMemoria++;
+    if (!copia) emitir("    pxor %%xmm0, %%xmm0");
+    emitir("    movl $%d, %%ecx", tamanho / 16);
+    emitir(".Lmem%d:", rotulo);
+    if (copia) {
+        emitir("    movdqu (%%r11), %%xmm0");
+        emitir("    addq $16, %%r11");
+    }
+    emitir("    movdqu %%xmm0, (%%rax)");
+    emitir("    addq $16, %%rax");
+    emitir("    decl %%ecx");
+    emitir("    jnz .Lmem%d", rotulo);
+    return tamanho % 16;
+}
+
+static void gerarZerar(const InstrIr* i) {
+    int k = 0;
+    carregar(i->args[0], RAX);
+    int resto = gerarLacoMemoria(i->tamanho, false);
+    for (; k + 8 <= resto; k += 8) emitir("    movq $0, %d(%%rax)", k);
+    for (; k < resto; k++) emitir("    movb $0, %d(%%rax)", k);
+}
+
+static void gerarCopia(const InstrIr* i) {
+    int k = 0;
+    carregar(i->args[0], RAX);
+    carregar(i->args[1], R11);
+    int resto = gerarLacoMemoria(i->tamanho, true);
+    for (; k + 8 <= resto; k += 8) {
+        emitir("    movq %d(%%r11), %%r10", k);
+        emitir("    movq %%r10, %d(%%rax)", k);
+    }
+    for (; k < resto; k++) {
+        emitir("    movb %d(%%r11), %%r10b", k);
+        emitir("    movb %%r10b, %d(%%rax)", k);
+    }
+}
+
+// ===================
+// Vetores (SSE2)
+// ===================
+
+// %xmm0 = a < b ? a : b (ou a > b ? a : b) por faixa, com a em %xmm0 e b em %xmm1
+static void escolherFaixas(TipoIr tipo, bool minimo) {
+    if (tipo == IR_V4F32) {
+        emitir("    %s %%xmm1, %%xmm0", minimo ? "minps" : "maxps");
+        return;
+    }
+
+    // Sem pminsd/pmaxsd no SSE2: máscara com pcmpgtd e mistura com and/andn/or
+    if (minimo) {
+        emitir("    movdqa %%xmm1, %%xmm2");
+        emitir("    pcmpgtd %%xmm0, %%xmm2");
+    } else {
+        emitir("    movdqa %%xmm0, %%xmm2");
+        emitir("    pcmpgtd %%xmm1, %%xmm2");
+    }
+    emitir("    pand %%xmm2, %%xmm0");
+    emitir("    pandn %%xmm1, %%xmm2");
+    emitir("    por %%xmm2, %%xmm0");
+}
+
+static void gerarAritmeticaVetorial(const InstrIr* i) {
+    carregarVetor(i->args[0], 0);
+    carregarVetor(i->args[1], 1);
+
+    if (i->tipo == IR_V4F32) {
+        const char* instr = i->op == IR_ADD ? "addps" :
+                            i->op == IR_SUB ? "subps" :
+                            i->op == IR_MUL ? "mulps" : "divps";
+        emitir("    %s %%xmm1, %%xmm0", instr);
+    } else if (i->tipo == IR_V16I8) {
+        emitir("    %s %%xmm1, %%xmm0", i->op == IR_ADD ? "paddb" : "psubb");
+    } else if (i->op != IR_MUL) {
+        emitir("    %s %%xmm1, %%xmm0", i->op == IR_ADD ? "paddd" : "psubd");
+    } else {
+        // Sem pmulld no SSE2: faixas pares e ímpares com pmuludq, depois intercaladas
+        emitir("    movdqa %%xmm0, %%xmm2");
+        emitir("    pmuludq %%xmm1, %%xmm0");
+        emitir("    psrlq $32, %%xmm2");
+        emitir("    psrlq $32, %%xmm1");
+        emitir("    pmuludq %%xmm1, %%xmm2");
+        emitir("    pshufd $0x08, %%xmm0, %%xmm0");
+        emitir("    pshufd $0x08, %%xmm2, %%xmm2");
+        emitir("    punpckldq %%xmm2, %%xmm0");
+    }
+}
+
+static void gerarReducao(const InstrIr* i) {
+    TipoIr tipo = i->args[0]->tipo;
+    carregarVetor(i->args[0], 0);
+
+    // Duas rodadas: faixas {2,3} com {0,1}, depois 1 com 0
+    for (int rodada = 0; rodada < 2; rodada++) {
+        emitir("    pshufd $%s, %%xmm0, %%xmm1", rodada == 0 ? "0x4e" : "0xb1");
+        if (i->indice == IR_ADD) emitir("    %s %%xmm1, %%xmm0", tipo == IR_V4F32 ? "addps" : "paddd");
+        else escolherFaixas(tipo, i->indice == IR_MIN);
+    }
+    if (tipo == IR_V4I32) emitir("    movd %%xmm0, %%eax");
+}
+
+static void gerarVetorial(const InstrIr* i) {
+    switch (i->op) {
+        case IR_ADD:
+        case IR_SUB:
+        case IR_MUL:
+        case IR_DIV:
+            gerarAritmeticaVetorial(i);
+            break;
+
+        case IR_NEG:
+            carregarVetor(i->args[0], 1);
+            if (i->tipo == IR_V4F32) {
+                // Inverte o bit de sinal de cada faixa
+                emitir("    pcmpeqd %%xmm0, %%xmm0");
+                emitir("    pslld $31, %%xmm0");
+                emitir("    xorps %%xmm1, %%xmm0");
+            } else {
+                emitir("    pxor %%xmm0, %%xmm0");
+                emitir("    %s %%xmm1, %%xmm0", i->tipo == IR_V16I8 ? "psubb" : "psubd");
+            }
+            break;
+
+        case IR_CONV:
+            carregarVetor(i->args[0], 0);
+            // cvttps2dq dá 0x80000000 para NaN e fora do intervalo, como cvttss2si
+            emitir("    %s %%xmm0, %%xmm0", i->tipo == IR_V4F32 ? "cvtdq2ps" : "cvttps2dq");
+            break;
+
+        case IR_REPLICAR:
+            if (i->tipo == IR_V4F32) {
+                carregarFloat(i->args[0], 0);
+                emitir("    shufps $0, %%xmm0, %%xmm0");
+                break;
+            }
+            carregar(i->args[0], RAX);
+            emitir("    movd %%eax, %%xmm0");
+            if (i->tipo == IR_V16I8) {
+                emitir("    punpcklbw %%xmm0, %%xmm0");
+                emitir("    punpcklwd %%xmm0, %%xmm0");
+            }
+            emitir("    pshufd $0, %%xmm0, %%xmm0");
+            break;
+
+        case IR_MIN:
+        case IR_MAX:
+            carregarVetor(i->args[0], 0);
+            carregarVetor(i->args[1], 1);
+            escolherFaixas(i->tipo, i->op == IR_MIN);
+            break;
+
+        case IR_REDUZIR:
+            gerarReducao(i);
+            break;
+
+        case IR_LOAD:
+            carregar(i->args[0], RAX);
+            emitir("    movdqu (%%rax), %%xmm0");
+            break;
+
+        default:
+            // store
+            carregar(i->args[0], RAX);
+            carregarVetor(i->args[1], 0);
+            emitir("    movdqu %%xmm0, (%%rax)");
+            break;
+    }
+}
+
+// Argumento na pilha de saída (deslocamento a partir de %rsp)
+static void passarNaPilha(const InstrIr* arg, int offset) {
+    if (arg->tipo == IR_F32) {
+        carregarFloat(arg, 0);
+        emitir("    movss %%xmm0, %d(%%rsp)", offset);
+    } else {
+        carregar(arg, RAX);
+        emitir("    movq %%rax, %d(%%rsp)", offset);
+    }
+}
+
+// Põe os argumentos nos registradores e na pilha de saída; devolve os bytes de pilha usados
+static int passarArgumentos(const InstrIr* i) {
+    int n = i->nArgs;
+    int saida;
+
+    if (abiAlvo == ABI_WIN64) {
+        // Posição fixa: os quatro primeiros em registradores, espaço de sombra de 32 bytes
+        saida = 32 + 8 * (n > 4 ? n - 4 : 0);
+        for (int a = 4; a < n; a++) passarNaPilha(i->args[a], 32 + 8 * (a - 4));
+        for (int a = 0; a < n && a < 4; a++) {
+            if (i->args[a]->tipo == IR_F32) carregarFloat(i->args[a], a);
+            else carregar(i->args[a], regsIntWin64[a]);
+        }
+    } else {
+        // Inteiros e float contam separadamente; o que sobra vai para a pilha em ordem
+        int gi = 0, fi = 0, pilha = 0;
+        for (int a = 0; a < n; a++) {
+            bool flutuante = i->args[a]->tipo == IR_F32;
+            if ((flutuante && fi >= 8) || (!flutuante && gi >= 6)) {
+                passarNaPilha(i->args[a], 8 * pilha++);
+            } else if (flutuante) {
+                fi++;
+            } else {
+                gi++;
+            }
+        }
+        saida = 8 * pilha;
+
+        gi = fi = 0;
+        for (int a = 0; a < n; a++) {
+            if (i->args[a]->tipo == IR_F32) {
+                if (fi < 8) carregarFloat(i->args[a], fi++);
+            } else if (gi < 6) {
+                carregar(i->args[a], regsIntSysV[gi++]);
+            }
+        }
+    }
+
+    return saida;
+}
+
+static void gerarChamada(const InstrIr* i) {
+    int saida = passarArgumentos(i);
+    if (saida > maxSaida) maxSaida = saida;
+
+    if (i->simbolo >= 0) emitir("    call cs_%s", simbolo(i->simbolo)->nome);
+    else emitir("    call %s", i->runtime);
+}
+
+// Chamada de cauda vira salto quando nenhum argumento vai para a pilha: o
+// quadro é desfeito antes e a função chamada volta direto para quem nos chamou
+static bool viraSalto(const InstrIr* i) {
+    if (i->op != IR_CALL || !i->cauda) return false;
+    if (abiAlvo == ABI_WIN64) return i->nArgs <= 4;
+
+    int gi = 0, fi = 0;
+    for (int a = 0; a < i->nArgs; a++) {
+        if (i->args[a]->tipo == IR_F32) fi++;
+        else gi++;
+    }
+    return gi <= 6 && fi <= 8;
+}
+
+static void gerarSaltoCauda(const InstrIr* i) {
+    passarArgumentos(i);
+    emitir("    leave");
+    emitir("    jmp cs_%s", simbolo(i->simbolo)->nome);
+}
+
+// Índice sem sinal abaixo do tamanho cobre também os negativos; fora disso, o runtime interrompe
+static void gerarLimite(const InstrIr* i) {
+    int ok = contLimites++;
+    const Reg* regs = abiAlvo == ABI_WIN64 ? regsIntWin64 : regsIntSysV;
+
+    carregar(i->args[0], RAX);
+    emitir("    cmpl $%d, %%eax", i->tamanho);
+    emitir("    jb .Llim%d", ok);
+    emitir("    movl %%eax, %s", regs32[regs[1]]);
+    emitir("    movl $%d, %s", i->linha, regs32[regs[0]]);
+    emitir("    movl $%d, %s", i->tamanho, regs32[regs[2]]);
+    emitir("    call csrt_fora_dos_limites");
+    emitir(".Llim%d:", ok);
+}
+
+// ===================
+// Blocos
+// ===================
+
+// Grava nas entradas dos phi do sucessor os valores que vêm deste bloco
+static void copiarParaPhi(const BlocoIr* b, const BlocoIr* succ) {
+    int p = indicePredIr(succ, b);
+
+    for (InstrIr* phi = succ->primeira; phi && phi->op == IR_PHI; phi = phi->prox) {
+        const InstrIr* v = phi->args[p];
+        if (ehVetorIr(v->tipo)) {
+            carregarVetor(v, 0);
+            emitir("    movdqa %%xmm0, %d(%%rbp)", offsetEntrada[phi->id]);
+        } else if (v->tipo == IR_F32) {
+            carregarFloat(v, 0);
+            emitir("    movss %%xmm0, %d(%%rbp)", offsetEntrada[phi->id]);
+        } else {
+            carregar(v, RAX);
+            emitir("    movq %%rax, %d(%%rbp)", offsetEntrada[phi->id]);
+        }
+    }
+}
+
+static void gerarTerminador(const InstrIr* i, const BlocoIr* seguinte) {
+    BlocoIr* succ[2];
+    int ns = sucessoresIr(i->bloco, succ);
+
+    for (int s = 0; s < ns; s++) copiarParaPhi(i->bloco, succ[s]);
+
+    switch (i->op) {
+        case IR_JMP:
+            if (i->alvos[0] != seguinte) emitir("    jmp .L%d", rotuloBloco(i->alvos[0]));
+            break;
+
+        case IR_BR:
+            carregar(i->args[0], RAX);
+            emitir("    testl %%eax, %%eax");
+            if (i->alvos[1] == seguinte) {
+                emitir("    jne .L%d", rotuloBloco(i->alvos[0]));
+            } else if (i->alvos[0] == seguinte) {
+                emitir("    je .L%d", rotuloBloco(i->alvos[1]));
+            } else {
+                emitir("    jne .L%d", rotuloBloco(i->alvos[0]));
+                emitir("    jmp .L%d", rotuloBloco(i->alvos[1]));
+            }
+            break;
+
+        default:
+            // O salto de cauda logo antes já saiu da função
+            if (i->ant && viraSalto(i->ant)) break;
+            if (i->nArgs > 0) {
+                if (i->args[0]->tipo == IR_F32) carregarFloat(i->args[0], 0);
+                else carregar(i->args[0], RAX);
+            }
+            emitir("    leave");
+            emitir("    ret");
+            break;
+    }
+}
+
+// ===================
+// Cadeias de comparações
+// ===================
+//
+// Um switch chega como uma cadeia de blocos 'x == k ? caso : próximo teste'
+// (um if / else if sobre a mesma variável também). Com MIN_CASOS_CADEIA
+// valores ou mais, a cadeia inteira sai como uma tabela de saltos, se os
+// valores são densos, ou como uma busca binária sobre os valores ordenados.
+
+#define MIN_CASOS_CADEIA 4
+#define DENSIDADE_TABELA 3     // até 3 entradas na tabela por valor
+
+typedef struct {
+    int32_t valor;
+    const BlocoIr* alvo;
+    const BlocoIr* de;          // bloco do teste (de onde vêm os phi do alvo)
+} CasoCadeia;
+
+typedef struct {
+    const InstrIr* teste;       // comparação do primeiro bloco (NULL se tem outros usos)
+    const InstrIr* x;
+    CasoCadeia* casos;          // ordenados pelo valor, sem repetição
+    int nCasos;
+    const BlocoIr* padrao;
+    const BlocoIr* dePadrao;
+    int rotulo;
+} Cadeia;
+
+// Desvio do bloco por 'x == constante': devolve x e a constante em *valor
+static const InstrIr* testeIgualdade(const BlocoIr* b, int32_t* valor) {
+    const InstrIr* br = terminadorIr(b);
+    if (!br || br->op != IR_BR) return NULL;
+
+    const InstrIr* cmp = br->args[0];
+    if (cmp->op != IR_CMP || cmp->cond != COND_EQ || cmp->bloco != b) return NULL;
+    if (cmp->args[0]->tipo != IR_I32) return NULL;
+
+    if (cmp->args[1]->op == IR_CONST && cmp->args[0]->op != IR_CONST) {
+        *valor = cmp->args[1]->imm.i;
+        return cmp->args[0];
+    }
+    if (cmp->args[0]->op == IR_CONST && cmp->args[1]->op != IR_CONST) {
+        *valor = cmp->args[0]->imm.i;
+        return cmp->args[1];
+    }
+    return NULL;
+}
+
+// Bloco que só faz o teste e só é alcançado pelo teste anterior
+static bool soTeste(const BlocoIr* b) {
+    const InstrIr* br = terminadorIr(b);
+    if (b->nPreds != 1 || br->args[0]->nUsos != 1) return false;
+    for (const InstrIr* i = b->primeira; i != br; i = i->prox) {
+        if (i->op != IR_CONST && i != br->args[0]) return false;
+    }
+    return true;
+}
+
+static int compararCasos(const void* a, const void* b) {
+    int32_t x = ((const CasoCadeia*)a)->valor;
+    int32_t y = ((const CasoCadeia*)b)->valor;
+    return (x > y) - (x < y);
+}
+
+// Monta a cadeia que começa em 'b'; os blocos seguintes dela entram em 'absorvido'
+static Cadeia* montarCadeia(const BlocoIr* b, bool* absorvido) {
+    int32_t valor;
+    const InstrIr* x = testeIgualdade(b, &valor);
+    if (!x) return NULL;
+
+    int n = 0, cap = 8;
+    CasoCadeia* casos = malloc(cap * sizeof(CasoCadeia));
+    const BlocoIr* atual = b;
+
+    for (;;) {
+        const InstrIr* br = terminadorIr(atual);
+
+        // Um valor repetido nunca chega ao segundo teste
+        bool repetido = false;
+        for (int k = 0; k < n; k++) repetido |= casos[k].valor == valor;
+        if (!repetido) {
+            if (n == cap) casos = realloc(casos, (cap *= 2) * sizeof(CasoCadeia));
+            casos[n++] = (CasoCadeia){ valor, br->alvos[0], atual };
+        }
+
+        const BlocoIr* proximo = br->alvos[1];
+        int32_t v;
+        if (proximo->rpo <= atual->rpo || testeIgualdade(proximo, &v) != x || !soTeste(proximo)) break;
+        atual = proximo;
+        valor = v;
+    }
+
+    if (n < MIN_CASOS_CADEIA) {
+        free(casos);
+        return NULL;
+    }
+
+    Cadeia* c = calloc(1, sizeof(Cadeia));
+    c->teste = terminadorIr(b)->args[0]->nUsos == 1 ? terminadorIr(b)->args[0] : NULL;
+    c->x = x;
+    c->casos = casos;
+    c->nCasos = n;
+    c->padrao = terminadorIr(atual)->alvos[1];
+    c->dePadrao = atual;
+    c->rotulo = contCadeias++;
+    qsort(casos, n, sizeof(CasoCadeia), compararCasos);
+
+    for (const BlocoIr* t = b; t != atual; ) {
+        t = terminadorIr(t)->alvos[1];
+        absorvido[t->id] = true;
+    }
+    return c;
+}
+
+static bool temPhi(const BlocoIr* b) {
+    return b->primeira && b->primeira->op == IR_PHI;
+}
+
+// Destino do caso k (k == nCasos: o padrão); com phi, um trecho copia as entradas antes
+static void rotuloCaso(const Cadeia* c, int k, char* rotulo, size_t tam) {
+    const BlocoIr* alvo = k < c->nCasos ? c->casos[k].alvo : c->padrao;
+    if (temPhi(alvo)) snprintf(rotulo, tam, ".Lsw%d_c%d", c->rotulo, k);
+    else snprintf(rotulo, tam, ".L%d", rotuloBloco(alvo));
+}
+
+// Busca binária em casos[ini..fim] com o valor em %eax; poucos casos são testados em sequência
+static void gerarBusca(const Cadeia* c, int ini, int fim) {
+    char rotulo[32];
+
+    if (fim - ini < 3) {
+        for (int k = ini; k <= fim; k++) {
+            rotuloCaso(c, k, rotulo, sizeof(rotulo));
+            emitir("    cmpl $%d, %%eax", c->casos[k].valor);
+            emitir("    je %s", rotulo);
+        }
+        rotuloCaso(c, c->nCasos, rotulo, sizeof(rotulo));
+        emitir("    jmp %s", rotulo);
+        return;
+    }
+
+    int meio = (ini + fim) / 2;
+    rotuloCaso(c, meio, rotulo, sizeof(rotulo));
+    emitir("    cmpl $%d, %%eax", c->casos[meio].valor);
+    emitir("    je %s", rotulo);
+    emitir("    jl .Lsw%d_m%d", c->rotulo, meio);
+    gerarBusca(c, meio + 1, fim);
+    emitir(".Lsw%d_m%d:", c->rotulo, meio);
+    gerarBusca(c, ini, meio - 1);
+}
+
+// Tabela com uma entrada por valor entre o menor e o maior caso
+static void gerarTabela(const Cadeia* c) {
+    char rotulo[32];
+    int32_t menor = c->casos[0].valor;
+    int32_t maior = c->casos[c->nCasos - 1].valor;
+
+    rotuloCaso(c, c->nCasos, rotulo, sizeof(rotulo));
+    if (menor != 0) emitir("    subl $%d, %%eax", menor);
+    emitir("    cmpl $%u, %%eax", (uint32_t)maior - (uint32_t)menor);
+    emitir("    ja %s", rotulo);
+    emitir("    leaq .Lsw%d(%%rip), %%r11", c->rotulo);
+    emitir("    movslq (%%r11,%%rax,4), %%rax");
+    emitir("    addq %%r11, %%rax");
+    emitir("    jmp *%%rax");
+    emitir("    .p2align 2");
+    emitir(".Lsw%d:", c->rotulo);
+
+    int k = 0;
+    for (int64_t v = menor; v <= maior; v++) {
+        if (c->casos[k].valor == v) rotuloCaso(c, k++, rotulo, sizeof(rotulo));
+        else rotuloCaso(c, c->nCasos, rotulo, sizeof(rotulo));
+        emitir("    .long %s - .Lsw%d", rotulo, c->rotulo);
+    }
+}
+
+static void gerarCadeia(const Cadeia* c) {
+    int64_t faixa = (int64_t)c->casos[c->nCasos - 1].valor - c->casos[0].valor + 1;
+
+    carregar(c->x, RAX);
+    if (faixa <= (int64_t)DENSIDADE_TABELA * c->nCasos) gerarTabela(c);
+    else gerarBusca(c, 0, c->nCasos - 1);
+
+    for (int k = 0; k <= c->nCasos; k++) {
+        const BlocoIr* alvo = k < c->nCasos ? c->casos[k].alvo : c->padrao;
+        if (!temPhi(alvo)) continue;
+        emitir(".Lsw%d_c%d:", c->rotulo, k);
+        copiarParaPhi(k < c->nCasos ? c->casos[k].de : c->dePadrao, alvo);
+        emitir("    jmp .L%d", rotuloBloco(alvo));
+    }
+}
+
+static void liberarCadeia(Cadeia* c) {
+    if (!c) return;
+    free(c->casos);
+    free(c);
+}
+
+static void gerarInstr(const InstrIr* i, const BlocoIr* seguinte) {
+    if (i->op != IR_PHI && (ehVetorIr(i->tipo) || i->op == IR_REDUZIR
+                            || (i->op == IR_STORE && ehVetorIr(i->args[1]->tipo)))) {
+        gerarVetorial(i);
+        guardar(i);
+        return;
+    }
+
+    switch (i->op) {
+        case IR_ADD:
+        case IR_SUB:
+        case IR_MUL:
+        case IR_DIV:
+            gerarAritmetica(i);
+            break;
+
+        case IR_NEG:
+            if (i->tipo == IR_F32) {
+                // Inverte só o bit de sinal
+                carregarFloat(i->args[0], 0);
+                emitir("    movd %%xmm0, %%eax");
+                emitir("    xorl $0x80000000, %%eax");
+                emitir("    movd %%eax, %%xmm0");
+            } else {
+                carregar(i->args[0], RAX);
+                emitir("    negl %%eax");
+                if (i->tipo == IR_I8) emitir("    movsbl %%al, %%eax");
+            }
+            break;
+
+        case IR_NOT:
+            carregar(i->args[0], RAX);
+            emitir("    xorl $1, %%eax");
+            break;
+
+        case IR_CMP:
+            gerarComparacao(i);
+            break;
+
+        case IR_CONV:
+            gerarConversao(i);
+            break;
+
+        case IR_ELEM:
+            if (ehBit(i)) {
+                gerarElementoBit(i);
+                break;
+            }
+            carregar(i->args[0], RAX);
+            carregar(i->args[1], RCX);
+            emitir("    movslq %%ecx, %%rcx");
+            emitir("    leaq (%%rax,%%rcx,%d), %%rax", i->escala);
+            break;
+
+        case IR_LOAD:
+            gerarLoad(i);
+            break;
+
+        case IR_STORE:
+            gerarStore(i);
+            break;
+
+        case IR_ZERAR:
+            gerarZerar(i);
+            break;
+
+        case IR_COPIAR:
+            gerarCopia(i);
+            break;
+
+        case IR_LIMITE:
+            gerarLimite(i);
+            return;
+
+        case IR_CALL:
+            if (viraSalto(i)) {
+                gerarSaltoCauda(i);
+                return;
+            }
+            gerarChamada(i);
+            break;
+
+        case IR_JMP:
+        case IR_BR:
+        case IR_RET:
+            gerarTerminador(i, seguinte);
+            return;
+
+        default:
+            // Constantes, endereços e parâmetros não geram código aqui
+            return;
+    }
+
+    guardar(i);
+}
+
+// ===================
+// Funções
+// ===================
+
+static int alinhar(int valor, int alinhamento) {
+    return (valor + alinhamento - 1) / alinhamento * alinhamento;
+}
+
+// Copia os parâmetros recebidos (registradores ou pilha) para os blocos dos seus valores
+static void salvarParametros(FuncaoIr* f) {
+    InstrIr* params[MAX_PARAM + 1] = { NULL };
+    int gi = 0, fi = 0, pilha = 0;
+
+    for (InstrIr* i = f->blocos[0]->primeira; i; i = i->prox) {
+        if (i->op == IR_PARAM) params[i->indice] = i;
+    }
+
+    for (int pos = 0; pos < f->nParams; pos++) {
+        bool flutuante = f->tiposParams[pos] == IR_F32;
+        bool ponteiro = f->tiposParams[pos] == IR_PTR;
+        int reg = -1;
+        int regFloat = -1;
+        int origemPilha = 0;
+
+        if (abiAlvo == ABI_WIN64) {
+            if (pos < 4) {
+                if (flutuante) regFloat = pos;
+                else reg = regsIntWin64[pos];
+            } else {
+                origemPilha = 16 + 32 + 8 * (pos - 4);
+            }
+        } else {
+            if (flutuante && fi < 8) {
+                regFloat = fi++;
+            } else if (!flutuante && gi < 6) {
+                reg = regsIntSysV[gi++];
+            } else {
+                origemPilha = 16 + 8 * pilha++;
+            }
+        }
+
+        // Parâmetro sem uso: nada a guardar
+        if (!params[pos]) continue;
+        int off = offsetValor[params[pos]->id];
+
+        if (regFloat >= 0) {
+            emitir("    movss %%xmm%d, %d(%%rbp)", regFloat, off);
+        } else if (reg >= 0) {
+            emitir("    mov%c %s, %d(%%rbp)", ponteiro ? 'q' : 'l', ponteiro ? regs64[reg] : regs32[reg], off);
+        } else {
+            emitir("    movq %d(%%rbp), %%rax", origemPilha);
+            emitir("    movq %%rax, %d(%%rbp)", off);
+        }
+    }
+}
+
+// Distribui slots, valores e entradas de phi no quadro (quadro.c); devolve os bytes usados
+static int montarQuadro(FuncaoIr* f) {
+    int n = f->nValores > 0 ? f->nValores : 1;
+    bool* lugar = calloc(n, sizeof(bool));
+    for (int b = 0; b < f->nBlocos; b++) {
+        for (InstrIr* i = f->blocos[b]->primeira; i; i = i->prox) {
+            lugar[i->id] = i->tipo != IR_VOID && !ehImediato(i);
+        }
+    }
+
+    offsetSlot = calloc(f->nSlots > 0 ? f->nSlots : 1, sizeof(int));
+    offsetValor = calloc(n, sizeof(int));
+    offsetEntrada = calloc(n, sizeof(int));
+    int tam = montarQuadroIr(f, lugar, offsetSlot, offsetValor, offsetEntrada);
+    free(lugar);
+    return tam;
+}
+
+static void gerarFuncao(FuncaoIr* f, FILE* saida) {
+    maxSaida = 0;
+    corpo.tam = 0;
+    baseRotulos = contRotulos;
+    contRotulos += f->nBlocos;
+
+    int tamQuadro = montarQuadro(f);
+
+    // Os blocos saem em pós-ordem reversa (caminho verdadeiro logo após o desvio)
+    calcularDominadoresIr(f);
+    BlocoIr** ordem = calloc(f->nBlocos, sizeof(BlocoIr*));
+    for (int b = 0; b < f->nBlocos; b++) ordem[f->blocos[b]->rpo] = f->blocos[b];
+
+    // Cadeias de comparações: os testes depois do primeiro não saem como blocos
+    bool* absorvido = calloc(f->nBlocos, sizeof(bool));
+    Cadeia** cadeias = calloc(f->nBlocos, sizeof(Cadeia*));
+    for (int k = 0; k < f->nBlocos; k++) {
+        if (!absorvido[ordem[k]->id]) cadeias[ordem[k]->id] = montarCadeia(ordem[k], absorvido);
+    }
+
+    salvarParametros(f);
+
+    for (int k = 0; k < f->nBlocos; k++) {
+        BlocoIr* b = ordem[k];
+        if (absorvido[b->id]) continue;
+
+        int proximo = k + 1;
+        while (proximo < f->nBlocos && absorvido[ordem[proximo]->id]) proximo++;
+        BlocoIr* seguinte = proximo < f->nBlocos ? ordem[proximo] : NULL;
+        const Cadeia* cadeia = cadeias[b->id];
+
+        emitir(".L%d:", rotuloBloco(b));
+        for (InstrIr* phi = b->primeira; phi && phi->op == IR_PHI; phi = phi->prox) {
+            if (ehVetorIr(phi->tipo)) {
+                emitir("    movdqa %d(%%rbp), %%xmm0", offsetEntrada[phi->id]);
+                emitir("    movdqa %%xmm0, %d(%%rbp)", offsetValor[phi->id]);
+            } else {
+                emitir("    movq %d(%%rbp), %%rax", offsetEntrada[phi->id]);
+                emitir("    movq %%rax, %d(%%rbp)", offsetValor[phi->id]);
+            }
+        }
+        for (InstrIr* i = b->primeira; i; i = i->prox) {
+            if (cadeia && i == cadeia->teste) continue;
+            if (cadeia && i == b->ultima) gerarCadeia(cadeia);
+            else gerarInstr(i, seguinte);
+        }
+    }
+
+    for (int b = 0; b < f->nBlocos; b++) liberarCadeia(cadeias[b]);
+    free(cadeias);
+    free(absorvido);
+
+    // Toda chamada (inclusive ao runtime) reserva o espaço de sombra na Win64
+    if (abiAlvo == ABI_WIN64 && maxSaida < 32) maxSaida = 32;
+    int quadro = alinhar(tamQuadro + maxSaida, 16);
+
+    fprintf(saida, "\n    .globl cs_%s\n", f->nome);
+    fprintf(saida, "cs_%s:\n", f->nome);
+    fprintf(saida, "    pushq %%rbp\n");
+    fprintf(saida, "    movq %%rsp, %%rbp\n");
+    if (quadro > 0) fprintf(saida, "    subq $%d, %%rsp\n", quadro);
+    fputs(corpo.dados, saida);
+
+    free(ordem);
+    free(offsetSlot);
+    free(offsetValor);
+    free(offsetEntrada);
+    offsetSlot = offsetValor = offsetEntrada = NULL;
+}
+
+// Ponto de entrada do executável: chama cs_main e devolve seu resultado
+static void gerarEntrada(const FuncaoIr* mainCs, FILE* saida) {
+    TipoId t = simbolo(mainCs->simbolo)->tipoId;
+
+    fprintf(saida, "\n    .globl main\n");
+    fprintf(saida, "main:\n");
+    fprintf(saida, "    pushq %%rbp\n");
+    fprintf(saida, "    movq %%rsp, %%rbp\n");
+    if (t == TIPO_STRING) {
+        // Espaço para a string devolvida (descartada; o programa devolve 0)
+        int sombra = abiAlvo == ABI_WIN64 ? 32 : 0;
+        fprintf(saida, "    subq $%d, %%rsp\n", sombra + 16);
+        fprintf(saida, "    leaq %d(%%rsp), %s\n", sombra,
+                regs64[abiAlvo == ABI_WIN64 ? regsIntWin64[0] : regsIntSysV[0]]);
+    } else if (abiAlvo == ABI_WIN64) {
+        fprintf(saida, "    subq $32, %%rsp\n");
+    }
+    fprintf(saida, "    call cs_main\n");
+    if (t == TIPO_VOID || t == TIPO_STRING) {
+        fprintf(saida, "    xorl %%eax, %%eax\n");
+    } else if (t == TIPO_FLOAT) {
+        fprintf(saida, "    cvttss2si %%xmm0, %%eax\n");
+    }
+    fprintf(saida, "    leave\n");
+    fprintf(saida, "    ret\n");
+}
+
+// ===================
+// Programa
+// ===================
+
+// Bytes de uma constante em linhas de '.byte'
+static void emitirBytes(FILE* saida, const unsigned char* bytes, int tam) {
+    for (int i = 0; i < tam; i++) {
+        fprintf(saida, i % 16 == 0 ? "    .byte %d" : ",%d", bytes[i]);
+        if (i % 16 == 15 || i == tam - 1) fprintf(saida, "\n");
+    }
+}
+
+// Pool de constantes string: valores de 16 bytes no formato do runtime. As longas
+// apontam para um buffer com refs = -1, que nunca é liberado.
+static void gerarConstantes(FILE* saida) {
+    int n = numStringsConstantes();
+    if (n == 0) return;
+
+    // Os ponteiros das longas precisam de relocação, então na SysV ficam em .data.rel.ro
+    fprintf(saida, "\n    %s\n", abiAlvo == ABI_WIN64 ? ".section .rdata,\"dr\""
+                                                     : ".section .data.rel.ro,\"aw\"");
+    for (int id = 0; id < n; id++) {
+        int tam;
+        const unsigned char* dados = (const unsigned char*)stringConstante(id, &tam);
+        unsigned char curta[16] = { 0 };
+
+        fprintf(saida, "    .balign 16\n");
+        fprintf(saida, ".LCS%d:\n", id);
+        if (tam <= 15) {
+            memcpy(curta, dados, tam);
+            curta[15] = (unsigned char)tam;
+            emitirBytes(saida, curta, 16);
+        } else {
+            fprintf(saida, "    .quad .LCT%d\n", id);
+            fprintf(saida, "    .zero 7\n");
+            fprintf(saida, "    .byte 255\n");
+        }
+    }
+
+    for (int id = 0; id < n; id++) {
+        int tam;
+        const unsigned char* dados = (const unsigned char*)stringConstante(id, &tam);
+        if (tam <= 15) continue;
+
+        fprintf(saida, "    .balign 4\n");
+        fprintf(saida, ".LCT%d:\n", id);
+        fprintf(saida, "    .long -1, %d, %d\n", tam, tam);
+        emitirBytes(saida, dados, tam);
+    }
+}
+
+bool gerarCodigo(const ProgramaIr* programa, FILE* saida) {
+    const FuncaoIr* mainCs = NULL;
+
+    fprintf(saida, "# Gerado pelo compilador C.SHORT\n");
+
+    // Variáveis globais (zeradas)
+    fprintf(saida, "    .bss\n");
+    for (int g = 0; g < programa->nGlobais; g++) {
+        Simbolo* s = simbolo(programa->globais[g]);
+        int tam = tipoIdEhVetor(s->tipoId)   ? bytesVetorIr(s->tipoId, s->tamanho)
+                : s->tipoId == TIPO_STRING   ? 16
+                                             : tamanhoElemento(s->tipoId);
+        fprintf(saida, "    .globl cs_%s\n", s->nome);
+        fprintf(saida, "    .balign %d\n", tipoIdEhVetor(s->tipoId) || s->tipoId == TIPO_STRING ? 16 : 4);
+        fprintf(saida, "cs_%s:\n", s->nome);
+        fprintf(saida, "    .zero %d\n", tam > 0 ? tam : 1);
+    }
+
+    gerarConstantes(saida);
+
+    fprintf(saida, "\n    .text\n");
+    for (int k = 0; k < programa->nFuncoes; k++) {
+        FuncaoIr* f = programa->funcoes[k];
+        gerarFuncao(f, saida);
+        if (strcmp(f->nome, "main") == 0) mainCs = f;
+    }
+
+    if (mainCs) gerarEntrada(mainCs, saida);
+
+    if (abiAlvo == ABI_SYSV) {
+        fprintf(saida, "\n    .section .note.GNU-stack,\"\",@progbits\n");
+    }
+
+    free(corpo.dados);
+    corpo.dados = NULL;
+    corpo.tam = corpo.cap = 0;
+
+    return true;
+}
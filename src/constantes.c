@@ -0,0 +1,76 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "constantes.h"
+
+typedef struct {
+    char* dados;
+    int tam;
+} StringConstante;
+
+static StringConstante* strings = NULL;
+static int nStrings = 0;
+static int capStrings = 0;
+
+// Endereçamento aberto: guarda id + 1 (0 = livre)
+static int* hashStrings = NULL;
+static int capHash = 0;
+
+static unsigned int hashDados(const char* dados, int tam) {
+    unsigned int h = 2166136261u;
+    for (int i = 0; i < tam; i++) {
+        h ^= (unsigned char)dados[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static void inserirNoHash(int* hash, int cap, int id) {
+    unsigned int j = hashDados(strings[id].dados, strings[id].tam) & (cap - 1);
+    while (hash[j]) j = (j + 1) & (cap - 1);
+    hash[j] = id + 1;
+}
+
+int internarString(const char* dados, int tam) {
+    if (capHash > 0) {
+        unsigned int j = hashDados(dados, tam) & (capHash - 1);
+        while (hashStrings[j]) {
+            StringConstante* s = &strings[hashStrings[j] - 1];
+            if (s->tam == tam && memcmp(s->dados, dados, tam) == 0) return hashStrings[j] - 1;
+            j = (j + 1) & (capHash - 1);
+        }
+    }
+
+    if (nStrings == capStrings) {
+        capStrings = capStrings ? capStrings * 2 : 64;
+        strings = realloc(strings, capStrings * sizeof(StringConstante));
+    }
+
+    strings[nStrings].dados = malloc(tam + 1);
+    memcpy(strings[nStrings].dados, dados, tam);
+    strings[nStrings].dados[tam] = '\0';
+    strings[nStrings].tam = tam;
+
+    // Mantém o fator de carga abaixo de 1/2
+    if ((nStrings + 1) * 2 > capHash) {
+        int novaCap = capHash ? capHash * 2 : 128;
+        int* novo = calloc(novaCap, sizeof(int));
+        for (int i = 0; i < nStrings; i++) inserirNoHash(novo, novaCap, i);
+        free(hashStrings);
+        hashStrings = novo;
+        capHash = novaCap;
+    }
+    inserirNoHash(hashStrings, capHash, nStrings);
+
+    return nStrings++;
+}
+
+int numStringsConstantes(void) {
+    return nStrings;
+}
+
+const char* stringConstante(int id, int* tam) {
+    *tam = strings[id].tam;
+    return strings[id].dados;
+}
@@ -0,0 +1,239 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "otimizacao.h"
+
+// ==============================================
+// DOBRAMENTO DE CONSTANTES E SIMPLIFICAÇÃO
+// ==============================================
+//
+// Os resultados seguem exatamente o código gerado (calcularOperacaoIr):
+// int com aritmética de 32 bits em complemento de dois, char truncado para
+// 8 bits com sinal a cada operação, bool 0/1 e float em precisão simples.
+// Divisões que interromperiam o programa (por zero, INT_MIN / -1) não são
+// dobradas.
+
+static bool ehConst(const InstrIr* v) {
+    return v->op == IR_CONST;
+}
+
+static bool ehConstInt(const InstrIr* v, int32_t valor) {
+    return v->op == IR_CONST && v->tipo != IR_F32 && v->imm.i == valor;
+}
+
+static bool ehConstFloat(const InstrIr* v, float valor) {
+    return v->op == IR_CONST && v->tipo == IR_F32 && v->imm.f == valor;
+}
+
+// Nova constante logo antes de 'pos'
+static InstrIr* constanteAntes(FuncaoIr* f, InstrIr* pos, TipoIr tipo, int32_t valor) {
+    InstrIr* c = novaInstrIr(f, IR_CONST, tipo);
+    c->imm.i = valor;
+    c->linha = pos->linha;
+    inserirAntesIr(pos, c);
+    return c;
+}
+
+static InstrIr* constanteFloatAntes(FuncaoIr* f, InstrIr* pos, float valor) {
+    InstrIr* c = novaInstrIr(f, IR_CONST, IR_F32);
+    c->imm.f = valor;
+    c->linha = pos->linha;
+    inserirAntesIr(pos, c);
+    return c;
+}
+
+// ===================
+// Operações com constantes
+// ===================
+
+static InstrIr* dobrarOperacao(FuncaoIr* f, InstrIr* i) {
+    ValorIr args[2], r;
+    if (i->nArgs > 2 || ehVetorIr(i->tipo)) return NULL;
+
+    for (int k = 0; k < i->nArgs; k++) args[k] = i->args[k]->imm;
+    if (!calcularOperacaoIr(i->op, i->cond, i->tipo, i->args[0]->tipo, args, &r)) return NULL;
+    if (i->tipo == IR_F32) return constanteFloatAntes(f, i, r.f);
+    return constanteAntes(f, i, i->tipo, r.i);
+}
+
+// ===================
+// Identidades
+// ===================
+
+static InstrIr* simplificar(FuncaoIr* f, InstrIr* i) {
+    InstrIr* a = i->nArgs > 0 ? i->args[0] : NULL;
+    InstrIr* b = i->nArgs > 1 ? i->args[1] : NULL;
+    bool inteiro = i->tipo != IR_F32;
+
+    if (ehVetorIr(i->tipo)) return NULL;
+
+    switch (i->op) {
+        case IR_ADD:
+            if (inteiro && ehConstInt(b, 0)) return a;
+            if (inteiro && ehConstInt(a, 0)) return b;
+            break;
+
+        case IR_SUB:
+            if (inteiro && ehConstInt(b, 0)) return a;
+            if (!inteiro && ehConstFloat(b, 0.0f) && !signbit(b->imm.f)) return a;
+            if (inteiro && a == b) return constanteAntes(f, i, i->tipo, 0);
+            break;
+
+        case IR_MUL:
+            if (inteiro && ehConstInt(b, 1)) return a;
+            if (inteiro && ehConstInt(a, 1)) return b;
+            if (inteiro && (ehConstInt(a, 0) || ehConstInt(b, 0))) return constanteAntes(f, i, i->tipo, 0);
+            if (!inteiro && ehConstFloat(b, 1.0f)) return a;
+            if (!inteiro && ehConstFloat(a, 1.0f)) return b;
+            break;
+
+        case IR_DIV:
+            if (inteiro && ehConstInt(b, 1)) return a;
+            if (!inteiro && ehConstFloat(b, 1.0f)) return a;
+            break;
+
+        case IR_NEG:
+        case IR_NOT:
+            // -(-x) e !!b
+            if (a->op == i->op) return a->args[0];
+            break;
+
+        case IR_CMP:
+            // x op x com inteiros (float não: NaN != NaN)
+            if (a == b && a->tipo != IR_F32) {
+                bool igual = i->cond == COND_EQ || i->cond == COND_LE || i->cond == COND_GE;
+                return constanteAntes(f, i, IR_I1, igual);
+            }
+            break;
+
+        case IR_CONV:
+            // Ida e volta sem perda: char→int→char, bool→int→bool, bool→char→bool
+            if (a->op == IR_CONV && a->args[0]->tipo == i->tipo && a->args[0]->tipo != IR_F32
+                && a->tipo != IR_F32 && a->tipo > a->args[0]->tipo) {
+                return a->args[0];
+            }
+            // Conversões encadeadas de inteiros que só alargam: vai direto da origem
+            if (a->op == IR_CONV && a->args[0]->tipo != IR_F32 && a->tipo != IR_F32 && i->tipo != IR_F32
+                && a->args[0]->tipo < a->tipo && a->tipo < i->tipo) {
+                InstrIr* c = novaInstrIr(f, IR_CONV, i->tipo);
+                c->linha = i->linha;
+                adicionarArgIr(c, a->args[0]);
+                inserirAntesIr(i, c);
+                return c;
+            }
+            break;
+
+        case IR_PHI: {
+            // Todos os operandos iguais (ou o próprio phi)
+            InstrIr* mesmo = NULL;
+            for (int k = 0; k < i->nArgs; k++) {
+                if (i->args[k] == i || i->args[k] == mesmo) continue;
+                if (mesmo) return NULL;
+                mesmo = i->args[k];
+            }
+            return mesmo;
+        }
+
+        default:
+            break;
+    }
+    return NULL;
+}
+
+// ===================
+// Desvios
+// ===================
+
+// br com condição constante vira jmp; a aresta não tomada sai dos preds do alvo
+static bool dobrarDesvio(FuncaoIr* f, InstrIr* br) {
+    InstrIr* cond = br->args[0];
+
+    // br !c, a, b  ==>  br c, b, a
+    if (cond->op == IR_NOT) {
+        BlocoIr* t = br->alvos[0];
+        br->alvos[0] = br->alvos[1];
+        br->alvos[1] = t;
+        trocarArgIr(br, 0, cond->args[0]);
+        if (cond->nUsos == 0) removerInstrIr(cond);
+        return true;
+    }
+
+    if (!ehConst(cond) && br->alvos[0] != br->alvos[1]) return false;
+
+    BlocoIr* tomado = ehConst(cond) && !cond->imm.i ? br->alvos[1] : br->alvos[0];
+    BlocoIr* outro = tomado == br->alvos[0] ? br->alvos[1] : br->alvos[0];
+    BlocoIr* origem = br->bloco;
+
+    // Com os dois alvos iguais, o bloco aparece duas vezes entre os preds
+    removerPredIr(outro, indicePredIr(outro, origem));
+
+    InstrIr* jmp = novaInstrIr(f, IR_JMP, IR_VOID);
+    jmp->alvos[0] = tomado;
+    jmp->linha = br->linha;
+    removerInstrIr(br);
+    anexarInstrIr(origem, jmp);
+    return true;
+}
+
+// ===================
+// Passe
+// ===================
+
+static bool todosConstantes(const InstrIr* i) {
+    if (i->nArgs == 0) return false;
+    for (int k = 0; k < i->nArgs; k++) {
+        if (!ehConst(i->args[k])) return false;
+    }
+    return true;
+}
+
+bool dobrarConstantes(FuncaoIr* f) {
+    bool mudou = false;
+    bool desvios = false;
+    bool progresso = true;
+
+    while (progresso) {
+        progresso = false;
+
+        for (int b = 0; b < f->nBlocos; b++) {
+            InstrIr* i = f->blocos[b]->primeira;
+            while (i) {
+                InstrIr* prox = i->prox;
+                InstrIr* novo = NULL;
+
+                if (i->op == IR_BR) {
+                    if (dobrarDesvio(f, i)) {
+                        desvios = true;
+                        progresso = true;
+                    }
+                    break;
+                }
+
+                if (i->op != IR_PHI && i->op != IR_CALL && todosConstantes(i)) novo = dobrarOperacao(f, i);
+                if (!novo) novo = simplificar(f, i);
+
+                if (novo && novo != i) {
+                    substituirUsosIr(i, novo);
+                    removerInstrIr(i);
+                    progresso = true;
+                }
+                i = prox;
+            }
+        }
+        mudou |= progresso;
+    }
+
+    if (desvios) removerBlocosInalcancaveisIr(f);
+    return mudou;
+}
+
+void avisarDivisaoPorZero(const FuncaoIr* f) {
+    for (int b = 0; b < f->nBlocos; b++) {
+        for (InstrIr* i = f->blocos[b]->primeira; i; i = i->prox) {
+            if (i->op == IR_DIV && i->tipo != IR_F32 && ehConstInt(i->args[1], 0)) {
+                fprintf(stderr, "[AVISO] %s: Divisão por zero constante (linha %d)\n", f->nome, i->linha);
+            }
+        }
+    }
+}
@@ -0,0 +1,351 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "otimizacao.h"
+
+// ==============================================
+// ELIMINAÇÃO DE CÓDIGO MORTO
+// ==============================================
+//
+// Valores: tudo o que não é alcançado a partir das instruções com efeito
+// sai (inclusive ciclos de phi que só usam uns aos outros). Uma chamada a
+// função que não grava nada e sempre volta não conta como efeito.
+// Stores: em slots do quadro cujo endereço não escapa, uma gravação que
+// nenhum caminho lê depois é removida (análise de vivacidade para trás).
+// Blocos: inalcançáveis saem, um bloco com um único predecessor que salta
+// para ele é juntado a esse predecessor e blocos vazios são atalhados.
+
+// Divisão inteira só pode ser removida se o divisor é uma constante que não a interrompe;
+// chamada, se a função chamada não faz nada além de devolver o valor
+static bool temEfeito(const InstrIr* i) {
+    if (i->op == IR_DIV && i->tipo != IR_F32) {
+        const InstrIr* d = i->args[1];
+        return !(d->op == IR_CONST && d->imm.i != 0 && d->imm.i != -1);
+    }
+    if (i->op == IR_CALL && !i->cauda && chamadaRemovivel(i)) return false;
+    return temEfeitoIr(i);
+}
+
+// ===================
+// Valores sem uso
+// ===================
+
+static bool removerValoresMortos(FuncaoIr* f) {
+    bool* vivo = calloc(f->nValores > 0 ? f->nValores : 1, sizeof(bool));
+    int capPilha = 64, topo = 0, nMortos = 0;
+    InstrIr** pilha = malloc(capPilha * sizeof(InstrIr*));
+
+    for (int b = 0; b < f->nBlocos; b++) {
+        for (InstrIr* i = f->blocos[b]->primeira; i; i = i->prox) {
+            if (!temEfeito(i)) continue;
+            vivo[i->id] = true;
+            if (topo == capPilha) pilha = realloc(pilha, (capPilha *= 2) * sizeof(InstrIr*));
+            pilha[topo++] = i;
+        }
+    }
+
+    while (topo > 0) {
+        InstrIr* i = pilha[--topo];
+        for (int a = 0; a < i->nArgs; a++) {
+            InstrIr* arg = i->args[a];
+            if (vivo[arg->id]) continue;
+            vivo[arg->id] = true;
+            if (topo == capPilha) pilha = realloc(pilha, (capPilha *= 2) * sizeof(InstrIr*));
+            pilha[topo++] = arg;
+        }
+    }
+
+    // Desliga todos os mortos antes de liberar (podem usar uns aos outros)
+    for (int b = 0; b < f->nBlocos; b++) {
+        InstrIr* i = f->blocos[b]->primeira;
+        while (i) {
+            InstrIr* prox = i->prox;
+            if (!vivo[i->id]) {
+                desligarInstrIr(i);
+                if (topo == capPilha) pilha = realloc(pilha, (capPilha *= 2) * sizeof(InstrIr*));
+                pilha[topo++] = i;
+                nMortos++;
+            }
+            i = prox;
+        }
+    }
+    for (int k = 0; k < topo; k++) liberarInstrIr(pilha[k]);
+
+    free(pilha);
+    free(vivo);
+    return nMortos > 0;
+}
+
+// ===================
+// Stores mortos
+// ===================
+
+typedef enum {
+    ACESSO_NENHUM,
+    ACESSO_LEITURA,
+    ACESSO_ESCRITA,         // grava o slot inteiro
+    ACESSO_ESCRITA_PARCIAL  // grava um elemento
+} Acesso;
+
+static int tamanhoTipo(TipoIr t) {
+    switch (t) {
+        case IR_I1:
+        case IR_I8:  return 1;
+        case IR_PTR: return 8;
+        default:     return ehVetorIr(t) ? 16 : 4;
+    }
+}
+
+// O endereço só é usado para ler ou gravar valores (não é guardado nem passado adiante)
+static bool enderecoSoAcessado(const InstrIr* end) {
+    for (int u = 0; u < end->nUsos; u++) {
+        const InstrIr* uso = end->usos[u];
+        if (uso->op == IR_LOAD) continue;
+        if (uso->op == IR_STORE && uso->args[0] == end && uso->args[1] != end) continue;
+        return false;
+    }
+    return true;
+}
+
+// Slots que só são lidos e gravados diretamente ou por elementos
+static bool* slotsNaoEscapam(FuncaoIr* f) {
+    bool* candidato = malloc((f->nSlots > 0 ? f->nSlots : 1) * sizeof(bool));
+    for (int s = 0; s < f->nSlots; s++) candidato[s] = true;
+
+    for (int b = 0; b < f->nBlocos; b++) {
+        for (InstrIr* i = f->blocos[b]->primeira; i; i = i->prox) {
+            if (i->op != IR_LOCAL) continue;
+
+            for (int u = 0; u < i->nUsos && candidato[i->indice]; u++) {
+                InstrIr* uso = i->usos[u];
+                bool ok;
+                if (uso->op == IR_ELEM) {
+                    ok = uso->args[0] == i && uso->args[1] != i && enderecoSoAcessado(uso);
+                } else if (uso->op == IR_LOAD) {
+                    ok = true;
+                } else {
+                    ok = uso->op == IR_STORE && uso->args[0] == i && uso->args[1] != i;
+                }
+                if (!ok) candidato[i->indice] = false;
+            }
+        }
+    }
+    return candidato;
+}
+
+// Como a instrução acessa um slot candidato (o slot vai em *slot)
+static Acesso acessoDe(const FuncaoIr* f, const InstrIr* i, const bool* candidato, int* slot) {
+    if (i->op != IR_LOAD && i->op != IR_STORE) return ACESSO_NENHUM;
+
+    const InstrIr* end = i->args[0];
+    bool elemento = end->op == IR_ELEM;
+    if (elemento) end = end->args[0];
+    if (end->op != IR_LOCAL || !candidato[end->indice]) return ACESSO_NENHUM;
+
+    *slot = end->indice;
+    if (i->op == IR_LOAD) return ACESSO_LEITURA;
+    if (elemento || tamanhoTipo(i->args[1]->tipo) < f->slots[*slot].tamanho) return ACESSO_ESCRITA_PARCIAL;
+    return ACESSO_ESCRITA;
+}
+
+static bool removerStoresMortos(FuncaoIr* f) {
+    int nb = f->nBlocos, ns = f->nSlots;
+    if (ns == 0) return false;
+
+    bool* candidato = slotsNaoEscapam(f);
+    bool* vivoSaida = calloc((size_t)nb * ns, sizeof(bool));
+    bool* vivoEntrada = calloc((size_t)nb * ns, sizeof(bool));
+    bool* vivo = malloc(ns * sizeof(bool));
+    bool mudou = false;
+
+    // Vivacidade: um slot está vivo se algum caminho o lê antes de gravá-lo por inteiro
+    bool alterou = true;
+    while (alterou) {
+        alterou = false;
+        for (int b = nb - 1; b >= 0; b--) {
+            BlocoIr* bloco = f->blocos[b];
+            BlocoIr* succ[2];
+            int nsucc = sucessoresIr(bloco, succ);
+
+            memset(vivo, 0, ns * sizeof(bool));
+            for (int k = 0; k < nsucc; k++) {
+                for (int s = 0; s < ns; s++) vivo[s] |= vivoEntrada[succ[k]->id * ns + s];
+            }
+            memcpy(&vivoSaida[b * ns], vivo, ns * sizeof(bool));
+
+            for (InstrIr* i = bloco->ultima; i; i = i->ant) {
+                int slot;
+                switch (acessoDe(f, i, candidato, &slot)) {
+                    case ACESSO_LEITURA: vivo[slot] = true; break;
+                    case ACESSO_ESCRITA: vivo[slot] = false; break;
+                    default: break;
+                }
+            }
+
+            if (memcmp(&vivoEntrada[b * ns], vivo, ns * sizeof(bool)) != 0) {
+                memcpy(&vivoEntrada[b * ns], vivo, ns * sizeof(bool));
+                alterou = true;
+            }
+        }
+    }
+
+    for (int b = 0; b < nb; b++) {
+        memcpy(vivo, &vivoSaida[b * ns], ns * sizeof(bool));
+
+        InstrIr* i = f->blocos[b]->ultima;
+        while (i) {
+            InstrIr* ant = i->ant;
+            int slot;
+            Acesso acesso = acessoDe(f, i, candidato, &slot);
+
+            if ((acesso == ACESSO_ESCRITA || acesso == ACESSO_ESCRITA_PARCIAL) && !vivo[slot]) {
+                removerInstrIr(i);
+                mudou = true;
+            } else if (acesso == ACESSO_LEITURA) {
+                vivo[slot] = true;
+            } else if (acesso == ACESSO_ESCRITA) {
+                vivo[slot] = false;
+            }
+            i = ant;
+        }
+    }
+
+    free(candidato);
+    free(vivoSaida);
+    free(vivoEntrada);
+    free(vivo);
+    return mudou;
+}
+
+// Slots que nenhuma instrução usa mais saem do quadro
+static bool compactarSlots(FuncaoIr* f) {
+    if (f->nSlots == 0) return false;
+
+    int* novo = malloc(f->nSlots * sizeof(int));
+    for (int s = 0; s < f->nSlots; s++) novo[s] = -1;
+
+    for (int b = 0; b < f->nBlocos; b++) {
+        for (InstrIr* i = f->blocos[b]->primeira; i; i = i->prox) {
+            if (i->op == IR_LOCAL) novo[i->indice] = 0;
+        }
+    }
+
+    int n = 0;
+    for (int s = 0; s < f->nSlots; s++) {
+        if (novo[s] < 0) continue;
+        f->slots[n] = f->slots[s];
+        novo[s] = n++;
+    }
+
+    bool mudou = n != f->nSlots;
+    if (mudou) {
+        for (int b = 0; b < f->nBlocos; b++) {
+            for (InstrIr* i = f->blocos[b]->primeira; i; i = i->prox) {
+                if (i->op == IR_LOCAL) i->indice = novo[i->indice];
+            }
+        }
+        f->nSlots = n;
+    }
+
+    free(novo);
+    return mudou;
+}
+
+// ===================
+// Blocos
+// ===================
+
+static void trocarPred(BlocoIr* b, BlocoIr* antigo, BlocoIr* novo) {
+    for (int p = 0; p < b->nPreds; p++) {
+        if (b->preds[p] == antigo) b->preds[p] = novo;
+    }
+}
+
+// 'b' tem um único predecessor, que termina em 'jmp b': as instruções passam para ele
+static void juntarAoPredecessor(FuncaoIr* f, BlocoIr* b) {
+    BlocoIr* pred = b->preds[0];
+
+    // Com um só predecessor, cada phi é o seu único operando
+    while (b->primeira && b->primeira->op == IR_PHI) {
+        InstrIr* phi = b->primeira;
+        substituirUsosIr(phi, phi->args[0]);
+        removerInstrIr(phi);
+    }
+
+    removerInstrIr(pred->ultima);
+
+    BlocoIr* succ[2];
+    int ns = sucessoresIr(b, succ);
+    for (int s = 0; s < ns; s++) trocarPred(succ[s], b, pred);
+
+    for (InstrIr* i = b->primeira; i; i = i->prox) i->bloco = pred;
+    if (b->primeira) {
+        b->primeira->ant = pred->ultima;
+        if (pred->ultima) pred->ultima->prox = b->primeira;
+        else pred->primeira = b->primeira;
+        pred->ultima = b->ultima;
+    }
+
+    b->primeira = b->ultima = NULL;
+    b->nPreds = 0;
+    removerBlocoIr(f, b);
+}
+
+// 'b' só contém 'jmp alvo' e 'alvo' não tem phi: os predecessores de 'b' vão direto ao alvo
+static void atalharBlocoVazio(FuncaoIr* f, BlocoIr* b) {
+    BlocoIr* alvo = b->ultima->alvos[0];
+
+    for (int p = 0; p < b->nPreds; p++) {
+        InstrIr* t = terminadorIr(b->preds[p]);
+        for (int k = 0; k < 2; k++) {
+            if (t->alvos[k] == b) {
+                t->alvos[k] = alvo;
+                adicionarPredIr(alvo, b->preds[p]);
+            }
+        }
+    }
+
+    removerPredIr(alvo, indicePredIr(alvo, b));
+    removerInstrIr(b->ultima);
+    b->nPreds = 0;
+    removerBlocoIr(f, b);
+}
+
+static bool simplificarBlocos(FuncaoIr* f) {
+    bool mudou = false;
+
+    for (int k = 1; k < f->nBlocos; k++) {
+        BlocoIr* b = f->blocos[k];
+        InstrIr* t = b->ultima;
+
+        if (b->nPreds == 1 && b->preds[0] != b && b->preds[0]->ultima->op == IR_JMP) {
+            juntarAoPredecessor(f, b);
+        } else if (t && t->op == IR_JMP && b->primeira == t && t->alvos[0] != b
+                   && (!t->alvos[0]->primeira || t->alvos[0]->primeira->op != IR_PHI)) {
+            atalharBlocoVazio(f, b);
+        } else {
+            continue;
+        }
+
+        // Os ids mudaram: recomeça
+        mudou = true;
+        k = 0;
+    }
+    return mudou;
+}
+
+// ===================
+// Passe
+// ===================
+
+bool eliminarCodigoMorto(FuncaoIr* f) {
+    bool mudou = false;
+
+    removerBlocosInalcancaveisIr(f);
+    mudou |= simplificarBlocos(f);
+    mudou |= removerStoresMortos(f);
+    mudou |= removerValoresMortos(f);
+    mudou |= compactarSlots(f);
+    return mudou;
+}
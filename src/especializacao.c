@@ -0,0 +1,203 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "otimizacao.h"
+
+// ==============================================
+// ESPECIALIZAÇÃO DE FUNÇÕES
+// ==============================================
+//
+// Uma chamada que passa constantes (um passo 1, uma opção fixa) ou um
+// vetor inteiro de tamanho conhecido ganha uma cópia da função só para
+// chamadas com esses mesmos fatos: na cópia, o parâmetro constante vira a
+// constante e os acessos ao vetor recebido passam a ter o tamanho dele.
+// As otimizações seguintes tratam a cópia como qualquer outra função, e a
+// análise de alias vê que os parâmetros dela só recebem o que as chamadas
+// redirecionadas passam (o que muitas vezes dispensa as conferências da
+// vetorização). A original fica como está para as outras chamadas e para
+// quem a chama de fora do programa.
+//
+// Chamadas que a expansão já vai copiar no lugar não são especializadas, e
+// o crescimento do programa é limitado por função e no total.
+
+#define MAX_VERSOES 4           // cópias de uma mesma função
+#define TAMANHO_MAXIMO 400      // funções maiores não são copiadas
+#define CRESCIMENTO_MINIMO 200  // o total copiado pode chegar a metade do programa, ou a isto
+
+typedef struct {
+    int funcao;                         // original, em p->funcoes
+    unsigned constantes;                // bit a: o argumento a é constante
+    ValorIr valores[MAX_PARAM + 1];
+    int extensoes[MAX_PARAM + 1];       // elementos do vetor passado (0 = desconhecido)
+    int copia;                          // em p->funcoes
+} Versao;
+
+// ===================
+// Fatos da chamada
+// ===================
+
+// Elementos do vetor inteiro (global ou local de quem chama) passado no argumento
+static int extensao(const FuncaoIr* f, const InstrIr* arg) {
+    int simbolo = -1;
+    if (arg->op == IR_GLOBAL) simbolo = arg->simbolo;
+    else if (arg->op == IR_LOCAL) simbolo = f->slots[arg->indice].simbolo;
+    if (simbolo < 0) return 0;
+
+    const Simbolo* s = &getTabela()[simbolo];
+    return tipoIdEhVetor(s->tipoId) ? s->tamanho : 0;
+}
+
+static bool indexado(const InstrIr* param) {
+    for (int u = 0; u < param->nUsos; u++) {
+        if (param->usos[u]->op == IR_ELEM && param->usos[u]->args[0] == param) return true;
+    }
+    return false;
+}
+
+// O que a chamada fixa e 'chamada' usa (false se não há nada)
+static bool descrever(const FuncaoIr* f, const InstrIr* call, const FuncaoIr* chamada, Versao* v) {
+    const Simbolo* s = &getTabela()[chamada->simbolo];
+    int oculto = s->tipoId == TIPO_STRING ? 1 : 0;     // endereço do retorno string
+    bool util = false;
+
+    memset(v, 0, sizeof(Versao));
+    for (InstrIr* param = chamada->blocos[0]->primeira; param; param = param->prox) {
+        if (param->op != IR_PARAM || param->nUsos == 0) continue;
+        int a = param->indice;
+        if (a >= call->nArgs) continue;
+
+        if (call->args[a]->op == IR_CONST) {
+            v->constantes |= 1u << a;
+            v->valores[a] = call->args[a]->imm;
+            util = true;
+        } else if (a >= oculto && s->modosParams[a - oculto] == PARAM_VETOR && indexado(param)) {
+            v->extensoes[a] = extensao(f, call->args[a]);
+            util |= v->extensoes[a] > 0;
+        }
+    }
+    return util;
+}
+
+static bool mesmaVersao(const Versao* a, const Versao* b) {
+    if (a->funcao != b->funcao || a->constantes != b->constantes) return false;
+    for (int k = 0; k <= MAX_PARAM; k++) {
+        if ((a->constantes & (1u << k)) && a->valores[k].i != b->valores[k].i) return false;
+        if (a->extensoes[k] != b->extensoes[k]) return false;
+    }
+    return true;
+}
+
+// ===================
+// Cópia
+// ===================
+
+// Símbolo da cópia: o da original com outro nome ('.' não aparece em identificadores)
+static int registrarCopia(int original, int numero) {
+    Simbolo copia = getTabela()[original];
+    char nome[sizeof(copia.nome)];
+    if (snprintf(nome, sizeof(nome), "%s.esp%d", copia.nome, numero) >= (int)sizeof(nome)) return -1;
+    if (!inserirSimbolo(nome, copia.tipo, CLASSE_FUNCAO, ESC_GLOBAL, 0)) return -1;
+
+    int s = getNumSimbolos() - 1;
+    strcpy(copia.nome, nome);
+    copia.chamadas = 0;
+    getTabela()[s] = copia;
+    return s;
+}
+
+// Aplica os fatos da versão na cópia
+static void fixar(FuncaoIr* f, const Versao* v) {
+    for (InstrIr* param = f->blocos[0]->primeira; param; param = param->prox) {
+        if (param->op != IR_PARAM) continue;
+        int a = param->indice;
+
+        if (v->constantes & (1u << a)) {
+            InstrIr* c = novaInstrIr(f, IR_CONST, param->tipo);
+            c->imm = v->valores[a];
+            c->linha = param->linha;
+            inserirAntesIr(param->prox, c);
+            substituirUsosIr(param, c);
+        } else if (v->extensoes[a] > 0) {
+            for (int u = 0; u < param->nUsos; u++) {
+                InstrIr* e = param->usos[u];
+                if (e->op == IR_ELEM && e->args[0] == param && e->tamanho == 0) e->tamanho = v->extensoes[a];
+            }
+        }
+    }
+}
+
+static int criarCopia(ProgramaIr* p, const Versao* v, int numero) {
+    const FuncaoIr* original = p->funcoes[v->funcao];
+    int simbolo = registrarCopia(original->simbolo, numero);
+    if (simbolo < 0) return -1;
+
+    FuncaoIr* copia = copiarFuncaoIr(original, getTabela()[simbolo].nome, simbolo);
+    fixar(copia, v);
+
+    p->funcoes = realloc(p->funcoes, (p->nFuncoes + 1) * sizeof(FuncaoIr*));
+    p->funcoes[p->nFuncoes] = copia;
+    return p->nFuncoes++;
+}
+
+// ===================
+// Passe
+// ===================
+
+bool especializarFuncoes(ProgramaIr* p) {
+    int nOriginais = p->nFuncoes;
+    GrafoChamadas* g = construirGrafoChamadas(p);
+    int* nCopias = calloc(nOriginais > 0 ? nOriginais : 1, sizeof(int));
+    Versao* versoes = NULL;
+    int nVersoes = 0;
+    bool mudou = false;
+
+    int orcamento = 0;
+    for (int k = 0; k < nOriginais; k++) orcamento += tamanhoFuncaoIr(p->funcoes[k]);
+    orcamento = orcamento / 2 > CRESCIMENTO_MINIMO ? orcamento / 2 : CRESCIMENTO_MINIMO;
+
+    for (int k = 0; k < nOriginais; k++) {
+        FuncaoIr* f = p->funcoes[k];
+        for (int b = 0; b < f->nBlocos; b++) {
+            for (InstrIr* call = f->blocos[b]->primeira; call; call = call->prox) {
+                if (call->op != IR_CALL || call->simbolo < 0) continue;
+                int alvo = funcaoDeSimbolo(p, call->simbolo);
+                if (alvo < 0 || alvo >= nOriginais || g->recursiva[alvo]) continue;
+
+                // A expansão já leva as constantes para dentro de quem chama
+                const FuncaoIr* chamada = p->funcoes[alvo];
+                if (expansaoCompensa(call, chamada)) continue;
+
+                Versao v;
+                if (!descrever(f, call, chamada, &v)) continue;
+                v.funcao = alvo;
+
+                int existente = -1;
+                for (int e = 0; e < nVersoes && existente < 0; e++) {
+                    if (mesmaVersao(&versoes[e], &v)) existente = e;
+                }
+
+                if (existente < 0) {
+                    int custo = tamanhoFuncaoIr(chamada);
+                    if (nCopias[alvo] == MAX_VERSOES || custo > TAMANHO_MAXIMO || custo > orcamento) continue;
+                    v.copia = criarCopia(p, &v, nCopias[alvo] + 1);
+                    if (v.copia < 0) continue;
+
+                    orcamento -= custo;
+                    nCopias[alvo]++;
+                    versoes = realloc(versoes, (nVersoes + 1) * sizeof(Versao));
+                    versoes[nVersoes] = v;
+                    existente = nVersoes++;
+                }
+
+                call->simbolo = p->funcoes[versoes[existente].copia]->simbolo;
+                mudou = true;
+            }
+        }
+    }
+
+    free(versoes);
+    free(nCopias);
+    liberarGrafoChamadas(g);
+    return mudou;
+}
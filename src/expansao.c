@@ -0,0 +1,218 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "otimizacao.h"
+
+// ==============================================
+// EXPANSÃO DE CHAMADAS (INLINING)
+// ==============================================
+//
+// O corpo de uma função pequena e não recursiva é copiado no lugar da
+// chamada: os parâmetros viram os argumentos (endereços, no caso de &id,
+// id[] e strings, então o corpo copiado lê e grava a memória de quem
+// chama), os slots entram no quadro de quem chama e cada ret vira um salto
+// para o resto do bloco, com um phi juntando os valores devolvidos.
+//
+// Custo: instruções que viram código no corpo. Benefício: a sequência de
+// chamada que some e os usos de parâmetros que recebem constantes (que o
+// dobramento vai resolver). Expande quando custo - benefício <= limite.
+
+#define LIMITE_PADRAO 30
+
+// Quem chama não cresce além disto por expansões
+#define TAMANHO_MAXIMO 2000
+
+static int limiteExpansao = LIMITE_PADRAO;
+
+void definirLimiteExpansao(int limite) {
+    limiteExpansao = limite;
+}
+
+// ===================
+// Custo
+// ===================
+
+int tamanhoFuncaoIr(const FuncaoIr* f) {
+    int tamanho = 0;
+    for (int b = 0; b < f->nBlocos; b++) {
+        for (InstrIr* i = f->blocos[b]->primeira; i; i = i->prox) {
+            switch (i->op) {
+                case IR_PARAM:
+                case IR_CONST:
+                case IR_PHI:
+                case IR_LOCAL:
+                case IR_GLOBAL:
+                case IR_CONST_STR:
+                case IR_FUNCAO:
+                    break;
+                case IR_CALL:
+                    tamanho += 1 + i->nArgs;
+                    break;
+                default:
+                    tamanho++;
+                    break;
+            }
+        }
+    }
+    return tamanho;
+}
+
+static bool temRetorno(const FuncaoIr* f) {
+    for (int b = 0; b < f->nBlocos; b++) {
+        InstrIr* t = terminadorIr(f->blocos[b]);
+        if (t && t->op == IR_RET) return true;
+    }
+    return false;
+}
+
+static int beneficio(const InstrIr* call, const FuncaoIr* chamada) {
+    int ganho = 2 + call->nArgs;
+
+    for (InstrIr* i = chamada->blocos[0]->primeira; i; i = i->prox) {
+        if (i->op == IR_PARAM && call->args[i->indice]->op == IR_CONST) ganho += 2 * i->nUsos;
+    }
+    return ganho;
+}
+
+bool expansaoCompensa(const InstrIr* call, const FuncaoIr* chamada) {
+    return temRetorno(chamada) && tamanhoFuncaoIr(chamada) - beneficio(call, chamada) <= limiteExpansao;
+}
+
+// ===================
+// Cópia do corpo
+// ===================
+
+static void copiarCampos(InstrIr* copia, const InstrIr* i) {
+    copia->imm = i->imm;
+    copia->cond = i->cond;
+    copia->indice = i->indice;
+    copia->simbolo = i->simbolo;
+    copia->runtime = i->runtime;
+    copia->escala = i->escala;
+    copia->tamanho = i->tamanho;
+    copia->linha = i->linha;
+}
+
+// Substitui 'call' pelo corpo de 'chamada'
+static void expandir(FuncaoIr* f, InstrIr* call, const FuncaoIr* chamada) {
+    BlocoIr* origem = call->bloco;
+    BlocoIr* resto = dividirBlocoIr(f, call->prox);
+    int baseSlots = f->nSlots;
+    int nb = chamada->nBlocos;
+
+    for (int s = 0; s < chamada->nSlots; s++) {
+        novoSlotIr(f, chamada->slots[s].tamanho, chamada->slots[s].alinhamento, chamada->slots[s].simbolo);
+    }
+
+    BlocoIr** blocos = malloc(nb * sizeof(BlocoIr*));
+    for (int b = 0; b < nb; b++) {
+        blocos[b] = novoBlocoIr(f);
+        blocos[b]->paralelo = chamada->blocos[b]->paralelo;
+    }
+
+    InstrIr** valor = calloc(chamada->nValores, sizeof(InstrIr*));
+    InstrIr** retornos = malloc(nb * sizeof(InstrIr*));
+    int nRetornos = 0;
+
+    // Instruções sem operandos primeiro: um phi pode usar um valor definido mais adiante
+    for (int b = 0; b < nb; b++) {
+        const BlocoIr* bloco = chamada->blocos[b];
+        for (int p = 0; p < bloco->nPreds; p++) adicionarPredIr(blocos[b], blocos[bloco->preds[p]->id]);
+
+        for (InstrIr* i = bloco->primeira; i; i = i->prox) {
+            if (i->op == IR_PARAM) {
+                valor[i->id] = call->args[i->indice];
+                continue;
+            }
+
+            InstrIr* copia;
+            if (i->op == IR_RET) {
+                copia = novaInstrIr(f, IR_JMP, IR_VOID);
+                copia->alvos[0] = resto;
+                copia->linha = i->linha;
+                adicionarPredIr(resto, blocos[b]);
+                retornos[nRetornos++] = i;
+            } else {
+                copia = novaInstrIr(f, i->op, i->tipo);
+                copiarCampos(copia, i);
+                if (i->op == IR_LOCAL) copia->indice += baseSlots;
+                for (int k = 0; k < 2; k++) {
+                    if (i->alvos[k]) copia->alvos[k] = blocos[i->alvos[k]->id];
+                }
+            }
+            anexarInstrIr(blocos[b], copia);
+            valor[i->id] = copia;
+        }
+    }
+
+    for (int b = 0; b < nb; b++) {
+        for (InstrIr* i = chamada->blocos[b]->primeira; i; i = i->prox) {
+            if (i->op == IR_PARAM || i->op == IR_RET) continue;
+            for (int a = 0; a < i->nArgs; a++) adicionarArgIr(valor[i->id], valor[i->args[a]->id]);
+        }
+    }
+
+    // O valor devolvido: direto se há um só ret, senão um phi no resto do bloco
+    if (call->tipo != IR_VOID) {
+        InstrIr* resultado;
+        if (nRetornos == 1) {
+            resultado = valor[retornos[0]->args[0]->id];
+        } else {
+            resultado = novaInstrIr(f, IR_PHI, call->tipo);
+            resultado->linha = call->linha;
+            for (int r = 0; r < nRetornos; r++) adicionarArgIr(resultado, valor[retornos[r]->args[0]->id]);
+            inserirAntesIr(resto->primeira, resultado);
+        }
+        substituirUsosIr(call, resultado);
+    }
+
+    InstrIr* jmp = novaInstrIr(f, IR_JMP, IR_VOID);
+    jmp->alvos[0] = blocos[0];
+    jmp->linha = call->linha;
+    removerInstrIr(call);
+    anexarInstrIr(origem, jmp);
+    adicionarPredIr(blocos[0], origem);
+
+    free(blocos);
+    free(valor);
+    free(retornos);
+}
+
+// ===================
+// Passe
+// ===================
+
+bool expandirChamadas(const ProgramaIr* p, FuncaoIr* f, const GrafoChamadas* g) {
+    int capCandidatas = 16, nCandidatas = 0;
+    InstrIr** candidatas = malloc(capCandidatas * sizeof(InstrIr*));
+    int tamanho = tamanhoFuncaoIr(f);
+    bool mudou = false;
+
+    // Junta as chamadas antes: a expansão cria blocos e mexe na lista de f
+    for (int b = 0; b < f->nBlocos; b++) {
+        for (InstrIr* i = f->blocos[b]->primeira; i; i = i->prox) {
+            if (i->op != IR_CALL || i->simbolo < 0) continue;
+            if (nCandidatas == capCandidatas) {
+                candidatas = realloc(candidatas, (capCandidatas *= 2) * sizeof(InstrIr*));
+            }
+            candidatas[nCandidatas++] = i;
+        }
+    }
+
+    for (int k = 0; k < nCandidatas; k++) {
+        InstrIr* call = candidatas[k];
+        int alvo = funcaoDeSimbolo(p, call->simbolo);
+        if (alvo < 0 || g->recursiva[alvo] || p->funcoes[alvo] == f) continue;
+
+        const FuncaoIr* chamada = p->funcoes[alvo];
+        int custo = tamanhoFuncaoIr(chamada);
+        if (!expansaoCompensa(call, chamada) || tamanho + custo > TAMANHO_MAXIMO) continue;
+
+        expandir(f, call, chamada);
+        tamanho += custo;
+        mudou = true;
+    }
+
+    free(candidatas);
+    return mudou;
+}
@@ -0,0 +1,342 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "otimizacao.h"
+
+// ==============================================
+// FUSÃO DE LAÇOS
+// ==============================================
+//
+// Dois laços contados seguidos com a mesma variável (mesmo início, passo,
+// comparação e limite) viram um só: o corpo do segundo passa a rodar logo
+// depois do corpo do primeiro, na mesma volta. Um vetor gravado pelo
+// primeiro e lido pelo segundo (b[i] = a[i] * 2; c[i] = b[i] + 1) passa
+// pela memória uma vez só. A numeração de valores troca a leitura de b[i]
+// pelo valor recém-gravado e, se b é um vetor local que ninguém mais lê,
+// as gravações somem.
+//
+// Condições:
+// - cada laço tem um cabeçalho que é a única saída e uma única aresta de
+//   volta; o cabeçalho do segundo só tem phi, a comparação e o desvio;
+// - entre os dois só há o pré-cabeçalho do segundo, com contas que podem
+//   ir para antes do primeiro;
+// - o segundo não usa nada calculado no primeiro;
+// - nenhuma chamada com efeitos, e só um dos dois pode interromper o
+//   programa (a mensagem de erro seria outra);
+// - nenhum dos dois é um 'parallel for': a independência declarada vale
+//   para as voltas de um laço, não para o corpo dos dois juntos;
+// - para cada par de acessos que podem se sobrepor, com uma gravação, os
+//   dois são v[i + c] no mesmo vetor e o elemento é tocado pelo segundo
+//   laço na mesma volta ou numa volta seguinte (c do segundo <= c do
+//   primeiro): a ordem das leituras e gravações de cada elemento não muda.
+
+typedef struct {
+    LacoIr* l;
+    BlocoIr* cabecalho;
+    InstrIr* desvio;        // br do cabeçalho
+    int corpo;              // alvo do desvio que fica no laço
+    InstrIr* iv;            // phi da variável do laço
+    InstrIr* inicio;
+    int passo;              // somado a cada volta
+    InstrIr* limite;
+    BlocoIr* trava;         // bloco da aresta de volta (termina em jmp)
+    int fora, volta;        // índices dos predecessores do cabeçalho
+} Contado;
+
+typedef struct {
+    const InstrIr* end;
+    bool grava;
+} Acesso;
+
+typedef struct {
+    Acesso* itens;
+    int n;
+    int cap;
+} Acessos;
+
+static bool noLaco(const LacoIr* l, const BlocoIr* b) {
+    return l->contem[b->id];
+}
+
+static bool mesmaConstante(const InstrIr* a, const InstrIr* b) {
+    return a == b || (a->op == IR_CONST && b->op == IR_CONST && a->tipo == b->tipo && a->imm.i == b->imm.i);
+}
+
+// ===================
+// Forma dos laços
+// ===================
+
+// Laço contado: cabeçalho com 'cmp iv, limite' e saída única por ele
+static bool reconhecer(LacoIr* l, Contado* c) {
+    BlocoIr* h = l->cabecalho;
+    c->l = l;
+    c->cabecalho = h;
+    if (h->nPreds != 2 || h->paralelo) return false;
+
+    c->fora = h->preds[0] == l->preCabecalho ? 0 : 1;
+    c->volta = 1 - c->fora;
+    c->trava = h->preds[c->volta];
+    if (c->trava == h || terminadorIr(c->trava)->op != IR_JMP) return false;
+
+    c->desvio = terminadorIr(h);
+    if (c->desvio->op != IR_BR) return false;
+    c->corpo = noLaco(l, c->desvio->alvos[0]) ? 0 : 1;
+    if (noLaco(l, c->desvio->alvos[1 - c->corpo]) || !noLaco(l, c->desvio->alvos[c->corpo])) return false;
+
+    // A única saída é a do cabeçalho
+    for (int b = 0; b < l->nBlocos; b++) {
+        if (l->blocos[b] == h) continue;
+        BlocoIr* succ[2];
+        int ns = sucessoresIr(l->blocos[b], succ);
+        for (int s = 0; s < ns; s++) {
+            if (!noLaco(l, succ[s])) return false;
+        }
+    }
+
+    const InstrIr* cmp = c->desvio->args[0];
+    if (cmp->op != IR_CMP || cmp->bloco != h) return false;
+    c->iv = cmp->args[0];
+    c->limite = cmp->args[1];
+    if (c->iv->op != IR_PHI || c->iv->bloco != h || noLaco(l, c->limite->bloco)) return false;
+
+    c->inicio = c->iv->args[c->fora];
+    const InstrIr* prox = c->iv->args[c->volta];
+    if ((prox->op != IR_ADD && prox->op != IR_SUB) || prox->args[0] != c->iv || prox->args[1]->op != IR_CONST) return false;
+    c->passo = prox->op == IR_ADD ? prox->args[1]->imm.i : -prox->args[1]->imm.i;
+    return true;
+}
+
+static bool mesmoEspaco(const Contado* a, const Contado* b) {
+    const InstrIr* ca = a->desvio->args[0];
+    const InstrIr* cb = b->desvio->args[0];
+    return ca->cond == cb->cond && a->corpo == b->corpo && mesmaConstante(a->inicio, b->inicio)
+           && a->passo == b->passo && mesmaConstante(a->limite, b->limite);
+}
+
+// ===================
+// Dependências
+// ===================
+
+static void adicionarAcesso(Acessos* a, const InstrIr* end, bool grava) {
+    if (a->n == a->cap) {
+        a->cap = a->cap ? a->cap * 2 : 16;
+        a->itens = realloc(a->itens, a->cap * sizeof(Acesso));
+    }
+    a->itens[a->n++] = (Acesso){ end, grava };
+}
+
+// Acessos à memória dos blocos; false se há chamada com efeitos
+static bool juntarAcessos(BlocoIr** blocos, int n, Acessos* a, bool* podeFalhar) {
+    for (int b = 0; b < n; b++) {
+        for (const InstrIr* i = blocos[b]->primeira; i; i = i->prox) {
+            switch (i->op) {
+                case IR_LOAD:
+                    adicionarAcesso(a, i->args[0], false);
+                    break;
+                case IR_COPIAR:
+                    adicionarAcesso(a, i->args[1], false);
+                    // fallthrough
+                case IR_STORE:
+                case IR_ZERAR:
+                    adicionarAcesso(a, i->args[0], true);
+                    break;
+                case IR_CALL:
+                    if (!chamadaPura(i)) return false;
+                    *podeFalhar |= (efeitosDeChamada(i) & EFEITO_PODE_NAO_VOLTAR) != 0;
+                    break;
+                case IR_LIMITE:
+                    *podeFalhar = true;
+                    break;
+                case IR_DIV:
+                    *podeFalhar |= temEfeitoIr(i);
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+    return true;
+}
+
+static bool mesmoObjeto(const InstrIr* a, const InstrIr* b) {
+    if (a == b) return true;
+    if (a->op != b->op) return false;
+    if (a->op == IR_GLOBAL) return a->simbolo == b->simbolo;
+    if (a->op == IR_LOCAL) return a->indice == b->indice;
+    return false;
+}
+
+// end = base[iv + desloc]
+static bool afim(const InstrIr* end, const InstrIr* iv, const InstrIr** base, int* desloc) {
+    if (end->op != IR_ELEM) return false;
+    const InstrIr* idx = end->args[1];
+    *base = end->args[0];
+
+    if (idx == iv) {
+        *desloc = 0;
+        return true;
+    }
+    if ((idx->op == IR_ADD || idx->op == IR_SUB) && idx->args[0] == iv && idx->args[1]->op == IR_CONST) {
+        *desloc = idx->op == IR_ADD ? idx->args[1]->imm.i : -idx->args[1]->imm.i;
+        return true;
+    }
+    if (idx->op == IR_ADD && idx->args[1] == iv && idx->args[0]->op == IR_CONST) {
+        *desloc = idx->args[0]->imm.i;
+        return true;
+    }
+    return false;
+}
+
+// O acesso 'x' do primeiro laço e o 'y' do segundo continuam na mesma ordem
+// quando os corpos rodam juntos? O elemento tocado pelos dois precisa ser
+// alcançado pelo segundo na mesma volta ou numa seguinte
+static bool ordemMantida(const FuncaoIr* f, const Contado* a, const Acesso* x, const Contado* b, const Acesso* y) {
+    if (!x->grava && !y->grava) return true;
+    if (!podemSobreporIr(f, x->end, y->end)) return true;
+
+    const InstrIr *bx, *by;
+    int cx, cy;
+    if (!afim(x->end, a->iv, &bx, &cx) || !afim(y->end, b->iv, &by, &cy)) return false;
+    if (!mesmoObjeto(bx, by) || x->end->escala != y->end->escala) return false;
+
+    // Com passo negativo as voltas seguintes têm índices menores
+    return a->passo > 0 ? cy <= cx : a->passo < 0 ? cy >= cx : cy == cx;
+}
+
+// Nada do primeiro laço é usado nos blocos dados
+static bool independente(const LacoIr* l, BlocoIr** blocos, int n) {
+    for (int b = 0; b < n; b++) {
+        for (const InstrIr* i = blocos[b]->primeira; i; i = i->prox) {
+            for (int a = 0; a < i->nArgs; a++) {
+                if (noLaco(l, i->args[a]->bloco)) return false;
+            }
+        }
+    }
+    return true;
+}
+
+// O pré-cabeçalho do segundo laço pode ir para antes do primeiro
+static bool intermediarioMovel(BlocoIr* s, const Contado* a) {
+    if (s->nPreds != 1 || s->preds[0] != a->cabecalho) return false;
+    for (const InstrIr* i = s->primeira; i; i = i->prox) {
+        if (i == s->ultima) break;
+        if (i->op == IR_PHI || temEfeitoIr(i)) return false;
+    }
+    return true;
+}
+
+// Um laço interno pode não terminar: conta como interrupção
+static bool temInterno(const LacoIr* l, LacoIr** lacos, int n) {
+    for (int k = 0; k < n; k++) {
+        if (lacos[k]->pai == l) return true;
+    }
+    return false;
+}
+
+static bool podeFundir(const FuncaoIr* f, const Contado* a, const Contado* b, LacoIr** lacos, int n) {
+    BlocoIr* s = b->l->preCabecalho;
+    if (a->desvio->alvos[1 - a->corpo] != s || !intermediarioMovel(s, a) || !mesmoEspaco(a, b)) return false;
+
+    // O cabeçalho do segundo some: só pode ter phi e a comparação
+    for (const InstrIr* i = b->cabecalho->primeira; i; i = i->prox) {
+        if (i->op != IR_PHI && i != b->desvio && i != b->desvio->args[0]) return false;
+    }
+    if (b->desvio->args[0]->nUsos != 1) return false;
+
+    if (!independente(a->l, b->l->blocos, b->l->nBlocos) || !independente(a->l, &s, 1)) return false;
+
+    Acessos xa = { NULL, 0, 0 }, xb = { NULL, 0, 0 };
+    bool falhaA = temInterno(a->l, lacos, n), falhaB = temInterno(b->l, lacos, n);
+    bool ok = juntarAcessos(a->l->blocos, a->l->nBlocos, &xa, &falhaA)
+              && juntarAcessos(b->l->blocos, b->l->nBlocos, &xb, &falhaB)
+              && juntarAcessos(&s, 1, &xb, &falhaB)
+              && !(falhaA && falhaB);
+
+    for (int x = 0; x < xa.n && ok; x++) {
+        for (int y = 0; y < xb.n && ok; y++) ok = ordemMantida(f, a, &xa.itens[x], b, &xb.itens[y]);
+    }
+
+    free(xa.itens);
+    free(xb.itens);
+    return ok;
+}
+
+// ===================
+// Fusão
+// ===================
+
+static void trocarPred(BlocoIr* b, BlocoIr* antigo, BlocoIr* novo) {
+    b->preds[indicePredIr(b, antigo)] = novo;
+}
+
+static void fundir(FuncaoIr* f, const Contado* a, const Contado* b) {
+    BlocoIr* s = b->l->preCabecalho;
+    BlocoIr* h = a->cabecalho;
+    BlocoIr* entrada = b->desvio->alvos[b->corpo];
+    BlocoIr* saida = b->desvio->alvos[1 - b->corpo];
+
+    // O que estava entre os dois laços vai para antes do primeiro
+    InstrIr* destino = terminadorIr(a->l->preCabecalho);
+    while (s->primeira != s->ultima) moverInstrIr(s->primeira, destino);
+
+    // Os phi do segundo cabeçalho passam para o primeiro, na ordem dos predecessores dele
+    substituirUsosIr(b->iv, a->iv);
+    for (InstrIr* phi = b->cabecalho->primeira; phi && phi->op == IR_PHI; phi = phi->prox) {
+        if (phi == b->iv) continue;
+        InstrIr* novo = novaInstrIr(f, IR_PHI, phi->tipo);
+        novo->linha = phi->linha;
+        for (int p = 0; p < h->nPreds; p++) adicionarArgIr(novo, phi->args[p == a->fora ? b->fora : b->volta]);
+        inserirAntesIr(h->primeira, novo);
+        substituirUsosIr(phi, novo);
+    }
+
+    // Volta do primeiro -> corpo do segundo -> volta do segundo -> cabeçalho do primeiro
+    terminadorIr(a->trava)->alvos[0] = entrada;
+    trocarPred(entrada, b->cabecalho, a->trava);
+    terminadorIr(b->trava)->alvos[0] = h;
+    h->preds[a->volta] = b->trava;
+
+    // A saída do primeiro passa a ser a do segundo
+    a->desvio->alvos[1 - a->corpo] = saida;
+    trocarPred(saida, b->cabecalho, h);
+
+    removerBlocosInalcancaveisIr(f);
+}
+
+// ===================
+// Passe
+// ===================
+
+// Funde um par de laços seguidos; devolve se achou algum
+static bool fundirPar(FuncaoIr* f, LacoIr** lacos, int n) {
+    for (int k = 0; k < n; k++) {
+        Contado a;
+        if (!reconhecer(lacos[k], &a)) continue;
+
+        for (int j = 0; j < n; j++) {
+            Contado b;
+            if (j == k || lacos[j]->preCabecalho != a.desvio->alvos[1 - a.corpo]) continue;
+            if (!reconhecer(lacos[j], &b) || !podeFundir(f, &a, &b, lacos, n)) continue;
+
+            fundir(f, &a, &b);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Cada fusão muda os blocos: os laços são encontrados de novo (o laço
+// fundido ainda pode se juntar ao seguinte)
+bool fundirLacos(FuncaoIr* f) {
+    bool mudou = false;
+    bool progresso = true;
+
+    while (progresso) {
+        int n;
+        LacoIr** lacos = encontrarLacosIr(f, &n);
+        progresso = fundirPar(f, lacos, n);
+        liberarLacosIr(lacos, n);
+        mudou |= progresso;
+    }
+    return mudou;
+}
@@ -0,0 +1,313 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "otimizacao.h"
+
+// ==============================================
+// IDIOMAS DE LAÇO
+// ==============================================
+//
+// Laços 'for (i = a; i < b; i = i + 1)' que só fazem uma coisa conhecida
+// com um vetor inteiro (ou um trecho dele) viram uma chamada ao runtime,
+// que faz o mesmo trabalho em blocos (palavras de 64 bits, memset, memcpy):
+//
+// - v[i] = x, com v bool e x invariante: csrt_bits_preencher(v, a, b, x);
+// - if (v[i]) c = c + 1 (ou if (!v[i])): c += csrt_bits_contar(v, a, b, valor);
+// - v[i] = k, com k um char invariante ou uma constante de bytes iguais
+//   (0, -1, 0.0): csrt_mem_preencher(&v[a], byte, b - a, tamanho);
+// - v[i] = w[i], com v e w sem memória em comum:
+//   csrt_mem_copiar(&v[a], &w[a], b - a, tamanho).
+//
+// O laço inteiro some. Por isso nada mais pode acontecer nele, e a
+// variável i não pode ser usada depois (o valor final dela não é refeito).
+// Com -fbounds-check, o laço só é trocado se as verificações já tiverem
+// sido eliminadas.
+
+typedef struct {
+    LacoIr* l;
+    BlocoIr* corpo;         // alvo do desvio do cabeçalho que fica no laço
+    BlocoIr* trava;         // bloco da aresta de volta
+    BlocoIr* saida;
+    int fora, volta;        // posições do pré-cabeçalho e da volta nos preds do cabeçalho
+    InstrIr* iv;
+    InstrIr* prox;          // iv + 1
+    InstrIr* inicio;
+    InstrIr* limite;
+} Forma;
+
+static bool noLaco(const LacoIr* l, const InstrIr* i) {
+    return l->contem[i->bloco->id];
+}
+
+static bool ehConstante(const InstrIr* i, int32_t valor) {
+    return i->op == IR_CONST && i->tipo == IR_I32 && i->imm.i == valor;
+}
+
+// ===================
+// Forma do laço
+// ===================
+
+// Cabeçalho com phi, 'i < limite' e o desvio; i avança de 1 em 1 na volta
+static bool analisarForma(LacoIr* l, Forma* fm) {
+    BlocoIr* h = l->cabecalho;
+    fm->l = l;
+    if (h->nPreds != 2) return false;
+    fm->fora = h->preds[0] == l->preCabecalho ? 0 : 1;
+    fm->volta = 1 - fm->fora;
+    fm->trava = h->preds[fm->volta];
+
+    InstrIr* br = terminadorIr(h);
+    InstrIr* cmp = br->op == IR_BR ? br->args[0] : NULL;
+    if (!cmp || cmp->op != IR_CMP || cmp->bloco != h || cmp->cond != COND_LT || cmp->nUsos != 1) return false;
+    if (!l->contem[br->alvos[0]->id] || l->contem[br->alvos[1]->id]) return false;
+    fm->corpo = br->alvos[0];
+    fm->saida = br->alvos[1];
+
+    for (InstrIr* i = h->primeira; i; i = i->prox) {
+        if (i->op != IR_PHI && i != cmp && i != br) return false;
+    }
+
+    fm->iv = cmp->args[0];
+    fm->limite = cmp->args[1];
+    if (fm->iv->op != IR_PHI || fm->iv->bloco != h || fm->iv->tipo != IR_I32 || noLaco(l, fm->limite)) return false;
+    fm->inicio = fm->iv->args[fm->fora];
+
+    fm->prox = fm->iv->args[fm->volta];
+    if (fm->prox->op != IR_ADD || fm->prox->args[0] != fm->iv || !ehConstante(fm->prox->args[1], 1)) return false;
+
+    // A única saída é a do cabeçalho, e i não é usado depois
+    for (int b = 0; b < l->nBlocos; b++) {
+        BlocoIr* succ[2];
+        int ns = sucessoresIr(l->blocos[b], succ);
+        for (int s = 0; s < ns; s++) {
+            if (l->blocos[b] != h && !l->contem[succ[s]->id]) return false;
+        }
+    }
+    for (int u = 0; u < fm->iv->nUsos; u++) {
+        if (!noLaco(l, fm->iv->usos[u])) return false;
+    }
+    return terminadorIr(fm->trava)->op == IR_JMP;
+}
+
+// v[i] de um vetor bool que não muda no laço
+static bool bitDoLaco(const Forma* fm, const InstrIr* end) {
+    return end->op == IR_ELEM && end->escala == 0 && end->args[1] == fm->iv && !noLaco(fm->l, end->args[0]);
+}
+
+// O bloco só tem as instruções dadas (e o terminador)
+static bool soContem(const BlocoIr* b, InstrIr* const* instrs, int n) {
+    for (const InstrIr* i = b->primeira; i != b->ultima; i = i->prox) {
+        bool achou = false;
+        for (int k = 0; k < n && !achou; k++) achou = instrs[k] == i;
+        if (!achou) return false;
+    }
+    return true;
+}
+
+// ===================
+// Reescrita
+// ===================
+
+static InstrIr* chamarAntes(FuncaoIr* f, InstrIr* pos, const char* nome, TipoIr tipo, InstrIr** args, int n) {
+    InstrIr* call = novaInstrIr(f, IR_CALL, tipo);
+    call->simbolo = -1;
+    call->runtime = nome;
+    call->linha = pos->linha;
+    for (int a = 0; a < n; a++) adicionarArgIr(call, args[a]);
+    inserirAntesIr(pos, call);
+    return call;
+}
+
+// O pré-cabeçalho passa a ir direto para a saída; os blocos do laço ficam inalcançáveis
+static void removerLaco(FuncaoIr* f, const Forma* fm) {
+    BlocoIr* pre = fm->l->preCabecalho;
+    terminadorIr(pre)->alvos[0] = fm->saida;
+    fm->saida->preds[indicePredIr(fm->saida, fm->l->cabecalho)] = pre;
+    removerBlocosInalcancaveisIr(f);
+}
+
+// &v[inicio], do mesmo tipo de elemento que 'elem'
+static InstrIr* elementoInicial(FuncaoIr* f, InstrIr* pos, const Forma* fm, const InstrIr* elem) {
+    InstrIr* e = novaInstrIr(f, IR_ELEM, IR_PTR);
+    e->escala = elem->escala;
+    e->linha = pos->linha;
+    adicionarArgIr(e, elem->args[0]);
+    adicionarArgIr(e, fm->inicio);
+    inserirAntesIr(pos, e);
+    return e;
+}
+
+static InstrIr* constanteAntes(FuncaoIr* f, InstrIr* pos, int32_t valor) {
+    InstrIr* c = novaInstrIr(f, IR_CONST, IR_I32);
+    c->imm.i = valor;
+    inserirAntesIr(pos, c);
+    return c;
+}
+
+// Número de elementos do laço (negativo quando ele não roda)
+static InstrIr* voltasAntes(FuncaoIr* f, InstrIr* pos, const Forma* fm) {
+    InstrIr* n = novaInstrIr(f, IR_SUB, IR_I32);
+    n->linha = pos->linha;
+    adicionarArgIr(n, fm->limite);
+    adicionarArgIr(n, fm->inicio);
+    inserirAntesIr(pos, n);
+    return n;
+}
+
+// O corpo (que é a trava) só tem o elem, o store e o avanço de i
+static InstrIr* storeUnico(const Forma* fm) {
+    if (fm->l->nBlocos != 2 || fm->corpo != fm->trava || fm->iv->bloco->primeira->prox->op == IR_PHI) return NULL;
+
+    InstrIr* st = NULL;
+    for (InstrIr* i = fm->corpo->primeira; i && !st; i = i->prox) {
+        if (i->op == IR_STORE) st = i;
+    }
+    return st;
+}
+
+// Byte que, repetido, forma o valor gravado (-1 se não há)
+static int byteRepetido(const InstrIr* valor, int escala) {
+    if (escala == 1) return 0;
+    if (valor->op != IR_CONST) return -1;
+    uint32_t u = (uint32_t)valor->imm.i;
+    return (u & 0xFF) * 0x01010101u == u ? (int)(u & 0xFF) : -1;
+}
+
+// v[i] = x
+static bool preencher(FuncaoIr* f, const Forma* fm) {
+    InstrIr* st = storeUnico(fm);
+    if (!st) return false;
+    InstrIr* e = st->args[0];
+    InstrIr* x = st->args[1];
+    if (e->op != IR_ELEM || e->args[1] != fm->iv || noLaco(fm->l, e->args[0]) || noLaco(fm->l, x) || e->nUsos != 1) {
+        return false;
+    }
+
+    InstrIr* corpo[] = { e, st, fm->prox };
+    if (!soContem(fm->corpo, corpo, 3)) return false;
+
+    InstrIr* pos = terminadorIr(fm->l->preCabecalho);
+    if (e->escala == 0) {
+        InstrIr* args[] = { e->args[0], fm->inicio, fm->limite, x };
+        chamarAntes(f, pos, "csrt_bits_preencher", IR_VOID, args, 4);
+    } else {
+        int byte = byteRepetido(x, e->escala);
+        if (byte < 0 || ehVetorIr(x->tipo)) return false;
+        InstrIr* valor = e->escala == 1 ? x : constanteAntes(f, pos, byte);
+        InstrIr* args[] = { elementoInicial(f, pos, fm, e), valor, voltasAntes(f, pos, fm), constanteAntes(f, pos, e->escala) };
+        chamarAntes(f, pos, "csrt_mem_preencher", IR_VOID, args, 4);
+    }
+    removerLaco(f, fm);
+    return true;
+}
+
+// v[i] = w[i]
+static bool copiar(FuncaoIr* f, const Forma* fm) {
+    InstrIr* st = storeUnico(fm);
+    if (!st) return false;
+    InstrIr* destino = st->args[0];
+    InstrIr* x = st->args[1];
+    if (x->op != IR_LOAD || x->nUsos != 1 || ehVetorIr(x->tipo)) return false;
+    InstrIr* origem = x->args[0];
+
+    bool elementos = destino->op == IR_ELEM && origem->op == IR_ELEM && destino->escala > 0
+                     && destino->escala == origem->escala && destino->args[1] == fm->iv && origem->args[1] == fm->iv;
+    if (!elementos || noLaco(fm->l, destino->args[0]) || noLaco(fm->l, origem->args[0])) return false;
+    if (destino->nUsos != 1 || origem->nUsos != 1 || podemSobreporIr(f, destino, origem)) return false;
+
+    InstrIr* corpo[] = { origem, x, destino, st, fm->prox };
+    if (!soContem(fm->corpo, corpo, 5)) return false;
+
+    InstrIr* pos = terminadorIr(fm->l->preCabecalho);
+    InstrIr* args[] = { elementoInicial(f, pos, fm, destino), elementoInicial(f, pos, fm, origem), voltasAntes(f, pos, fm),
+                        constanteAntes(f, pos, destino->escala) };
+    chamarAntes(f, pos, "csrt_mem_copiar", IR_VOID, args, 4);
+    removerLaco(f, fm);
+    return true;
+}
+
+// if (v[i]) c = c + 1: cabeçalho, teste, soma e junção (a trava)
+static bool contarBits(FuncaoIr* f, const Forma* fm) {
+    BlocoIr* teste = fm->corpo;
+    BlocoIr* juncao = fm->trava;
+    InstrIr* br = terminadorIr(teste);
+    if (fm->l->nBlocos != 4 || br->op != IR_BR || juncao->nPreds != 2) return false;
+
+    int lado = br->alvos[0] == juncao ? 1 : 0;        // alvo do desvio que soma
+    BlocoIr* soma = br->alvos[lado];
+    if (br->alvos[1 - lado] != juncao || soma->nPreds != 1 || terminadorIr(soma)->op != IR_JMP
+        || terminadorIr(soma)->alvos[0] != juncao) {
+        return false;
+    }
+
+    InstrIr* x = br->args[0];
+    if (x->op != IR_LOAD || x->bloco != teste || x->nUsos != 1 || !bitDoLaco(fm, x->args[0]) || x->args[0]->nUsos != 1) {
+        return false;
+    }
+
+    // Phi do contador no cabeçalho e na junção
+    BlocoIr* h = fm->l->cabecalho;
+    InstrIr* c = h->primeira == fm->iv ? fm->iv->prox : h->primeira;
+    if (c->op != IR_PHI || (c->prox->op == IR_PHI && c->prox != fm->iv) || c->tipo != IR_I32) return false;
+    if (c->prox == fm->iv && fm->iv->prox->op == IR_PHI) return false;
+
+    InstrIr* cj = c->args[fm->volta];
+    if (cj->op != IR_PHI || cj->bloco != juncao || cj->nUsos != 1 || cj->prox != fm->prox) return false;
+
+    InstrIr* incremento = cj->args[indicePredIr(juncao, soma)];
+    if (cj->args[indicePredIr(juncao, teste)] != c || incremento->op != IR_ADD || incremento->bloco != soma
+        || incremento->nUsos != 1) {
+        return false;
+    }
+    bool mais1 = (incremento->args[0] == c && ehConstante(incremento->args[1], 1))
+                 || (incremento->args[1] == c && ehConstante(incremento->args[0], 1));
+    if (!mais1) return false;
+
+    InstrIr* instrsTeste[] = { x->args[0], x };
+    InstrIr* instrsSoma[] = { incremento };
+    InstrIr* instrsJuncao[] = { cj, fm->prox };
+    if (!soContem(teste, instrsTeste, 2) || !soContem(soma, instrsSoma, 1) || !soContem(juncao, instrsJuncao, 2)) {
+        return false;
+    }
+
+    // Valor inicial mais o que o laço contaria, para quem usa c depois dele
+    InstrIr* pos = terminadorIr(fm->l->preCabecalho);
+    InstrIr* args[] = { x->args[0]->args[0], fm->inicio, fm->limite, constanteAntes(f, pos, lado == 0 ? 1 : 0) };
+    InstrIr* n = chamarAntes(f, pos, "csrt_bits_contar", IR_I32, args, 4);
+    InstrIr* total = novaInstrIr(f, IR_ADD, IR_I32);
+    total->linha = n->linha;
+    adicionarArgIr(total, c->args[fm->fora]);
+    adicionarArgIr(total, n);
+    inserirAntesIr(pos, total);
+
+    // Os usos de dentro do laço somem com ele
+    substituirUsosIr(c, total);
+
+    removerLaco(f, fm);
+    return true;
+}
+
+// ===================
+// Passe
+// ===================
+
+// Cada troca remove blocos: os laços são encontrados de novo
+bool reconhecerIdiomas(FuncaoIr* f) {
+    bool mudou = false;
+    bool progresso = true;
+
+    while (progresso) {
+        int n;
+        LacoIr** lacos = encontrarLacosIr(f, &n);
+        progresso = false;
+        for (int k = 0; k < n && !progresso; k++) {
+            Forma fm;
+            if (!analisarForma(lacos[k], &fm)) continue;
+            progresso = preencher(f, &fm) || copiar(f, &fm) || contarBits(f, &fm);
+        }
+        liberarLacosIr(lacos, n);
+        mudou |= progresso;
+    }
+    return mudou;
+}
@@ -0,0 +1,176 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "otimizacao.h"
+
+// ==============================================
+// INVARIANTES DE LAÇO E REDUÇÃO DE FORÇA
+// ==============================================
+//
+// Invariantes: uma instrução sem efeito cujos operandos vêm todos de fora
+// do laço calcula o mesmo valor em toda volta e vai para o pré-cabeçalho.
+// Uma leitura de memória só sai quando nenhuma gravação ou chamada do laço
+// pode atingir o endereço (pela análise de alias) e a divisão inteira só
+// com divisor constante seguro, porque o pré-cabeçalho roda mesmo quando o
+// laço não dá nenhuma volta: pelo mesmo motivo, só saem leituras de
+// endereços que sempre existem (variáveis e elementos constantes dentro do
+// vetor).
+//
+// Redução de força: para uma variável de indução i (phi do cabeçalho que
+// soma um passo invariante a cada volta), i * k com k invariante vira uma
+// variável de indução própria j, que começa em i0 * k e soma passo * k a
+// cada volta. É o que sobra de a[i*k + j] depois que o laço interno tira
+// i*k para fora: a multiplicação do laço externo vira uma soma.
+
+static bool invariante(const LacoIr* l, const InstrIr* v) {
+    return !l->contem[v->bloco->id];
+}
+
+// Nenhuma instrução do laço grava onde o load lê
+static bool memoriaFixa(const FuncaoIr* f, const LacoIr* l, const InstrIr* load) {
+    const InstrIr* end = load->args[0];
+    for (int b = 0; b < l->nBlocos; b++) {
+        for (const InstrIr* i = l->blocos[b]->primeira; i; i = i->prox) {
+            if (i->op == IR_STORE || i->op == IR_ZERAR || i->op == IR_COPIAR) {
+                if (podemSobreporIr(f, i->args[0], end)) return false;
+            } else if (i->op == IR_CALL && chamadaPodeGravarIr(f, i, end)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static bool podeSair(const FuncaoIr* f, const LacoIr* l, const InstrIr* i) {
+    if (i->op == IR_LOAD) return enderecoValidoIr(i->args[0]) && invariante(l, i->args[0]) && memoriaFixa(f, l, i);
+    if (i->op == IR_PHI || ehTerminadorIr(i->op)) return false;
+    if (i->op == IR_DIV && i->tipo != IR_F32) {
+        const InstrIr* d = i->args[1];
+        return d->op == IR_CONST && d->imm.i != 0 && d->imm.i != -1;
+    }
+    return !temEfeitoIr(i);
+}
+
+// ===================
+// Invariantes
+// ===================
+
+static bool moverInvariantes(const FuncaoIr* f, LacoIr* l) {
+    InstrIr* destino = terminadorIr(l->preCabecalho);
+    bool mudou = false;
+    bool progresso = true;
+
+    // Em pós-ordem reversa a definição vem antes do uso, então quase sempre basta uma volta
+    while (progresso) {
+        progresso = false;
+        for (int b = 0; b < l->nBlocos; b++) {
+            InstrIr* i = l->blocos[b]->primeira;
+            while (i) {
+                InstrIr* prox = i->prox;
+                bool sai = podeSair(f, l, i);
+                for (int a = 0; a < i->nArgs && sai; a++) sai = invariante(l, i->args[a]);
+
+                if (sai) {
+                    moverInstrIr(i, destino);
+                    progresso = true;
+                }
+                i = prox;
+            }
+        }
+        mudou |= progresso;
+    }
+    return mudou;
+}
+
+// ===================
+// Redução de força
+// ===================
+
+static InstrIr* operacaoAntes(FuncaoIr* f, InstrIr* pos, OpIr op, InstrIr* a, InstrIr* b) {
+    InstrIr* i = novaInstrIr(f, op, a->tipo);
+    i->linha = pos->linha;
+    adicionarArgIr(i, a);
+    adicionarArgIr(i, b);
+    inserirAntesIr(pos, i);
+    return i;
+}
+
+// Troca 'mul' (= phi * fator) por uma variável de indução nova
+static void reduzir(FuncaoIr* f, LacoIr* l, InstrIr* phi, InstrIr* mul, InstrIr* fator, int fora, int volta) {
+    InstrIr* proximo = phi->args[volta];
+    InstrIr* preFim = terminadorIr(l->preCabecalho);
+    BlocoIr* trava = l->cabecalho->preds[volta];
+
+    InstrIr* inicio = operacaoAntes(f, preFim, IR_MUL, phi->args[fora], fator);
+    InstrIr* passo = operacaoAntes(f, preFim, IR_MUL, proximo->args[1], fator);
+
+    InstrIr* novo = novaInstrIr(f, IR_PHI, IR_I32);
+    novo->linha = mul->linha;
+    inserirAntesIr(l->cabecalho->primeira, novo);
+
+    // Soma no fim da volta, como a de i
+    InstrIr* seguinte = operacaoAntes(f, terminadorIr(trava), proximo->op, novo, passo);
+    for (int p = 0; p < l->cabecalho->nPreds; p++) adicionarArgIr(novo, p == fora ? inicio : seguinte);
+
+    substituirUsosIr(mul, novo);
+    removerInstrIr(mul);
+}
+
+// i: phi do cabeçalho com [i0, pré-cabeçalho] e [i + passo, volta] (ou i - passo)
+static bool ehInducao(const LacoIr* l, const InstrIr* phi, int volta) {
+    const InstrIr* prox = phi->args[volta];
+    if (phi->tipo != IR_I32 || (prox->op != IR_ADD && prox->op != IR_SUB)) return false;
+    return prox->args[0] == phi && invariante(l, prox->args[1]);
+}
+
+static bool reduzirInducoes(FuncaoIr* f, LacoIr* l) {
+    BlocoIr* h = l->cabecalho;
+    if (h->nPreds != 2) return false;
+
+    int fora = h->preds[0] == l->preCabecalho ? 0 : 1;
+    int volta = 1 - fora;
+    bool mudou = false;
+
+    for (InstrIr* phi = h->primeira; phi && phi->op == IR_PHI; phi = phi->prox) {
+        // i + passo com os operandos invertidos
+        InstrIr* prox = phi->args[volta];
+        if (prox->op == IR_ADD && prox->args[1] == phi && prox->args[0] != phi) {
+            InstrIr* passo = prox->args[0];
+            trocarArgIr(prox, 0, phi);
+            trocarArgIr(prox, 1, passo);
+        }
+        if (!ehInducao(l, phi, volta)) continue;
+
+        for (int u = 0; u < phi->nUsos; u++) {
+            InstrIr* mul = phi->usos[u];
+            if (mul->op != IR_MUL || mul->tipo != IR_I32 || !l->contem[mul->bloco->id]) continue;
+
+            InstrIr* fator = mul->args[0] == phi ? mul->args[1] : mul->args[0];
+            if (fator == phi || !invariante(l, fator)) continue;
+
+            reduzir(f, l, phi, mul, fator, fora, volta);
+            mudou = true;
+            u = -1;    // a lista de usos mudou
+        }
+    }
+    return mudou;
+}
+
+// ===================
+// Passe
+// ===================
+
+bool otimizarLacos(FuncaoIr* f) {
+    int n;
+    LacoIr** lacos = encontrarLacosIr(f, &n);
+    bool mudou = false;
+
+    // Dos internos para os externos: o que sai de um laço interno ainda pode sair do externo
+    for (int k = 0; k < n; k++) {
+        mudou |= moverInvariantes(f, lacos[k]);
+        mudou |= reduzirInducoes(f, lacos[k]);
+    }
+
+    liberarLacosIr(lacos, n);
+    return mudou;
+}
@@ -0,0 +1,1139 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+
+#include "ir.h"
+#include "constantes.h"
+
+// ===================
+// Tipos
+// ===================
+
+TipoIr tipoIrDe(TipoId t) {
+    switch (t) {
+        case TIPO_BOOL:  return IR_I1;
+        case TIPO_CHAR:  return IR_I8;
+        case TIPO_INT:   return IR_I32;
+        case TIPO_FLOAT: return IR_F32;
+        case TIPO_VOID:  return IR_VOID;
+        default:         return IR_PTR;   // vetores e strings são acessados pelo endereço
+    }
+}
+
+int bytesVetorIr(TipoId t, int tamanho) {
+    switch (tipoElemento(t)) {
+        case TIPO_BOOL: return (tamanho + 63) / 64 * 8;
+        case TIPO_CHAR: return tamanho;
+        default:        return tamanho * 4;
+    }
+}
+
+const char* nomeTipoIr(TipoIr t) {
+    static const char* nomes[] = { "void", "i1", "i8", "i32", "f32", "ptr", "v16i8", "v4i32", "v4f32" };
+    return nomes[t];
+}
+
+bool ehVetorIr(TipoIr t) {
+    return t == IR_V16I8 || t == IR_V4I32 || t == IR_V4F32;
+}
+
+TipoIr elementoIr(TipoIr t) {
+    switch (t) {
+        case IR_V16I8: return IR_I8;
+        case IR_V4I32: return IR_I32;
+        case IR_V4F32: return IR_F32;
+        default:       return t;
+    }
+}
+
+int faixasIr(TipoIr t) {
+    return t == IR_V16I8 ? 16 : ehVetorIr(t) ? 4 : 1;
+}
+
+TipoIr vetorDeIr(TipoIr elemento) {
+    switch (elemento) {
+        case IR_I8:  return IR_V16I8;
+        case IR_I32: return IR_V4I32;
+        case IR_F32: return IR_V4F32;
+        default:     return IR_VOID;
+    }
+}
+
+// ===================
+// Constantes
+// ===================
+//
+// int com aritmética de 32 bits em complemento de dois, char truncado para
+// 8 bits com sinal a cada operação, bool 0/1 e float em precisão simples.
+
+// Ajusta um resultado inteiro ao tipo (char trunca com sinal, bool é 0/1)
+static int32_t normalizar(TipoIr tipo, int32_t v) {
+    switch (tipo) {
+        case IR_I8: return (int8_t)v;
+        case IR_I1: return v != 0;
+        default:    return v;
+    }
+}
+
+// cvttss2si: NaN e valores fora do intervalo viram INT_MIN
+static int32_t truncarFloat(float x) {
+    if (x != x || x >= 2147483648.0f || x < -2147483648.0f) return INT32_MIN;
+    return (int32_t)x;
+}
+
+static bool compararInt(CondIr cond, int32_t a, int32_t b) {
+    switch (cond) {
+        case COND_EQ: return a == b;
+        case COND_NE: return a != b;
+        case COND_LT: return a < b;
+        case COND_GT: return a > b;
+        case COND_LE: return a <= b;
+        default:      return a >= b;
+    }
+}
+
+// Comparações com NaN são falsas, menos !=
+static bool compararFloat(CondIr cond, float a, float b) {
+    switch (cond) {
+        case COND_EQ: return a == b;
+        case COND_NE: return a != b;
+        case COND_LT: return a < b;
+        case COND_GT: return a > b;
+        case COND_LE: return a <= b;
+        default:      return a >= b;
+    }
+}
+
+bool calcularOperacaoIr(OpIr op, CondIr cond, TipoIr tipo, TipoIr tipoArgs, const ValorIr* args, ValorIr* r) {
+    switch (op) {
+        case IR_ADD:
+        case IR_SUB:
+        case IR_MUL:
+        case IR_DIV:
+            if (tipo == IR_F32) {
+                float x = args[0].f, y = args[1].f;
+                r->f = op == IR_ADD ? x + y : op == IR_SUB ? x - y : op == IR_MUL ? x * y : x / y;
+                return true;
+            } else {
+                uint32_t x = (uint32_t)args[0].i, y = (uint32_t)args[1].i;
+                int32_t v;
+                switch (op) {
+                    case IR_ADD: v = (int32_t)(x + y); break;
+                    case IR_SUB: v = (int32_t)(x - y); break;
+                    case IR_MUL: v = (int32_t)(x * y); break;
+                    default:
+                        if (args[1].i == 0 || (args[0].i == INT32_MIN && args[1].i == -1)) return false;
+                        v = args[0].i / args[1].i;
+                        break;
+                }
+                r->i = normalizar(tipo, v);
+                return true;
+            }
+
+        case IR_NEG:
+            if (tipo == IR_F32) r->f = -args[0].f;
+            else r->i = normalizar(tipo, (int32_t)(0u - (uint32_t)args[0].i));
+            return true;
+
+        case IR_NOT:
+            r->i = !args[0].i;
+            return true;
+
+        case IR_CMP:
+            r->i = tipoArgs == IR_F32 ? compararFloat(cond, args[0].f, args[1].f)
+                                      : compararInt(cond, args[0].i, args[1].i);
+            return true;
+
+        case IR_CONV:
+            if (tipo == IR_F32) r->f = tipoArgs == IR_F32 ? args[0].f : (float)args[0].i;
+            else if (tipoArgs != IR_F32) r->i = normalizar(tipo, args[0].i);
+            else if (tipo == IR_I1) r->i = args[0].f != 0.0f;
+            else r->i = normalizar(tipo, truncarFloat(args[0].f));
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+// ===================
+// Alocação
+// ===================
+
+static void* alocar(size_t n) {
+    void* p = calloc(1, n);
+    if (!p) {
+        fprintf(stderr, "Erro: memória insuficiente para a representação intermediária.\n");
+        exit(EXIT_FAILURE);
+    }
+    return p;
+}
+
+// Garante espaço para mais um elemento em um vetor dinâmico
+static void crescer(void** vetor, int n, int* cap, size_t tamElem) {
+    if (n < *cap) return;
+    *cap = *cap ? *cap * 2 : 4;
+    *vetor = realloc(*vetor, *cap * tamElem);
+    if (!*vetor) {
+        fprintf(stderr, "Erro: memória insuficiente para a representação intermediária.\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+FuncaoIr* novaFuncaoIr(const char* nome, int simbolo) {
+    FuncaoIr* f = alocar(sizeof(FuncaoIr));
+    f->nome = strdup(nome);
+    f->simbolo = simbolo;
+    return f;
+}
+
+BlocoIr* novoBlocoIr(FuncaoIr* f) {
+    BlocoIr* b = alocar(sizeof(BlocoIr));
+    b->id = f->nBlocos;
+    b->rpo = -1;
+
+    crescer((void**)&f->blocos, f->nBlocos, &f->capBlocos, sizeof(BlocoIr*));
+    f->blocos[f->nBlocos++] = b;
+    return b;
+}
+
+int novoSlotIr(FuncaoIr* f, int tamanho, int alinhamento, int simbolo) {
+    crescer((void**)&f->slots, f->nSlots, &f->capSlots, sizeof(SlotIr));
+    f->slots[f->nSlots].tamanho = tamanho;
+    f->slots[f->nSlots].alinhamento = alinhamento;
+    f->slots[f->nSlots].simbolo = simbolo;
+    return f->nSlots++;
+}
+
+InstrIr* novaInstrIr(FuncaoIr* f, OpIr op, TipoIr tipo) {
+    InstrIr* i = alocar(sizeof(InstrIr));
+    i->op = op;
+    i->tipo = tipo;
+    i->id = f->nValores++;
+    i->simbolo = -1;
+    return i;
+}
+
+// ===================
+// Operandos e usos
+// ===================
+
+static void adicionarUso(InstrIr* valor, InstrIr* usuario) {
+    crescer((void**)&valor->usos, valor->nUsos, &valor->capUsos, sizeof(InstrIr*));
+    valor->usos[valor->nUsos++] = usuario;
+}
+
+// Remove uma entrada de 'usuario' da lista de usos de 'valor'
+static void removerUso(InstrIr* valor, InstrIr* usuario) {
+    for (int i = 0; i < valor->nUsos; i++) {
+        if (valor->usos[i] == usuario) {
+            valor->usos[i] = valor->usos[--valor->nUsos];
+            return;
+        }
+    }
+}
+
+void adicionarArgIr(InstrIr* instr, InstrIr* arg) {
+    crescer((void**)&instr->args, instr->nArgs, &instr->capArgs, sizeof(InstrIr*));
+    instr->args[instr->nArgs++] = arg;
+    adicionarUso(arg, instr);
+}
+
+void trocarArgIr(InstrIr* instr, int i, InstrIr* novo) {
+    removerUso(instr->args[i], instr);
+    instr->args[i] = novo;
+    adicionarUso(novo, instr);
+}
+
+// Tira o operando i (usado nos phi quando um predecessor some)
+static void removerArg(InstrIr* instr, int i) {
+    removerUso(instr->args[i], instr);
+    for (int j = i; j < instr->nArgs - 1; j++) instr->args[j] = instr->args[j + 1];
+    instr->nArgs--;
+}
+
+void substituirUsosIr(InstrIr* antigo, InstrIr* novo) {
+    for (int u = 0; u < antigo->nUsos; u++) {
+        InstrIr* usuario = antigo->usos[u];
+        for (int j = 0; j < usuario->nArgs; j++) {
+            if (usuario->args[j] == antigo) {
+                usuario->args[j] = novo;
+                adicionarUso(novo, usuario);
+                break;
+            }
+        }
+    }
+    antigo->nUsos = 0;
+}
+
+// ===================
+// Instruções nos blocos
+// ===================
+
+void anexarInstrIr(BlocoIr* b, InstrIr* instr) {
+    instr->bloco = b;
+    instr->ant = b->ultima;
+    instr->prox = NULL;
+    if (b->ultima) b->ultima->prox = instr;
+    else b->primeira = instr;
+    b->ultima = instr;
+}
+
+void inserirAntesIr(InstrIr* pos, InstrIr* instr) {
+    BlocoIr* b = pos->bloco;
+    instr->bloco = b;
+    instr->prox = pos;
+    instr->ant = pos->ant;
+    if (pos->ant) pos->ant->prox = instr;
+    else b->primeira = instr;
+    pos->ant = instr;
+}
+
+static void desligarDoBloco(InstrIr* instr) {
+    BlocoIr* b = instr->bloco;
+    if (!b) return;
+
+    if (instr->ant) instr->ant->prox = instr->prox;
+    else b->primeira = instr->prox;
+    if (instr->prox) instr->prox->ant = instr->ant;
+    else b->ultima = instr->ant;
+    instr->bloco = NULL;
+    instr->ant = instr->prox = NULL;
+}
+
+void moverInstrIr(InstrIr* instr, InstrIr* pos) {
+    desligarDoBloco(instr);
+    inserirAntesIr(pos, instr);
+}
+
+static void liberarInstr(InstrIr* instr) {
+    free(instr->args);
+    free(instr->usos);
+    free(instr);
+}
+
+void desligarInstrIr(InstrIr* instr) {
+    desligarDoBloco(instr);
+    for (int i = 0; i < instr->nArgs; i++) removerUso(instr->args[i], instr);
+    instr->nArgs = 0;
+}
+
+void liberarInstrIr(InstrIr* instr) {
+    liberarInstr(instr);
+}
+
+void removerInstrIr(InstrIr* instr) {
+    desligarInstrIr(instr);
+    liberarInstr(instr);
+}
+
+// ===================
+// Grafo de fluxo
+// ===================
+
+bool ehTerminadorIr(OpIr op) {
+    return op == IR_JMP || op == IR_BR || op == IR_RET;
+}
+
+bool temEfeitoIr(const InstrIr* instr) {
+    switch (instr->op) {
+        case IR_STORE:
+        case IR_ZERAR:
+        case IR_COPIAR:
+        case IR_LIMITE:
+        case IR_CALL:
+        case IR_JMP:
+        case IR_BR:
+        case IR_RET:
+            return true;
+        case IR_DIV:
+            // Divisão inteira por zero interrompe o programa
+            return instr->tipo != IR_F32;
+        default:
+            return false;
+    }
+}
+
+void adicionarPredIr(BlocoIr* b, BlocoIr* pred) {
+    crescer((void**)&b->preds, b->nPreds, &b->capPreds, sizeof(BlocoIr*));
+    b->preds[b->nPreds++] = pred;
+}
+
+int indicePredIr(const BlocoIr* b, const BlocoIr* pred) {
+    for (int i = 0; i < b->nPreds; i++) {
+        if (b->preds[i] == pred) return i;
+    }
+    return -1;
+}
+
+InstrIr* terminadorIr(const BlocoIr* b) {
+    return b->ultima && ehTerminadorIr(b->ultima->op) ? b->ultima : NULL;
+}
+
+int sucessoresIr(const BlocoIr* b, BlocoIr* succ[2]) {
+    InstrIr* t = terminadorIr(b);
+    if (!t) return 0;
+
+    switch (t->op) {
+        case IR_JMP:
+            succ[0] = t->alvos[0];
+            return 1;
+        case IR_BR:
+            succ[0] = t->alvos[0];
+            succ[1] = t->alvos[1];
+            return succ[0] == succ[1] ? 1 : 2;
+        default:
+            return 0;
+    }
+}
+
+void removerPredIr(BlocoIr* b, int i) {
+    for (InstrIr* p = b->primeira; p && p->op == IR_PHI; p = p->prox) {
+        removerArg(p, i);
+    }
+    for (int j = i; j < b->nPreds - 1; j++) b->preds[j] = b->preds[j + 1];
+    b->nPreds--;
+}
+
+static void liberarBloco(BlocoIr* b) {
+    InstrIr* i = b->primeira;
+    while (i) {
+        InstrIr* prox = i->prox;
+        liberarInstr(i);
+        i = prox;
+    }
+    free(b->preds);
+    free(b);
+}
+
+void removerBlocosInalcancaveisIr(FuncaoIr* f) {
+    if (f->nBlocos == 0) return;
+
+    bool* alcancado = alocar(f->nBlocos * sizeof(bool));
+    BlocoIr** pilha = alocar(f->nBlocos * sizeof(BlocoIr*));
+    int topo = 0;
+
+    alcancado[0] = true;
+    pilha[topo++] = f->blocos[0];
+    while (topo > 0) {
+        BlocoIr* succ[2];
+        int n = sucessoresIr(pilha[--topo], succ);
+        for (int s = 0; s < n; s++) {
+            if (!alcancado[succ[s]->id]) {
+                alcancado[succ[s]->id] = true;
+                pilha[topo++] = succ[s];
+            }
+        }
+    }
+
+    // Desliga as arestas que saem dos blocos mortos
+    for (int b = 0; b < f->nBlocos; b++) {
+        if (alcancado[b]) continue;
+        BlocoIr* succ[2];
+        int n = sucessoresIr(f->blocos[b], succ);
+        for (int s = 0; s < n; s++) {
+            int i;
+            while ((i = indicePredIr(succ[s], f->blocos[b])) >= 0) removerPredIr(succ[s], i);
+        }
+    }
+
+    // Solta os operandos antes de liberar (valores mortos podem se usar entre si)
+    for (int b = 0; b < f->nBlocos; b++) {
+        if (alcancado[b]) continue;
+        for (InstrIr* i = f->blocos[b]->primeira; i; i = i->prox) {
+            for (int a = 0; a < i->nArgs; a++) removerUso(i->args[a], i);
+            i->nArgs = 0;
+        }
+    }
+
+    int n = 0;
+    for (int b = 0; b < f->nBlocos; b++) {
+        if (alcancado[b]) {
+            f->blocos[b]->id = n;
+            f->blocos[n++] = f->blocos[b];
+        } else {
+            liberarBloco(f->blocos[b]);
+        }
+    }
+    f->nBlocos = n;
+
+    free(alcancado);
+    free(pilha);
+}
+
+void removerBlocoIr(FuncaoIr* f, BlocoIr* b) {
+    int n = 0;
+    for (int k = 0; k < f->nBlocos; k++) {
+        if (f->blocos[k] == b) continue;
+        f->blocos[k]->id = n;
+        f->blocos[n++] = f->blocos[k];
+    }
+    f->nBlocos = n;
+    liberarBloco(b);
+}
+
+BlocoIr* dividirBlocoIr(FuncaoIr* f, InstrIr* pos) {
+    BlocoIr* antigo = pos->bloco;
+    BlocoIr* novo = novoBlocoIr(f);
+
+    novo->primeira = pos;
+    novo->ultima = antigo->ultima;
+    antigo->ultima = pos->ant;
+    if (pos->ant) pos->ant->prox = NULL;
+    else antigo->primeira = NULL;
+    pos->ant = NULL;
+    for (InstrIr* i = pos; i; i = i->prox) i->bloco = novo;
+
+    // Os sucessores passam a vir do bloco novo
+    BlocoIr* succ[2];
+    int ns = sucessoresIr(novo, succ);
+    for (int s = 0; s < ns; s++) {
+        for (int p = 0; p < succ[s]->nPreds; p++) {
+            if (succ[s]->preds[p] == antigo) succ[s]->preds[p] = novo;
+        }
+    }
+    return novo;
+}
+
+// ===================
+// Dominadores
+// ===================
+
+// Interseção de Cooper, Harvey e Kennedy sobre a ordem rpo
+static BlocoIr* intersecao(BlocoIr* a, BlocoIr* b) {
+    while (a != b) {
+        while (a->rpo > b->rpo) a = a->idom;
+        while (b->rpo > a->rpo) b = b->idom;
+    }
+    return a;
+}
+
+void calcularDominadoresIr(FuncaoIr* f) {
+    int n = f->nBlocos;
+    if (n == 0) return;
+
+    BlocoIr** ordem = alocar(n * sizeof(BlocoIr*));
+    BlocoIr** pilha = alocar(n * sizeof(BlocoIr*));
+    int* proximoSucc = alocar(n * sizeof(int));
+    bool* visitado = alocar(n * sizeof(bool));
+    int nPos = 0, topo = 0;
+
+    for (int b = 0; b < n; b++) {
+        f->blocos[b]->rpo = -1;
+        f->blocos[b]->idom = NULL;
+    }
+
+    // Pós-ordem iterativa; os sucessores são visitados do último para o primeiro,
+    // então na ordem reversa o alvo verdadeiro de um desvio vem logo depois dele
+    visitado[0] = true;
+    pilha[topo++] = f->blocos[0];
+    while (topo > 0) {
+        BlocoIr* b = pilha[topo - 1];
+        BlocoIr* succ[2];
+        int ns = sucessoresIr(b, succ);
+
+        if (proximoSucc[b->id] < ns) {
+            BlocoIr* s = succ[ns - 1 - proximoSucc[b->id]++];
+            if (!visitado[s->id]) {
+                visitado[s->id] = true;
+                pilha[topo++] = s;
+            }
+        } else {
+            ordem[nPos++] = b;
+            topo--;
+        }
+    }
+
+    for (int i = 0; i < nPos; i++) ordem[i]->rpo = nPos - 1 - i;
+
+    BlocoIr* entrada = f->blocos[0];
+    entrada->idom = entrada;
+
+    bool mudou = true;
+    while (mudou) {
+        mudou = false;
+        for (int i = nPos - 2; i >= 0; i--) {
+            BlocoIr* b = ordem[i];
+            BlocoIr* novo = NULL;
+
+            for (int p = 0; p < b->nPreds; p++) {
+                BlocoIr* pred = b->preds[p];
+                if (!pred->idom) continue;
+                novo = novo ? intersecao(pred, novo) : pred;
+            }
+            if (novo && b->idom != novo) {
+                b->idom = novo;
+                mudou = true;
+            }
+        }
+    }
+
+    free(ordem);
+    free(pilha);
+    free(proximoSucc);
+    free(visitado);
+}
+
+bool dominaIr(const BlocoIr* a, const BlocoIr* b) {
+    if (a->rpo < 0 || b->rpo < 0) return false;
+
+    while (b != a) {
+        if (b->idom == b || !b->idom) return false;
+        b = b->idom;
+    }
+    return true;
+}
+
+// ===================
+// Cópia
+// ===================
+
+FuncaoIr* copiarFuncaoIr(const FuncaoIr* f, const char* nome, int simbolo) {
+    FuncaoIr* c = novaFuncaoIr(nome, simbolo);
+    c->retorno = f->retorno;
+    c->nParams = f->nParams;
+    memcpy(c->tiposParams, f->tiposParams, sizeof(f->tiposParams));
+    for (int s = 0; s < f->nSlots; s++) novoSlotIr(c, f->slots[s].tamanho, f->slots[s].alinhamento, f->slots[s].simbolo);
+
+    for (int b = 0; b < f->nBlocos; b++) novoBlocoIr(c)->paralelo = f->blocos[b]->paralelo;
+    InstrIr** valor = calloc(f->nValores > 0 ? f->nValores : 1, sizeof(InstrIr*));
+
+    // Operandos depois: um phi pode usar um valor definido mais adiante
+    for (int b = 0; b < f->nBlocos; b++) {
+        const BlocoIr* bloco = f->blocos[b];
+        for (int p = 0; p < bloco->nPreds; p++) adicionarPredIr(c->blocos[b], c->blocos[bloco->preds[p]->id]);
+
+        for (InstrIr* i = bloco->primeira; i; i = i->prox) {
+            InstrIr* copia = novaInstrIr(c, i->op, i->tipo);
+            copia->imm = i->imm;
+            copia->cond = i->cond;
+            copia->indice = i->indice;
+            copia->simbolo = i->simbolo;
+            copia->runtime = i->runtime;
+            copia->cauda = i->cauda;
+            copia->escala = i->escala;
+            copia->tamanho = i->tamanho;
+            copia->linha = i->linha;
+            for (int k = 0; k < 2; k++) {
+                if (i->alvos[k]) copia->alvos[k] = c->blocos[i->alvos[k]->id];
+            }
+            anexarInstrIr(c->blocos[b], copia);
+            valor[i->id] = copia;
+        }
+    }
+
+    for (int b = 0; b < f->nBlocos; b++) {
+        for (InstrIr* i = f->blocos[b]->primeira; i; i = i->prox) {
+            for (int a = 0; a < i->nArgs; a++) adicionarArgIr(valor[i->id], valor[i->args[a]->id]);
+        }
+    }
+
+    free(valor);
+    return c;
+}
+
+// ===================
+// Liberação
+// ===================
+
+void liberarFuncaoIr(FuncaoIr* f) {
+    for (int b = 0; b < f->nBlocos; b++) liberarBloco(f->blocos[b]);
+    free(f->blocos);
+    free(f->slots);
+    free(f->nome);
+    free(f);
+}
+
+void liberarProgramaIr(ProgramaIr* p) {
+    if (!p) return;
+    for (int i = 0; i < p->nFuncoes; i++) liberarFuncaoIr(p->funcoes[i]);
+    free(p->funcoes);
+    free(p->globais);
+    free(p);
+}
+
+// ===================
+// Impressão
+// ===================
+
+static const char* nomesOp[NUM_OPS_IR] = {
+    [IR_CONST] = "const", [IR_PARAM] = "param", [IR_PHI] = "phi",
+    [IR_ADD] = "add", [IR_SUB] = "sub", [IR_MUL] = "mul", [IR_DIV] = "div",
+    [IR_NEG] = "neg", [IR_NOT] = "not", [IR_CMP] = "cmp", [IR_CONV] = "conv",
+    [IR_REPLICAR] = "replicar", [IR_MIN] = "min", [IR_MAX] = "max", [IR_REDUZIR] = "reduzir",
+    [IR_LOCAL] = "local", [IR_GLOBAL] = "global", [IR_CONST_STR] = "str", [IR_FUNCAO] = "funcao",
+    [IR_ELEM] = "elem", [IR_LOAD] = "load", [IR_STORE] = "store",
+    [IR_ZERAR] = "zerar", [IR_COPIAR] = "copiar", [IR_LIMITE] = "limite", [IR_CALL] = "call",
+    [IR_JMP] = "jmp", [IR_BR] = "br", [IR_RET] = "ret"
+};
+
+static const char* nomesCond[] = { "eq", "ne", "lt", "gt", "le", "ge" };
+
+// Conteúdo de uma constante string, escapado e abreviado
+static void imprimirTexto(FILE* saida, int id) {
+    int tam;
+    const char* dados = stringConstante(id, &tam);
+
+    fputc('"', saida);
+    for (int i = 0; i < tam && i < 40; i++) {
+        unsigned char c = (unsigned char)dados[i];
+        if (c == '"' || c == '\\') fprintf(saida, "\\%c", c);
+        else if (c >= 32 && c < 127) fputc(c, saida);
+        else fprintf(saida, "\\x%02x", c);
+    }
+    fputs(tam > 40 ? "\"..." : "\"", saida);
+}
+
+static void imprimirArgs(FILE* saida, const InstrIr* instr, int inicio) {
+    for (int a = inicio; a < instr->nArgs; a++) {
+        fprintf(saida, "%s%%%d", a > inicio ? ", " : "", instr->args[a]->id);
+    }
+}
+
+static void imprimirInstr(FILE* saida, const InstrIr* i) {
+    fprintf(saida, "    ");
+    if (i->tipo != IR_VOID) fprintf(saida, "%%%d = ", i->id);
+    fprintf(saida, "%s", nomesOp[i->op]);
+
+    switch (i->op) {
+        case IR_CONST:
+            if (i->tipo == IR_F32) fprintf(saida, " f32 %.9g", i->imm.f);
+            else fprintf(saida, " %s %d", nomeTipoIr(i->tipo), i->imm.i);
+            break;
+
+        case IR_PARAM:
+            fprintf(saida, " %s %d", nomeTipoIr(i->tipo), i->indice);
+            break;
+
+        case IR_PHI:
+            fprintf(saida, " %s", nomeTipoIr(i->tipo));
+            for (int a = 0; a < i->nArgs; a++) {
+                fprintf(saida, "%s [%%%d, b%d]", a ? "," : "", i->args[a]->id, i->bloco->preds[a]->id);
+            }
+            break;
+
+        case IR_CMP:
+            fprintf(saida, " %s %s ", nomesCond[i->cond], nomeTipoIr(i->args[0]->tipo));
+            imprimirArgs(saida, i, 0);
+            break;
+
+        case IR_CONV:
+            fprintf(saida, " %s %%%d to %s", nomeTipoIr(i->args[0]->tipo), i->args[0]->id, nomeTipoIr(i->tipo));
+            break;
+
+        case IR_REDUZIR:
+            fprintf(saida, " %s %s %%%d", nomesOp[i->indice], nomeTipoIr(i->args[0]->tipo), i->args[0]->id);
+            break;
+
+        case IR_LOCAL:
+            fprintf(saida, " $%d", i->indice);
+            break;
+
+        case IR_GLOBAL:
+        case IR_FUNCAO:
+            fprintf(saida, " @%s", getTabela()[i->simbolo].nome);
+            break;
+
+        case IR_CONST_STR:
+            fprintf(saida, " #%d ", i->indice);
+            imprimirTexto(saida, i->indice);
+            break;
+
+        case IR_ELEM:
+            fprintf(saida, " ");
+            imprimirArgs(saida, i, 0);
+            fprintf(saida, ", %d x %d", i->escala, i->tamanho);
+            break;
+
+        case IR_ZERAR:
+        case IR_COPIAR:
+        case IR_LIMITE:
+            fprintf(saida, " ");
+            imprimirArgs(saida, i, 0);
+            fprintf(saida, ", %d", i->tamanho);
+            break;
+
+        case IR_CALL:
+            fprintf(saida, "%s %s @%s(", i->cauda ? " cauda" : "", nomeTipoIr(i->tipo),
+                    i->simbolo >= 0 ? getTabela()[i->simbolo].nome : i->runtime);
+            imprimirArgs(saida, i, 0);
+            fprintf(saida, ")");
+            break;
+
+        case IR_JMP:
+            fprintf(saida, " b%d", i->alvos[0]->id);
+            break;
+
+        case IR_BR:
+            fprintf(saida, " %%%d, b%d, b%d", i->args[0]->id, i->alvos[0]->id, i->alvos[1]->id);
+            break;
+
+        default:
+            fprintf(saida, " %s%s", i->tipo != IR_VOID ? nomeTipoIr(i->tipo) : "", i->tipo != IR_VOID && i->nArgs ? " " : "");
+            imprimirArgs(saida, i, 0);
+            break;
+    }
+    fputc('\n', saida);
+}
+
+static void imprimirFuncao(FILE* saida, const FuncaoIr* f) {
+    fprintf(saida, "\nfuncao %s @%s(", nomeTipoIr(f->retorno), f->nome);
+    for (int p = 0; p < f->nParams; p++) {
+        fprintf(saida, "%s%s", p ? ", " : "", nomeTipoIr(f->tiposParams[p]));
+    }
+    fprintf(saida, ") {\n");
+
+    for (int s = 0; s < f->nSlots; s++) {
+        const SlotIr* slot = &f->slots[s];
+        fprintf(saida, "    $%d: %d bytes, alinhamento %d", s, slot->tamanho, slot->alinhamento);
+        if (slot->simbolo >= 0) fprintf(saida, " (%s)", getTabela()[slot->simbolo].nome);
+        fputc('\n', saida);
+    }
+
+    for (int b = 0; b < f->nBlocos; b++) {
+        const BlocoIr* bloco = f->blocos[b];
+        fprintf(saida, "b%d:", bloco->id);
+        if (bloco->nPreds > 0) {
+            fprintf(saida, "%*s; preds:", 8, "");
+            for (int p = 0; p < bloco->nPreds; p++) fprintf(saida, " b%d", bloco->preds[p]->id);
+        }
+        fputc('\n', saida);
+
+        for (const InstrIr* i = bloco->primeira; i; i = i->prox) imprimirInstr(saida, i);
+    }
+    fprintf(saida, "}\n");
+}
+
+void imprimirIr(const ProgramaIr* p, FILE* saida) {
+    fprintf(saida, "; IR gerada pelo compilador C.SHORT\n");
+    for (int g = 0; g < p->nGlobais; g++) {
+        const Simbolo* s = &getTabela()[p->globais[g]];
+        fprintf(saida, "global @%s: %s\n", s->nome, nomeTipo(s->tipoId));
+    }
+    for (int i = 0; i < p->nFuncoes; i++) imprimirFuncao(saida, p->funcoes[i]);
+}
+
+// ===================
+// Verificação
+// ===================
+
+static const FuncaoIr* funcaoVerificada;
+static bool verificacaoOk;
+
+static void falhaIr(const InstrIr* instr, const char* formato, ...) {
+    va_list args;
+    va_start(args, formato);
+    fprintf(stderr, "[ERRO IR] %s: ", funcaoVerificada->nome);
+    if (instr) fprintf(stderr, "b%d, %s %%%d: ", instr->bloco->id, nomesOp[instr->op], instr->id);
+    vfprintf(stderr, formato, args);
+    fputc('\n', stderr);
+    va_end(args);
+    verificacaoOk = false;
+}
+
+static bool ehEscalar(TipoIr t) {
+    return t == IR_I1 || t == IR_I8 || t == IR_I32 || t == IR_F32;
+}
+
+// Número de operandos e tipos exigidos por cada operação
+static void verificarTipos(const FuncaoIr* f, const InstrIr* i) {
+    #define ARGS(n) if (i->nArgs != (n)) { falhaIr(i, "esperava %d operandos, tem %d", (n), i->nArgs); return; }
+    #define EXIGE(cond, msg) if (!(cond)) { falhaIr(i, msg); return; }
+
+    switch (i->op) {
+        case IR_CONST:
+            ARGS(0);
+            EXIGE(ehEscalar(i->tipo), "constante precisa de tipo escalar");
+            break;
+
+        case IR_PARAM:
+            ARGS(0);
+            EXIGE(i->indice >= 0 && i->indice < f->nParams, "parâmetro inexistente");
+            EXIGE(i->tipo == f->tiposParams[i->indice], "tipo diferente do parâmetro");
+            EXIGE(i->bloco == f->blocos[0], "parâmetro fora do bloco de entrada");
+            break;
+
+        case IR_PHI:
+            EXIGE(i->nArgs == i->bloco->nPreds, "phi com número de operandos diferente do de predecessores");
+            for (int a = 0; a < i->nArgs; a++) {
+                EXIGE(i->args[a]->tipo == i->tipo, "operando de phi com tipo diferente");
+            }
+            EXIGE(i->tipo != IR_VOID, "phi sem tipo");
+            break;
+
+        case IR_ADD:
+        case IR_SUB:
+        case IR_MUL:
+        case IR_DIV:
+            ARGS(2);
+            EXIGE(i->tipo == IR_I8 || i->tipo == IR_I32 || i->tipo == IR_F32 || ehVetorIr(i->tipo),
+                  "aritmética exige i8, i32, f32 ou vetor");
+            EXIGE(i->args[0]->tipo == i->tipo && i->args[1]->tipo == i->tipo, "operandos com tipo diferente do resultado");
+            // SSE2 não tem multiplicação de bytes nem divisão inteira
+            EXIGE(i->tipo != IR_V16I8 || i->op == IR_ADD || i->op == IR_SUB, "v16i8 só soma e subtrai");
+            EXIGE(i->tipo != IR_V4I32 || i->op != IR_DIV, "v4i32 não divide");
+            break;
+
+        case IR_NEG:
+            ARGS(1);
+            EXIGE(i->tipo == IR_I8 || i->tipo == IR_I32 || i->tipo == IR_F32 || ehVetorIr(i->tipo),
+                  "neg exige i8, i32, f32 ou vetor");
+            EXIGE(i->args[0]->tipo == i->tipo, "operando com tipo diferente do resultado");
+            break;
+
+        case IR_NOT:
+            ARGS(1);
+            EXIGE(i->tipo == IR_I1 && i->args[0]->tipo == IR_I1, "not exige i1");
+            break;
+
+        case IR_CMP:
+            ARGS(2);
+            EXIGE(i->tipo == IR_I1, "comparação produz i1");
+            EXIGE((ehEscalar(i->args[0]->tipo) || i->args[0]->tipo == IR_PTR) && i->args[0]->tipo == i->args[1]->tipo,
+                  "comparação exige dois operandos escalares do mesmo tipo");
+            break;
+
+        case IR_CONV:
+            ARGS(1);
+            if (ehVetorIr(i->tipo)) {
+                EXIGE((i->tipo == IR_V4I32 && i->args[0]->tipo == IR_V4F32)
+                      || (i->tipo == IR_V4F32 && i->args[0]->tipo == IR_V4I32),
+                      "conversão vetorial só entre v4i32 e v4f32");
+                break;
+            }
+            EXIGE(ehEscalar(i->tipo) && ehEscalar(i->args[0]->tipo), "conversão só entre escalares");
+            break;
+
+        case IR_REPLICAR:
+            ARGS(1);
+            EXIGE(ehVetorIr(i->tipo) && i->args[0]->tipo == elementoIr(i->tipo), "replicar exige o escalar do vetor");
+            break;
+
+        case IR_MIN:
+        case IR_MAX:
+            ARGS(2);
+            EXIGE(i->tipo == IR_V4I32 || i->tipo == IR_V4F32, "min/max exigem v4i32 ou v4f32");
+            EXIGE(i->args[0]->tipo == i->tipo && i->args[1]->tipo == i->tipo, "operandos com tipo diferente do resultado");
+            break;
+
+        case IR_REDUZIR:
+            ARGS(1);
+            EXIGE(i->args[0]->tipo == IR_V4I32 || i->args[0]->tipo == IR_V4F32, "reduzir exige v4i32 ou v4f32");
+            EXIGE(i->tipo == elementoIr(i->args[0]->tipo), "reduzir produz o elemento do vetor");
+            EXIGE(i->indice == IR_ADD || i->indice == IR_MIN || i->indice == IR_MAX, "redução desconhecida");
+            break;
+
+        case IR_LOCAL:
+            ARGS(0);
+            EXIGE(i->tipo == IR_PTR, "local produz ptr");
+            EXIGE(i->indice >= 0 && i->indice < f->nSlots, "slot inexistente");
+            break;
+
+        case IR_GLOBAL:
+        case IR_CONST_STR:
+        case IR_FUNCAO:
+            ARGS(0);
+            EXIGE(i->tipo == IR_PTR, "endereço produz ptr");
+            break;
+
+        case IR_ELEM:
+            ARGS(2);
+            EXIGE(i->tipo == IR_PTR && i->args[0]->tipo == IR_PTR && i->args[1]->tipo == IR_I32,
+                  "elem exige base ptr e índice i32");
+            EXIGE(i->escala >= 0, "elem sem escala");
+            for (int u = 0; u < i->nUsos && i->escala == 0; u++) {
+                const InstrIr* uso = i->usos[u];
+                EXIGE((uso->op == IR_LOAD && uso->tipo == IR_I1)
+                      || (uso->op == IR_STORE && uso->args[0] == i && uso->args[1]->tipo == IR_I1),
+                      "elem de bit só pode ser lido ou gravado como i1");
+            }
+            break;
+
+        case IR_LOAD:
+            ARGS(1);
+            EXIGE(i->args[0]->tipo == IR_PTR, "load exige endereço ptr");
+            EXIGE(i->tipo != IR_VOID, "load sem tipo");
+            break;
+
+        case IR_STORE:
+            ARGS(2);
+            EXIGE(i->tipo == IR_VOID && i->args[0]->tipo == IR_PTR, "store exige endereço ptr");
+            EXIGE(i->args[1]->tipo != IR_VOID, "store de valor sem tipo");
+            break;
+
+        case IR_ZERAR:
+            ARGS(1);
+            EXIGE(i->args[0]->tipo == IR_PTR && i->tamanho > 0, "zerar exige endereço e tamanho");
+            break;
+
+        case IR_COPIAR:
+            ARGS(2);
+            EXIGE(i->args[0]->tipo == IR_PTR && i->args[1]->tipo == IR_PTR && i->tamanho > 0,
+                  "copiar exige dois endereços e tamanho");
+            break;
+
+        case IR_LIMITE:
+            ARGS(1);
+            EXIGE(i->tipo == IR_VOID && i->args[0]->tipo == IR_I32 && i->tamanho > 0,
+                  "limite exige índice i32 e tamanho");
+            break;
+
+        case IR_CALL:
+            EXIGE(i->simbolo >= 0 || i->runtime, "chamada sem destino");
+            EXIGE(!i->cauda || (i->prox && i->prox->op == IR_RET
+                                && (i->prox->nArgs == 0 || i->prox->args[0] == i)),
+                  "chamada de cauda sem ret logo depois");
+            for (int a = 0; a < i->nArgs; a++) {
+                EXIGE(i->args[a]->tipo != IR_VOID, "argumento sem tipo");
+            }
+            break;
+
+        case IR_JMP:
+            ARGS(0);
+            EXIGE(i->alvos[0], "jmp sem destino");
+            break;
+
+        case IR_BR:
+            ARGS(1);
+            EXIGE(i->args[0]->tipo == IR_I1, "br exige condição i1");
+            EXIGE(i->alvos[0] && i->alvos[1], "br sem destinos");
+            break;
+
+        case IR_RET:
+            if (f->retorno == IR_VOID) {
+                ARGS(0);
+            } else {
+                ARGS(1);
+                EXIGE(i->args[0]->tipo == f->retorno, "valor de retorno com tipo diferente da função");
+            }
+            break;
+
+        default:
+            falhaIr(i, "operação desconhecida");
+            break;
+    }
+
+    #undef ARGS
+    #undef EXIGE
+}
+
+static int contar(InstrIr* const* lista, int n, const InstrIr* x) {
+    int c = 0;
+    for (int k = 0; k < n; k++) c += lista[k] == x;
+    return c;
+}
+
+bool verificarIr(FuncaoIr* f) {
+    funcaoVerificada = f;
+    verificacaoOk = true;
+
+    if (f->nBlocos == 0) {
+        falhaIr(NULL, "função sem blocos");
+        return false;
+    }
+    if (f->blocos[0]->nPreds != 0) falhaIr(NULL, "o bloco de entrada não pode ter predecessores");
+
+    calcularDominadoresIr(f);
+
+    // Posição de cada instrução no seu bloco (dominância dentro do bloco)
+    int* posicao = calloc(f->nValores > 0 ? f->nValores : 1, sizeof(int));
+    bool* definido = calloc(f->nValores > 0 ? f->nValores : 1, sizeof(bool));
+
+    for (int b = 0; b < f->nBlocos; b++) {
+        BlocoIr* bloco = f->blocos[b];
+        int pos = 0;
+
+        if (bloco->id != b) falhaIr(NULL, "b%d fora de posição na lista de blocos", bloco->id);
+        if (bloco->rpo < 0) falhaIr(NULL, "b%d é inalcançável", bloco->id);
+
+        for (InstrIr* i = bloco->primeira; i; i = i->prox) {
+            if (i->id < 0 || i->id >= f->nValores || definido[i->id]) {
+                falhaIr(i, "número de valor inválido ou repetido");
+                continue;
+            }
+            definido[i->id] = true;
+            posicao[i->id] = pos++;
+            if (i->bloco != bloco) falhaIr(i, "instrução com bloco errado");
+        }
+
+        InstrIr* term = terminadorIr(bloco);
+        if (!term) falhaIr(NULL, "b%d não termina em jmp, br ou ret", bloco->id);
+
+        bool aposPhi = false;
+        for (InstrIr* i = bloco->primeira; i; i = i->prox) {
+            if (i->op == IR_PHI && aposPhi) falhaIr(i, "phi depois de outras instruções");
+            if (i->op != IR_PHI) aposPhi = true;
+            if (ehTerminadorIr(i->op) && i != term) falhaIr(i, "terminador no meio do bloco");
+        }
+
+        // Arestas nos dois sentidos
+        BlocoIr* succ[2];
+        int ns = sucessoresIr(bloco, succ);
+        for (int s = 0; s < ns; s++) {
+            if (indicePredIr(succ[s], bloco) < 0) {
+                falhaIr(term, "b%d não lista b%d entre os predecessores", succ[s]->id, bloco->id);
+            }
+        }
+        for (int p = 0; p < bloco->nPreds; p++) {
+            BlocoIr* ps[2];
+            int np = sucessoresIr(bloco->preds[p], ps);
+            bool ok = false;
+            for (int s = 0; s < np; s++) ok = ok || ps[s] == bloco;
+            if (!ok) falhaIr(NULL, "b%d lista b%d como predecessor sem aresta", bloco->id, bloco->preds[p]->id);
+            if (indicePredIr(bloco, bloco->preds[p]) != p) {
+                falhaIr(NULL, "b%d lista b%d mais de uma vez", bloco->id, bloco->preds[p]->id);
+            }
+        }
+    }
+
+    if (!verificacaoOk) {
+        free(posicao);
+        free(definido);
+        return false;
+    }
+
+    for (int b = 0; b < f->nBlocos; b++) {
+        for (InstrIr* i = f->blocos[b]->primeira; i; i = i->prox) {
+            verificarTipos(f, i);
+
+            for (int a = 0; a < i->nArgs; a++) {
+                InstrIr* arg = i->args[a];
+
+                if (!arg->bloco || arg->id < 0 || arg->id >= f->nValores || !definido[arg->id]) {
+                    falhaIr(i, "operando %d não pertence à função", a);
+                    continue;
+                }
+
+                // Definição domina o uso (no phi, o fim do predecessor correspondente)
+                BlocoIr* local = i->op == IR_PHI ? i->bloco->preds[a] : i->bloco;
+                bool domina = arg->bloco == local
+                    ? (i->op == IR_PHI || posicao[arg->id] < posicao[i->id])
+                    : dominaIr(arg->bloco, local);
+                if (!domina) falhaIr(i, "%%%d não domina o uso", arg->id);
+
+                if (contar(arg->usos, arg->nUsos, i) != contar(i->args, i->nArgs, arg)) {
+                    falhaIr(i, "lista de usos de %%%d inconsistente", arg->id);
+                }
+            }
+
+            for (int u = 0; u < i->nUsos; u++) {
+                if (contar(i->usos[u]->args, i->usos[u]->nArgs, i) == 0) {
+                    falhaIr(i, "uso registrado em %%%d, que não usa o valor", i->usos[u]->id);
+                }
+            }
+        }
+    }
+
+    free(posicao);
+    free(definido);
+    return verificacaoOk;
+}
+
+bool verificarProgramaIr(ProgramaIr* p) {
+    bool ok = true;
+    for (int i = 0; i < p->nFuncoes; i++) {
+        ok = verificarIr(p->funcoes[i]) && ok;
+    }
+    return ok;
+}
@@ -0,0 +1,1216 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ir.h"
+#include "lexer.h"
+
+// ==============================================
+// CONSTRUÇÃO DA IR A PARTIR DA ÁRVORE
+// ==============================================
+//
+// Cada função é percorrida uma vez. Variáveis escalares locais (e
+// parâmetros por valor) que nunca têm o endereço tomado viram valores SSA
+// pelo algoritmo de Braun et al. ("Simple and Efficient Construction of
+// Static Single Assignment Form"): cada bloco guarda a definição atual de
+// cada variável, leituras sobem pelos predecessores criando phi, e blocos
+// ainda sem todos os predecessores (cabeçalhos de laço) ficam com phi
+// incompletos até serem selados. Phi triviais são removidos na hora; um
+// valor guardado antes da remoção passa ao substituto quando é usado.
+
+#define SEM_VAR (-1)
+
+// String avaliada: endereço do valor e, se for um temporário de quem avaliou, seu slot
+typedef struct {
+    InstrIr* endereco;
+    int proprio;            // slot do temporário (-1 se é de uma variável ou constante)
+} ValorString;
+
+typedef struct {
+    FuncaoIr* f;
+    NoAst* decl;
+    BlocoIr* atual;         // onde as instruções entram (NULL logo após um desvio)
+
+    // Símbolos da função (parâmetros e locais ocupam um intervalo da tabela)
+    int baseSimbolos;
+    int nSimbolos;
+    int* varDe;             // símbolo - base -> variável SSA (SEM_VAR se fica em memória)
+    int* slotDe;            // símbolo - base -> slot do quadro (-1 se não tem)
+    InstrIr** paramDe;      // símbolo - base -> valor do parâmetro
+
+    int nVars;
+    TipoIr* tipoVar;
+
+    // Estado SSA por bloco (indexado por bloco->id)
+    InstrIr*** defs;
+    InstrIr*** incompletos;
+    bool* selado;
+    int capBlocos;
+
+    InstrIr** removidos;    // phi triviais já desligados (liberados no fim)
+    InstrIr** substitutos;  // valor que ficou no lugar de cada removido
+    int nRemovidos;
+    int capRemovidos;
+
+    InstrIr* enderecoRetorno;   // funções string: onde o resultado é escrito
+    BlocoIr* saida;             // bloco de saída comum (quando há strings a liberar)
+    int varRetorno;             // variável SSA do valor devolvido à saída comum
+
+    BlocoIr* quebra;        // destino do 'break' (fim do laço ou switch mais interno)
+
+    int linha;              // linha do nó em tradução
+
+    bool falhou;
+} Construtor;
+
+static bool verificarLimites = false;
+
+void definirVerificacaoLimites(bool ativa) {
+    verificarLimites = ativa;
+}
+
+static void erroConstrucao(Construtor* c, const char* msg, const char* nome) {
+    fprintf(stderr, "[ERRO GERAÇÃO] %s: %s\n", nome, msg);
+    c->falhou = true;
+}
+
+static Simbolo* simbolo(int idx) {
+    return &getTabela()[idx];
+}
+
+static int tamanhoEscalar(TipoId t) {
+    switch (tipoElemento(t)) {
+        case TIPO_CHAR:
+        case TIPO_BOOL:
+            return 1;
+        default:
+            return 4;
+    }
+}
+
+// ===================
+// Blocos e instruções
+// ===================
+
+static BlocoIr* novoBloco(Construtor* c) {
+    BlocoIr* b = novoBlocoIr(c->f);
+
+    if (b->id >= c->capBlocos) {
+        int cap = c->capBlocos ? c->capBlocos * 2 : 16;
+        c->defs = realloc(c->defs, cap * sizeof(InstrIr**));
+        c->incompletos = realloc(c->incompletos, cap * sizeof(InstrIr**));
+        c->selado = realloc(c->selado, cap * sizeof(bool));
+        c->capBlocos = cap;
+    }
+    c->defs[b->id] = calloc(c->nVars + 1, sizeof(InstrIr*));
+    c->incompletos[b->id] = calloc(c->nVars + 1, sizeof(InstrIr*));
+    c->selado[b->id] = false;
+    return b;
+}
+
+// Um phi removido depois que o valor foi lido (por uma leitura de outra
+// variável no meio da expressão) vale o que ficou no lugar dele
+static InstrIr* resolver(Construtor* c, InstrIr* v) {
+    while (v->op == IR_PHI && !v->bloco) {
+        int k = c->nRemovidos - 1;
+        while (k >= 0 && c->removidos[k] != v) k--;
+        if (k < 0) break;
+        v = c->substitutos[k];
+    }
+    return v;
+}
+
+// Anexa ao bloco atual; depois de um desvio, o código segue em um bloco inalcançável
+static InstrIr* emitir(Construtor* c, InstrIr* instr) {
+    for (int a = 0; a < instr->nArgs; a++) {
+        InstrIr* v = resolver(c, instr->args[a]);
+        if (v != instr->args[a]) trocarArgIr(instr, a, v);
+    }
+    instr->linha = c->linha;
+    if (!c->atual) {
+        c->atual = novoBloco(c);
+        c->selado[c->atual->id] = true;
+    }
+    anexarInstrIr(c->atual, instr);
+    return instr;
+}
+
+static InstrIr* instr0(Construtor* c, OpIr op, TipoIr tipo) {
+    return emitir(c, novaInstrIr(c->f, op, tipo));
+}
+
+static InstrIr* instr1(Construtor* c, OpIr op, TipoIr tipo, InstrIr* a) {
+    InstrIr* i = novaInstrIr(c->f, op, tipo);
+    adicionarArgIr(i, a);
+    return emitir(c, i);
+}
+
+static InstrIr* instr2(Construtor* c, OpIr op, TipoIr tipo, InstrIr* a, InstrIr* b) {
+    InstrIr* i = novaInstrIr(c->f, op, tipo);
+    adicionarArgIr(i, a);
+    adicionarArgIr(i, b);
+    return emitir(c, i);
+}
+
+static InstrIr* constante(Construtor* c, TipoIr tipo, int32_t valor) {
+    InstrIr* i = instr0(c, IR_CONST, tipo);
+    i->imm.i = valor;
+    return i;
+}
+
+static InstrIr* constanteFloat(Construtor* c, float valor) {
+    InstrIr* i = instr0(c, IR_CONST, IR_F32);
+    i->imm.f = valor;
+    return i;
+}
+
+static InstrIr* enderecoSlot(Construtor* c, int slot) {
+    InstrIr* i = instr0(c, IR_LOCAL, IR_PTR);
+    i->indice = slot;
+    return i;
+}
+
+static void desviar(Construtor* c, BlocoIr* alvo) {
+    InstrIr* j = instr0(c, IR_JMP, IR_VOID);
+    j->alvos[0] = alvo;
+    adicionarPredIr(alvo, c->atual);
+    c->atual = NULL;
+}
+
+static void desviarSe(Construtor* c, InstrIr* cond, BlocoIr* verdadeiro, BlocoIr* falso) {
+    InstrIr* br = instr1(c, IR_BR, IR_VOID, cond);
+    br->alvos[0] = verdadeiro;
+    br->alvos[1] = falso;
+    adicionarPredIr(verdadeiro, c->atual);
+    adicionarPredIr(falso, c->atual);
+    c->atual = NULL;
+}
+
+// Chamada ao runtime com até três argumentos
+static InstrIr* chamarRuntime(Construtor* c, const char* nome, TipoIr tipo,
+                              InstrIr* a, InstrIr* b, InstrIr* d) {
+    InstrIr* i = novaInstrIr(c->f, IR_CALL, tipo);
+    i->runtime = nome;
+    if (a) adicionarArgIr(i, a);
+    if (b) adicionarArgIr(i, b);
+    if (d) adicionarArgIr(i, d);
+    return emitir(c, i);
+}
+
+// ===================
+// Variáveis SSA
+// ===================
+
+static InstrIr* lerVar(Construtor* c, int var, BlocoIr* b);
+
+// Valor de uma variável lida antes de qualquer atribuição: zero
+static InstrIr* indefinido(Construtor* c, TipoIr tipo) {
+    BlocoIr* entrada = c->f->blocos[0];
+    InstrIr* i = novaInstrIr(c->f, IR_CONST, tipo);
+    i->imm.i = 0;
+    if (entrada->primeira) inserirAntesIr(entrada->primeira, i);
+    else anexarInstrIr(entrada, i);
+    return i;
+}
+
+static void escreverVar(Construtor* c, int var, BlocoIr* b, InstrIr* valor) {
+    c->defs[b->id][var] = resolver(c, valor);
+}
+
+static InstrIr* novoPhi(Construtor* c, int var, BlocoIr* b) {
+    InstrIr* phi = novaInstrIr(c->f, IR_PHI, c->tipoVar[var]);
+    phi->indice = var;
+    if (b->primeira) inserirAntesIr(b->primeira, phi);
+    else anexarInstrIr(b, phi);
+    return phi;
+}
+
+// Um phi com todos os operandos; os que ainda estão sendo preenchidos (ou
+// esperam o bloco ser selado) são conferidos quando ficarem completos
+static bool phiCompleto(const InstrIr* phi) {
+    return phi->bloco && phi->nArgs == phi->bloco->nPreds;
+}
+
+// Um phi cujos operandos são todos o mesmo valor (ou ele próprio) é esse valor
+static void removerPhiTrivial(Construtor* c, InstrIr* phi) {
+    InstrIr* mesmo = NULL;
+
+    for (int a = 0; a < phi->nArgs; a++) {
+        InstrIr* op = phi->args[a];
+        if (op == mesmo || op == phi) continue;
+        if (mesmo) return;
+        mesmo = op;
+    }
+    if (!mesmo) mesmo = indefinido(c, phi->tipo);
+
+    // Phi que usavam este podem ficar triviais depois da troca
+    int nUsuarios = 0;
+    InstrIr** usuarios = malloc((phi->nUsos + 1) * sizeof(InstrIr*));
+    for (int u = 0; u < phi->nUsos; u++) {
+        if (phi->usos[u] != phi && phi->usos[u]->op == IR_PHI) usuarios[nUsuarios++] = phi->usos[u];
+    }
+
+    substituirUsosIr(phi, mesmo);
+    for (int b = 0; b < c->f->nBlocos; b++) {
+        if (c->defs[b][phi->indice] == phi) c->defs[b][phi->indice] = mesmo;
+    }
+
+    desligarInstrIr(phi);
+    if (c->nRemovidos == c->capRemovidos) {
+        c->capRemovidos = c->capRemovidos ? c->capRemovidos * 2 : 16;
+        c->removidos = realloc(c->removidos, c->capRemovidos * sizeof(InstrIr*));
+        c->substitutos = realloc(c->substitutos, c->capRemovidos * sizeof(InstrIr*));
+    }
+    c->removidos[c->nRemovidos] = phi;
+    c->substitutos[c->nRemovidos++] = mesmo;
+
+    for (int u = 0; u < nUsuarios; u++) {
+        if (phiCompleto(usuarios[u])) removerPhiTrivial(c, usuarios[u]);
+    }
+    free(usuarios);
+}
+
+static void adicionarOperandosPhi(Construtor* c, int var, InstrIr* phi) {
+    BlocoIr* b = phi->bloco;
+    for (int p = 0; p < b->nPreds; p++) {
+        adicionarArgIr(phi, lerVar(c, var, b->preds[p]));
+    }
+    removerPhiTrivial(c, phi);
+}
+
+static InstrIr* lerVarRecursivo(Construtor* c, int var, BlocoIr* b) {
+    InstrIr* valor;
+
+    if (!c->selado[b->id]) {
+        // Ainda podem chegar predecessores: phi incompleto
+        valor = novoPhi(c, var, b);
+        c->incompletos[b->id][var] = valor;
+    } else if (b->nPreds == 0) {
+        valor = indefinido(c, c->tipoVar[var]);
+    } else if (b->nPreds == 1) {
+        valor = lerVar(c, var, b->preds[0]);
+    } else {
+        // O phi é registrado antes de ler os predecessores (quebra ciclos)
+        InstrIr* phi = novoPhi(c, var, b);
+        escreverVar(c, var, b, phi);
+        adicionarOperandosPhi(c, var, phi);
+        return c->defs[b->id][var];
+    }
+
+    escreverVar(c, var, b, valor);
+    return valor;
+}
+
+// A definição pode ser um phi de outra variável (y = x) já removido
+static InstrIr* lerVar(Construtor* c, int var, BlocoIr* b) {
+    if (c->defs[b->id][var]) return c->defs[b->id][var] = resolver(c, c->defs[b->id][var]);
+    return lerVarRecursivo(c, var, b);
+}
+
+// Todos os predecessores do bloco já são conhecidos
+static void selar(Construtor* c, BlocoIr* b) {
+    for (int v = 0; v < c->nVars + 1; v++) {
+        InstrIr* phi = c->incompletos[b->id][v];
+        if (!phi) continue;
+        c->incompletos[b->id][v] = NULL;
+        adicionarOperandosPhi(c, v, phi);
+    }
+    c->selado[b->id] = true;
+}
+
+// Bloco atual para leituras (um bloco novo e inalcançável depois de um desvio)
+static BlocoIr* blocoAtual(Construtor* c) {
+    if (!c->atual) {
+        c->atual = novoBloco(c);
+        c->selado[c->atual->id] = true;
+    }
+    return c->atual;
+}
+
+// ===================
+// Variáveis em geral
+// ===================
+
+static bool ehLocal(Construtor* c, int idx) {
+    return idx >= c->baseSimbolos && idx < c->baseSimbolos + c->nSimbolos
+        && simbolo(idx)->escopo == ESC_LOCAL;
+}
+
+// Endereço de uma variável em memória (global, slot, parâmetro por referência ou vetor)
+static InstrIr* enderecoVariavel(Construtor* c, int idx) {
+    Simbolo* s = simbolo(idx);
+
+    if (!ehLocal(c, idx)) {
+        InstrIr* g = instr0(c, IR_GLOBAL, IR_PTR);
+        g->simbolo = idx;
+        return g;
+    }
+
+    int k = idx - c->baseSimbolos;
+    if (s->posParam >= 0 && s->modoParam != PARAM_VALOR) return c->paramDe[k];
+    return enderecoSlot(c, c->slotDe[k]);
+}
+
+static InstrIr* lerVariavel(Construtor* c, int idx) {
+    Simbolo* s = simbolo(idx);
+
+    if (ehLocal(c, idx) && c->varDe[idx - c->baseSimbolos] != SEM_VAR) {
+        return lerVar(c, c->varDe[idx - c->baseSimbolos], blocoAtual(c));
+    }
+    return instr1(c, IR_LOAD, tipoIrDe(s->tipoId), enderecoVariavel(c, idx));
+}
+
+static void escreverVariavel(Construtor* c, int idx, InstrIr* valor) {
+    if (ehLocal(c, idx) && c->varDe[idx - c->baseSimbolos] != SEM_VAR) {
+        escreverVar(c, c->varDe[idx - c->baseSimbolos], blocoAtual(c), valor);
+        return;
+    }
+    instr2(c, IR_STORE, IR_VOID, enderecoVariavel(c, idx), valor);
+}
+
+// ===================
+// Expressões
+// ===================
+
+static InstrIr* gerarExpr(Construtor* c, NoAst* no);
+static void gerarDesvio(Construtor* c, NoAst* cond, BlocoIr* verdadeiro, BlocoIr* falso);
+static InstrIr* gerarChamada(Construtor* c, NoAst* no, int* slotResultado);
+
+static InstrIr* converter(Construtor* c, InstrIr* valor, TipoIr destino) {
+    if (valor->tipo == destino) return valor;
+    return instr1(c, IR_CONV, destino, valor);
+}
+
+static InstrIr* gerarExprComo(Construtor* c, NoAst* no, TipoIr destino) {
+    return converter(c, gerarExpr(c, no), destino);
+}
+
+static int novoTempString(Construtor* c) {
+    return novoSlotIr(c->f, 16, 16, -1);
+}
+
+// Avalia uma expressão string
+static ValorString gerarString(Construtor* c, NoAst* no) {
+    ValorString v = { NULL, -1 };
+
+    switch (no->tipo) {
+        case NO_CONST_STRING:
+            v.endereco = instr0(c, IR_CONST_STR, IR_PTR);
+            v.endereco->indice = no->valor.intVal;
+            break;
+
+        case NO_ID:
+            v.endereco = enderecoVariavel(c, no->simbolo);
+            break;
+
+        case NO_CHAMADA:
+            gerarChamada(c, no, &v.proprio);
+            v.endereco = enderecoSlot(c, v.proprio);
+            break;
+
+        default:
+            erroConstrucao(c, "Expressão string não suportada na geração de código", no->nome ? no->nome : "string");
+            v.endereco = instr0(c, IR_CONST_STR, IR_PTR);
+            break;
+    }
+    return v;
+}
+
+static void liberarTempString(Construtor* c, int slot) {
+    chamarRuntime(c, "csrt_str_liberar", IR_VOID, enderecoSlot(c, slot), NULL, NULL);
+}
+
+// Endereço do elemento v[i] (o tamanho declarado fica registrado no elem).
+// Vetores bool guardam um bit por elemento: o elem tem escala 0
+static InstrIr* gerarElemento(Construtor* c, int idx, InstrIr* indice) {
+    Simbolo* s = simbolo(idx);
+    int tamanho = s->posParam >= 0 ? 0 : s->tamanho;
+
+    // Vetores recebidos por parâmetro não têm tamanho conhecido aqui
+    if (verificarLimites && tamanho > 0) {
+        InstrIr* limite = instr1(c, IR_LIMITE, IR_VOID, indice);
+        limite->tamanho = tamanho;
+    }
+
+    InstrIr* e = instr2(c, IR_ELEM, IR_PTR, enderecoVariavel(c, idx), indice);
+    e->escala = tipoElemento(s->tipoId) == TIPO_BOOL ? 0 : tamanhoEscalar(s->tipoId);
+    e->tamanho = tamanho;
+    return e;
+}
+
+// strlen, strcmp e strcat: o runtime só lê os argumentos
+static InstrIr* gerarChamadaEmbutida(Construtor* c, NoAst* no, int* slotResultado) {
+    Simbolo* f = simbolo(no->simbolo);
+    InstrIr* call = novaInstrIr(c->f, IR_CALL, tipoIrDe(f->tipoId));
+    int proprios[MAX_PARAM];
+    int n = 0;
+
+    call->runtime = strcmp(f->nome, "strlen") == 0 ? "csrt_strlen"
+                  : strcmp(f->nome, "strcmp") == 0 ? "csrt_strcmp" : "csrt_strcat";
+
+    if (f->tipoId == TIPO_STRING) {
+        call->tipo = IR_VOID;
+        *slotResultado = novoTempString(c);
+        adicionarArgIr(call, enderecoSlot(c, *slotResultado));
+    }
+
+    for (NoAst* a = no->filhos[0]; a; a = a->prox) {
+        ValorString v = gerarString(c, a);
+        adicionarArgIr(call, v.endereco);
+        proprios[n++] = v.proprio;
+    }
+    emitir(c, call);
+
+    for (int i = 0; i < n; i++) {
+        if (proprios[i] >= 0) liberarTempString(c, proprios[i]);
+    }
+    return call->tipo == IR_VOID ? NULL : call;
+}
+
+// Chamada de função; se ela devolve string, o slot do resultado vai em *slotResultado
+static InstrIr* gerarChamada(Construtor* c, NoAst* no, int* slotResultado) {
+    Simbolo* f = simbolo(no->simbolo);
+    if (f->embutida) return gerarChamadaEmbutida(c, no, slotResultado);
+
+    bool devolveString = f->tipoId == TIPO_STRING;
+    InstrIr* args[MAX_PARAM + 1];
+    int n = 0;
+
+    // Bits passados por referência: o chamado recebe um temporário, copiado de volta depois
+    InstrIr* bits[MAX_PARAM];
+    int temps[MAX_PARAM];
+    int nBits = 0;
+
+    if (devolveString) {
+        *slotResultado = novoTempString(c);
+        args[n++] = enderecoSlot(c, *slotResultado);
+    }
+
+    int i = 0;
+    for (NoAst* a = no->filhos[0]; a; a = a->prox, i++) {
+        TipoId tipoParam = tipoIdDeNome(f->tiposParams[i]);
+
+        switch (f->modosParams[i]) {
+            case PARAM_VETOR:
+                args[n++] = enderecoVariavel(c, a->simbolo);
+                break;
+
+            case PARAM_REFERENCIA:
+                if (a->tipo == NO_INDEXACAO) {
+                    InstrIr* indice = gerarExprComo(c, a->filhos[0], IR_I32);
+                    InstrIr* e = gerarElemento(c, a->simbolo, indice);
+                    if (e->escala == 0) {
+                        bits[nBits] = e;
+                        temps[nBits] = novoSlotIr(c->f, 1, 1, -1);
+                        instr2(c, IR_STORE, IR_VOID, enderecoSlot(c, temps[nBits]), instr1(c, IR_LOAD, IR_I1, e));
+                        e = enderecoSlot(c, temps[nBits++]);
+                    }
+                    args[n++] = e;
+                } else {
+                    args[n++] = enderecoVariavel(c, a->simbolo);
+                }
+                break;
+
+            default:
+                if (tipoParam == TIPO_STRING) {
+                    // O chamado fica com a string: variáveis e constantes são copiadas antes
+                    ValorString v = gerarString(c, a);
+                    if (v.proprio < 0) {
+                        int copia = novoTempString(c);
+                        chamarRuntime(c, "csrt_str_iniciar", IR_VOID, enderecoSlot(c, copia), v.endereco, NULL);
+                        v.endereco = enderecoSlot(c, copia);
+                    }
+                    args[n++] = v.endereco;
+                } else {
+                    args[n++] = gerarExprComo(c, a, tipoIrDe(tipoParam));
+                }
+                break;
+        }
+    }
+
+    InstrIr* call = novaInstrIr(c->f, IR_CALL, devolveString ? IR_VOID : tipoIrDe(f->tipoId));
+    call->simbolo = no->simbolo;
+    for (int k = 0; k < n; k++) adicionarArgIr(call, args[k]);
+    emitir(c, call);
+
+    for (int k = 0; k < nBits; k++) {
+        instr2(c, IR_STORE, IR_VOID, bits[k], instr1(c, IR_LOAD, IR_I1, enderecoSlot(c, temps[k])));
+    }
+
+    return call->tipo == IR_VOID ? NULL : call;
+}
+
+// && e || como valor: desvios que terminam em um phi de constantes
+static InstrIr* gerarLogico(Construtor* c, NoAst* no) {
+    BlocoIr* verdadeiro = novoBloco(c);
+    BlocoIr* falso = novoBloco(c);
+    BlocoIr* fim = novoBloco(c);
+
+    gerarDesvio(c, no, verdadeiro, falso);
+    selar(c, verdadeiro);
+    selar(c, falso);
+
+    c->atual = verdadeiro;
+    InstrIr* um = constante(c, IR_I1, 1);
+    desviar(c, fim);
+
+    c->atual = falso;
+    InstrIr* zero = constante(c, IR_I1, 0);
+    desviar(c, fim);
+
+    selar(c, fim);
+    c->atual = fim;
+
+    InstrIr* phi = novaInstrIr(c->f, IR_PHI, IR_I1);
+    phi->indice = SEM_VAR;
+    adicionarArgIr(phi, um);
+    adicionarArgIr(phi, zero);
+    anexarInstrIr(fim, phi);
+    return phi;
+}
+
+static CondIr condicaoDe(TokenType op) {
+    switch (op) {
+        case TOKEN_EQ:  return COND_EQ;
+        case TOKEN_NEQ: return COND_NE;
+        case TOKEN_LT:  return COND_LT;
+        case TOKEN_GT:  return COND_GT;
+        case TOKEN_LEQ: return COND_LE;
+        default:        return COND_GE;
+    }
+}
+
+static InstrIr* gerarBinario(Construtor* c, NoAst* no) {
+    TipoId esq = no->filhos[0]->tipoExpr;
+    TipoId dir = no->filhos[1]->tipoExpr;
+    InstrIr* a;
+    InstrIr* b;
+
+    switch (no->op) {
+        case TOKEN_AND:
+        case TOKEN_OR:
+            return gerarLogico(c, no);
+
+        case TOKEN_EQ: case TOKEN_NEQ:
+        case TOKEN_LT: case TOKEN_GT:
+        case TOKEN_LEQ: case TOKEN_GEQ: {
+            TipoIr tipo = (esq == TIPO_FLOAT || dir == TIPO_FLOAT) ? IR_F32 : IR_I32;
+            a = gerarExprComo(c, no->filhos[0], tipo);
+            b = gerarExprComo(c, no->filhos[1], tipo);
+            InstrIr* cmp = instr2(c, IR_CMP, IR_I1, a, b);
+            cmp->cond = condicaoDe(no->op);
+            return cmp;
+        }
+
+        default: {
+            // char op char continua char; com int, int; com float, float
+            TipoIr tipo = tipoIrDe(no->tipoExpr);
+            OpIr op = no->op == TOKEN_PLUS  ? IR_ADD :
+                      no->op == TOKEN_MINUS ? IR_SUB :
+                      no->op == TOKEN_MUL   ? IR_MUL : IR_DIV;
+            a = gerarExprComo(c, no->filhos[0], tipo);
+            b = gerarExprComo(c, no->filhos[1], tipo);
+            return instr2(c, op, tipo, a, b);
+        }
+    }
+}
+
+static InstrIr* gerarExprNo(Construtor* c, NoAst* no) {
+    InstrIr* v;
+    Simbolo* s;
+
+    switch (no->tipo) {
+        case NO_CONST_INT:
+            return constante(c, IR_I32, no->valor.intVal);
+
+        case NO_CONST_CHAR:
+            return constante(c, IR_I8, no->valor.charVal);
+
+        case NO_CONST_BOOL:
+            return constante(c, IR_I1, no->valor.boolVal ? 1 : 0);
+
+        case NO_CONST_REAL:
+            return constanteFloat(c, no->valor.realVal);
+
+        case NO_ID:
+            return lerVariavel(c, no->simbolo);
+
+        case NO_INDEXACAO:
+            s = simbolo(no->simbolo);
+            v = gerarExprComo(c, no->filhos[0], IR_I32);
+            if (s->tipoId == TIPO_STRING) {
+                // s[i]: leitura pelo runtime (0 fora dos limites)
+                return chamarRuntime(c, "csrt_str_char", IR_I8, enderecoVariavel(c, no->simbolo), v, NULL);
+            }
+            return instr1(c, IR_LOAD, tipoIrDe(tipoElemento(s->tipoId)), gerarElemento(c, no->simbolo, v));
+
+        case NO_CHAMADA: {
+            int slot = -1;
+            v = gerarChamada(c, no, &slot);
+            if (!v) {
+                erroConstrucao(c, "Chamada sem valor usada em expressão", no->nome);
+                return constante(c, IR_I32, 0);
+            }
+            return v;
+        }
+
+        case NO_UNARIO:
+            if (no->op == TOKEN_NOT) {
+                return instr1(c, IR_NOT, IR_I1, gerarExprComo(c, no->filhos[0], IR_I1));
+            }
+            v = gerarExprComo(c, no->filhos[0], tipoIrDe(no->tipoExpr));
+            if (no->op == TOKEN_MINUS) v = instr1(c, IR_NEG, v->tipo, v);
+            return v;
+
+        case NO_BINARIO:
+            return gerarBinario(c, no);
+
+        default:
+            erroConstrucao(c, "Expressão não suportada na geração de código", no->nome ? no->nome : "?");
+            return constante(c, IR_I32, 0);
+    }
+}
+
+static InstrIr* gerarExpr(Construtor* c, NoAst* no) {
+    int linha = c->linha;
+    c->linha = no->linha;
+    InstrIr* v = gerarExprNo(c, no);
+    c->linha = linha;
+    return v;
+}
+
+// Desvia conforme a condição; && || e ! viram desvios diretos (curto-circuito)
+static void gerarDesvio(Construtor* c, NoAst* cond, BlocoIr* verdadeiro, BlocoIr* falso) {
+    if (cond->tipo == NO_BINARIO && (cond->op == TOKEN_AND || cond->op == TOKEN_OR)) {
+        BlocoIr* meio = novoBloco(c);
+        if (cond->op == TOKEN_AND) gerarDesvio(c, cond->filhos[0], meio, falso);
+        else gerarDesvio(c, cond->filhos[0], verdadeiro, meio);
+        selar(c, meio);
+        c->atual = meio;
+        gerarDesvio(c, cond->filhos[1], verdadeiro, falso);
+        return;
+    }
+
+    if (cond->tipo == NO_UNARIO && cond->op == TOKEN_NOT) {
+        gerarDesvio(c, cond->filhos[0], falso, verdadeiro);
+        return;
+    }
+
+    InstrIr* v = gerarExprComo(c, cond, IR_I1);
+    desviarSe(c, v, verdadeiro, falso);
+}
+
+// ===================
+// Comandos
+// ===================
+
+static void gerarCmd(Construtor* c, NoAst* no);
+
+static void gerarListaCmds(Construtor* c, NoAst* lista) {
+    for (NoAst* cmd = lista; cmd; cmd = cmd->prox) gerarCmd(c, cmd);
+}
+
+// A expressão contém chamadas (que poderiam alterar variáveis)?
+static bool temChamada(const NoAst* no) {
+    if (!no) return false;
+    if (no->tipo == NO_CHAMADA) return true;
+    for (int i = 0; i < 4; i++) {
+        if (temChamada(no->filhos[i])) return true;
+    }
+    return false;
+}
+
+// s = strcat(s, x): x é anexado ao buffer de s, sem montar uma string nova
+static bool ehAnexo(const NoAst* no) {
+    const NoAst* valor = no->filhos[1];
+    if (valor->tipo != NO_CHAMADA) return false;
+
+    const Simbolo* f = simbolo(valor->simbolo);
+    if (!f->embutida || strcmp(f->nome, "strcat") != 0) return false;
+
+    const NoAst* primeiro = valor->filhos[0];
+    return primeiro->tipo == NO_ID && primeiro->simbolo == no->simbolo && !temChamada(primeiro->prox);
+}
+
+// Atribuição de string: temporários são movidos, variáveis e constantes copiadas
+static void gerarAtribuicaoString(Construtor* c, NoAst* no) {
+    ValorString v;
+    const char* funcao;
+
+    if (ehAnexo(no)) {
+        v = gerarString(c, no->filhos[1]->filhos[0]->prox);
+        funcao = "csrt_str_anexar";
+    } else {
+        v = gerarString(c, no->filhos[1]);
+        funcao = v.proprio >= 0 ? "csrt_str_mover" : "csrt_str_copiar";
+    }
+
+    chamarRuntime(c, funcao, IR_VOID, enderecoVariavel(c, no->simbolo), v.endereco, NULL);
+    if (v.proprio >= 0 && strcmp(funcao, "csrt_str_mover") != 0) liberarTempString(c, v.proprio);
+}
+
+static void gerarAtribuicao(Construtor* c, NoAst* no) {
+    TipoId destino = no->tipoExpr;
+
+    if (destino == TIPO_STRING) {
+        gerarAtribuicaoString(c, no);
+        return;
+    }
+
+    // Vetor inteiro: a análise semântica já conferiu que os tamanhos são iguais
+    if (tipoIdEhVetor(destino)) {
+        int origem = no->filhos[1]->simbolo;
+        if (origem == no->simbolo) return;
+        InstrIr* copia = instr2(c, IR_COPIAR, IR_VOID, enderecoVariavel(c, no->simbolo), enderecoVariavel(c, origem));
+        copia->tamanho = bytesVetorIr(destino, simbolo(no->simbolo)->tamanho);
+        return;
+    }
+
+    if (no->filhos[0]) {
+        InstrIr* indice = gerarExprComo(c, no->filhos[0], IR_I32);
+        InstrIr* valor = gerarExprComo(c, no->filhos[1], tipoIrDe(destino));
+        instr2(c, IR_STORE, IR_VOID, gerarElemento(c, no->simbolo, indice), valor);
+        return;
+    }
+
+    escreverVariavel(c, no->simbolo, gerarExprComo(c, no->filhos[1], tipoIrDe(destino)));
+}
+
+static void gerarRetorno(Construtor* c, NoAst* no) {
+    TipoId tipo = simbolo(c->decl->simbolo)->tipoId;
+    InstrIr* valor = NULL;
+
+    if (no->filhos[0] && tipo == TIPO_STRING) {
+        ValorString v = gerarString(c, no->filhos[0]);
+        chamarRuntime(c, v.proprio >= 0 ? "csrt_str_mover" : "csrt_str_copiar", IR_VOID,
+                      c->enderecoRetorno, v.endereco, NULL);
+    } else if (no->filhos[0]) {
+        valor = gerarExprComo(c, no->filhos[0], c->f->retorno);
+    }
+
+    if (c->saida) {
+        if (valor) escreverVar(c, c->varRetorno, blocoAtual(c), valor);
+        desviar(c, c->saida);
+        return;
+    }
+
+    InstrIr* ret = novaInstrIr(c->f, IR_RET, IR_VOID);
+    if (valor) adicionarArgIr(ret, valor);
+    emitir(c, ret);
+    c->atual = NULL;
+}
+
+// switch: um teste 'x == rótulo' por case, na ordem do fonte, e os corpos
+// em seguida (sem break, um corpo continua no próximo). A geração de código
+// troca a cadeia de testes por uma tabela de saltos ou uma busca binária.
+static void gerarSwitch(Construtor* c, NoAst* no) {
+    InstrIr* valor = gerarExprComo(c, no->filhos[0], IR_I32);
+    BlocoIr* fim = novoBloco(c);
+    BlocoIr* padrao = fim;
+
+    int nCasos = 0;
+    NoAst* ultimoRotulo = NULL;
+    for (NoAst* caso = no->filhos[1]; caso; caso = caso->prox) {
+        if (caso->filhos[0]) ultimoRotulo = caso;
+        nCasos++;
+    }
+
+    BlocoIr** corpos = malloc((nCasos ? nCasos : 1) * sizeof(BlocoIr*));
+    int k = 0;
+    for (NoAst* caso = no->filhos[1]; caso; caso = caso->prox, k++) {
+        corpos[k] = novoBloco(c);
+        if (!caso->filhos[0]) padrao = corpos[k];
+    }
+
+    k = 0;
+    for (NoAst* caso = no->filhos[1]; caso; caso = caso->prox, k++) {
+        if (!caso->filhos[0]) continue;
+        BlocoIr* proximo = caso == ultimoRotulo ? padrao : novoBloco(c);
+        InstrIr* rotulo = constante(c, IR_I32, caso->valor.intVal);
+        InstrIr* cmp = instr2(c, IR_CMP, IR_I1, valor, rotulo);
+        cmp->cond = COND_EQ;
+        desviarSe(c, cmp, corpos[k], proximo);
+        if (caso == ultimoRotulo) break;
+        selar(c, proximo);
+        c->atual = proximo;
+    }
+    if (!ultimoRotulo) desviar(c, padrao);
+
+    BlocoIr* quebra = c->quebra;
+    c->quebra = fim;
+    k = 0;
+    for (NoAst* caso = no->filhos[1]; caso; caso = caso->prox, k++) {
+        if (c->atual) desviar(c, corpos[k]);
+        selar(c, corpos[k]);
+        c->atual = corpos[k];
+        gerarListaCmds(c, caso->filhos[1]);
+    }
+    if (c->atual) desviar(c, fim);
+    c->quebra = quebra;
+
+    selar(c, fim);
+    c->atual = fim;
+    free(corpos);
+}
+
+static void gerarCmd(Construtor* c, NoAst* no) {
+    if (!no) return;
+    c->linha = no->linha;
+
+    BlocoIr* entao;
+    BlocoIr* senao;
+    BlocoIr* cabecalho;
+    BlocoIr* corpo;
+    BlocoIr* fim;
+    BlocoIr* quebra = c->quebra;
+
+    switch (no->tipo) {
+        case NO_IF:
+            entao = novoBloco(c);
+            fim = novoBloco(c);
+            senao = no->filhos[2] ? novoBloco(c) : fim;
+
+            gerarDesvio(c, no->filhos[0], entao, senao);
+            selar(c, entao);
+            c->atual = entao;
+            gerarCmd(c, no->filhos[1]);
+            if (c->atual) desviar(c, fim);
+
+            if (no->filhos[2]) {
+                selar(c, senao);
+                c->atual = senao;
+                gerarCmd(c, no->filhos[2]);
+                if (c->atual) desviar(c, fim);
+            }
+            selar(c, fim);
+            c->atual = fim;
+            break;
+
+        case NO_WHILE:
+            cabecalho = novoBloco(c);
+            corpo = novoBloco(c);
+            fim = novoBloco(c);
+
+            desviar(c, cabecalho);
+            c->atual = cabecalho;
+            gerarDesvio(c, no->filhos[0], corpo, fim);
+
+            selar(c, corpo);
+            c->atual = corpo;
+            c->quebra = fim;
+            gerarCmd(c, no->filhos[1]);
+            c->quebra = quebra;
+            if (c->atual) desviar(c, cabecalho);
+
+            selar(c, cabecalho);
+            selar(c, fim);
+            c->atual = fim;
+            break;
+
+        case NO_FOR:
+            gerarCmd(c, no->filhos[0]);
+
+            cabecalho = novoBloco(c);
+            cabecalho->paralelo = no->valor.boolVal;
+            corpo = novoBloco(c);
+            fim = novoBloco(c);
+
+            desviar(c, cabecalho);
+            c->atual = cabecalho;
+            if (no->filhos[1]) gerarDesvio(c, no->filhos[1], corpo, fim);
+            else desviar(c, corpo);
+
+            selar(c, corpo);
+            c->atual = corpo;
+            c->quebra = fim;
+            gerarCmd(c, no->filhos[3]);
+            c->quebra = quebra;
+            gerarCmd(c, no->filhos[2]);
+            if (c->atual) desviar(c, cabecalho);
+
+            selar(c, cabecalho);
+            selar(c, fim);
+            c->atual = fim;
+            break;
+
+        case NO_SWITCH:
+            gerarSwitch(c, no);
+            break;
+
+        case NO_BREAK:
+            desviar(c, c->quebra);
+            break;
+
+        case NO_RETURN:
+            gerarRetorno(c, no);
+            break;
+
+        case NO_ATRIB:
+            gerarAtribuicao(c, no);
+            break;
+
+        case NO_CMD_CHAMADA: {
+            int slot = -1;
+            gerarChamada(c, no, &slot);
+            break;
+        }
+
+        case NO_BLOCO:
+            gerarListaCmds(c, no->filhos[0]);
+            break;
+
+        default:
+            break;
+    }
+}
+
+// ===================
+// Funções
+// ===================
+
+// Marca as variáveis passadas por referência (precisam ficar em memória)
+static void marcarEnderecados(Construtor* c, NoAst* no, bool* enderecado) {
+    for (; no; no = no->prox) {
+        if ((no->tipo == NO_CHAMADA || no->tipo == NO_CMD_CHAMADA) && no->simbolo >= 0) {
+            Simbolo* f = simbolo(no->simbolo);
+            int i = 0;
+            for (NoAst* a = no->filhos[0]; a && i < f->nParams; a = a->prox, i++) {
+                if (f->modosParams[i] == PARAM_REFERENCIA && a->tipo == NO_ID && ehLocal(c, a->simbolo)) {
+                    enderecado[a->simbolo - c->baseSimbolos] = true;
+                }
+            }
+        }
+        for (int k = 0; k < 4; k++) marcarEnderecados(c, no->filhos[k], enderecado);
+    }
+}
+
+static bool ehEscalarSsa(const Simbolo* s) {
+    switch (s->tipoId) {
+        case TIPO_INT:
+        case TIPO_CHAR:
+        case TIPO_BOOL:
+        case TIPO_FLOAT:
+            return s->posParam < 0 || s->modoParam == PARAM_VALOR;
+        default:
+            return false;
+    }
+}
+
+// Decide onde vive cada parâmetro e local e prepara a entrada da função
+static void prepararVariaveis(Construtor* c) {
+    NoAst* func = c->decl;
+    int menor = -1, maior = -1;
+
+    for (int lista = 0; lista < 2; lista++) {
+        for (NoAst* d = func->filhos[lista]; d; d = d->prox) {
+            if (menor < 0 || d->simbolo < menor) menor = d->simbolo;
+            if (d->simbolo > maior) maior = d->simbolo;
+        }
+    }
+
+    c->baseSimbolos = menor < 0 ? 0 : menor;
+    c->nSimbolos = menor < 0 ? 0 : maior - menor + 1;
+    int n = c->nSimbolos > 0 ? c->nSimbolos : 1;
+    c->varDe = malloc(n * sizeof(int));
+    c->slotDe = malloc(n * sizeof(int));
+    c->paramDe = calloc(n, sizeof(InstrIr*));
+    c->tipoVar = malloc((n + 1) * sizeof(TipoIr));
+    for (int k = 0; k < n; k++) {
+        c->varDe[k] = SEM_VAR;
+        c->slotDe[k] = -1;
+    }
+
+    bool* enderecado = calloc(n, sizeof(bool));
+    marcarEnderecados(c, func->filhos[2], enderecado);
+
+    bool liberaStrings = false;
+    for (int lista = 0; lista < 2; lista++) {
+        for (NoAst* d = func->filhos[lista]; d; d = d->prox) {
+            Simbolo* s = simbolo(d->simbolo);
+            int k = d->simbolo - c->baseSimbolos;
+
+            if (ehEscalarSsa(s) && !enderecado[k]) {
+                c->tipoVar[c->nVars] = tipoIrDe(s->tipoId);
+                c->varDe[k] = c->nVars++;
+            } else if (tipoIdEhVetor(s->tipoId) && s->posParam < 0) {
+                c->slotDe[k] = novoSlotIr(c->f, bytesVetorIr(s->tipoId, s->tamanho), 16, d->simbolo);
+            } else if (s->tipoId == TIPO_STRING && (s->posParam < 0 || s->modoParam == PARAM_VALOR)) {
+                c->slotDe[k] = novoSlotIr(c->f, 16, 16, d->simbolo);
+                liberaStrings = true;
+            } else if (s->posParam < 0 || s->modoParam == PARAM_VALOR) {
+                int tam = tamanhoEscalar(s->tipoId);
+                c->slotDe[k] = novoSlotIr(c->f, tam, tam, d->simbolo);
+            }
+        }
+    }
+    free(enderecado);
+
+    // Valor devolvido à saída comum
+    c->varRetorno = c->nVars;
+    c->tipoVar[c->varRetorno] = c->f->retorno;
+
+    c->capBlocos = 0;
+    BlocoIr* entrada = novoBloco(c);
+    c->selado[entrada->id] = true;
+    c->atual = entrada;
+
+    if (liberaStrings) c->saida = novoBloco(c);
+}
+
+static void gerarEntrada(Construtor* c) {
+    NoAst* func = c->decl;
+    FuncaoIr* f = c->f;
+    int pos = 0;
+
+    // Funções string recebem o endereço do resultado como primeiro parâmetro
+    if (simbolo(func->simbolo)->tipoId == TIPO_STRING) {
+        f->tiposParams[f->nParams++] = IR_PTR;
+        c->enderecoRetorno = instr0(c, IR_PARAM, IR_PTR);
+        c->enderecoRetorno->indice = pos++;
+    }
+
+    for (NoAst* p = func->filhos[0]; p; p = p->prox) {
+        Simbolo* s = simbolo(p->simbolo);
+        bool ponteiro = s->modoParam != PARAM_VALOR || s->tipoId == TIPO_STRING;
+        TipoIr tipo = ponteiro ? IR_PTR : tipoIrDe(s->tipoId);
+        int k = p->simbolo - c->baseSimbolos;
+
+        f->tiposParams[f->nParams++] = tipo;
+        InstrIr* param = instr0(c, IR_PARAM, tipo);
+        param->indice = pos++;
+        c->paramDe[k] = param;
+    }
+
+    // Parâmetros que vivem em memória recebem o valor na entrada
+    for (NoAst* p = func->filhos[0]; p; p = p->prox) {
+        Simbolo* s = simbolo(p->simbolo);
+        int k = p->simbolo - c->baseSimbolos;
+
+        if (c->varDe[k] != SEM_VAR) {
+            escreverVar(c, c->varDe[k], c->atual, c->paramDe[k]);
+        } else if (s->tipoId == TIPO_STRING && s->modoParam == PARAM_VALOR) {
+            // Recebe o endereço de uma cópia que passa a ser desta função
+            InstrIr* copia = instr2(c, IR_COPIAR, IR_VOID, enderecoSlot(c, c->slotDe[k]), c->paramDe[k]);
+            copia->tamanho = 16;
+        } else if (c->slotDe[k] >= 0) {
+            instr2(c, IR_STORE, IR_VOID, enderecoSlot(c, c->slotDe[k]), c->paramDe[k]);
+        }
+    }
+
+    // Strings locais começam vazias, assim como o resultado
+    for (NoAst* v = func->filhos[1]; v; v = v->prox) {
+        if (simbolo(v->simbolo)->tipoId != TIPO_STRING) continue;
+        InstrIr* z = instr1(c, IR_ZERAR, IR_VOID, enderecoSlot(c, c->slotDe[v->simbolo - c->baseSimbolos]));
+        z->tamanho = 16;
+    }
+    if (c->enderecoRetorno) {
+        InstrIr* z = instr1(c, IR_ZERAR, IR_VOID, c->enderecoRetorno);
+        z->tamanho = 16;
+    }
+}
+
+// Saída comum: libera as strings da função e devolve o valor
+static void gerarSaida(Construtor* c) {
+    NoAst* func = c->decl;
+
+    selar(c, c->saida);
+    c->atual = c->saida;
+
+    InstrIr* valor = c->f->retorno != IR_VOID ? lerVar(c, c->varRetorno, c->saida) : NULL;
+
+    for (int lista = 0; lista < 2; lista++) {
+        for (NoAst* d = func->filhos[lista]; d; d = d->prox) {
+            Simbolo* s = simbolo(d->simbolo);
+            if (s->tipoId != TIPO_STRING || (s->posParam >= 0 && s->modoParam != PARAM_VALOR)) continue;
+            chamarRuntime(c, "csrt_str_liberar", IR_VOID,
+                          enderecoSlot(c, c->slotDe[d->simbolo - c->baseSimbolos]), NULL, NULL);
+        }
+    }
+
+    InstrIr* ret = novaInstrIr(c->f, IR_RET, IR_VOID);
+    if (valor) adicionarArgIr(ret, valor);
+    emitir(c, ret);
+    c->atual = NULL;
+}
+
+static void liberarConstrutor(Construtor* c) {
+    for (int b = 0; b < c->f->nBlocos; b++) {
+        free(c->defs[b]);
+        free(c->incompletos[b]);
+    }
+    for (int i = 0; i < c->nRemovidos; i++) liberarInstrIr(c->removidos[i]);
+    free(c->removidos);
+    free(c->substitutos);
+    free(c->defs);
+    free(c->incompletos);
+    free(c->selado);
+    free(c->varDe);
+    free(c->slotDe);
+    free(c->paramDe);
+    free(c->tipoVar);
+}
+
+static FuncaoIr* construirFuncao(NoAst* func, bool* falhou) {
+    Construtor c;
+    memset(&c, 0, sizeof(c));
+
+    TipoId retorno = simbolo(func->simbolo)->tipoId;
+    c.f = novaFuncaoIr(func->nome, func->simbolo);
+    c.f->retorno = retorno == TIPO_STRING ? IR_VOID : tipoIrDe(retorno);
+    c.decl = func;
+
+    prepararVariaveis(&c);
+    gerarEntrada(&c);
+    gerarListaCmds(&c, func->filhos[2]);
+
+    // Fim do corpo sem return: devolve zero
+    if (c.atual) {
+        NoAst fimSemValor;
+        memset(&fimSemValor, 0, sizeof(fimSemValor));
+        fimSemValor.tipo = NO_RETURN;
+
+        if (c.f->retorno != IR_VOID) {
+            InstrIr* zero = c.f->retorno == IR_F32 ? constanteFloat(&c, 0.0f) : constante(&c, c.f->retorno, 0);
+            if (c.saida) {
+                escreverVar(&c, c.varRetorno, c.atual, zero);
+                desviar(&c, c.saida);
+            } else {
+                InstrIr* ret = novaInstrIr(c.f, IR_RET, IR_VOID);
+                adicionarArgIr(ret, zero);
+                emitir(&c, ret);
+            }
+        } else {
+            gerarRetorno(&c, &fimSemValor);
+        }
+    }
+    if (c.saida) gerarSaida(&c);
+
+    if (c.falhou) *falhou = true;
+    liberarConstrutor(&c);
+
+    removerBlocosInalcancaveisIr(c.f);
+    return c.f;
+}
+
+ProgramaIr* construirIr(NoAst* programa) {
+    ProgramaIr* p = calloc(1, sizeof(ProgramaIr));
+    bool falhou = false;
+    int nDecls = tamanhoLista(programa->filhos[0]);
+
+    p->funcoes = calloc(nDecls > 0 ? nDecls : 1, sizeof(FuncaoIr*));
+    p->globais = calloc(nDecls > 0 ? nDecls : 1, sizeof(int));
+
+    for (NoAst* d = programa->filhos[0]; d; d = d->prox) {
+        if (d->tipo == NO_DECL_VAR) {
+            p->globais[p->nGlobais++] = d->simbolo;
+        } else if (d->tipo == NO_FUNCAO && d->temCorpo) {
+            p->funcoes[p->nFuncoes++] = construirFuncao(d, &falhou);
+        }
+    }
+
+    if (falhou) {
+        liberarProgramaIr(p);
+        return NULL;
+    }
+    return p;
+}
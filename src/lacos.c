@@ -0,0 +1,184 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "otimizacao.h"
+
+// ==============================================
+// LAÇOS NATURAIS
+// ==============================================
+//
+// Uma aresta b -> h em que h domina b fecha um laço; o corpo são os blocos
+// que chegam a b sem passar por h. Laços com o mesmo cabeçalho são
+// juntados. Todo laço recebe um pré-cabeçalho: o único predecessor de fora,
+// terminando em 'jmp cabeçalho', onde os passes põem o que sai do laço.
+
+static bool ehCabecalho(const BlocoIr* h) {
+    for (int p = 0; p < h->nPreds; p++) {
+        if (dominaIr(h, h->preds[p])) return true;
+    }
+    return false;
+}
+
+static int compararRpo(const void* a, const void* b) {
+    return (*(BlocoIr* const*)a)->rpo - (*(BlocoIr* const*)b)->rpo;
+}
+
+// Corpo do laço de 'h': sobe pelos predecessores a partir das arestas de volta
+static LacoIr* corpoDoLaco(FuncaoIr* f, BlocoIr* h) {
+    LacoIr* l = calloc(1, sizeof(LacoIr));
+    l->cabecalho = h;
+    l->contem = calloc(f->nBlocos, sizeof(bool));
+    l->blocos = malloc(f->nBlocos * sizeof(BlocoIr*));
+
+    l->contem[h->id] = true;
+    l->blocos[l->nBlocos++] = h;
+
+    int topo = 0;
+    BlocoIr** pilha = malloc(f->nBlocos * sizeof(BlocoIr*));
+    for (int p = 0; p < h->nPreds; p++) {
+        BlocoIr* b = h->preds[p];
+        if (!dominaIr(h, b) || l->contem[b->id]) continue;
+        l->contem[b->id] = true;
+        l->blocos[l->nBlocos++] = b;
+        pilha[topo++] = b;
+    }
+
+    while (topo > 0) {
+        BlocoIr* b = pilha[--topo];
+        for (int p = 0; p < b->nPreds; p++) {
+            BlocoIr* pred = b->preds[p];
+            if (pred->rpo < 0 || l->contem[pred->id]) continue;
+            l->contem[pred->id] = true;
+            l->blocos[l->nBlocos++] = pred;
+            pilha[topo++] = pred;
+        }
+    }
+    free(pilha);
+
+    qsort(l->blocos, l->nBlocos, sizeof(BlocoIr*), compararRpo);
+    return l;
+}
+
+static void liberarLaco(LacoIr* l) {
+    free(l->blocos);
+    free(l->contem);
+    free(l);
+}
+
+// Garante o pré-cabeçalho; devolve se precisou criar um bloco
+static bool criarPreCabecalho(FuncaoIr* f, LacoIr* l) {
+    BlocoIr* h = l->cabecalho;
+    int nFora = 0;
+    BlocoIr* fora = NULL;
+
+    for (int p = 0; p < h->nPreds; p++) {
+        if (l->contem[h->preds[p]->id]) continue;
+        fora = h->preds[p];
+        nFora++;
+    }
+    if (nFora == 1 && terminadorIr(fora)->op == IR_JMP) {
+        l->preCabecalho = fora;
+        return false;
+    }
+
+    BlocoIr* pre = novoBlocoIr(f);
+
+    // Os valores que vêm de fora passam a chegar por um phi no pré-cabeçalho
+    for (InstrIr* phi = h->primeira; phi && phi->op == IR_PHI; phi = phi->prox) {
+        InstrIr* entrada = NULL;
+        if (nFora > 1) {
+            entrada = novaInstrIr(f, IR_PHI, phi->tipo);
+            entrada->linha = phi->linha;
+            for (int p = 0; p < h->nPreds; p++) {
+                if (!l->contem[h->preds[p]->id]) adicionarArgIr(entrada, phi->args[p]);
+            }
+            anexarInstrIr(pre, entrada);
+        } else {
+            for (int p = 0; p < h->nPreds; p++) {
+                if (!l->contem[h->preds[p]->id]) entrada = phi->args[p];
+            }
+        }
+        adicionarArgIr(phi, entrada);
+    }
+
+    // Ordem dos preds de 'pre' = ordem dos operandos dos phi novos
+    for (int p = 0; p < h->nPreds; p++) {
+        BlocoIr* pred = h->preds[p];
+        if (l->contem[pred->id]) continue;
+        adicionarPredIr(pre, pred);
+        InstrIr* t = terminadorIr(pred);
+        for (int k = 0; k < 2; k++) {
+            if (t->alvos[k] == h) t->alvos[k] = pre;
+        }
+    }
+
+    // O operando de 'pre' já está no fim de cada phi; 'pre' entra por último nos preds
+    for (int p = h->nPreds - 1; p >= 0; p--) {
+        if (!l->contem[h->preds[p]->id]) removerPredIr(h, p);
+    }
+    adicionarPredIr(h, pre);
+
+    InstrIr* jmp = novaInstrIr(f, IR_JMP, IR_VOID);
+    jmp->alvos[0] = h;
+    jmp->linha = h->primeira ? h->primeira->linha : 0;
+    anexarInstrIr(pre, jmp);
+
+    l->preCabecalho = pre;
+    return true;
+}
+
+// Cabeçalhos (em pós-ordem reversa) e os corpos dos seus laços
+static int detectar(FuncaoIr* f, LacoIr*** lacos) {
+    calcularDominadoresIr(f);
+
+    int n = 0;
+    *lacos = malloc((f->nBlocos > 0 ? f->nBlocos : 1) * sizeof(LacoIr*));
+    for (int b = 0; b < f->nBlocos; b++) {
+        BlocoIr* h = f->blocos[b];
+        if (h->rpo >= 0 && ehCabecalho(h)) (*lacos)[n++] = corpoDoLaco(f, h);
+    }
+    return n;
+}
+
+static int compararTamanho(const void* a, const void* b) {
+    return (*(LacoIr* const*)a)->nBlocos - (*(LacoIr* const*)b)->nBlocos;
+}
+
+LacoIr** encontrarLacosIr(FuncaoIr* f, int* nLacos) {
+    LacoIr** lacos;
+    int n = detectar(f, &lacos);
+
+    // Blocos novos mudam os dominadores e os corpos: detecta de novo
+    bool criou = false;
+    for (int k = 0; k < n; k++) criou |= criarPreCabecalho(f, lacos[k]);
+    if (criou) {
+        liberarLacosIr(lacos, n);
+        n = detectar(f, &lacos);
+        for (int k = 0; k < n; k++) criarPreCabecalho(f, lacos[k]);
+    }
+
+    // Internos primeiro: um laço contido em outro tem menos blocos
+    qsort(lacos, n, sizeof(LacoIr*), compararTamanho);
+    for (int k = 0; k < n; k++) {
+        for (int j = k + 1; j < n && !lacos[k]->pai; j++) {
+            if (lacos[j]->contem[lacos[k]->cabecalho->id]) lacos[k]->pai = lacos[j];
+        }
+    }
+
+    *nLacos = n;
+    return lacos;
+}
+
+void liberarLacosIr(LacoIr** lacos, int n) {
+    for (int k = 0; k < n; k++) liberarLaco(lacos[k]);
+    free(lacos);
+}
+
+bool enderecoValidoIr(const InstrIr* end) {
+    if (end->op == IR_ELEM) {
+        const InstrIr* indice = end->args[1];
+        return indice->op == IR_CONST && indice->imm.i >= 0 && indice->imm.i < end->tamanho
+               && enderecoValidoIr(end->args[0]);
+    }
+    return end->op == IR_GLOBAL || end->op == IR_LOCAL || end->op == IR_PARAM;
+}
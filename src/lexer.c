@@ -15,15 +15,21 @@ static FILE* sourceFile = NULL;
 int contLinha = 1;
 static int contColuna = 1;
 
+// Quantidade de bytes já lidos do arquivo (usado para o deslocamento dos tokens)
+static long contOffset = 0;
+
+// Deslocamento do primeiro caractere do token em construção
+static long offsetToken = 0;
+
 // Último caractere lido
 static int lastChar = ' ';
 
 // Lista de palavras-chave reconhecidas pela linguagem
-#define MAX_KEYWORDS 16
+#define MAX_KEYWORDS 17
 const char* keywords[] = {
     "if", "else", "while", "for", "return",
     "int", "float", "char", "void", "string",
-    "break", "continue", "do", "switch", "case", "default"
+    "break", "continue", "do", "switch", "case", "default", "parallel"
 };
 
 const char* tokenTypeName(TokenType type) {
@@ -58,13 +64,14 @@ const char* tokenTypeName(TokenType type) {
         case TOKEN_RBRACE: return "}";
         case TOKEN_SEMICOLON: return ";";
         case TOKEN_COMMA: return ",";
+        case TOKEN_COLON: return ":";
         case TOKEN_EOF: return "EOF";
         case TOKEN_INVALID: return "inválido";
         default: return "desconhecido";
     }
 }
 
-const int numKeywords = 16;
+const int numKeywords = 17;
 
 // ==============================
 // FUNÇÕES AUXILIARES
@@ -78,31 +85,64 @@ int isKeyword(const char* lexeme) {
     return 0;
 }
 
+// Valor de uma constante de caractere a partir do lexema ('a', '\n', '\0', ...)
+static char valorCaractere(const char* lexeme) {
+    if (lexeme[1] != '\\') return lexeme[1];
+
+    switch (lexeme[2]) {
+        case 'n': return '\n';
+        case 't': return '\t';
+        case 'r': return '\r';
+        case '0': return '\0';
+        default:  return lexeme[2];   // \\, \', \" e demais escapes literais
+    }
+}
+
 // Cria um token com as informações apropriadas
 Token makeToken(TokenType type, const char* lexeme, int line, int col) {
     Token t;
+    t.offset = offsetToken;
     strncpy(t.lexeme, lexeme, TAM_MAX_LEXEMA - 1);
     t.lexeme[TAM_MAX_LEXEMA - 1] = '\0';
     t.line = line;
     t.column = col;
     t.type = type;
+    t.tamStr = 0;
 
     // Preenche os campos específicos do token
     if (type == TOKEN_INTCON)
         t.intVal = atoi(lexeme);
     else if (type == TOKEN_REALCON)
         t.realVal = atof(lexeme);
-    else if (type == TOKEN_CHARCON)
-        t.charVal = lexeme[0];
+    else if (type == TOKEN_CHARCON || type == TOKEN_CHARCON_N || type == TOKEN_CHARCON_0)
+        t.charVal = valorCaractere(lexeme);
     else
         t.strVal = strdup(lexeme); // para strings e identificadores
 
     return t;
 }
 
+// Cria um token de string com o conteúdo completo (o lexema guarda só o início)
+static Token makeStringToken(char* conteudo, int tam, int line, int col) {
+    char lexeme[TAM_MAX_LEXEMA];
+    int n = tam < TAM_MAX_LEXEMA - 3 ? tam : TAM_MAX_LEXEMA - 3;
+
+    lexeme[0] = '"';
+    memcpy(lexeme + 1, conteudo, n);
+    lexeme[n + 1] = '"';
+    lexeme[n + 2] = '\0';
+
+    Token t = makeToken(TOKEN_STRINGCON, lexeme, line, col);
+    free(t.strVal);
+    t.strVal = conteudo;
+    t.tamStr = tam;
+    return t;
+}
+
 // Lê o próximo caractere do arquivo fonte e atualiza contadores
 int nextChar() {
     int c = fgetc(sourceFile);
+    if (c != EOF) contOffset++;
     if (c == '\n') {
         contLinha++;
         contColuna = 1;
@@ -128,6 +168,7 @@ void initLexer(FILE* source) {
     sourceFile = source;
     contLinha = 1;
     contColuna = 1;
+    contOffset = 0;
     lastChar = nextChar(); // pega o primeiro caractere
 }
 
@@ -144,6 +185,9 @@ void destroyLexer() {
 Token getNextToken() {
     skipWhitespace();
 
+    // lastChar já foi lido, então ocupa a posição anterior ao contador
+    offsetToken = (lastChar == EOF) ? contOffset : contOffset - 1;
+
     int line = contLinha;
     int col = contColuna;
     char lexeme[TAM_MAX_LEXEMA];
@@ -178,6 +222,7 @@ Token getNextToken() {
         else if (strcmp(lexeme, "switch") == 0) return makeToken(TOKEN_KEYWORD_SWITCH, lexeme, line, col);
         else if (strcmp(lexeme, "case") == 0) return makeToken(TOKEN_KEYWORD_CASE, lexeme, line, col);
         else if (strcmp(lexeme, "default") == 0) return makeToken(TOKEN_KEYWORD_DEFAULT, lexeme, line, col);
+        else if (strcmp(lexeme, "parallel") == 0) return makeToken(TOKEN_KEYWORD_PARALLEL, lexeme, line, col);
         else if (strcmp(lexeme, "string") == 0) return makeToken(TOKEN_KEYWORD_STRING, lexeme, line, col);
         else if (strcmp(lexeme, "true") == 0 || strcmp(lexeme, "false") == 0) return makeToken(TOKEN_BOOLCON, lexeme, line, col);
         else return makeToken(TOKEN_ID, lexeme, line, col);
@@ -239,20 +284,42 @@ Token getNextToken() {
         }
     }
 
-    // Constantes de string (ex: "texto")
+    // Constantes de string (ex: "texto"), sem limite de tamanho
     if (lastChar == '"') {
-        lexeme[i++] = '"'; // adiciona a aspa de abertura
+        int cap = 64;
+        char* conteudo = malloc(cap);
+
         lastChar = nextChar();
-        while (lastChar != '"' && lastChar != EOF && i < TAM_MAX_LEXEMA - 2) {
-            lexeme[i++] = lastChar;
+        while (lastChar != '"' && lastChar != EOF) {
+            int c = lastChar;
+
+            if (c == '\\') {
+                lastChar = nextChar();
+                if (lastChar == EOF) break;
+
+                switch (lastChar) {
+                    case 'n': c = '\n'; break;
+                    case 't': c = '\t'; break;
+                    case 'r': c = '\r'; break;
+                    case '0': c = '\0'; break;
+                    default:  c = lastChar; break;   // \\, \" e demais escapes literais
+                }
+            }
+
+            if (i + 1 >= cap) {
+                cap *= 2;
+                conteudo = realloc(conteudo, cap);
+            }
+            conteudo[i++] = (char)c;
             lastChar = nextChar();
         }
+
         if (lastChar == '"') {
-            lexeme[i++] = '"'; // adiciona a aspa de fechamento
-            lexeme[i] = '\0';
+            conteudo[i] = '\0';
             lastChar = nextChar();
-            return makeToken(TOKEN_STRINGCON, lexeme, line, col);
+            return makeStringToken(conteudo, i, line, col);
         } else {
+            free(conteudo);
             return makeToken(TOKEN_INVALID, "Unclosed string", line, col);
         }
     }
@@ -337,6 +404,7 @@ Token getNextToken() {
         case '}': lastChar = nextChar(); return makeToken(TOKEN_RBRACE, "}", line, col);
         case ';': lastChar = nextChar(); return makeToken(TOKEN_SEMICOLON, ";", line, col);
         case ',': lastChar = nextChar(); return makeToken(TOKEN_COMMA, ",", line, col);
+        case ':': lastChar = nextChar(); return makeToken(TOKEN_COLON, ":", line, col);
         default:
             // Caractere não reconhecido
             lexeme[0] = lastChar;
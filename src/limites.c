@@ -0,0 +1,309 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "otimizacao.h"
+
+// ==============================================
+// VERIFICAÇÕES DE ÍNDICE REDUNDANTES
+// ==============================================
+//
+// Com -fbounds-check todo acesso a vetor de tamanho conhecido passa por
+// 'limite i, n'. Este passe calcula um intervalo para o índice e remove a
+// verificação quando ele cabe em [0, n):
+//
+// - constantes, e contas (+, -, *, /, conversão de char) sobre intervalos;
+// - comparações que dominam o acesso: dentro de 'if (i < 10)' ou do corpo
+//   de 'while (i < n)', i <= 9 (ou i <= max(n) - 1);
+// - variáveis de laço que só crescem (i = i + c, c >= 0) nunca ficam abaixo
+//   do valor inicial, desde que o limite de cima impeça o transbordo; as
+//   que só diminuem, simetricamente;
+// - uma verificação do mesmo índice num bloco dominante com tamanho menor
+//   ou igual já garante a de agora.
+
+#define PROFUNDIDADE_MAXIMA 6
+
+typedef struct {
+    int64_t min, max;
+} Intervalo;
+
+static const Intervalo TUDO = { INT32_MIN, INT32_MAX };
+
+typedef struct {
+    Intervalo* base;        // por id de valor (válido quando estado[id] == 2)
+    char* estado;           // 0 = não calculado, 1 = calculando, 2 = pronto
+} Analise;
+
+static Intervalo intervalo(int64_t min, int64_t max) {
+    if (min < INT32_MIN || max > INT32_MAX || min > max) return TUDO;
+    Intervalo r = { min, max };
+    return r;
+}
+
+static Intervalo unir(Intervalo a, Intervalo b) {
+    Intervalo r = { a.min < b.min ? a.min : b.min, a.max > b.max ? a.max : b.max };
+    return r;
+}
+
+static int64_t menor4(int64_t a, int64_t b, int64_t c, int64_t d) {
+    int64_t m = a < b ? a : b;
+    m = m < c ? m : c;
+    return m < d ? m : d;
+}
+
+static int64_t maior4(int64_t a, int64_t b, int64_t c, int64_t d) {
+    int64_t m = a > b ? a : b;
+    m = m > c ? m : c;
+    return m > d ? m : d;
+}
+
+// Resultado da operação com operandos nos intervalos (TUDO se pode transbordar)
+static Intervalo aplicar(const InstrIr* i, Intervalo a, Intervalo b) {
+    switch (i->op) {
+        case IR_ADD:
+            return intervalo(a.min + b.min, a.max + b.max);
+        case IR_SUB:
+            return intervalo(a.min - b.max, a.max - b.min);
+        case IR_MUL:
+            return intervalo(menor4(a.min * b.min, a.min * b.max, a.max * b.min, a.max * b.max),
+                             maior4(a.min * b.min, a.min * b.max, a.max * b.min, a.max * b.max));
+        case IR_DIV:
+            // Só divisor positivo constante: o quociente trunca em direção a zero
+            if (b.min != b.max || b.min <= 0) return TUDO;
+            return intervalo(a.min / b.min, a.max / b.min);
+        case IR_NEG:
+            return intervalo(-a.max, -a.min);
+        default:
+            return TUDO;
+    }
+}
+
+// ===================
+// Intervalo sem contexto
+// ===================
+
+static Intervalo base(Analise* an, const InstrIr* v);
+
+// Passo constante de uma variável de laço: phi = [inicio..., phi + c...] (0 se não é)
+static int64_t passoInducao(const InstrIr* phi, const InstrIr* atualizacao) {
+    if (atualizacao->op != IR_ADD && atualizacao->op != IR_SUB) return 0;
+    if (atualizacao->args[0] != phi || atualizacao->args[1]->op != IR_CONST) return 0;
+    int64_t c = atualizacao->args[1]->imm.i;
+    return atualizacao->op == IR_ADD ? c : -c;
+}
+
+static Intervalo refinar(Analise* an, const InstrIr* v, const BlocoIr* b, Intervalo r);
+
+// i = phi [i0, i + c]: todas as atualizações andam no mesmo sentido e não transbordam
+static Intervalo baseInducao(Analise* an, const InstrIr* phi) {
+    int sentido = 0;
+    Intervalo inicio = { INT32_MAX, INT32_MIN };
+    bool temInicio = false;
+
+    for (int a = 0; a < phi->nArgs; a++) {
+        const InstrIr* arg = phi->args[a];
+        int64_t passo = passoInducao(phi, arg);
+        if (passo == 0) {
+            if (arg == phi) continue;
+            inicio = temInicio ? unir(inicio, base(an, arg)) : base(an, arg);
+            temInicio = true;
+            continue;
+        }
+        int s = passo > 0 ? 1 : -1;
+        if (sentido && s != sentido) return TUDO;
+        sentido = s;
+    }
+    if (!sentido || !temInicio) return TUDO;
+
+    // Por indução: se phi está no intervalo, phi + c também está, desde que as
+    // comparações no caminho até a conta segurem o outro lado
+    Intervalo suposto = sentido > 0 ? intervalo(inicio.min, INT32_MAX) : intervalo(INT32_MIN, inicio.max);
+    for (int a = 0; a < phi->nArgs; a++) {
+        const InstrIr* arg = phi->args[a];
+        int64_t passo = passoInducao(phi, arg);
+        if (passo == 0) continue;
+        Intervalo antes = refinar(an, phi, arg->bloco, suposto);
+        if (antes.min + passo < INT32_MIN || antes.max + passo > INT32_MAX) return TUDO;
+    }
+    return suposto;
+}
+
+static Intervalo base(Analise* an, const InstrIr* v) {
+    if (v->tipo == IR_I8) return intervalo(-128, 127);
+    if (v->tipo == IR_I1) return intervalo(0, 1);
+    if (v->tipo != IR_I32) return TUDO;
+
+    if (an->estado[v->id] == 2) return an->base[v->id];
+    if (an->estado[v->id] == 1) return TUDO;     // ciclo de phi
+    an->estado[v->id] = 1;
+
+    Intervalo r;
+    switch (v->op) {
+        case IR_CONST:
+            r = intervalo(v->imm.i, v->imm.i);
+            break;
+        case IR_CONV:
+            r = v->args[0]->tipo == IR_I8 || v->args[0]->tipo == IR_I1 ? base(an, v->args[0]) : TUDO;
+            break;
+        case IR_ADD:
+        case IR_SUB:
+        case IR_MUL:
+        case IR_DIV:
+            r = aplicar(v, base(an, v->args[0]), base(an, v->args[1]));
+            break;
+        case IR_NEG:
+            r = aplicar(v, base(an, v->args[0]), TUDO);
+            break;
+        case IR_PHI:
+            r = baseInducao(an, v);
+            if (r.min == TUDO.min && r.max == TUDO.max) {
+                r = base(an, v->args[0]);
+                for (int a = 1; a < v->nArgs; a++) r = unir(r, base(an, v->args[a]));
+            }
+            break;
+        default:
+            r = TUDO;
+            break;
+    }
+
+    an->base[v->id] = r;
+    an->estado[v->id] = 2;
+    return r;
+}
+
+// ===================
+// Comparações dominantes
+// ===================
+
+static CondIr negar(CondIr c) {
+    switch (c) {
+        case COND_EQ: return COND_NE;
+        case COND_NE: return COND_EQ;
+        case COND_LT: return COND_GE;
+        case COND_GE: return COND_LT;
+        case COND_GT: return COND_LE;
+        default:      return COND_GT;   // COND_LE
+    }
+}
+
+static CondIr inverter(CondIr c) {
+    switch (c) {
+        case COND_LT: return COND_GT;
+        case COND_GT: return COND_LT;
+        case COND_LE: return COND_GE;
+        case COND_GE: return COND_LE;
+        default:      return c;
+    }
+}
+
+// v <cond> x, com x em 'outro'
+static Intervalo restringir(Intervalo r, CondIr cond, Intervalo outro) {
+    switch (cond) {
+        case COND_LT: if (outro.max - 1 < r.max) r.max = outro.max - 1; break;
+        case COND_LE: if (outro.max < r.max) r.max = outro.max; break;
+        case COND_GT: if (outro.min + 1 > r.min) r.min = outro.min + 1; break;
+        case COND_GE: if (outro.min > r.min) r.min = outro.min; break;
+        case COND_EQ:
+            if (outro.min > r.min) r.min = outro.min;
+            if (outro.max < r.max) r.max = outro.max;
+            break;
+        default: break;
+    }
+    return r;
+}
+
+// Aplica as comparações das arestas que levam obrigatoriamente a 'b'
+static Intervalo refinar(Analise* an, const InstrIr* v, const BlocoIr* b, Intervalo r) {
+    while (b->idom && b->idom != b) {
+        const BlocoIr* d = b->idom;
+        const InstrIr* br = terminadorIr(d);
+
+        // Só vale se a aresta d -> b é o único jeito de chegar em b
+        if (br && br->op == IR_BR && b->nPreds == 1 && b->preds[0] == d && br->alvos[0] != br->alvos[1]) {
+            const InstrIr* cmp = br->args[0];
+            if (cmp->op == IR_CMP && cmp->args[0]->tipo != IR_F32) {
+                CondIr cond = br->alvos[0] == b ? cmp->cond : negar(cmp->cond);
+                if (cmp->args[0] == v) r = restringir(r, cond, base(an, cmp->args[1]));
+                else if (cmp->args[1] == v) r = restringir(r, inverter(cond), base(an, cmp->args[0]));
+            }
+        }
+        b = d;
+    }
+    return r;
+}
+
+// Intervalo de v quando o controle está em 'b'
+static Intervalo intervaloEm(Analise* an, const InstrIr* v, const BlocoIr* b, int profundidade) {
+    Intervalo r = base(an, v);
+
+    // Contas sobre valores que têm comparações próprias (a[i + 1] dentro de 'i < n - 1')
+    if (profundidade < PROFUNDIDADE_MAXIMA && v->tipo == IR_I32) {
+        if (v->op == IR_ADD || v->op == IR_SUB || v->op == IR_MUL || v->op == IR_DIV) {
+            Intervalo a = intervaloEm(an, v->args[0], b, profundidade + 1);
+            Intervalo c = intervaloEm(an, v->args[1], b, profundidade + 1);
+            Intervalo calculado = aplicar(v, a, c);
+            if (calculado.min > r.min) r.min = calculado.min;
+            if (calculado.max < r.max) r.max = calculado.max;
+        } else if (v->op == IR_NEG) {
+            Intervalo calculado = aplicar(v, intervaloEm(an, v->args[0], b, profundidade + 1), TUDO);
+            if (calculado.min > r.min) r.min = calculado.min;
+            if (calculado.max < r.max) r.max = calculado.max;
+        }
+    }
+    return refinar(an, v, b, r);
+}
+
+// ===================
+// Passe
+// ===================
+
+// Outra verificação do mesmo índice, com tamanho menor ou igual, que sempre roda antes
+static bool jaVerificado(const InstrIr* lim) {
+    const InstrIr* indice = lim->args[0];
+    for (int u = 0; u < indice->nUsos; u++) {
+        const InstrIr* outra = indice->usos[u];
+        if (outra == lim || outra->op != IR_LIMITE || outra->tamanho > lim->tamanho) continue;
+
+        if (outra->bloco == lim->bloco) {
+            for (const InstrIr* i = outra->prox; i; i = i->prox) {
+                if (i == lim) return true;
+            }
+        } else if (dominaIr(outra->bloco, lim->bloco)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool eliminarVerificacoesLimite(FuncaoIr* f) {
+    bool tem = false;
+    for (int b = 0; b < f->nBlocos && !tem; b++) {
+        for (InstrIr* i = f->blocos[b]->primeira; i && !tem; i = i->prox) tem = i->op == IR_LIMITE;
+    }
+    if (!tem) return false;
+
+    calcularDominadoresIr(f);
+    Analise an;
+    an.base = malloc(f->nValores * sizeof(Intervalo));
+    an.estado = calloc(f->nValores, 1);
+    bool mudou = false;
+
+    for (int b = 0; b < f->nBlocos; b++) {
+        InstrIr* i = f->blocos[b]->primeira;
+        while (i) {
+            InstrIr* prox = i->prox;
+            if (i->op == IR_LIMITE && f->blocos[b]->rpo >= 0) {
+                Intervalo r = intervaloEm(&an, i->args[0], i->bloco, 0);
+                if ((r.min >= 0 && r.max < i->tamanho) || jaVerificado(i)) {
+                    removerInstrIr(i);
+                    mudou = true;
+                }
+            }
+            i = prox;
+        }
+    }
+
+    free(an.base);
+    free(an.estado);
+    return mudou;
+}
@@ -1,37 +1,165 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "lexer.h"
-#include "parser.h" 
+#include "parser.h"
 #include "symbols.h"
 #include "semantic.h"
+#include "xref.h"
+#include "ast.h"
+#include "threadpool.h"
+#include "ir.h"
+#include "otimizacao.h"
+#include "codegen.h"
+
+// Mostra as formas de uso do compilador
+static void imprimirUso(const char* prog) {
+    fprintf(stderr, "Uso: %s [-j <threads>] [-O0|-O1] [-finline-limit=<n>] [-fopt-info-vec] [-fopt-info-par] [-fbounds-check] [-o <saida.s>] [--emit-ir <saida.ir>] [--abi sysv|win64] [--xref <saida.xref>] <arquivo-fonte>\n", prog);
+    fprintf(stderr, "     %s --xref-query <indice.xref> <nome>\n", prog);
+}
 
 // Função principal: entrada do compilador
 int main(int argc, char* argv[]) {
+    const char* arquivoFonte = NULL;
+    const char* arquivoXref = NULL;
+    const char* arquivoSaida = NULL;
+    const char* arquivoIr = NULL;
+
+    // Lê as opções da linha de comando
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--xref") == 0 && i + 1 < argc) {
+            arquivoXref = argv[++i];
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            arquivoSaida = argv[++i];
+        } else if (strcmp(argv[i], "--emit-ir") == 0 && i + 1 < argc) {
+            arquivoIr = argv[++i];
+        } else if (strcmp(argv[i], "--abi") == 0 && i + 1 < argc) {
+            AbiAlvo abi;
+            if (!abiDeNome(argv[++i], &abi)) {
+                imprimirUso(argv[0]);
+                return 1;
+            }
+            definirAbiAlvo(abi);
+        } else if (strcmp(argv[i], "-O0") == 0 || strcmp(argv[i], "-O1") == 0) {
+            // -O0 gera o código direto da IR, sem otimizações
+            definirNivelOtimizacao(argv[i][2] - '0');
+        } else if (strncmp(argv[i], "-finline-limit=", 15) == 0) {
+            // Custo máximo (instruções menos o ganho) de uma função expandida na chamada
+            definirLimiteExpansao(atoi(argv[i] + 15));
+        } else if (strcmp(argv[i], "-fbounds-check") == 0) {
+            // Todo acesso a vetor de tamanho conhecido confere o índice em tempo de execução
+            definirVerificacaoLimites(true);
+        } else if (strcmp(argv[i], "-fopt-info-vec") == 0) {
+            // Diz em stderr quais laços foram vetorizados e por que os outros não
+            definirRelatorioVetorizacao(true);
+        } else if (strcmp(argv[i], "-fopt-info-par") == 0) {
+            // Diz em stderr quais laços foram paralelizados e por que os outros não
+            definirRelatorioParalelizacao(true);
+        } else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            // Threads da análise semântica (0 = número de processadores)
+            definirNumThreads(atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--xref-query") == 0) {
+            // Modo consulta: não compila nada, apenas lê o índice
+            if (i + 2 >= argc) {
+                imprimirUso(argv[0]);
+                return 1;
+            }
+            return consultarXref(argv[i + 1], argv[i + 2]) ? 0 : 1;
+        } else if (argv[i][0] == '-' || arquivoFonte != NULL) {
+            imprimirUso(argv[0]);
+            return 1;
+        } else {
+            arquivoFonte = argv[i];
+        }
+    }
+
     // Verifica se o nome do arquivo-fonte foi fornecido como argumento
-    if (argc != 2) {
-        fprintf(stderr, "Uso: %s <arquivo-fonte>\n", argv[0]);
+    if (arquivoFonte == NULL) {
+        imprimirUso(argv[0]);
         return 1;
     }
 
     // Tenta abrir o arquivo fornecido para leitura
-    FILE* f = fopen(argv[1], "r");
+    FILE* f = fopen(arquivoFonte, "r");
     if (!f) {
         perror("Erro ao abrir o arquivo");
         return 1;
     }
 
-    // Inicia o parser: análise léxica, sintática e preenchimento da tabela de símbolos
-    startParser(f);
+    if (arquivoXref) {
+        ativarXref();
+    }
+
+    // Inicia o parser: análise léxica e sintática, construindo a árvore do programa
+    NoAst* programa = startParser(f);
 
-    // Realiza a análise semântica sobre os símbolos e uso de identificadores
-    verificarSemantica();
+    // Realiza a análise semântica sobre a árvore (preenche a tabela de símbolos)
+    bool semErros = verificarSemantica(programa);
 
     // Imprime a tabela de símbolos resultante (para depuração)
     imprimirTabela();
 
+    // Grava o índice de referências cruzadas, se pedido
+    if (arquivoXref && !gravarXref(arquivoXref, arquivoFonte)) {
+        fclose(f);
+        liberarAst(programa);
+        encerrarThreads();
+        return 1;
+    }
+
+    // Constrói e confere a IR, se algo depende dela (apenas para programas sem erros)
+    int codigo = 0;
+    ProgramaIr* ir = NULL;
+    if (arquivoSaida || arquivoIr) {
+        if (!semErros) {
+            fprintf(stderr, "[ERRO] Código não gerado: o programa tem erros semânticos.\n");
+            codigo = 1;
+        } else {
+            ir = construirIr(programa);
+            if (!ir || !verificarProgramaIr(ir)) {
+                codigo = 1;
+            } else {
+                // Os passes devolvem a IR válida; a verificação de novo pega erros neles
+                otimizarPrograma(ir);
+                if (!verificarProgramaIr(ir)) codigo = 1;
+            }
+        }
+    }
+
+    // Grava a IR em forma textual, se pedido
+    if (codigo == 0 && arquivoIr) {
+        FILE* saidaIr = fopen(arquivoIr, "w");
+        if (!saidaIr) {
+            perror("Erro ao criar o arquivo da IR");
+            codigo = 1;
+        } else {
+            imprimirIr(ir, saidaIr);
+            fclose(saidaIr);
+        }
+    }
+
+    // Gera o assembly, se pedido
+    if (codigo == 0 && arquivoSaida) {
+        FILE* saida = fopen(arquivoSaida, "w");
+
+        if (!saida) {
+            perror("Erro ao criar o arquivo de saída");
+            codigo = 1;
+        } else {
+            if (!gerarCodigo(ir, saida)) codigo = 1;
+            fclose(saida);
+            if (codigo == 0) printf("[OK] Código gerado em %s\n", arquivoSaida);
+        }
+    }
+
+    if (ir) liberarProgramaIr(ir);
+
     // Fecha o arquivo de entrada
     fclose(f);
 
-    return 0;
+    liberarAst(programa);
+    encerrarThreads();
+
+    return codigo;
 }
@@ -0,0 +1,220 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "otimizacao.h"
+
+// ==============================================
+// NUMERAÇÃO GLOBAL DE VALORES (GVN)
+// ==============================================
+//
+// Duas instruções sem efeito com a mesma operação e os mesmos operandos
+// calculam o mesmo valor. Os blocos são visitados em pós-ordem reversa e
+// cada instrução é procurada numa tabela de espalhamento: se uma igual
+// está num bloco que domina o atual, a segunda é trocada pela primeira.
+// Operandos de add, mul e das comparações == e != valem em qualquer ordem.
+// Chamadas a funções puras (que não leem nem gravam memória) também entram:
+// com os mesmos argumentos, devolvem o mesmo valor.
+//
+// Leituras de memória dependem do que foi gravado entre elas: dentro de um
+// bloco (e ao longo de blocos com um único predecessor) cada endereço lido
+// ou gravado fica disponível até um store que possa atingi-lo ou uma
+// chamada que possa gravar nele (a análise de alias diz quais). Uma
+// leitura logo depois de gravar no mesmo endereço usa o valor gravado.
+
+// ===================
+// Instruções puras
+// ===================
+
+static bool comutativa(const InstrIr* i) {
+    if (i->op == IR_ADD || i->op == IR_MUL) return true;
+    return i->op == IR_CMP && (i->cond == COND_EQ || i->cond == COND_NE);
+}
+
+static bool numeravel(const InstrIr* i) {
+    // A divisão inteira repetida não interrompe o programa mais do que a primeira
+    if (i->op == IR_DIV) return true;
+    return i->op != IR_LOAD && !temEfeitoIr(i);
+}
+
+static uint32_t espalhar(const InstrIr* i) {
+    uint32_t h = (uint32_t)i->op * 2654435761u ^ (uint32_t)i->tipo * 40503u;
+    h ^= (uint32_t)i->imm.i * 31u + (uint32_t)i->indice * 131u + (uint32_t)i->simbolo * 8191u;
+    h ^= (uint32_t)i->cond * 17u + (uint32_t)i->escala * 257u;
+
+    // Soma dos operandos: não depende da ordem (as comutativas são comparadas nas duas)
+    for (int a = 0; a < i->nArgs; a++) h += (uint32_t)i->args[a]->id * 2246822519u;
+    if (i->op == IR_PHI) h += (uint32_t)i->bloco->id * 3266489917u;
+    return h;
+}
+
+static bool mesmosArgs(const InstrIr* a, const InstrIr* b) {
+    bool iguais = true;
+    for (int k = 0; k < a->nArgs && iguais; k++) iguais = a->args[k] == b->args[k];
+    if (iguais) return true;
+    return comutativa(a) && a->nArgs == 2 && a->args[0] == b->args[1] && a->args[1] == b->args[0];
+}
+
+static bool equivalentes(const InstrIr* a, const InstrIr* b) {
+    if (a->op != b->op || a->tipo != b->tipo || a->nArgs != b->nArgs) return false;
+    if (a->imm.i != b->imm.i || a->cond != b->cond || a->indice != b->indice || a->simbolo != b->simbolo) return false;
+    if (a->escala != b->escala || a->tamanho != b->tamanho) return false;
+
+    // Phi só se repete no mesmo bloco (os operandos seguem a ordem dos predecessores)
+    if (a->op == IR_PHI) {
+        if (a->bloco != b->bloco) return false;
+        for (int k = 0; k < a->nArgs; k++) {
+            if (a->args[k] != b->args[k]) return false;
+        }
+        return true;
+    }
+    return mesmosArgs(a, b);
+}
+
+typedef struct {
+    InstrIr** itens;
+    uint32_t mascara;
+} Tabela;
+
+// Uma instrução equivalente cujo bloco domina o de 'i' (ou NULL, e então 'i' entra na tabela)
+static InstrIr* procurarOuInserir(Tabela* t, InstrIr* i) {
+    uint32_t k = espalhar(i) & t->mascara;
+    while (t->itens[k]) {
+        InstrIr* outra = t->itens[k];
+        if (equivalentes(outra, i) && dominaIr(outra->bloco, i->bloco)) return outra;
+        k = (k + 1) & t->mascara;
+    }
+    t->itens[k] = i;
+    return NULL;
+}
+
+// ===================
+// Memória
+// ===================
+
+typedef struct {
+    InstrIr* endereco;
+    InstrIr* valor;         // o load anterior ou o valor gravado
+} Disponivel;
+
+typedef struct {
+    Disponivel* itens;
+    int n;
+    int cap;
+} Memoria;
+
+static void esquecer(const FuncaoIr* f, Memoria* m, const InstrIr* endereco) {
+    int k = 0;
+    for (int j = 0; j < m->n; j++) {
+        if (!podemSobreporIr(f, m->itens[j].endereco, endereco)) m->itens[k++] = m->itens[j];
+    }
+    m->n = k;
+}
+
+// Só sobrevive o que a chamada não pode gravar
+static void esquecerChamada(const FuncaoIr* f, Memoria* m, const InstrIr* call) {
+    int k = 0;
+    for (int j = 0; j < m->n; j++) {
+        if (!chamadaPodeGravarIr(f, call, m->itens[j].endereco)) m->itens[k++] = m->itens[j];
+    }
+    m->n = k;
+}
+
+static void lembrar(Memoria* m, InstrIr* endereco, InstrIr* valor) {
+    if (m->n == m->cap) {
+        m->cap = m->cap ? m->cap * 2 : 8;
+        m->itens = realloc(m->itens, m->cap * sizeof(Disponivel));
+    }
+    m->itens[m->n].endereco = endereco;
+    m->itens[m->n].valor = valor;
+    m->n++;
+}
+
+static InstrIr* disponivel(const Memoria* m, const InstrIr* load) {
+    for (int j = m->n - 1; j >= 0; j--) {
+        if (m->itens[j].endereco == load->args[0] && m->itens[j].valor->tipo == load->tipo) return m->itens[j].valor;
+    }
+    return NULL;
+}
+
+// ===================
+// Passe
+// ===================
+
+static void trocar(InstrIr* i, InstrIr* novo) {
+    substituirUsosIr(i, novo);
+    removerInstrIr(i);
+}
+
+bool numerarValores(FuncaoIr* f) {
+    calcularDominadoresIr(f);
+
+    int nInstr = 0;
+    BlocoIr** ordem = calloc(f->nBlocos > 0 ? f->nBlocos : 1, sizeof(BlocoIr*));
+    for (int b = 0; b < f->nBlocos; b++) {
+        if (f->blocos[b]->rpo >= 0) ordem[f->blocos[b]->rpo] = f->blocos[b];
+        for (InstrIr* i = f->blocos[b]->primeira; i; i = i->prox) nInstr++;
+    }
+
+    Tabela t;
+    uint32_t tam = 16;
+    while (tam < 2u * (uint32_t)nInstr) tam *= 2;
+    t.itens = calloc(tam, sizeof(InstrIr*));
+    t.mascara = tam - 1;
+
+    // Memória disponível no fim de cada bloco (pelo id)
+    Memoria* fim = calloc(f->nBlocos > 0 ? f->nBlocos : 1, sizeof(Memoria));
+    bool mudou = false;
+
+    for (int k = 0; k < f->nBlocos && ordem[k]; k++) {
+        BlocoIr* b = ordem[k];
+        Memoria* m = &fim[b->id];
+
+        // Com um único predecessor (já visitado), o que estava disponível no fim dele continua
+        if (b->nPreds == 1 && b->preds[0]->rpo < b->rpo) {
+            const Memoria* anterior = &fim[b->preds[0]->id];
+            for (int j = 0; j < anterior->n; j++) lembrar(m, anterior->itens[j].endereco, anterior->itens[j].valor);
+        }
+
+        InstrIr* i = b->primeira;
+        while (i) {
+            InstrIr* prox = i->prox;
+
+            if (i->op == IR_LOAD) {
+                InstrIr* valor = disponivel(m, i);
+                if (valor) {
+                    trocar(i, valor);
+                    mudou = true;
+                } else {
+                    lembrar(m, i->args[0], i);
+                }
+            } else if (i->op == IR_STORE) {
+                esquecer(f, m, i->args[0]);
+                lembrar(m, i->args[0], i->args[1]);
+            } else if (i->op == IR_ZERAR || i->op == IR_COPIAR) {
+                esquecer(f, m, i->args[0]);
+            } else if (i->op == IR_CALL && chamadaPura(i)) {
+                InstrIr* igual = procurarOuInserir(&t, i);
+                if (igual) {
+                    trocar(i, igual);
+                    mudou = true;
+                }
+            } else if (i->op == IR_CALL) {
+                esquecerChamada(f, m, i);
+            } else if (numeravel(i)) {
+                InstrIr* igual = procurarOuInserir(&t, i);
+                if (igual) {
+                    trocar(i, igual);
+                    mudou = true;
+                }
+            }
+            i = prox;
+        }
+    }
+
+    for (int b = 0; b < f->nBlocos; b++) free(fim[b].itens);
+    free(fim);
+    free(t.itens);
+    free(ordem);
+    return mudou;
+}
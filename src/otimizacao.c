@@ -0,0 +1,115 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "otimizacao.h"
+#include "threadpool.h"
+
+static int nivelOtimizacao = 1;
+
+void definirNivelOtimizacao(int nivel) {
+    nivelOtimizacao = nivel;
+}
+
+// Repete os passes locais até a função parar de mudar
+static void simplificarFuncao(FuncaoIr* f) {
+    bool mudou = true;
+
+    while (mudou) {
+        mudou = false;
+        mudou |= dobrarConstantes(f);
+        mudou |= numerarValores(f);
+        mudou |= eliminarVerificacoesLimite(f);
+        mudou |= eliminarCodigoMorto(f);
+    }
+}
+
+// Os passes de laço ficam fora da repetição: a eliminação de código morto
+// juntaria de volta um pré-cabeçalho vazio que eles acabaram de criar
+static void otimizarFuncao(FuncaoIr* f) {
+    simplificarFuncao(f);
+    if (avaliarChamadas(f)) simplificarFuncao(f);
+    if (otimizarChamadasCauda(f)) simplificarFuncao(f);
+    if (otimizarLacos(f)) simplificarFuncao(f);
+    if (fundirLacos(f)) simplificarFuncao(f);
+    if (promoverEscalares(f)) simplificarFuncao(f);
+    if (reconhecerIdiomas(f)) simplificarFuncao(f);
+}
+
+static void simplificarTarefa(int indice, void* arg) {
+    simplificarFuncao(((ProgramaIr*)arg)->funcoes[indice]);
+}
+
+// Tarefa do pool: um componente do grafo de chamadas, com as funções na ordem do grafo
+typedef struct {
+    ProgramaIr* p;
+    GrafoChamadas* g;
+    int* raizes;            // componentes do nível atual
+} Nivel;
+
+static void otimizarComponente(int indice, void* arg) {
+    Nivel* n = arg;
+    GrafoChamadas* g = n->g;
+    int raiz = n->raizes[indice];
+
+    for (int k = 0; k < g->nFuncoes; k++) {
+        int v = g->ordem[k];
+        if (g->componente[v] != raiz) continue;
+        FuncaoIr* f = n->p->funcoes[v];
+        otimizarFuncao(f);
+        if (expandirChamadas(n->p, f, g)) otimizarFuncao(f);
+    }
+
+    // Quem chama este componente (num nível acima) já vê os efeitos que sobraram
+    atualizarEfeitos(n->p, g, raiz);
+}
+
+// As funções são otimizadas de baixo para cima no grafo de chamadas: quando
+// uma chamada é expandida, o corpo copiado já está otimizado e os efeitos
+// da função chamada já estão calculados. Os componentes de um mesmo nível
+// não chamam uns aos outros e vão em paralelo para o pool de threads
+void otimizarPrograma(ProgramaIr* p) {
+    if (nivelOtimizacao > 0) {
+        // A especialização decide pelos tamanhos e constantes já simplificados;
+        // as cópias entram no grafo como qualquer outra função
+        executarEmParalelo(p->nFuncoes, simplificarTarefa, p);
+        especializarFuncoes(p);
+
+        analisarAliasPrograma(p);
+        GrafoChamadas* g = construirGrafoChamadas(p);
+        definirGrafoChamadas(p, g);
+
+        Nivel n = { p, g, malloc((g->nFuncoes > 0 ? g->nFuncoes : 1) * sizeof(int)) };
+        for (int nivel = 0; ; nivel++) {
+            int nRaizes = 0;
+            bool resta = false;
+            for (int k = 0; k < g->nFuncoes; k++) {
+                if (g->componente[k] != k) continue;
+                if (g->nivel[k] == nivel) n.raizes[nRaizes++] = k;
+                else if (g->nivel[k] > nivel) resta = true;
+            }
+            executarEmParalelo(nRaizes, otimizarComponente, &n);
+            if (!resta) break;
+        }
+        free(n.raizes);
+
+        // A paralelização tira os laços de fora para funções novas, que ainda
+        // passam pela simplificação e pela vetorização abaixo
+        int nFuncoes = p->nFuncoes;
+        for (int k = 0; k < nFuncoes; k++) {
+            if (paralelizarLacos(p, p->funcoes[k])) simplificarFuncao(p->funcoes[k]);
+        }
+        for (int k = nFuncoes; k < p->nFuncoes; k++) simplificarFuncao(p->funcoes[k]);
+
+        // Por último: a vetorização duplica os laços e atrapalharia a expansão.
+        // As chamadas que sobraram dão alvos mais precisos aos parâmetros
+        analisarAliasPrograma(p);
+        for (int k = 0; k < p->nFuncoes; k++) {
+            if (vetorizarLacos(p->funcoes[k])) simplificarFuncao(p->funcoes[k]);
+        }
+        liberarAliasPrograma();
+        definirGrafoChamadas(NULL, NULL);
+        liberarGrafoChamadas(g);
+    }
+
+    for (int i = 0; i < p->nFuncoes; i++) avisarDivisaoPorZero(p->funcoes[i]);
+}
@@ -0,0 +1,962 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "otimizacao.h"
+
+// ==============================================
+// PARALELIZAÇÃO DE LAÇOS
+// ==============================================
+//
+// Um laço contado 'for (i = a; i < b; i = i + 1)' cujas voltas não
+// dependem umas das outras vira uma função própria, f.parN(inicio, fim,
+// env), que faz as voltas [inicio, fim). No lugar do laço fica a chamada
+// csrt_paralelo(f.parN, a, b, env, ...), que divide [a, b) em trechos e os
+// distribui entre as threads do runtime. Os valores de fora que o corpo usa
+// vão em env, um bloco de 8 bytes por valor no quadro de quem chama.
+//
+// Dependências: o índice de todo acesso a vetor precisa ser afim na
+// variável do laço (k * i + c, mais valores que não mudam no laço). Para
+// cada par de acessos à mesma memória, um deles gravando, os dois só podem
+// cair no mesmo elemento na mesma volta. Uma variável que avança um valor
+// fixo por volta (p = p + 3) é refeita no começo de cada trecho. Vetores
+// bool só podem ser gravados em v[i + 64k]: os trechos começam em
+// múltiplos de 64 e duas threads nunca mexem na mesma palavra.
+//
+// Reduções int ('s = s + x', 's = s - x', também dentro de if, e
+// 'if (x < m) m = x' / 'if (x > m) m = x') dão o mesmo resultado em
+// qualquer ordem, com transbordo inclusive. Cada trecho acumula a sua
+// parcial (a soma a partir de zero, o mínimo e o máximo a partir do valor
+// inicial) e a junta no fim a um acumulador em env (csrt_reduzir_*); depois
+// de csrt_paralelo quem chama soma o acumulador ao valor inicial. Soma de
+// float não é paralelizada (a ordem das somas mudaria o arredondamento), e
+// nenhum outro valor pode ser levado de uma volta para a seguinte.
+//
+// 'parallel for' declara que as voltas são independentes: a conferência
+// dos acessos à memória é dispensada, mas o resto continua exigido. Um
+// laço marcado que não pode ser paralelizado ganha um aviso.
+//
+// Só compensa com trabalho bastante para as threads: são precisas pelo
+// menos TRABALHO_MINIMO instruções (voltas vezes o tamanho do corpo, com
+// os laços internos multiplicados pelas suas voltas). Com limites
+// constantes isso é conferido aqui; nos outros casos o runtime faz o laço
+// inteiro na thread atual quando há poucas voltas.
+
+#define TRABALHO_MINIMO 65536
+#define MAX_TERMOS 8
+#define MAX_DERIVADAS 8
+#define MAX_REDUCOES 8
+#define MAX_ACESSOS 32
+#define MAX_PROFUNDIDADE 16
+#define ALINHAMENTO_BITS 64
+
+// Voltas supostas de um laço interno sem limites constantes
+#define VOLTAS_DESCONHECIDAS 16
+
+// Coeficientes maiores que isto desistem da análise (os produtos cabem em 64 bits)
+#define COEFICIENTE_MAXIMO ((int64_t)1 << 31)
+
+static bool relatorio = false;
+
+void definirRelatorioParalelizacao(bool ativo) {
+    relatorio = ativo;
+}
+
+// passo * i + constante + soma de fatores * termos (valores de fora do laço)
+typedef struct {
+    int64_t passo;
+    int64_t constante;
+    InstrIr* termos[MAX_TERMOS];
+    int64_t fatores[MAX_TERMOS];
+    int nTermos;
+} Afim;
+
+// p = p + passo a cada volta, com 'passo' fixo no laço
+typedef struct {
+    InstrIr* phi;
+    InstrIr* passo;
+    InstrIr* inicial;       // na cópia: p0 + passo * (inicio - i0)
+} Derivada;
+
+// Acumulador de uma redução int no cabeçalho
+typedef struct {
+    InstrIr* phi;
+    OpIr operacao;          // IR_ADD, IR_MIN ou IR_MAX
+    InstrIr* inicial;       // na cópia: zero (soma) ou o valor de antes do laço
+} Reducao;
+
+typedef struct {
+    InstrIr* endereco;
+    InstrIr* base;          // objeto acessado
+    Afim indice;            // zero nos acessos diretos
+    int escala;             // -1 nos acessos diretos
+    bool grava;
+} Acesso;
+
+typedef struct {
+    FuncaoIr* f;
+    LacoIr* l;
+    LacoIr** lacos;         // todos os laços da função, para pesar os internos
+    int nLacos;
+    int nBlocos;            // blocos de f quando o laço foi encontrado
+    int fora, volta;        // posições do pré-cabeçalho e da volta nos preds do cabeçalho
+    BlocoIr* saida;
+    InstrIr* iv;
+    InstrIr* prox;
+    InstrIr* inicio;
+    InstrIr* limite;
+    InstrIr* condicao;
+    Derivada derivadas[MAX_DERIVADAS];
+    int nDerivadas;
+    Reducao reducoes[MAX_REDUCOES];
+    int nReducoes;
+    Acesso acessos[MAX_ACESSOS];
+    int nAcessos;
+    int64_t custo;          // instruções de uma volta
+    int alinhamento;        // dos limites dos trechos
+    bool marcado;           // 'parallel for'
+    bool pequeno;           // rejeitado só por ter pouco trabalho
+} Paralelo;
+
+static bool noLaco(const Paralelo* pl, const InstrIr* i) {
+    return i->bloco->id < pl->nBlocos && pl->l->contem[i->bloco->id];
+}
+
+// Igual em todas as voltas: definido fora do laço ou refeito em cada uso
+static bool invariante(const Paralelo* pl, const InstrIr* i) {
+    return !noLaco(pl, i) || i->op == IR_CONST || i->op == IR_GLOBAL;
+}
+
+static bool ehConstante(const InstrIr* i, int32_t valor) {
+    return i->op == IR_CONST && i->tipo == IR_I32 && i->imm.i == valor;
+}
+
+// Mesmo objeto de memória (globais e locais se repetem como instruções diferentes)
+static bool mesmoObjeto(const InstrIr* a, const InstrIr* b) {
+    if (a == b) return true;
+    if (a->op != b->op) return false;
+    if (a->op == IR_GLOBAL) return a->simbolo == b->simbolo;
+    if (a->op == IR_LOCAL) return a->indice == b->indice;
+    return false;
+}
+
+// ===================
+// Índices afins
+// ===================
+
+static bool limitado(int64_t x) {
+    return x <= COEFICIENTE_MAXIMO && x >= -COEFICIENTE_MAXIMO;
+}
+
+static bool somarTermo(Afim* r, InstrIr* v, int64_t fator) {
+    for (int k = 0; k < r->nTermos; k++) {
+        if (r->termos[k] != v) continue;
+        r->fatores[k] += fator;
+        if (r->fatores[k] == 0) {
+            r->nTermos--;
+            r->termos[k] = r->termos[r->nTermos];
+            r->fatores[k] = r->fatores[r->nTermos];
+        }
+        return limitado(fator) && (k >= r->nTermos || limitado(r->fatores[k]));
+    }
+    if (r->nTermos == MAX_TERMOS || !limitado(fator)) return false;
+    r->termos[r->nTermos] = v;
+    r->fatores[r->nTermos++] = fator;
+    return true;
+}
+
+// r += fator * a
+static bool acumular(Afim* r, const Afim* a, int64_t fator) {
+    if (!limitado(fator)) return false;
+    r->passo += fator * a->passo;
+    r->constante += fator * a->constante;
+    for (int k = 0; k < a->nTermos; k++) {
+        if (!somarTermo(r, a->termos[k], fator * a->fatores[k])) return false;
+    }
+    return limitado(r->passo) && limitado(r->constante);
+}
+
+static bool soConstante(const Afim* a) {
+    return a->passo == 0 && a->nTermos == 0;
+}
+
+static Derivada* derivadaDe(Paralelo* pl, const InstrIr* phi) {
+    for (int d = 0; d < pl->nDerivadas; d++) {
+        if (pl->derivadas[d].phi == phi) return &pl->derivadas[d];
+    }
+    return NULL;
+}
+
+static Reducao* reducaoDe(Paralelo* pl, const InstrIr* phi) {
+    for (int r = 0; r < pl->nReducoes; r++) {
+        if (pl->reducoes[r].phi == phi) return &pl->reducoes[r];
+    }
+    return NULL;
+}
+
+static bool afimDe(Paralelo* pl, InstrIr* v, Afim* r, int profundidade) {
+    memset(r, 0, sizeof(Afim));
+    if (v->tipo != IR_I32 || profundidade > MAX_PROFUNDIDADE) return false;
+
+    if (v->op == IR_CONST) {
+        r->constante = v->imm.i;
+        return true;
+    }
+    if (v == pl->iv) {
+        r->passo = 1;
+        return true;
+    }
+    if (!noLaco(pl, v)) return somarTermo(r, v, 1);
+
+    // p = p0 + c * (i - i0)
+    Derivada* d = derivadaDe(pl, v);
+    if (d) {
+        Afim p0, i0;
+        if (d->passo->op != IR_CONST) return false;
+        int64_t c = d->passo->imm.i;
+        r->passo = c;
+        return afimDe(pl, d->phi->args[pl->fora], &p0, profundidade + 1) && afimDe(pl, pl->inicio, &i0, profundidade + 1)
+               && acumular(r, &p0, 1) && acumular(r, &i0, -c);
+    }
+
+    Afim a, b;
+    switch (v->op) {
+        case IR_ADD:
+        case IR_SUB:
+            return afimDe(pl, v->args[0], &a, profundidade + 1) && afimDe(pl, v->args[1], &b, profundidade + 1)
+                   && acumular(r, &a, 1) && acumular(r, &b, v->op == IR_ADD ? 1 : -1);
+
+        case IR_NEG:
+            return afimDe(pl, v->args[0], &a, profundidade + 1) && acumular(r, &a, -1);
+
+        case IR_MUL:
+            if (!afimDe(pl, v->args[0], &a, profundidade + 1) || !afimDe(pl, v->args[1], &b, profundidade + 1)) return false;
+            if (soConstante(&a)) return acumular(r, &b, a.constante);
+            if (soConstante(&b)) return acumular(r, &a, b.constante);
+            return false;
+
+        default:
+            return false;
+    }
+}
+
+// ===================
+// Análise
+// ===================
+
+static const char* analisarForma(Paralelo* pl) {
+    LacoIr* l = pl->l;
+    BlocoIr* h = l->cabecalho;
+
+    if (h->nPreds != 2) return "forma do laço não reconhecida";
+    pl->fora = h->preds[0] == l->preCabecalho ? 0 : 1;
+    pl->volta = 1 - pl->fora;
+
+    InstrIr* br = terminadorIr(h);
+    InstrIr* cmp = br && br->op == IR_BR ? br->args[0] : NULL;
+    if (!cmp || cmp->op != IR_CMP || cmp->bloco != h || cmp->cond != COND_LT || cmp->nUsos != 1
+        || !l->contem[br->alvos[0]->id] || l->contem[br->alvos[1]->id]) {
+        return "condição de parada não é i < limite";
+    }
+    pl->condicao = cmp;
+    pl->saida = br->alvos[1];
+    pl->iv = cmp->args[0];
+    pl->limite = cmp->args[1];
+    if (pl->iv->op != IR_PHI || pl->iv->bloco != h || pl->iv->tipo != IR_I32) return "condição de parada não é i < limite";
+    if (!invariante(pl, pl->limite)) return "limite muda dentro do laço";
+    pl->inicio = pl->iv->args[pl->fora];
+
+    for (InstrIr* i = h->primeira; i; i = i->prox) {
+        if (i->op != IR_PHI && i != cmp && i != br) return "cabeçalho com outras contas";
+    }
+
+    pl->prox = pl->iv->args[pl->volta];
+    if (pl->prox->op != IR_ADD || pl->prox->args[0] != pl->iv || !ehConstante(pl->prox->args[1], 1)) {
+        return "variável do laço não avança de 1 em 1";
+    }
+    if (terminadorIr(h->preds[pl->volta])->op != IR_JMP) return "forma do laço não reconhecida";
+
+    for (int b = 0; b < l->nBlocos; b++) {
+        BlocoIr* succ[2];
+        int ns = sucessoresIr(l->blocos[b], succ);
+        for (int s = 0; s < ns; s++) {
+            if (l->blocos[b] != h && !l->contem[succ[s]->id]) return "saída do laço pelo meio (break ou return)";
+        }
+    }
+    return NULL;
+}
+
+// ===================
+// Phi do cabeçalho
+// ===================
+
+static const char LEVADO[] = "valor de uma volta usado na seguinte";
+
+static bool naLista(InstrIr* const* lista, int n, const InstrIr* v) {
+    for (int k = 0; k < n; k++) {
+        if (lista[k] == v) return true;
+    }
+    return false;
+}
+
+// Soma: os usos do acumulador no laço formam uma cadeia de add, sub (como
+// primeiro operando) e phi de junção que volta ao cabeçalho; nada de fora
+// da cadeia usa um valor dela, nem a cadeia entra duas vezes numa conta
+static const char* analisarSoma(Paralelo* pl, InstrIr* phi) {
+    int cap = 8, n = 0;
+    InstrIr** cadeia = malloc(cap * sizeof(InstrIr*));
+    cadeia[n++] = phi;
+
+    for (int k = 0; k < n; k++) {
+        for (int u = 0; u < cadeia[k]->nUsos; u++) {
+            InstrIr* uso = cadeia[k]->usos[u];
+            if (!noLaco(pl, uso) || naLista(cadeia, n, uso)) continue;
+            if (uso->op != IR_ADD && uso->op != IR_SUB && uso->op != IR_PHI) {
+                free(cadeia);
+                return LEVADO;
+            }
+            if (n == cap) cadeia = realloc(cadeia, (cap *= 2) * sizeof(InstrIr*));
+            cadeia[n++] = uso;
+        }
+    }
+
+    const char* motivo = NULL;
+    for (int k = 1; k < n && !motivo; k++) {
+        InstrIr* v = cadeia[k];
+        bool a0 = naLista(cadeia, n, v->args[0]);
+        bool a1 = v->nArgs > 1 && naLista(cadeia, n, v->args[1]);
+        if (v->op == IR_ADD && a0 == a1) motivo = LEVADO;
+        if (v->op == IR_SUB && (!a0 || a1)) motivo = LEVADO;
+        for (int a = 0; a < v->nArgs && v->op == IR_PHI; a++) {
+            if (!naLista(cadeia, n, v->args[a])) motivo = LEVADO;
+        }
+        if (v->bloco == pl->l->cabecalho) motivo = LEVADO;
+    }
+    if (!motivo && !naLista(cadeia, n, phi->args[pl->volta])) motivo = LEVADO;
+    if (!motivo && phi->tipo == IR_F32) motivo = "soma de float: a ordem das somas mudaria o arredondamento";
+    if (!motivo && phi->tipo != IR_I32) motivo = "soma de char ou bool";
+    free(cadeia);
+    return motivo;
+}
+
+// if (x < m) m = x: a volta traz o phi da junção, que escolhe entre x (no
+// bloco da atribuição) e m (direto do bloco do if)
+static const char* analisarMinMax(Paralelo* pl, InstrIr* phi, OpIr* operacao) {
+    InstrIr* juncao = phi->args[pl->volta];
+    BlocoIr* j = juncao->bloco;
+    if (juncao->op != IR_PHI || j == pl->l->cabecalho || !noLaco(pl, juncao) || j->nPreds != 2 || juncao->nUsos != 1) {
+        return LEVADO;
+    }
+
+    int k = j->preds[0]->nPreds == 1 && terminadorIr(j->preds[0])->op == IR_JMP ? 0 : 1;
+    BlocoIr* atribuicao = j->preds[k];
+    BlocoIr* corpo = j->preds[1 - k];
+    InstrIr* br = terminadorIr(corpo);
+    if (atribuicao->nPreds != 1 || atribuicao->preds[0] != corpo || br->op != IR_BR || br->alvos[0] != atribuicao
+        || br->alvos[1] != j || juncao->args[1 - k] != phi) {
+        return LEVADO;
+    }
+
+    // Cada trecho acha outro mínimo parcial: gravar junto dependeria da ordem
+    for (InstrIr* i = atribuicao->primeira; i; i = i->prox) {
+        if (i->op == IR_STORE || i->op == IR_CALL) return "if do mínimo ou máximo faz mais do que atribuir";
+    }
+
+    InstrIr* x = juncao->args[k];
+    InstrIr* cmp = br->args[0];
+    if (cmp->op != IR_CMP || cmp->nUsos != 1) {
+        return "if no corpo que não é mínimo nem máximo";
+    }
+    for (int u = 0; u < phi->nUsos; u++) {
+        InstrIr* uso = phi->usos[u];
+        if (noLaco(pl, uso) && uso != cmp && uso != juncao) return LEVADO;
+    }
+
+    CondIr c = cmp->cond;
+    if (cmp->args[0] == phi && cmp->args[1] == x) {
+        c = c == COND_LT ? COND_GT : c == COND_GT ? COND_LT : c == COND_LE ? COND_GE : c == COND_GE ? COND_LE : c;
+    } else if (cmp->args[0] != x || cmp->args[1] != phi) {
+        return "if no corpo que não é mínimo nem máximo";
+    }
+    if (c == COND_LT || c == COND_LE) *operacao = IR_MIN;
+    else if (c == COND_GT || c == COND_GE) *operacao = IR_MAX;
+    else return "if no corpo que não é mínimo nem máximo";
+
+    return phi->tipo == IR_I32 ? NULL : "mínimo ou máximo de float";
+}
+
+// Além da variável do laço: variáveis que avançam um valor fixo e reduções int
+static const char* analisarPhis(Paralelo* pl) {
+    for (InstrIr* phi = pl->l->cabecalho->primeira; phi && phi->op == IR_PHI; phi = phi->prox) {
+        if (phi == pl->iv) continue;
+
+        InstrIr* op = phi->args[pl->volta];
+        bool derivada = phi->tipo == IR_I32 && op->op == IR_ADD && noLaco(pl, op)
+                        && ((op->args[0] == phi && invariante(pl, op->args[1]))
+                            || (op->args[1] == phi && invariante(pl, op->args[0])));
+        if (derivada) {
+            if (pl->nDerivadas == MAX_DERIVADAS) return "variáveis de laço demais";
+            Derivada* d = &pl->derivadas[pl->nDerivadas++];
+            d->phi = phi;
+            d->passo = op->args[0] == phi ? op->args[1] : op->args[0];
+            d->inicial = NULL;
+            continue;
+        }
+
+        // Sem forma de soma, o phi da volta ainda pode ser um mínimo ou máximo
+        OpIr operacao = IR_ADD;
+        const char* motivo = analisarSoma(pl, phi);
+        if (motivo && op->op == IR_PHI) {
+            const char* minMax = analisarMinMax(pl, phi, &operacao);
+            if (minMax != LEVADO) motivo = minMax;
+        }
+        if (motivo) return motivo;
+        if (pl->nReducoes == MAX_REDUCOES) return "reduções demais";
+
+        Reducao* r = &pl->reducoes[pl->nReducoes++];
+        r->phi = phi;
+        r->operacao = operacao;
+        r->inicial = NULL;
+    }
+    return NULL;
+}
+
+static const char* registrarAcesso(Paralelo* pl, InstrIr* endereco, bool grava) {
+    if (pl->nAcessos == MAX_ACESSOS) return "acessos à memória demais";
+    Acesso* a = &pl->acessos[pl->nAcessos];
+    memset(a, 0, sizeof(Acesso));
+    a->endereco = endereco;
+    a->grava = grava;
+
+    if (endereco->op != IR_ELEM) {
+        bool objeto = endereco->op == IR_GLOBAL || endereco->op == IR_LOCAL || endereco->op == IR_PARAM;
+        if (!objeto || !invariante(pl, endereco)) return "endereço calculado dentro do laço";
+        if (grava) return "gravação de variável escalar";
+        a->base = endereco;
+        a->escala = -1;
+        pl->nAcessos++;
+        return NULL;
+    }
+
+    a->base = endereco->args[0];
+    a->escala = endereco->escala;
+    if (!invariante(pl, a->base) || a->base->op == IR_ELEM) return "base de vetor muda dentro do laço";
+
+    bool afim = afimDe(pl, endereco->args[1], &a->indice, 0);
+    if (a->escala == 0 && grava) {
+        if (!afim || a->indice.passo != 1 || a->indice.nTermos > 0 || a->indice.constante % ALINHAMENTO_BITS != 0) {
+            return "vetor bool gravado fora do padrão v[i + 64k]";
+        }
+        pl->alinhamento = ALINHAMENTO_BITS;
+    }
+    if (!afim && !pl->marcado) return "índice de vetor não é afim na variável do laço";
+    pl->nAcessos++;
+    return NULL;
+}
+
+static const char* analisarInstr(Paralelo* pl, InstrIr* i) {
+    // O acumulador de uma redução vale depois do laço a soma dos trechos
+    for (int u = 0; u < i->nUsos && !reducaoDe(pl, i); u++) {
+        if (!noLaco(pl, i->usos[u])) return "valor calculado no laço usado depois dele";
+    }
+
+    switch (i->op) {
+        case IR_LOAD:
+            return registrarAcesso(pl, i->args[0], false);
+
+        case IR_STORE:
+            return registrarAcesso(pl, i->args[0], true);
+
+        case IR_CALL:
+            return "chamada de função no corpo";
+
+        case IR_ZERAR:
+        case IR_COPIAR:
+            return "cópia ou limpeza de string ou vetor inteiro";
+
+        case IR_LIMITE:
+            return "verificação de índice (-fbounds-check)";
+
+        case IR_CONST_STR:
+            return "string no corpo";
+
+        case IR_RET:
+            return "saída do laço pelo meio (break ou return)";
+
+        default:
+            return NULL;
+    }
+}
+
+// Dois acessos, um deles gravando, só podem cair no mesmo elemento na mesma volta
+static const char* conferirPar(const Paralelo* pl, const Acesso* a, const Acesso* b) {
+    if (!a->grava && !b->grava) return NULL;
+    if (!podemSobreporIr(pl->f, a->endereco, b->endereco)) return NULL;
+    if (!mesmoObjeto(a->base, b->base)) return "vetores que podem ser o mesmo";
+    if (a->escala != b->escala) return "acessos de tamanhos diferentes à mesma memória";
+
+    // a.passo * i1 - b.passo * i2 = delta, com i1 != i2?
+    Afim d = a->indice;
+    if (!acumular(&d, &b->indice, -1) || d.nTermos > 0) return "índices com partes desconhecidas diferentes";
+    int64_t delta = b->indice.constante - a->indice.constante;
+    int64_t pa = a->indice.passo, pb = b->indice.passo;
+
+    if (pa == pb) {
+        if (pa == 0) return delta == 0 ? "o mesmo elemento é usado em todas as voltas" : NULL;
+        return delta != 0 && delta % pa == 0 ? "uma volta usa um elemento gravado por outra" : NULL;
+    }
+
+    int64_t x = pa < 0 ? -pa : pa, y = pb < 0 ? -pb : pb;
+    while (y != 0) {
+        int64_t t = x % y;
+        x = y;
+        y = t;
+    }
+    return delta % x != 0 ? NULL : "índices com passos diferentes no mesmo vetor";
+}
+
+// Voltas de um laço interno: exatas com início e limite constantes
+static int64_t voltasDe(const LacoIr* l) {
+    InstrIr* br = terminadorIr(l->cabecalho);
+    InstrIr* cmp = br && br->op == IR_BR ? br->args[0] : NULL;
+    if (!cmp || cmp->op != IR_CMP || cmp->cond != COND_LT || cmp->args[1]->op != IR_CONST) return VOLTAS_DESCONHECIDAS;
+
+    InstrIr* iv = cmp->args[0];
+    if (iv->op != IR_PHI || iv->bloco != l->cabecalho || l->cabecalho->nPreds != 2) return VOLTAS_DESCONHECIDAS;
+    InstrIr* inicio = iv->args[l->cabecalho->preds[0] == l->preCabecalho ? 0 : 1];
+    if (inicio->op != IR_CONST) return VOLTAS_DESCONHECIDAS;
+
+    int64_t voltas = (int64_t)cmp->args[1]->imm.i - inicio->imm.i;
+    return voltas > 1 ? voltas : 1;
+}
+
+// Quantas vezes o bloco roda por volta do laço: o produto das voltas dos laços internos que o contêm
+static int64_t pesoDe(const Paralelo* pl, const BlocoIr* b) {
+    int64_t peso = 1;
+    for (int k = 0; k < pl->nLacos; k++) {
+        const LacoIr* interno = pl->lacos[k];
+        if (interno == pl->l || b->id >= pl->nBlocos || !interno->contem[b->id]) continue;
+
+        const LacoIr* acima = interno->pai;
+        while (acima && acima != pl->l) acima = acima->pai;
+        if (acima) peso = peso * voltasDe(interno) < TRABALHO_MINIMO ? peso * voltasDe(interno) : TRABALHO_MINIMO;
+    }
+    return peso;
+}
+
+static const char* analisar(Paralelo* pl) {
+    const char* motivo;
+    if ((motivo = analisarForma(pl)) || (motivo = analisarPhis(pl))) return motivo;
+
+    pl->alinhamento = 1;
+    for (int b = 0; b < pl->l->nBlocos; b++) {
+        int64_t peso = pesoDe(pl, pl->l->blocos[b]);
+        for (InstrIr* i = pl->l->blocos[b]->primeira; i; i = i->prox) {
+            if ((motivo = analisarInstr(pl, i))) return motivo;
+            switch (i->op) {
+                case IR_CONST:
+                case IR_PHI:
+                case IR_LOCAL:
+                case IR_GLOBAL:
+                    break;
+                default:
+                    if (pl->custo < TRABALHO_MINIMO) pl->custo += peso;
+                    break;
+            }
+        }
+    }
+
+    for (int a = 0; a < pl->nAcessos && !pl->marcado; a++) {
+        for (int b = a; b < pl->nAcessos; b++) {
+            if (b == a && !pl->acessos[a].grava) continue;
+            if ((motivo = conferirPar(pl, &pl->acessos[a], &pl->acessos[b]))) return motivo;
+        }
+    }
+
+    if (pl->inicio->op == IR_CONST && pl->limite->op == IR_CONST
+        && ((int64_t)pl->limite->imm.i - pl->inicio->imm.i) * pl->custo < TRABALHO_MINIMO) {
+        pl->pequeno = true;
+        return "poucas voltas para compensar as threads";
+    }
+    return NULL;
+}
+
+// ===================
+// Função do corpo
+// ===================
+
+// Valor de fora do laço guardado em env (slot >= 0: endereço do slot, refeito em quem chama)
+typedef struct {
+    InstrIr* valor;
+    int slot;
+    InstrIr* copia;         // leitura de env na função nova
+} Entrada;
+
+typedef struct {
+    Paralelo* pl;
+    FuncaoIr* g;
+    BlocoIr* entrada;
+    InstrIr* env;
+    InstrIr** valor;        // pelo id em f: o valor correspondente em g
+    Entrada* entradas;
+    int nEntradas;
+    int capEntradas;
+} Copia;
+
+static InstrIr* anexarNova(FuncaoIr* g, BlocoIr* b, OpIr op, TipoIr tipo, int linha) {
+    InstrIr* i = novaInstrIr(g, op, tipo);
+    i->linha = linha;
+    anexarInstrIr(b, i);
+    return i;
+}
+
+static InstrIr* constanteEm(FuncaoIr* g, BlocoIr* b, int32_t valor) {
+    InstrIr* c = anexarNova(g, b, IR_CONST, IR_I32, 0);
+    c->imm.i = valor;
+    return c;
+}
+
+// O valor de fora 'v' dentro de g: constantes e globais são refeitas, o resto vem de env
+static InstrIr* deFora(Copia* c, InstrIr* v) {
+    if (c->valor[v->id]) return c->valor[v->id];
+
+    InstrIr* novo;
+    if (v->op == IR_CONST || v->op == IR_GLOBAL) {
+        novo = anexarNova(c->g, c->entrada, v->op, v->tipo, v->linha);
+        novo->imm = v->imm;
+        novo->simbolo = v->simbolo;
+    } else {
+        int slot = v->op == IR_LOCAL ? v->indice : -1;
+        int k = 0;
+        while (k < c->nEntradas && (slot >= 0 ? c->entradas[k].slot != slot : c->entradas[k].valor != v)) k++;
+
+        if (k == c->nEntradas) {
+            if (c->nEntradas == c->capEntradas) {
+                c->capEntradas = c->capEntradas ? c->capEntradas * 2 : 8;
+                c->entradas = realloc(c->entradas, c->capEntradas * sizeof(Entrada));
+            }
+            InstrIr* posicao = constanteEm(c->g, c->entrada, k);
+            InstrIr* e = anexarNova(c->g, c->entrada, IR_ELEM, IR_PTR, v->linha);
+            e->escala = 8;
+            adicionarArgIr(e, c->env);
+            adicionarArgIr(e, posicao);
+            InstrIr* ld = anexarNova(c->g, c->entrada, IR_LOAD, v->tipo, v->linha);
+            adicionarArgIr(ld, e);
+            c->entradas[c->nEntradas++] = (Entrada){ v, slot, ld };
+        }
+        novo = c->entradas[k].copia;
+    }
+    c->valor[v->id] = novo;
+    return novo;
+}
+
+// Operandos que não vêm do valor correspondente: o início e o limite do trecho
+static bool operandoDoTrecho(const Paralelo* pl, const InstrIr* i, int a) {
+    return (i->op == IR_PHI && i->bloco == pl->l->cabecalho && a == pl->fora) || (i == pl->condicao && a == 1);
+}
+
+static const char* juntarReducao(OpIr operacao) {
+    return operacao == IR_ADD ? "csrt_reduzir_soma" : operacao == IR_MIN ? "csrt_reduzir_min" : "csrt_reduzir_max";
+}
+
+// f.parN(inicio, fim, env): entrada que lê env e refaz as variáveis derivadas,
+// cópia dos blocos do laço e um bloco de retorno no lugar da saída, que
+// junta a parcial de cada redução ao acumulador em env (depois dos valores)
+static FuncaoIr* criarCorpo(Copia* c, const char* nome, int simbolo) {
+    Paralelo* pl = c->pl;
+    FuncaoIr* f = pl->f;
+    LacoIr* l = pl->l;
+    int linha = pl->condicao->linha;
+
+    FuncaoIr* g = novaFuncaoIr(nome, simbolo);
+    g->retorno = IR_VOID;
+    g->nParams = 3;
+    g->tiposParams[0] = IR_I32;
+    g->tiposParams[1] = IR_I32;
+    g->tiposParams[2] = IR_PTR;
+    c->g = g;
+    c->entrada = novoBlocoIr(g);
+    c->valor = calloc(f->nValores, sizeof(InstrIr*));
+
+    InstrIr* params[3];
+    for (int k = 0; k < 3; k++) {
+        params[k] = anexarNova(g, c->entrada, IR_PARAM, g->tiposParams[k], linha);
+        params[k]->indice = k;
+    }
+    c->env = params[2];
+
+    // Valores de fora, antes de qualquer cópia (o bloco de entrada é fechado depois)
+    for (int b = 0; b < l->nBlocos; b++) {
+        for (InstrIr* i = l->blocos[b]->primeira; i; i = i->prox) {
+            if (i->op == IR_LOCAL) deFora(c, i);
+            for (int a = 0; a < i->nArgs; a++) {
+                if (!noLaco(pl, i->args[a]) && !operandoDoTrecho(pl, i, a)) deFora(c, i->args[a]);
+            }
+        }
+    }
+    for (int d = 0; d < pl->nDerivadas; d++) {
+        Derivada* dv = &pl->derivadas[d];
+        InstrIr* i0 = deFora(c, pl->inicio);
+        InstrIr* passo = deFora(c, dv->passo);
+        InstrIr* p0 = deFora(c, dv->phi->args[pl->fora]);
+
+        InstrIr* voltas = anexarNova(g, c->entrada, IR_SUB, IR_I32, linha);
+        adicionarArgIr(voltas, params[0]);
+        adicionarArgIr(voltas, i0);
+        InstrIr* avanco = anexarNova(g, c->entrada, IR_MUL, IR_I32, linha);
+        adicionarArgIr(avanco, passo);
+        adicionarArgIr(avanco, voltas);
+        dv->inicial = anexarNova(g, c->entrada, IR_ADD, IR_I32, linha);
+        adicionarArgIr(dv->inicial, p0);
+        adicionarArgIr(dv->inicial, avanco);
+    }
+    for (int r = 0; r < pl->nReducoes; r++) {
+        Reducao* red = &pl->reducoes[r];
+        red->inicial = red->operacao == IR_ADD ? constanteEm(g, c->entrada, 0) : deFora(c, red->phi->args[pl->fora]);
+    }
+
+    BlocoIr** blocos = calloc(f->nBlocos, sizeof(BlocoIr*));
+    for (int b = 0; b < l->nBlocos; b++) blocos[l->blocos[b]->id] = novoBlocoIr(g);
+    BlocoIr* retorno = novoBlocoIr(g);
+
+    InstrIr* jmp = anexarNova(g, c->entrada, IR_JMP, IR_VOID, linha);
+    jmp->alvos[0] = blocos[l->cabecalho->id];
+
+    // Instruções sem operandos primeiro: um phi pode usar um valor definido mais adiante
+    for (int b = 0; b < l->nBlocos; b++) {
+        BlocoIr* bloco = l->blocos[b];
+        BlocoIr* novo = blocos[bloco->id];
+        for (int p = 0; p < bloco->nPreds; p++) {
+            adicionarPredIr(novo, bloco->preds[p] == l->preCabecalho ? c->entrada : blocos[bloco->preds[p]->id]);
+        }
+
+        for (InstrIr* i = bloco->primeira; i; i = i->prox) {
+            if (i->op == IR_LOCAL) continue;
+
+            InstrIr* copia = anexarNova(g, novo, i->op, i->tipo, i->linha);
+            copia->imm = i->imm;
+            copia->cond = i->cond;
+            copia->indice = i->indice;
+            copia->simbolo = i->simbolo;
+            copia->escala = i->escala;
+            copia->tamanho = i->tamanho;
+            for (int k = 0; k < 2; k++) {
+                if (!i->alvos[k]) continue;
+                if (i->alvos[k] == pl->saida) {
+                    copia->alvos[k] = retorno;
+                    adicionarPredIr(retorno, novo);
+                } else {
+                    copia->alvos[k] = blocos[i->alvos[k]->id];
+                }
+            }
+            c->valor[i->id] = copia;
+        }
+    }
+
+    for (int b = 0; b < l->nBlocos; b++) {
+        for (InstrIr* i = l->blocos[b]->primeira; i; i = i->prox) {
+            if (i->op == IR_LOCAL) continue;
+            for (int a = 0; a < i->nArgs; a++) {
+                InstrIr* arg = c->valor[i->args[a]->id];
+                if (operandoDoTrecho(pl, i, a)) {
+                    Derivada* d = derivadaDe(pl, i);
+                    Reducao* red = reducaoDe(pl, i);
+                    arg = i == pl->condicao ? params[1] : d ? d->inicial : red ? red->inicial : params[0];
+                }
+                adicionarArgIr(c->valor[i->id], arg);
+            }
+        }
+    }
+
+    for (int r = 0; r < pl->nReducoes; r++) {
+        InstrIr* posicao = constanteEm(g, retorno, c->nEntradas + r);
+        InstrIr* e = anexarNova(g, retorno, IR_ELEM, IR_PTR, linha);
+        e->escala = 8;
+        adicionarArgIr(e, c->env);
+        adicionarArgIr(e, posicao);
+        InstrIr* call = anexarNova(g, retorno, IR_CALL, IR_VOID, linha);
+        call->simbolo = -1;
+        call->runtime = juntarReducao(pl->reducoes[r].operacao);
+        adicionarArgIr(call, e);
+        adicionarArgIr(call, c->valor[pl->reducoes[r].phi->id]);
+    }
+    anexarNova(g, retorno, IR_RET, IR_VOID, linha);
+    free(blocos);
+    return g;
+}
+
+// ===================
+// Troca do laço
+// ===================
+
+// Símbolo da função nova ('.' não aparece em identificadores)
+static int registrarCorpo(const FuncaoIr* f, int numero) {
+    char nome[sizeof(getTabela()[0].nome)];
+    if (snprintf(nome, sizeof(nome), "%s.par%d", getTabela()[f->simbolo].nome, numero) >= (int)sizeof(nome)) return -1;
+    if (!inserirSimbolo(nome, "void", CLASSE_FUNCAO, ESC_GLOBAL, 0)) return -1;
+
+    int s = getNumSimbolos() - 1;
+    getTabela()[s].foiDefinida = true;
+    return s;
+}
+
+static InstrIr* inserirNova(FuncaoIr* f, InstrIr* pos, OpIr op, TipoIr tipo) {
+    InstrIr* i = novaInstrIr(f, op, tipo);
+    i->linha = pos->linha;
+    inserirAntesIr(pos, i);
+    return i;
+}
+
+static InstrIr* constanteAntes(FuncaoIr* f, InstrIr* pos, int32_t valor) {
+    InstrIr* c = inserirNova(f, pos, IR_CONST, IR_I32);
+    c->imm.i = valor;
+    return c;
+}
+
+static InstrIr* elementoEnv(FuncaoIr* f, InstrIr* pos, InstrIr* env, int k) {
+    InstrIr* posicao = constanteAntes(f, pos, k);
+    InstrIr* e = inserirNova(f, pos, IR_ELEM, IR_PTR);
+    e->escala = 8;
+    adicionarArgIr(e, env);
+    adicionarArgIr(e, posicao);
+    return e;
+}
+
+static bool transformar(ProgramaIr* p, Paralelo* pl, int numero) {
+    FuncaoIr* f = pl->f;
+    int simbolo = registrarCorpo(f, numero);
+    if (simbolo < 0) return false;
+
+    Copia c = { 0 };
+    c.pl = pl;
+    FuncaoIr* g = criarCorpo(&c, getTabela()[simbolo].nome, simbolo);
+
+    p->funcoes = realloc(p->funcoes, (p->nFuncoes + 1) * sizeof(FuncaoIr*));
+    p->funcoes[p->nFuncoes++] = g;
+
+    // env no quadro de quem chama, com os valores de fora e os acumuladores
+    BlocoIr* pre = pl->l->preCabecalho;
+    InstrIr* pos = terminadorIr(pre);
+    pos->linha = pl->condicao->linha;
+    int nEnv = c.nEntradas + pl->nReducoes;
+    int slot = novoSlotIr(f, 8 * (nEnv > 0 ? nEnv : 1), 8, -1);
+    InstrIr* env = inserirNova(f, pos, IR_LOCAL, IR_PTR);
+    env->indice = slot;
+
+    for (int k = 0; k < c.nEntradas; k++) {
+        InstrIr* valor = c.entradas[k].valor;
+        if (c.entradas[k].slot >= 0) {
+            valor = inserirNova(f, pos, IR_LOCAL, IR_PTR);
+            valor->indice = c.entradas[k].slot;
+        }
+        InstrIr* st = inserirNova(f, pos, IR_STORE, IR_VOID);
+        adicionarArgIr(st, elementoEnv(f, st, env, k));
+        adicionarArgIr(st, valor);
+    }
+
+    // A soma dos trechos começa em zero; o mínimo e o máximo, no valor inicial
+    for (int r = 0; r < pl->nReducoes; r++) {
+        Reducao* red = &pl->reducoes[r];
+        InstrIr* st = inserirNova(f, pos, IR_STORE, IR_VOID);
+        adicionarArgIr(st, elementoEnv(f, st, env, c.nEntradas + r));
+        adicionarArgIr(st, red->operacao == IR_ADD ? constanteAntes(f, st, 0) : red->phi->args[pl->fora]);
+    }
+
+    InstrIr* corpo = inserirNova(f, pos, IR_FUNCAO, IR_PTR);
+    corpo->simbolo = simbolo;
+    int minimo = (int)(TRABALHO_MINIMO / (pl->custo > 0 ? pl->custo : 1));
+
+    InstrIr* call = inserirNova(f, pos, IR_CALL, IR_VOID);
+    call->simbolo = -1;
+    call->runtime = "csrt_paralelo";
+    InstrIr* args[] = { corpo, pl->inicio, pl->limite, env, constanteAntes(f, call, pl->alinhamento),
+                        constanteAntes(f, call, minimo > 0 ? minimo : 1) };
+    for (int a = 0; a < 6; a++) adicionarArgIr(call, args[a]);
+
+    // Depois do laço, cada acumulador vale o resultado da redução
+    for (int r = 0; r < pl->nReducoes; r++) {
+        Reducao* red = &pl->reducoes[r];
+        InstrIr* total = inserirNova(f, pos, IR_LOAD, IR_I32);
+        adicionarArgIr(total, elementoEnv(f, total, env, c.nEntradas + r));
+        if (red->operacao == IR_ADD) {
+            InstrIr* soma = inserirNova(f, pos, IR_ADD, IR_I32);
+            adicionarArgIr(soma, red->phi->args[pl->fora]);
+            adicionarArgIr(soma, total);
+            total = soma;
+        }
+        substituirUsosIr(red->phi, total);
+    }
+
+    // O pré-cabeçalho passa a ir direto para a saída; os blocos do laço ficam inalcançáveis
+    pos->alvos[0] = pl->saida;
+    pl->saida->preds[indicePredIr(pl->saida, pl->l->cabecalho)] = pre;
+    removerBlocosInalcancaveisIr(f);
+
+    free(c.valor);
+    free(c.entradas);
+    return true;
+}
+
+// ===================
+// Passe
+// ===================
+
+// Os laços de fora primeiro: um laço paralelizado leva os internos junto
+bool paralelizarLacos(ProgramaIr* p, FuncaoIr* f) {
+    int capVistos = 8, nVistos = 0;
+    BlocoIr** vistos = malloc(capVistos * sizeof(BlocoIr*));
+    int numero = 0;
+    bool mudou = false;
+    bool continuar = true;
+
+    // Cada troca remove blocos: os laços são encontrados de novo
+    while (continuar) {
+        continuar = false;
+        int n;
+        LacoIr** lacos = encontrarLacosIr(f, &n);
+
+        for (int k = n - 1; k >= 0 && !continuar; k--) {
+            LacoIr* l = lacos[k];
+            bool visto = false;
+            for (int j = 0; j < nVistos; j++) visto |= vistos[j] == l->cabecalho;
+            if (visto) continue;
+
+            if (nVistos == capVistos) vistos = realloc(vistos, (capVistos *= 2) * sizeof(BlocoIr*));
+            vistos[nVistos++] = l->cabecalho;
+
+            Paralelo pl = { 0 };
+            pl.f = f;
+            pl.l = l;
+            pl.lacos = lacos;
+            pl.nLacos = n;
+            pl.nBlocos = f->nBlocos;
+            pl.marcado = l->cabecalho->paralelo;
+
+            const char* motivo = analisar(&pl);
+            InstrIr* br = terminadorIr(l->cabecalho);
+            int linha = br && br->nArgs ? br->args[0]->linha : 0;
+
+            if (!motivo && !transformar(p, &pl, ++numero)) motivo = "nome da função nova grande demais";
+            if (motivo) {
+                // Um laço marcado com pouco trabalho só aparece no relatório
+                if (pl.marcado && !pl.pequeno) {
+                    fprintf(stderr, "[AVISO] %s: laço 'parallel' da linha %d não paralelizado: %s\n", f->nome, linha, motivo);
+                } else if (relatorio) {
+                    fprintf(stderr, "[PARALELIZAÇÃO] %s: laço da linha %d não paralelizado: %s\n", f->nome, linha, motivo);
+                }
+                continue;
+            }
+
+            if (relatorio) {
+                fprintf(stderr, "[PARALELIZAÇÃO] %s: laço da linha %d paralelizado em %s\n", f->nome, linha,
+                        p->funcoes[p->nFuncoes - 1]->nome);
+            }
+            mudou = true;
+            continuar = true;
+        }
+        liberarLacosIr(lacos, n);
+    }
+
+    free(vistos);
+    return mudou;
+}
@@ -5,32 +5,27 @@
 
 #include "parser.h"
 #include "lexer.h"
-#include "symbols.h"
-#include "semantic.h"
+#include "ast.h"
+#include "constantes.h"
 
 // ==============================
 // Variáveis globais
 // ==============================
 
-// Armazena os tipos dos parâmetros encontrados
-char tiposParamsTemp[MAX_PARAMS_FUNCAO][10];
-char nomesParamsTemp[MAX_PARAMS_FUNCAO][256];
-int numParamsTemp = 0;
-
 // Token atualmente em análise (lookahead principal usado pelo parser)
-static Token currentToken;     
+static Token currentToken;
 
 // Token salvo temporariamente para permitir "voltar" um passo (backtracking simples)
-static Token backupToken;      
+static Token backupToken;
 
 // Token empurrado manualmente por alguma função (por exemplo, ungetToken)
-static Token pushedToken;      
+static Token pushedToken;
 
 // Flag indicando se existe um token empurrado e aguardando ser usado
-static int hasPushedToken = 0;  
+static int hasPushedToken = 0;
 
 // Flag que permite um "retrocesso" simples: reprocessar o último token
-static bool tokenBack = false; 
+static bool tokenBack = false;
 
 // ==============================
 // Controle de Tokens
@@ -81,271 +76,206 @@ void parseEat(int expectedType) {
     }
 }
 
+// Cria um nó com o nome (identificador) do token dado
+static NoAst* novoNoNomeado(TipoNo tipo, Token token) {
+    NoAst* no = novoNo(tipo, token);
+    no->nome = strdup(token.lexeme);
+    return no;
+}
+
 // ==============================
 // Entrada do Parser
 // ==============================
 
 // Ponto de entrada do parser
-void startParser(FILE* f) {
+NoAst* startParser(FILE* f) {
     initLexer(f);
     advance(); // inicializa lookahead
-    parseProg();
+    NoAst* programa = parseProg();
     printf("[OK] Análise sintática concluída com sucesso.\n");
     destroyLexer();
+    return programa;
 }
 
-// prog ::= { decl ';' | func } 
-void parseProg() {
+// prog ::= { decl ';' | func }
+NoAst* parseProg() {
+    NoAst* programa = novoNo(NO_PROGRAMA, currentToken);
+    NoAst* fim = NULL;
+
     while (currentToken.type != TOKEN_EOF) {
         if (isTipo(currentToken.type)) {
             // Pode ser declaração ou função
-            parseDecl();
+            anexarNo(&programa->filhos[0], &fim, parseDecl());
         } else if (currentToken.type == TOKEN_KEYWORD_VOID) {
             // Função void
-            parseDecl();
+            anexarNo(&programa->filhos[0], &fim, parseDecl());
         } else {
             parseError("Esperado tipo ou void");
         }
     }
-}
-
-// decl ::= tipo decl_var {...} | tipo id(...) {...} | void id(...) {...}
-void parseDecl() {
-    if (isTipo(currentToken.type)) {
-        char tipoStr[10];
-        obterTipoString(tipoStr);  // ← Essa função pega o tipo em string
-        parseTipo();
-
-        if (currentToken.type == TOKEN_ID) {
-            char nomeFunc[256];
-            strncpy(nomeFunc, currentToken.lexeme, sizeof(nomeFunc));
-            nomeFunc[sizeof(nomeFunc) - 1] = '\0';
-            //Token idToken = currentToken;
-
-            advance();
-
-            if (currentToken.type == TOKEN_LPAREN) {
-     
-                advance();                    // consome '('
-                parseTiposParam();            // coleta parâmetros primeiro
-
-                verificarAssinaturaCompatível(nomeFunc, tipoStr, numParamsTemp, tiposParamsTemp);
-                verificarRedeclaracao(nomeFunc); // ainda útil para função que já foi definida
-                registrarFuncao(tipoStr, nomeFunc, numParamsTemp, tiposParamsTemp);
-                printf("[DECL_FUNCAO] Função com tipo reconhecida: %s\n", nomeFunc);
-
-                parseEat(TOKEN_RPAREN);
-
-                while (currentToken.type == TOKEN_COMMA) {
-                    advance();
-                    parseEat(TOKEN_ID);
-                    printf("[DECL_FUNCAO] Função adicional reconhecida: %s\n", currentToken.lexeme);
-                    parseEat(TOKEN_LPAREN);
-                    parseTiposParam();
-                    parseEat(TOKEN_RPAREN);
-                }
-
-
-            if (currentToken.type == TOKEN_SEMICOLON) {
-                verificarVoidEmFuncaoSemParametros(numParamsTemp, tiposParamsTemp, nomeFunc);
-
-                // ✅ É um protótipo: manter a verificação original
-                verificarRedeclaracao(nomeFunc);
-
-                advance();
-                limparEscopo(ESC_LOCAL);
-            } else if (currentToken.type == TOKEN_LBRACE) {
-                // ✅ Verificação de compatibilidade com protótipo (se existir)
-                verificarAssinaturaCompatível(nomeFunc, tipoStr, numParamsTemp, tiposParamsTemp);
-
-                // ✅ Verifica se já foi definida antes
-                verificarDefinicaoDeFuncao(nomeFunc);
-
-                // ✅ registra nome da função atual
-                setFuncaoAtual(nomeFunc); 
 
-                escopoAtual = ESC_LOCAL;
-
-                // ✅ Continua o parsing do corpo da função
-                parseFunc();
+    return programa;
+}
 
-                //limparEscopo(ESC_LOCAL);
+// Resto de uma declaração de função após o nome: '(' tipos_param ')' { ',' id '(' tipos_param ')' } (';' | corpo)
+static NoAst* parseDeclFuncao(TipoId tipoRetorno, Token idToken) {
+    NoAst* func = novoNoNomeado(NO_FUNCAO, idToken);
+    func->tipoDecl = tipoRetorno;
 
-                escopoAtual = ESC_GLOBAL;
+    parseEat(TOKEN_LPAREN);
+    parseTiposParam(func);            // coleta parâmetros primeiro
+    parseEat(TOKEN_RPAREN);
 
-            } else {
-                parseError("Esperado ';' ou '{' após declaração de função");
-            }
-            } else {
-                // declaração variável
-                printf("[DECL] Reconhecida declaração de variável (primeiro ID: %s)\n", nomeFunc);
+    if (tipoRetorno == TIPO_VOID) {
+        printf("[DECL_FUNCAO_VOID] Função void reconhecida: %s\n", func->nome);
+    } else {
+        printf("[DECL_FUNCAO] Função com tipo reconhecida: %s\n", func->nome);
+    }
 
-                int isVetor = 0;
-                int tamanho = 1;
+    NoAst* lista = func;
+    NoAst* fim = func;
 
-                if (currentToken.type == TOKEN_LBRACK) {
-                    advance();
-                    if (currentToken.type == TOKEN_INTCON) {
-                        tamanho = atoi(currentToken.lexeme);
-                        isVetor = 1;
-                        printf("[DECL_VAR] Vetor de tamanho: %s\n", currentToken.lexeme);
-                        advance();
-                        parseEat(TOKEN_RBRACK);
-                    } else {
-                        parseError("Esperado número inteiro dentro dos colchetes após o identificador");
-                    }
-                }
+    while (currentToken.type == TOKEN_COMMA) {
+        advance();
+        Token outroId = currentToken;
+        parseEat(TOKEN_ID);
 
-                // ✅ Verificação semântica
-                verificarRedeclaracao(nomeFunc);
+        NoAst* outra = novoNoNomeado(NO_FUNCAO, outroId);
+        outra->tipoDecl = tipoRetorno;
+        printf("[DECL_FUNCAO] Função adicional reconhecida: %s\n", outra->nome);
 
-                registrarVariavelGlobal(tipoStr, nomeFunc, isVetor, tamanho);
+        parseEat(TOKEN_LPAREN);
+        parseTiposParam(outra);
+        parseEat(TOKEN_RPAREN);
+        anexarNo(&lista, &fim, outra);
+    }
 
+    if (currentToken.type == TOKEN_SEMICOLON) {
+        // ✅ É um protótipo (ou lista de protótipos)
+        for (NoAst* f = lista; f; f = f->prox) {
+            f->offsetFim = currentToken.offset;
+        }
+        advance();
+    } else if (currentToken.type == TOKEN_LBRACE && lista == fim) {
+        // ✅ Continua o parsing do corpo da função
+        parseFunc(func);
+    } else {
+        parseError("Esperado ';' ou '{' após declaração de função");
+    }
 
-                // Verifica se há vetor após o primeiro identificador
-                if (currentToken.type == TOKEN_LBRACK) {
-                    advance(); // consome '['
+    return lista;
+}
 
-                    if (currentToken.type == TOKEN_INTCON) {
-                        printf("[DECL_VAR] Vetor de tamanho: %s\n", currentToken.lexeme);
-                        advance(); // consome número
-                        parseEat(TOKEN_RBRACK); // consome ']'
-                    } else {
-                        parseError("Esperado número inteiro dentro dos colchetes após o identificador");
-                    }
-                }
+// '[' já consumido: tamanho do vetor até ']'. Um número fica em 'tamanho';
+// outra expressão fica em filhos[0] e a análise semântica calcula o valor
+static void parseTamanhoVetor(NoAst* var) {
+    var->ehVetor = true;
+    NoAst* tamanho = parseExpr();
 
-                // Agora trata as outras variáveis separadas por vírgula
-                while (currentToken.type == TOKEN_COMMA) {
-                    advance(); // consome ','
-                    parseDeclVar(tipoStr, ESC_GLOBAL); // consome próximo id e vetor se tiver
-                }
+    if (tamanho->tipo == NO_CONST_INT) {
+        var->tamanho = tamanho->valor.intVal;
+        printf("[DECL_VAR] Vetor de tamanho: %d\n", var->tamanho);
+        liberarAst(tamanho);
+    } else {
+        var->filhos[0] = tamanho;
+        printf("[DECL_VAR] Vetor de tamanho calculado\n");
+    }
+    parseEat(TOKEN_RBRACK);
+}
 
-                parseEat(TOKEN_SEMICOLON);
+// decl ::= tipo decl_var {...} | tipo id(...) {...} | void id(...) {...}
+NoAst* parseDecl() {
+    if (isTipo(currentToken.type)) {
+        TipoId tipo = obterTipoId();
+        parseTipo();
 
-            }
-        } else {
+        if (currentToken.type != TOKEN_ID) {
             parseError("Esperado identificador após tipo");
         }
 
-    } else if (currentToken.type == TOKEN_KEYWORD_VOID) {
-
-
-        parseEat(TOKEN_KEYWORD_VOID);
+        Token idToken = currentToken;
+        advance();
 
-        char nomeFunc[256];
-        if (currentToken.type == TOKEN_ID) {
-            strncpy(nomeFunc, currentToken.lexeme, sizeof(nomeFunc));
-            nomeFunc[sizeof(nomeFunc) - 1] = '\0';
+        if (currentToken.type == TOKEN_LPAREN) {
+            return parseDeclFuncao(tipo, idToken);
         }
 
-        parseEat(TOKEN_ID);
-
-        printf("[DECL_FUNCAO_VOID] Função void reconhecida: %s\n", nomeFunc);
-        
-        // ✅ Verificação semântica
-        verificarRedeclaracao(nomeFunc);
+        // declaração variável
+        printf("[DECL] Reconhecida declaração de variável (primeiro ID: %s)\n", idToken.lexeme);
 
-        registrarFuncao("void", nomeFunc, numParamsTemp, tiposParamsTemp);
-        parseEat(TOKEN_LPAREN);
-        parseTiposParam();
-        parseEat(TOKEN_RPAREN);
+        NoAst* var = novoNoNomeado(NO_DECL_VAR, idToken);
+        var->tipoDecl = tipo;
+        var->tamanho = 1;
 
-        while (currentToken.type == TOKEN_COMMA) {
+        if (currentToken.type == TOKEN_LBRACK) {
             advance();
-            parseEat(TOKEN_ID);
-            printf("[DECL_FUNCAO_VOID] Função void adicional: %s\n", currentToken.lexeme);
-            parseEat(TOKEN_LPAREN);
-            parseTiposParam();
-            parseEat(TOKEN_RPAREN);
+            parseTamanhoVetor(var);
         }
 
-        if (currentToken.type == TOKEN_SEMICOLON) {
-            advance();
-        } else if (currentToken.type == TOKEN_LBRACE) {
-            // ✅ Verificação de compatibilidade com protótipo (se existir)
-            verificarAssinaturaCompatível(nomeFunc, "void", numParamsTemp, tiposParamsTemp);
-
-            // ✅ Verifica se já foi definida antes
-            verificarDefinicaoDeFuncao(nomeFunc);
+        NoAst* lista = var;
+        NoAst* fim = var;
 
-            // ✅ registra nome da função atual
-            setFuncaoAtual(nomeFunc);
-
-            limparEscopo(ESC_LOCAL);
-            escopoAtual = ESC_LOCAL;
+        // Agora trata as outras variáveis separadas por vírgula
+        while (currentToken.type == TOKEN_COMMA) {
+            advance(); // consome ','
+            anexarNo(&lista, &fim, parseDeclVar(tipo)); // consome próximo id e vetor se tiver
+        }
 
-            // ✅ Continua o parsing do corpo da função
-            parseFunc();
+        parseEat(TOKEN_SEMICOLON);
+        return lista;
 
-            escopoAtual = ESC_GLOBAL;
+    } else if (currentToken.type == TOKEN_KEYWORD_VOID) {
+        parseEat(TOKEN_KEYWORD_VOID);
 
-        } else {
-            parseError("Esperado ';' ou '{' após declaração de função void");
-        }
+        Token idToken = currentToken;
+        parseEat(TOKEN_ID);
 
-    } else {
-        parseError("Esperado tipo ou void na declaração");
+        return parseDeclFuncao(TIPO_VOID, idToken);
     }
-}
 
-// decl_var ::= id [ '[' intcon ']' ]
-void parseDeclVar(const char* tipo, Escopo escopo) {
-    char nomeVar[256];
-    int isVetor = 0;
-    int tamanho = 1;
+    parseError("Esperado tipo ou void na declaração");
+    return NULL;
+}
 
-    strncpy(nomeVar, currentToken.lexeme, sizeof(nomeVar));
-    nomeVar[sizeof(nomeVar) - 1] = '\0';
+// decl_var ::= id [ '[' expr ']' ]
+NoAst* parseDeclVar(TipoId tipo) {
+    NoAst* var = novoNoNomeado(NO_DECL_VAR, currentToken);
+    var->tipoDecl = tipo;
+    var->tamanho = 1;
 
     parseEat(TOKEN_ID);
-    printf("[DECL_VAR] Reconhecida variável: %s\n", nomeVar);
+    printf("[DECL_VAR] Reconhecida variável: %s\n", var->nome);
 
     if (currentToken.type == TOKEN_LBRACK) {
-        isVetor = 1;
         advance();
-        if (currentToken.type == TOKEN_INTCON) {
-            tamanho = atoi(currentToken.lexeme);
-            printf("[DECL_VAR] Vetor de tamanho: %d\n", tamanho);
-            advance();
-            parseEat(TOKEN_RBRACK);
-        } else {
-            parseError("Esperado número inteiro dentro dos colchetes");
-        }
+        parseTamanhoVetor(var);
     }
 
-    // ✅ Verificação semântica
-    verificarRedeclaracao(nomeVar);
-
-    registrarVariavelGlobal(tipo, nomeVar, isVetor, tamanho);
+    return var;
 }
 
-// tipo ::= char | int | float | bool 
+// tipo ::= char | int | float | bool
 void parseTipo() {
     if (isTipo(currentToken.type)) {
         advance();
     } else {
-        parseError("Esperado tipo (int, float, char, bool)");
+        parseError("Esperado tipo (int, float, char, bool, string)");
     }
 }
 
 // tipos_param ::= void | tipo (id | &id | id[]){, tipo (...)}
-void parseTiposParam() {
-    numParamsTemp = 0;
-    for (int i = 0; i < MAX_PARAMS_FUNCAO; i++) {
-        nomesParamsTemp[i][0] = '\0';
-        tiposParamsTemp[i][0] = '\0';
-    }
+void parseTiposParam(NoAst* func) {
+    NoAst* fim = NULL;
+    int numParams = 0;
 
     if (currentToken.type == TOKEN_RPAREN) {
         return;
     }
 
     if (currentToken.type == TOKEN_KEYWORD_VOID) {
-        // Registra void como único tipo de parâmetro
-        strcpy(tiposParamsTemp[0], "void");
-        numParamsTemp = 1;
-        
+        // Registra void como única "declaração" de parâmetros
+        func->paramsVoid = true;
+
         advance();
 
         if (currentToken.type != TOKEN_RPAREN) {
@@ -355,117 +285,194 @@ void parseTiposParam() {
         return;
     }
 
-    parseTipoParam();  // consome tipo e param juntos
+    anexarNo(&func->filhos[0], &fim, parseTipoParam());  // consome tipo e param juntos
+    numParams++;
 
     while (currentToken.type == TOKEN_COMMA) {
         advance();
-        parseTipoParam();  
+        if (++numParams > MAX_PARAMS_FUNCAO) {
+            parseError("Número excessivo de parâmetros na função");
+        }
+        anexarNo(&func->filhos[0], &fim, parseTipoParam());
     }
-
 }
 
-// func ::= tipo/void id(...) '{' {decl_var} {cmd} '}' 
-void parseFunc() {
+// func ::= tipo/void id(...) '{' {decl_var} {cmd} '}'
+void parseFunc(NoAst* func) {
+    NoAst* fimLocais = NULL;
+    NoAst* fimCmds = NULL;
 
     parseEat(TOKEN_LBRACE);
+    func->temCorpo = true;
 
     while (isTipo(currentToken.type)) {
-        char tipoStr[10];
-        obterTipoString(tipoStr);  // ← Isso obtém o tipo em string
+        TipoId tipo = obterTipoId();
         parseTipo();
-        parseDeclVarPrimeiro(tipoStr, ESC_LOCAL);
-        parseDeclVarResto(tipoStr, ESC_LOCAL);
+        anexarNo(&func->filhos[1], &fimLocais, parseDeclVarPrimeiro(tipo));
+        anexarNo(&func->filhos[1], &fimLocais, parseDeclVarResto(tipo));
         parseEat(TOKEN_SEMICOLON);
     }
 
     while (currentToken.type != TOKEN_RBRACE && currentToken.type != TOKEN_EOF) {
-        parseCmd();
+        anexarNo(&func->filhos[2], &fimCmds, parseCmd());
     }
 
-    verificarFuncaoComRetornoObrigatorio();
-
+    func->offsetFim = currentToken.offset;
     parseEat(TOKEN_RBRACE);
-    limparEscopo(ESC_LOCAL);
 }
 
-// cmd ::= if, while, for, return, atrib, chamada, bloco, ';'
-void parseCmd() {
+// Lista de argumentos de chamada: '(' [expr { ',' expr } ] ')'
+static NoAst* parseArgumentos(void) {
+    NoAst* args = NULL;
+    NoAst* fim = NULL;
+
+    parseEat(TOKEN_LPAREN);
+
+    if (currentToken.type != TOKEN_RPAREN) {
+        anexarNo(&args, &fim, parseExpr());
+
+        while (currentToken.type == TOKEN_COMMA) {
+            advance();
+            anexarNo(&args, &fim, parseExpr());
+        }
+    }
+
+    parseEat(TOKEN_RPAREN);
+    return args;
+}
+
+// caso ::= ( case expr | default ) ':' { cmd }
+static NoAst* parseCaso(void) {
+    NoAst* caso = novoNo(NO_CASE, currentToken);
+    NoAst* fim = NULL;
+
+    if (currentToken.type == TOKEN_KEYWORD_CASE) {
+        printf("[CMD] Reconhecido rótulo 'case'\n");
+        advance();
+        caso->filhos[0] = parseExpr();
+    } else {
+        printf("[CMD] Reconhecido rótulo 'default'\n");
+        advance();
+    }
+    parseEat(TOKEN_COLON);
+
+    while (currentToken.type != TOKEN_KEYWORD_CASE &&
+           currentToken.type != TOKEN_KEYWORD_DEFAULT &&
+           currentToken.type != TOKEN_RBRACE && currentToken.type != TOKEN_EOF) {
+        anexarNo(&caso->filhos[1], &fim, parseCmd());
+    }
+    return caso;
+}
+
+// cmd ::= if, while, for, switch, break, return, atrib, chamada, bloco, ';'
+NoAst* parseCmd() {
+    NoAst* cmd = NULL;
+
     if (currentToken.type == TOKEN_KEYWORD_IF) {
         printf("[CMD] Reconhecido comando 'if'\n");
+        cmd = novoNo(NO_IF, currentToken);
         advance();
 
         parseEat(TOKEN_LPAREN);
-        parseExpr();
+        cmd->filhos[0] = parseExpr();
         parseEat(TOKEN_RPAREN);
 
-        parseCmd();
+        cmd->filhos[1] = parseCmd();
 
         if (currentToken.type == TOKEN_KEYWORD_ELSE) {
             printf("[CMD] Reconhecido bloco 'else'\n");
             advance();
-            parseCmd();
+            cmd->filhos[2] = parseCmd();
         }
 
     } else if (currentToken.type == TOKEN_KEYWORD_WHILE) {
         printf("[CMD] Reconhecido comando 'while'\n");
+        cmd = novoNo(NO_WHILE, currentToken);
         advance();
 
         parseEat(TOKEN_LPAREN);
-        parseExpr();
+        cmd->filhos[0] = parseExpr();
         parseEat(TOKEN_RPAREN);
 
-        parseCmd();
+        cmd->filhos[1] = parseCmd();
 
-    } else if (currentToken.type == TOKEN_KEYWORD_FOR) {
+    } else if (currentToken.type == TOKEN_KEYWORD_FOR || currentToken.type == TOKEN_KEYWORD_PARALLEL) {
+        cmd = novoNo(NO_FOR, currentToken);
+        if (currentToken.type == TOKEN_KEYWORD_PARALLEL) {
+            printf("[CMD] Reconhecido prefixo 'parallel'\n");
+            cmd->valor.boolVal = true;
+            advance();
+        }
         printf("[CMD] Reconhecido comando 'for'\n");
-        advance();
+        parseEat(TOKEN_KEYWORD_FOR);
 
         parseEat(TOKEN_LPAREN);
 
         if (currentToken.type == TOKEN_ID) {
-            parseAtrib();
+            cmd->filhos[0] = parseAtrib();
         }
         parseEat(TOKEN_SEMICOLON);
 
         if (currentToken.type != TOKEN_SEMICOLON) {
-            parseExpr();
+            cmd->filhos[1] = parseExpr();
         }
         parseEat(TOKEN_SEMICOLON);
 
         if (currentToken.type == TOKEN_ID) {
-            parseAtrib();
+            cmd->filhos[2] = parseAtrib();
         }
         parseEat(TOKEN_RPAREN);
 
-        parseCmd();
+        cmd->filhos[3] = parseCmd();
+
+    } else if (currentToken.type == TOKEN_KEYWORD_SWITCH) {
+        printf("[CMD] Reconhecido comando 'switch'\n");
+        cmd = novoNo(NO_SWITCH, currentToken);
+        NoAst* fim = NULL;
+        advance();
+
+        parseEat(TOKEN_LPAREN);
+        cmd->filhos[0] = parseExpr();
+        parseEat(TOKEN_RPAREN);
+
+        parseEat(TOKEN_LBRACE);
+        while (currentToken.type == TOKEN_KEYWORD_CASE ||
+               currentToken.type == TOKEN_KEYWORD_DEFAULT) {
+            anexarNo(&cmd->filhos[1], &fim, parseCaso());
+        }
+        parseEat(TOKEN_RBRACE);
+
+    } else if (currentToken.type == TOKEN_KEYWORD_BREAK) {
+        printf("[CMD] Reconhecido comando 'break'\n");
+        cmd = novoNo(NO_BREAK, currentToken);
+        advance();
+        parseEat(TOKEN_SEMICOLON);
 
     } else if (currentToken.type == TOKEN_KEYWORD_RETURN) {
         printf("[CMD] Reconhecido comando 'return'\n");
+        cmd = novoNo(NO_RETURN, currentToken);
         advance();
 
         if (currentToken.type != TOKEN_SEMICOLON) {
-            parseExpr();
-
-            // ⚠️ Aqui: return com valor
-            verificarReturnComValor();
-        } else {
-            // ⚠️ Aqui: return vazio
-            verificarReturnSemValor();
+            cmd->filhos[0] = parseExpr();  // return com valor
         }
 
         parseEat(TOKEN_SEMICOLON);
 
     } else if (currentToken.type == TOKEN_LBRACE) {
         printf("[CMD] Bloco composto reconhecido\n");
+        cmd = novoNo(NO_BLOCO, currentToken);
+        NoAst* fim = NULL;
         advance();
 
         while (currentToken.type != TOKEN_RBRACE && currentToken.type != TOKEN_EOF) {
-            parseCmd();
+            anexarNo(&cmd->filhos[0], &fim, parseCmd());
         }
         parseEat(TOKEN_RBRACE);
 
     } else if (currentToken.type == TOKEN_SEMICOLON) {
         printf("[CMD] Comando vazio reconhecido\n");
+        cmd = novoNo(NO_VAZIO, currentToken);
         advance();
 
     } else if (currentToken.type == TOKEN_ID) {
@@ -473,32 +480,18 @@ void parseCmd() {
         ungetToken(lookahead);
 
         if (lookahead.type == TOKEN_ASSIGN || lookahead.type == TOKEN_LBRACK) {
-            parseAtrib();
+            cmd = parseAtrib();
             parseEat(TOKEN_SEMICOLON);
-            return;
 
         } else if (lookahead.type == TOKEN_LPAREN) {
             // chamada de função como comando
             printf("[CMD] Chamada de função reconhecida: %s\n", currentToken.lexeme);
-
-            // ⚠️ VERIFICAÇÃO SEMÂNTICA AQUI
-            verificarUsoDeFuncaoComoComando(currentToken.lexeme);
+            cmd = novoNoNomeado(NO_CMD_CHAMADA, currentToken);
 
             advance(); // consome id
-            parseEat(TOKEN_LPAREN);
-
-            if (currentToken.type != TOKEN_RPAREN) {
-                parseExpr();
-
-                while (currentToken.type == TOKEN_COMMA) {
-                    advance();
-                    parseExpr();
-                }
-            }
-
-            parseEat(TOKEN_RPAREN);
+            cmd->filhos[0] = parseArgumentos();
             parseEat(TOKEN_SEMICOLON);
-            return;
+
         } else {
             parseError("Identificador inesperado — esperada atribuição ou chamada de função");
         }
@@ -507,18 +500,18 @@ void parseCmd() {
         printf("[CMD] Comando inválido ou não tratado: token '%s'\n", currentToken.lexeme);
         parseError("Comando não reconhecido");
     }
+
+    return cmd;
 }
 
 // atrib ::= id [ '[' expr ']' ] = expr
-void parseAtrib() {
+NoAst* parseAtrib() {
     if (currentToken.type != TOKEN_ID) {
         parseError("Esperado identificador no início da atribuição");
-        return;
+        return NULL;
     }
 
-    // ✅ Verificação semântica
-    verificarVariavelDeclarada(currentToken.lexeme);
-    iniciarAtribuicao(currentToken.lexeme);  
+    NoAst* atrib = novoNoNomeado(NO_ATRIB, currentToken);
 
     printf("[ATRIB] Início de atribuição: %s\n", currentToken.lexeme);
     advance();  // consome o id
@@ -527,178 +520,174 @@ void parseAtrib() {
     if (currentToken.type == TOKEN_LBRACK) {
         printf("[ATRIB] Índice de vetor detectado\n");
         advance();  // consome '['
-        parseExpr();
+        atrib->filhos[0] = parseExpr();
         parseEat(TOKEN_RBRACK);  // consome ']'
     }
 
     parseEat(TOKEN_ASSIGN);  // consome '='
-    parseExpr();          // processa o lado direito da atribuição
-
-    verificarTipoExpr();  // ou "float", "char"... (temporário, depende do teste!)
+    atrib->filhos[1] = parseExpr();          // processa o lado direito da atribuição
 
     printf("[ATRIB] Atribuição completa reconhecida\n");
+    return atrib;
 }
 
-// expr ::= expr_simp [ op_rel  expr_simp ] 
-void parseExpr() {
-    parseExprSimp();
-
-    const char* tipoAntesOperadorRel = getTipoExpressao();  // <-- O ESQUERDO 
+// expr ::= expr_simp [ op_rel  expr_simp ]
+NoAst* parseExpr() {
+    NoAst* esquerda = parseExprSimp();  // <-- O ESQUERDO
 
     if (currentToken.type == TOKEN_EQ || currentToken.type == TOKEN_NEQ ||
         currentToken.type == TOKEN_LT || currentToken.type == TOKEN_GT ||
         currentToken.type == TOKEN_LEQ || currentToken.type == TOKEN_GEQ) {
-        
-        advance(); // consome o operador relacional
-
-        parseExprSimp();  // <-- O DIREITO 
-
-        const char* tipoDepoisOperadorRel = getTipoExpressao();
 
-        if (!(strcmp(tipoAntesOperadorRel, "int") == 0 || strcmp(tipoAntesOperadorRel, "char") == 0) ||
-            !(strcmp(tipoDepoisOperadorRel, "int") == 0 || strcmp(tipoDepoisOperadorRel, "char") == 0)) {
-            fprintf(stderr, "[ERRO SEMÂNTICO] Operadores relacionais requerem operandos do tipo int ou char (não bool)\n");
-            setTipoExpressao("erro");
-        } else {
-            registrarTipoRelacional(); // resultado será bool
-        }
+        NoAst* rel = novoNo(NO_BINARIO, currentToken);
+        rel->op = currentToken.type;
+        advance(); // consome o operador relacional
 
+        rel->filhos[0] = esquerda;
+        rel->filhos[1] = parseExprSimp();  // <-- O DIREITO
+        esquerda = rel;
     }
 
     printf("[EXPR] Expressão reconhecida (expr)\n");
+    return esquerda;
 }
 
-// expr_simp ::= [+ | – ] termo {(+ | – | ||) termo} 
-void parseExprSimp() {
+// expr_simp ::= [+ | – ] termo {(+ | – | ||) termo}
+NoAst* parseExprSimp() {
+    NoAst* unario = NULL;
+
     if (currentToken.type == TOKEN_PLUS || currentToken.type == TOKEN_MINUS) {
+        unario = novoNo(NO_UNARIO, currentToken);
+        unario->op = currentToken.type;
         advance(); // consome operador unário
     }
 
-    parseTermo();
-    const char* tipoAnterior = getTipoExpressao();
+    NoAst* esquerda = parseTermo();
 
-    while (currentToken.type == TOKEN_PLUS || 
-           currentToken.type == TOKEN_MINUS || 
-           currentToken.type == TOKEN_OR) {
-        
-        int operador = currentToken.type;  // salva operador atual
-        advance(); // consome operador
+    // O sinal unário se aplica ao primeiro termo
+    if (unario) {
+        unario->filhos[0] = esquerda;
+        esquerda = unario;
+    }
 
-        parseTermo();
+    while (currentToken.type == TOKEN_PLUS ||
+           currentToken.type == TOKEN_MINUS ||
+           currentToken.type == TOKEN_OR) {
 
-        if (operador == TOKEN_OR) {
-            if (strcmp(tipoAnterior, "bool") != 0 || strcmp(getTipoExpressao(), "bool") != 0) {
-                fprintf(stderr, "[ERRO SEMÂNTICO] Operador || requer operandos do tipo bool\n");
-                setTipoExpressao("erro");  // <<< ESSENCIAL: marca erro para impedir propagação
-            } else {
-                registrarTipoLogico();  // resultado será bool
-            }
-        } else {
-            setTipoExpressao(tipoDominanteAritmetico(tipoAnterior, getTipoExpressao()));
-        }
+        NoAst* bin = novoNo(NO_BINARIO, currentToken);
+        bin->op = currentToken.type;  // salva operador atual
+        advance(); // consome operador
 
-        tipoAnterior = getTipoExpressao(); // atualiza para próxima iteração
+        bin->filhos[0] = esquerda;
+        bin->filhos[1] = parseTermo();
+        esquerda = bin;
     }
 
     printf("[EXPR] Expressão reconhecida (expr_simp)\n");
+    return esquerda;
 }
 
-// termo ::= fator {(* | / | &&)  fator} 
-void parseTermo() {
-    parseFator();
-    const char* tipoAnterior = getTipoExpressao();  
+// termo ::= fator {(* | / | &&)  fator}
+NoAst* parseTermo() {
+    NoAst* esquerda = parseFator();
 
-    while (currentToken.type == TOKEN_MUL || 
-           currentToken.type == TOKEN_DIV || 
+    while (currentToken.type == TOKEN_MUL ||
+           currentToken.type == TOKEN_DIV ||
            currentToken.type == TOKEN_AND) {
-        
-        int operador = currentToken.type;
+
+        NoAst* bin = novoNo(NO_BINARIO, currentToken);
+        bin->op = currentToken.type;
         advance(); // consome operador
-        parseFator();
-        const char* tipoAtual = getTipoExpressao();
-
-        if (operador == TOKEN_AND) {
-            if (strcmp(tipoAnterior, "bool") != 0 || strcmp(tipoAtual, "bool") != 0) {
-                fprintf(stderr, "[ERRO SEMÂNTICO] Operador && requer operandos do tipo bool\n");
-                setTipoExpressao("erro");  // <<< ESSENCIAL: impede atribuição com tipo errado
-            } else {
-                registrarTipoLogico();
-            }
-        } else {
-            setTipoExpressao(tipoDominanteAritmetico(tipoAnterior, tipoAtual));
-        }
 
-        tipoAnterior = getTipoExpressao();  // atualiza
+        bin->filhos[0] = esquerda;
+        bin->filhos[1] = parseFator();
+        esquerda = bin;
     }
 
     printf("[EXPR] Expressão reconhecida (termo)\n");
+    return esquerda;
 }
 
 // fator ::= id[...] | constantes | chamada | (!fator)
-void parseFator() {
+NoAst* parseFator() {
+    NoAst* fator = NULL;
+
     if (currentToken.type == TOKEN_ID) {
         Token idToken = currentToken;
         advance();
 
         if (currentToken.type == TOKEN_LBRACK) {
             // Uso como vetor
-            verificarVariavelDeclarada(idToken.lexeme);
-            analisarTokenAtual(idToken);  // <- AQUI: registra tipo do vetor
+            fator = novoNoNomeado(NO_INDEXACAO, idToken);
             advance();
-            parseExpr();
+            fator->filhos[0] = parseExpr();
             parseEat(TOKEN_RBRACK);
 
         } else if (currentToken.type == TOKEN_LPAREN) {
             // Uso como função
-            verificarUsoDeFuncaoEmExpressao(idToken.lexeme);
-            advance();
-
-            if (currentToken.type != TOKEN_RPAREN) {
-                parseExpr();
-                while (currentToken.type == TOKEN_COMMA) {
-                    advance();
-                    parseExpr();
-                }
-            }
-
-            parseEat(TOKEN_RPAREN);
+            fator = novoNoNomeado(NO_CHAMADA, idToken);
+            fator->filhos[0] = parseArgumentos();
 
         } else {
             // Uso como variável simples
-            verificarVariavelDeclarada(idToken.lexeme);
-            analisarTokenAtual(idToken);  // <- AQUI: registra tipo do id simples
+            fator = novoNoNomeado(NO_ID, idToken);
         }
 
         printf("[EXPR] Fator reconhecido: %s\n", idToken.lexeme);
     }
-    else if (currentToken.type == TOKEN_INTCON || 
+    else if (currentToken.type == TOKEN_INTCON ||
              currentToken.type == TOKEN_REALCON ||
-             currentToken.type == TOKEN_CHARCON || 
+             currentToken.type == TOKEN_CHARCON ||
              currentToken.type == TOKEN_CHARCON_N ||
              currentToken.type == TOKEN_CHARCON_0 ||
              currentToken.type == TOKEN_BOOLCON) {
         printf("[EXPR] Constante reconhecida: %s\n", currentToken.lexeme);
-        registrarTipoConstante(currentToken);
+
+        switch (currentToken.type) {
+            case TOKEN_INTCON:
+                fator = novoNo(NO_CONST_INT, currentToken);
+                fator->valor.intVal = currentToken.intVal;
+                break;
+            case TOKEN_REALCON:
+                fator = novoNo(NO_CONST_REAL, currentToken);
+                fator->valor.realVal = currentToken.realVal;
+                break;
+            case TOKEN_BOOLCON:
+                fator = novoNo(NO_CONST_BOOL, currentToken);
+                fator->valor.boolVal = strcmp(currentToken.lexeme, "true") == 0;
+                break;
+            default:
+                fator = novoNo(NO_CONST_CHAR, currentToken);
+                fator->valor.charVal = currentToken.charVal;
+                break;
+        }
+        advance();
+    }
+    else if (currentToken.type == TOKEN_STRINGCON) {
+        printf("[EXPR] Constante reconhecida: %s\n", currentToken.lexeme);
+
+        // Literais iguais compartilham a mesma entrada do pool
+        fator = novoNo(NO_CONST_STRING, currentToken);
+        fator->valor.intVal = internarString(currentToken.strVal, currentToken.tamStr);
+        free(currentToken.strVal);
         advance();
     }
     else if (currentToken.type == TOKEN_LPAREN) {
         advance();
-        parseExpr();
+        fator = parseExpr();
         parseEat(TOKEN_RPAREN);
     }
     else if (currentToken.type == TOKEN_NOT) {
+        fator = novoNo(NO_UNARIO, currentToken);
+        fator->op = TOKEN_NOT;
         advance();
-        parseFator();
-        if (strcmp(getTipoExpressao(), "bool") != 0) {
-            fprintf(stderr, "[ERRO SEMÂNTICO] Operador ! requer operando do tipo bool\n");
-            setTipoExpressao("erro");
-        } else {
-            registrarTipoLogico();  // só registra se for bool de verdade
-        }
+        fator->filhos[0] = parseFator();
     }
     else {
         parseError("Fator inválido");
     }
+
+    return fator;
 }
 
 // ==============================
@@ -706,42 +695,31 @@ void parseFator() {
 // ==============================
 
 // Primeira variável da lista
-void parseDeclVarPrimeiro(const char* tipo, Escopo escopo) {
+NoAst* parseDeclVarPrimeiro(TipoId tipo) {
     if (currentToken.type != TOKEN_ID) {
         parseError("Esperado identificador na declaração de variável");
     }
 
-    char nome[256];
-    int isVetor = 0;
-    int tamanho = 1;
-
-    strncpy(nome, currentToken.lexeme, sizeof(nome));
-    nome[sizeof(nome) - 1] = '\0';
+    NoAst* var = novoNoNomeado(NO_DECL_VAR, currentToken);
+    var->tipoDecl = tipo;
+    var->tamanho = 1;
     advance(); // consome o ID
 
-    printf("[DECL_VAR] Reconhecida variável: %s\n", nome);
+    printf("[DECL_VAR] Reconhecida variável: %s\n", var->nome);
 
     if (currentToken.type == TOKEN_LBRACK) {
         advance();
-        if (currentToken.type == TOKEN_INTCON) {
-            isVetor = 1;
-            tamanho = atoi(currentToken.lexeme);
-            printf("[DECL_VAR] Vetor com tamanho: %s\n", currentToken.lexeme);
-            advance();
-            parseEat(TOKEN_RBRACK);
-        } else {
-            parseError("Esperado número inteiro dentro dos colchetes");
-        }
+        parseTamanhoVetor(var);
     }
 
-    if (escopo == ESC_GLOBAL)
-        registrarVariavelGlobal(tipo, nome, isVetor, tamanho);
-    else
-        registrarVariavelLocal(tipo, nome, isVetor, tamanho);
+    return var;
 }
 
 // Demais variáveis após vírgula
-void parseDeclVarResto(const char* tipo, Escopo escopo) {
+NoAst* parseDeclVarResto(TipoId tipo) {
+    NoAst* lista = NULL;
+    NoAst* fim = NULL;
+
     while (currentToken.type == TOKEN_COMMA) {
         advance(); // consome ','
 
@@ -749,60 +727,37 @@ void parseDeclVarResto(const char* tipo, Escopo escopo) {
             parseError("Esperado identificador após ','");
         }
 
-        char nome[256];
-        int isVetor = 0;
-        int tamanho = 1;
-
-        strncpy(nome, currentToken.lexeme, sizeof(nome));
-        nome[sizeof(nome) - 1] = '\0';
+        NoAst* var = novoNoNomeado(NO_DECL_VAR, currentToken);
+        var->tipoDecl = tipo;
+        var->tamanho = 1;
         advance(); // consome o ID
 
-        printf("[DECL_VAR] Reconhecida variável extra: %s\n", nome);
+        printf("[DECL_VAR] Reconhecida variável extra: %s\n", var->nome);
 
         if (currentToken.type == TOKEN_LBRACK) {
             advance();
-            if (currentToken.type == TOKEN_INTCON) {
-                isVetor = 1;
-                tamanho = atoi(currentToken.lexeme);
-                printf("[DECL_VAR] Vetor de tamanho: %s\n", currentToken.lexeme);
-                advance();
-                parseEat(TOKEN_RBRACK);
-            } else {
-                parseError("Esperado número inteiro dentro dos colchetes");
-            }
+            parseTamanhoVetor(var);
         }
 
-        if (escopo == ESC_GLOBAL)
-            registrarVariavelGlobal(tipo, nome, isVetor, tamanho);
-        else
-            registrarVariavelLocal(tipo, nome, isVetor, tamanho);
-
+        anexarNo(&lista, &fim, var);
     }
+
+    return lista;
 }
 
 // Tipo (id | &id | id[])
-void parseTipoParam() {
+NoAst* parseTipoParam() {
     if (!isTipo(currentToken.type)) {
-        parseError("Esperado tipo (int, char, float, bool) no parâmetro");
-    }
-
-    char tipoStr[10];                  // ← Captura o tipo ANTES de consumir
-    obterTipoString(tipoStr);
-
-    if (numParamsTemp < MAX_PARAMS_FUNCAO) {
-        strncpy(tiposParamsTemp[numParamsTemp], tipoStr, sizeof(tiposParamsTemp[numParamsTemp]));
-        tiposParamsTemp[numParamsTemp][sizeof(tiposParamsTemp[numParamsTemp]) - 1] = '\0';
-        numParamsTemp++;
-    } else {
-        parseError("Número excessivo de parâmetros na função");
+        parseError("Esperado tipo (int, char, float, bool, string) no parâmetro");
     }
 
+    TipoId tipo = obterTipoId();   // ← Captura o tipo ANTES de consumir
     advance(); // consome o tipo
 
-    // Verifica se é '&' (um único token do tipo TOKEN_AND)
-    int porReferencia = 0;
+    // Verifica se é '&' (um único token do tipo TOKEN_BITAND)
+    bool porReferencia = false;
     if (currentToken.type == TOKEN_BITAND) {
-        porReferencia = 1;
+        porReferencia = true;
         advance(); // consome '&'
     }
 
@@ -811,47 +766,35 @@ void parseTipoParam() {
         parseError("Esperado identificador no parâmetro");
     }
 
-    char nome[256];
-    strncpy(nome, currentToken.lexeme, sizeof(nome));
-    nome[sizeof(nome) - 1] = '\0';
-
-    // ✅ Verifica se já existe parâmetro com mesmo nome
-    verificarParametroRepetido(nome);  // ← ESTA LINHA É A NOVA ADIÇÃO
-
-    // ✅ Armazena o nome após checar
-    strncpy(nomesParamsTemp[numParamsTemp], nome, sizeof(nomesParamsTemp[numParamsTemp]));
-    nomesParamsTemp[numParamsTemp][sizeof(nomesParamsTemp[numParamsTemp]) - 1] = '\0';
-
-    numParamsTemp++; // só incrementa aqui, após nome e tipo armazenados
+    NoAst* param = novoNoNomeado(NO_PARAM, currentToken);
+    param->tipoDecl = tipo;
+    param->porReferencia = porReferencia;
 
     advance(); // consome ID
 
     // Verifica se é vetor
-    int isVetor = 0;
     if (currentToken.type == TOKEN_LBRACK) {
         advance();
         parseEat(TOKEN_RBRACK);
-        isVetor = 1;
+        param->ehVetor = true;
     }
 
-    // ao chamar registrarParametro
-    if (porReferencia) {
-        registrarParametro(tipoStr, nome, CLASSE_PARAM, ESC_LOCAL, 1);
-    } else if (isVetor) {
-        registrarParametro(tipoStr, nome, CLASSE_VETOR, ESC_LOCAL, 1);
-    } else {
-        registrarParametro(tipoStr, nome, CLASSE_PARAM, ESC_LOCAL, 1);
-    }
+    return param;
 }
 
 // Lista de variáveis tipo v1, v2, v3;
-void parseDeclVarLista(const char* tipo, Escopo escopo) {
-    parseDeclVar(tipo, ESC_GLOBAL); // primeiro já consumido id
+NoAst* parseDeclVarLista(TipoId tipo) {
+    NoAst* lista = NULL;
+    NoAst* fim = NULL;
+
+    anexarNo(&lista, &fim, parseDeclVar(tipo)); // primeiro já consumido id
 
     while (currentToken.type == TOKEN_COMMA) {
         advance(); // consome ','
-        parseDeclVar(tipo, ESC_GLOBAL); // próximo id
+        anexarNo(&lista, &fim, parseDeclVar(tipo)); // próximo id
     }
+
+    return lista;
 }
 
 // ==============================
@@ -863,12 +806,14 @@ int isTipo(TokenType t) {
     return t == TOKEN_KEYWORD_INT ||
            t == TOKEN_KEYWORD_CHAR ||
            t == TOKEN_KEYWORD_FLOAT ||
-           t == TOKEN_KEYWORD_BOOL;
+           t == TOKEN_KEYWORD_BOOL ||
+           t == TOKEN_KEYWORD_STRING;
 }
 
 // verifica se t inicia comando
 int isComandoInicio(TokenType t) {
     return t == TOKEN_KEYWORD_IF || t == TOKEN_KEYWORD_WHILE ||
+           t == TOKEN_KEYWORD_SWITCH || t == TOKEN_KEYWORD_BREAK ||
            t == TOKEN_KEYWORD_RETURN || t == TOKEN_LBRACE ||
            t == TOKEN_ID || t == TOKEN_SEMICOLON;
 }
@@ -884,7 +829,19 @@ void obterTipoString(char* dest) {
         case TOKEN_KEYWORD_FLOAT: strcpy(dest, "float"); break;
         case TOKEN_KEYWORD_CHAR:  strcpy(dest, "char"); break;
         case TOKEN_KEYWORD_BOOL:  strcpy(dest, "bool"); break;
+        case TOKEN_KEYWORD_STRING: strcpy(dest, "string"); break;
         default: strcpy(dest, "???"); break;
     }
 }
 
+// Retorna o identificador do tipo atual do token (int, float, char, bool)
+TipoId obterTipoId(void) {
+    switch (currentToken.type) {
+        case TOKEN_KEYWORD_INT:   return TIPO_INT;
+        case TOKEN_KEYWORD_FLOAT: return TIPO_FLOAT;
+        case TOKEN_KEYWORD_CHAR:  return TIPO_CHAR;
+        case TOKEN_KEYWORD_BOOL:  return TIPO_BOOL;
+        case TOKEN_KEYWORD_STRING: return TIPO_STRING;
+        default:                  return TIPO_ERRO;
+    }
+}
@@ -0,0 +1,306 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "otimizacao.h"
+
+// ==============================================
+// PROMOÇÃO DE ESCALARES EM LAÇOS
+// ==============================================
+//
+// Uma global escalar (ou um elemento de índice constante, ou uma variável
+// passada por &id) lida e gravada a cada volta, como 'total' em
+// 'total = total + v[i]', passa a viver num valor durante o laço. É lida
+// uma vez no pré-cabeçalho e circula por phi. Volta para a memória na
+// saída do laço e antes das chamadas que podem lê-la
+// (pelo resumo de efeitos da função chamada).
+//
+// Condições: o endereço sempre existe (a leitura antes do laço não pode
+// falhar) e vem de fora do laço. Nenhum outro acesso do laço pode atingir
+// a mesma memória e nenhuma chamada do laço pode gravá-la.
+
+// Promoções por chamada do passe (cada uma encontra os laços de novo)
+#define MAX_PROMOCOES 256
+
+// ===================
+// Endereços
+// ===================
+
+static bool mesmoEndereco(const InstrIr* a, const InstrIr* b) {
+    if (a == b) return true;
+    if (a->op != b->op) return false;
+
+    switch (a->op) {
+        case IR_GLOBAL:
+            return a->simbolo == b->simbolo;
+        case IR_LOCAL:
+            return a->indice == b->indice;
+        case IR_ELEM:
+            return a->escala == b->escala && a->args[1]->op == IR_CONST && b->args[1]->op == IR_CONST
+                   && a->args[1]->imm.i == b->args[1]->imm.i && mesmoEndereco(a->args[0], b->args[0]);
+        default:
+            return false;
+    }
+}
+
+// Elementos de índices constantes diferentes do mesmo vetor
+static bool elementosDistintos(const InstrIr* a, const InstrIr* b) {
+    return a->op == IR_ELEM && b->op == IR_ELEM && a->escala == b->escala
+           && a->args[1]->op == IR_CONST && b->args[1]->op == IR_CONST
+           && a->args[1]->imm.i != b->args[1]->imm.i && mesmoEndereco(a->args[0], b->args[0]);
+}
+
+// Um acesso escalar de 'tipo' em 'end' pode atingir o endereço promovido?
+static bool conflita(const FuncaoIr* f, const InstrIr* end, TipoIr tipo, const InstrIr* promovido) {
+    if (!ehVetorIr(tipo) && elementosDistintos(end, promovido)) return false;
+    return podemSobreporIr(f, end, promovido);
+}
+
+static bool ehAcesso(const InstrIr* i, const InstrIr* end) {
+    return (i->op == IR_LOAD || i->op == IR_STORE) && mesmoEndereco(i->args[0], end);
+}
+
+// A chamada pode ler a memória do endereço? Um slot de quem chama só é
+// alcançado pelos argumentos; o runtime só lê o que recebe (a não ser que
+// execute uma função do programa)
+static bool chamadaPodeLer(const FuncaoIr* f, const InstrIr* call, const InstrIr* end) {
+    if (chamadaExecutaFuncao(call)) return true;
+
+    bool porArgumento = false;
+    for (int a = 0; a < call->nArgs && !porArgumento; a++) {
+        porArgumento = call->args[a]->tipo == IR_PTR && podemSobreporIr(f, call->args[a], end);
+    }
+
+    const InstrIr* raiz = end;
+    while (raiz->op == IR_ELEM) raiz = raiz->args[0];
+    if (raiz->op == IR_LOCAL || call->simbolo < 0) return porArgumento;
+
+    int e = efeitosDeChamada(call);
+    if (e & (EFEITO_LE_GLOBAIS | EFEITO_EXTERNO)) return true;
+    return (e & EFEITO_LE_REFERENCIAS) && porArgumento;
+}
+
+// ===================
+// Candidatos
+// ===================
+
+static bool invariante(const LacoIr* l, const InstrIr* v) {
+    return !l->contem[v->bloco->id];
+}
+
+static TipoIr tipoDoAcesso(const InstrIr* i) {
+    return i->op == IR_LOAD ? i->tipo : i->args[1]->tipo;
+}
+
+// O laço tem a forma que a reescrita espera: só o cabeçalho recebe arestas
+// de fora, e nenhum desvio leva aos dois lados para o mesmo bloco
+static bool lacoSimples(const LacoIr* l) {
+    for (int b = 0; b < l->nBlocos; b++) {
+        const BlocoIr* bloco = l->blocos[b];
+        if (bloco != l->cabecalho) {
+            for (int p = 0; p < bloco->nPreds; p++) {
+                if (!l->contem[bloco->preds[p]->id]) return false;
+            }
+        }
+        const InstrIr* t = terminadorIr(bloco);
+        if (t->op == IR_BR && t->alvos[0] == t->alvos[1]) return false;
+    }
+    return true;
+}
+
+// Gravação que a própria promoção deixa no laço: as de vários endereços
+// promovidos ficam juntas logo antes da chamada
+static bool gravacaoAntesDeChamada(const InstrIr* st) {
+    const InstrIr* i = st->prox;
+    while (i && i->op == IR_STORE) i = i->prox;
+    return i && i->op == IR_CALL;
+}
+
+// Tipo do valor promovido, ou IR_VOID se o endereço não pode ser promovido.
+// Só compensa se o laço lê o endereço ou grava nele fora das gravações
+// antes de chamadas
+static TipoIr avaliar(const FuncaoIr* f, const LacoIr* l, const InstrIr* end) {
+    if (!invariante(l, end) || !enderecoValidoIr(end)) return IR_VOID;
+
+    TipoIr tipo = IR_VOID;
+    bool compensa = false;
+    for (int b = 0; b < l->nBlocos; b++) {
+        for (const InstrIr* i = l->blocos[b]->primeira; i; i = i->prox) {
+            if (ehAcesso(i, end)) {
+                TipoIr t = tipoDoAcesso(i);
+                if (tipo != IR_VOID && t != tipo) return IR_VOID;
+                tipo = t;
+                compensa |= i->op == IR_LOAD || !gravacaoAntesDeChamada(i);
+                continue;
+            }
+
+            switch (i->op) {
+                case IR_LOAD:
+                case IR_STORE:
+                    if (conflita(f, i->args[0], tipoDoAcesso(i), end)) return IR_VOID;
+                    break;
+                case IR_COPIAR:
+                    if (podemSobreporIr(f, i->args[1], end)) return IR_VOID;
+                    // fallthrough
+                case IR_ZERAR:
+                    if (podemSobreporIr(f, i->args[0], end)) return IR_VOID;
+                    break;
+                case IR_CALL:
+                    if (chamadaPodeGravarIr(f, i, end)) return IR_VOID;
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+    if (!compensa || ehVetorIr(tipo) || tipo == IR_PTR) return IR_VOID;
+    return tipo;
+}
+
+// ===================
+// Reescrita
+// ===================
+
+static void gravarAntes(FuncaoIr* f, InstrIr* pos, InstrIr* end, InstrIr* valor) {
+    InstrIr* st = novaInstrIr(f, IR_STORE, IR_VOID);
+    st->linha = pos->linha;
+    adicionarArgIr(st, end);
+    adicionarArgIr(st, valor);
+    inserirAntesIr(pos, st);
+}
+
+// Bloco novo no caminho de b para s (os phi de s continuam na mesma ordem)
+static BlocoIr* separarAresta(FuncaoIr* f, BlocoIr* b, BlocoIr* s) {
+    BlocoIr* novo = novoBlocoIr(f);
+    InstrIr* t = terminadorIr(b);
+    for (int k = 0; k < 2; k++) {
+        if (t->alvos[k] == s) t->alvos[k] = novo;
+    }
+    s->preds[indicePredIr(s, b)] = novo;
+    adicionarPredIr(novo, b);
+
+    InstrIr* jmp = novaInstrIr(f, IR_JMP, IR_VOID);
+    jmp->alvos[0] = s;
+    jmp->linha = t->linha;
+    anexarInstrIr(novo, jmp);
+    return novo;
+}
+
+static void promover(FuncaoIr* f, LacoIr* l, InstrIr* end, TipoIr tipo) {
+    BlocoIr* h = l->cabecalho;
+    int nBlocos = f->nBlocos;
+    InstrIr** saida = calloc(nBlocos, sizeof(InstrIr*));      // valor no fim de cada bloco
+
+    InstrIr* inicial = novaInstrIr(f, IR_LOAD, tipo);
+    inicial->linha = h->primeira->linha;
+    adicionarArgIr(inicial, end);
+    inserirAntesIr(terminadorIr(l->preCabecalho), inicial);
+
+    // Em pós-ordem reversa: com um predecessor só, ele já foi visto
+    for (int b = 0; b < l->nBlocos; b++) {
+        BlocoIr* bloco = l->blocos[b];
+        InstrIr* atual;
+        if (bloco == h || bloco->nPreds > 1) {
+            atual = novaInstrIr(f, IR_PHI, tipo);
+            atual->linha = bloco->primeira->linha;
+            inserirAntesIr(bloco->primeira, atual);
+        } else {
+            atual = saida[bloco->preds[0]->id];
+        }
+
+        InstrIr* i = atual->op == IR_PHI && atual->bloco == bloco ? atual->prox : bloco->primeira;
+        while (i) {
+            InstrIr* prox = i->prox;
+            if (i->op == IR_LOAD && mesmoEndereco(i->args[0], end)) {
+                substituirUsosIr(i, atual);
+                removerInstrIr(i);
+            } else if (i->op == IR_STORE && mesmoEndereco(i->args[0], end)) {
+                atual = i->args[1];
+                removerInstrIr(i);
+            } else if (i->op == IR_CALL && chamadaPodeLer(f, i, end)) {
+                gravarAntes(f, i, end, atual);
+            }
+            i = prox;
+        }
+        saida[bloco->id] = atual;
+    }
+
+    // Operandos dos phi criados: o valor inicial vem do pré-cabeçalho
+    for (int b = 0; b < l->nBlocos; b++) {
+        BlocoIr* bloco = l->blocos[b];
+        if (bloco != h && bloco->nPreds == 1) continue;
+        InstrIr* phi = bloco->primeira;
+        for (int p = 0; p < bloco->nPreds; p++) {
+            BlocoIr* pred = bloco->preds[p];
+            adicionarArgIr(phi, l->contem[pred->id] ? saida[pred->id] : inicial);
+        }
+    }
+
+    // Saídas: as arestas são juntadas antes porque separar cria blocos
+    int nSaidas = 0;
+    BlocoIr** de = malloc(2 * l->nBlocos * sizeof(BlocoIr*));
+    BlocoIr** para = malloc(2 * l->nBlocos * sizeof(BlocoIr*));
+    for (int b = 0; b < l->nBlocos; b++) {
+        BlocoIr* succ[2];
+        int ns = sucessoresIr(l->blocos[b], succ);
+        for (int s = 0; s < ns; s++) {
+            if (l->contem[succ[s]->id]) continue;
+            de[nSaidas] = l->blocos[b];
+            para[nSaidas++] = succ[s];
+        }
+    }
+    for (int k = 0; k < nSaidas; k++) {
+        BlocoIr* destino = para[k]->nPreds == 1 ? para[k] : separarAresta(f, de[k], para[k]);
+        InstrIr* pos = destino->primeira;
+        while (pos->op == IR_PHI) pos = pos->prox;
+
+        // A saída já grava o endereço logo no início (de uma promoção anterior)
+        const InstrIr* st = pos;
+        while (st->op == IR_STORE && !(mesmoEndereco(st->args[0], end) && st->args[1]->tipo == tipo)) st = st->prox;
+        if (st->op == IR_STORE) continue;
+        gravarAntes(f, pos, end, saida[de[k]->id]);
+    }
+
+    free(de);
+    free(para);
+    free(saida);
+}
+
+// Promove um endereço do laço; devolve se achou algum
+static bool promoverLaco(FuncaoIr* f, LacoIr* l) {
+    if (!lacoSimples(l)) return false;
+
+    for (int b = 0; b < l->nBlocos; b++) {
+        for (InstrIr* i = l->blocos[b]->primeira; i; i = i->prox) {
+            if (i->op != IR_LOAD && i->op != IR_STORE) continue;
+            TipoIr tipo = avaliar(f, l, i->args[0]);
+            if (tipo == IR_VOID) continue;
+
+            promover(f, l, i->args[0], tipo);
+            return true;
+        }
+    }
+    return false;
+}
+
+// ===================
+// Passe
+// ===================
+
+// Cada promoção muda os blocos: os laços são encontrados de novo. Dos
+// internos para os externos, então a leitura e as gravações que ficaram em
+// volta de um laço interno ainda podem sair do externo
+bool promoverEscalares(FuncaoIr* f) {
+    bool mudou = false;
+    bool progresso = true;
+
+    for (int rodada = 0; progresso && rodada < MAX_PROMOCOES; rodada++) {
+        int n;
+        LacoIr** lacos = encontrarLacosIr(f, &n);
+        progresso = false;
+        for (int k = 0; k < n && !progresso; k++) progresso = promoverLaco(f, lacos[k]);
+        liberarLacosIr(lacos, n);
+        mudou |= progresso;
+    }
+    return mudou;
+}
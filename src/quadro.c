@@ -0,0 +1,539 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "codegen.h"
+
+// ==============================================
+// QUADRO DE PILHA
+// ==============================================
+//
+// Cada valor que não é refeito a cada uso ganha um lugar no quadro. O
+// mesmo vale para a entrada de cada phi e para cada slot da IR (vetores,
+// variáveis que vivem na memória, temporários string). Dois objetos que
+// nunca estão vivos no mesmo ponto da função ocupam os mesmos bytes.
+//
+// Onde cada objeto está vivo, por bloco:
+// - valor: do ponto em que é definido até o último uso. Phi e parâmetros
+//   são definidos no início do bloco. Os argumentos de um phi são usados
+//   no terminador do predecessor;
+// - entrada de phi: gravada no terminador de cada predecessor e lida no
+//   início do bloco do phi;
+// - slot: nos pontos que vêm depois de algum acesso e antes de outro (por
+//   algum caminho). Um slot cujo endereço vai para a memória, ou se mistura
+//   com outro slot num phi, fica vivo na função inteira.
+//
+// Os objetos são colocados do maior para o menor (e do mais alinhado para
+// o menos alinhado). Cada um vai para o primeiro lugar alinhado que não se
+// sobrepõe aos vizinhos já colocados.
+
+typedef uint64_t Palavra;
+
+typedef struct {
+    int tamanho;
+    int alinhamento;
+    int fim;                // ocupa [-fim, -fim + tamanho) a partir de %rbp
+    bool presente;
+    bool fixo;              // vivo na função inteira
+    int* vizinhos;          // objetos vivos ao mesmo tempo (pode repetir)
+    int nVizinhos;
+    int capVizinhos;
+} Objeto;
+
+// Trecho de um bloco em que o objeto está vivo. Posição k = instrução k do
+// bloco; n (o nº de instruções) = depois do terminador
+typedef struct {
+    int objeto;
+    int de, ate;            // inclusive
+} Trecho;
+
+typedef struct {
+    const FuncaoIr* f;
+    int nValores;
+    int nObjetos;           // valores, entradas de phi (nValores + id) e slots (2 * nValores + s)
+    Objeto* objetos;
+
+    int palavrasValores;
+    int palavrasSlots;
+    Palavra** vivoEntrada;  // valores vivos no início de cada bloco
+    Palavra** vivoSaida;    // e no fim
+    Palavra** acessoAntes;  // slots acessados em algum caminho até o início do bloco
+    Palavra** acessoDepois; // slots acessados em algum caminho a partir do fim do bloco
+    int* origem;            // slot de onde vem cada endereço (-1: nenhum)
+} Quadro;
+
+// ===================
+// Conjuntos de bits
+// ===================
+
+static inline bool temBit(const Palavra* c, int i) {
+    return (c[i / 64] >> (i % 64)) & 1;
+}
+
+static inline void marcarBit(Palavra* c, int i) {
+    c[i / 64] |= (Palavra)1 << (i % 64);
+}
+
+static Palavra** novosConjuntos(int n, int palavras) {
+    Palavra** c = malloc((n > 0 ? n : 1) * sizeof(Palavra*));
+    for (int k = 0; k < n; k++) c[k] = calloc(palavras > 0 ? palavras : 1, sizeof(Palavra));
+    return c;
+}
+
+static void liberarConjuntos(Palavra** c, int n) {
+    for (int k = 0; k < n; k++) free(c[k]);
+    free(c);
+}
+
+// destino |= origem; devolve se mudou
+static bool unir(Palavra* destino, const Palavra* origem, int palavras) {
+    bool mudou = false;
+    for (int w = 0; w < palavras; w++) {
+        Palavra novo = destino[w] | origem[w];
+        mudou |= novo != destino[w];
+        destino[w] = novo;
+    }
+    return mudou;
+}
+
+// ===================
+// Objetos
+// ===================
+
+static int objetoEntrada(const Quadro* q, int phi) {
+    return q->nValores + phi;
+}
+
+static int objetoSlot(const Quadro* q, int s) {
+    return 2 * q->nValores + s;
+}
+
+static void adicionarVizinho(Objeto* o, int v) {
+    if (o->nVizinhos == o->capVizinhos) {
+        o->capVizinhos = o->capVizinhos ? o->capVizinhos * 2 : 8;
+        o->vizinhos = realloc(o->vizinhos, o->capVizinhos * sizeof(int));
+    }
+    o->vizinhos[o->nVizinhos++] = v;
+}
+
+static int tamanhoBloco(const BlocoIr* b) {
+    int n = 0;
+    for (InstrIr* i = b->primeira; i; i = i->prox) n++;
+    return n;
+}
+
+// Ponto em que o valor é definido no seu bloco
+static int posicaoDefinicao(const InstrIr* i, int k) {
+    return i->op == IR_PHI || i->op == IR_PARAM ? 0 : k;
+}
+
+// ===================
+// Valores
+// ===================
+
+// Vivos no início e no fim de cada bloco (SSA: um phi usa seu argumento no
+// fim do predecessor correspondente, não no bloco do phi)
+static void analisarValores(Quadro* q, const bool* lugar) {
+    const FuncaoIr* f = q->f;
+    int palavras = q->palavrasValores;
+    Palavra** usados = novosConjuntos(f->nBlocos, palavras);      // usados antes de definidos
+    Palavra** definidos = novosConjuntos(f->nBlocos, palavras);
+
+    for (int b = 0; b < f->nBlocos; b++) {
+        BlocoIr* bloco = f->blocos[b];
+        for (InstrIr* i = bloco->primeira; i; i = i->prox) {
+            if (i->op != IR_PHI) {
+                for (int a = 0; a < i->nArgs; a++) {
+                    int v = i->args[a]->id;
+                    if (lugar[v] && !temBit(definidos[b], v)) marcarBit(usados[b], v);
+                }
+            }
+            if (lugar[i->id]) marcarBit(definidos[b], i->id);
+        }
+
+        BlocoIr* succ[2];
+        int ns = sucessoresIr(bloco, succ);
+        for (int s = 0; s < ns; s++) {
+            int p = indicePredIr(succ[s], bloco);
+            for (InstrIr* phi = succ[s]->primeira; phi && phi->op == IR_PHI; phi = phi->prox) {
+                int v = phi->args[p]->id;
+                if (lugar[v] && !temBit(definidos[b], v)) marcarBit(usados[b], v);
+            }
+        }
+    }
+
+    bool mudou = true;
+    while (mudou) {
+        mudou = false;
+        for (int b = f->nBlocos - 1; b >= 0; b--) {
+            BlocoIr* succ[2];
+            int ns = sucessoresIr(f->blocos[b], succ);
+            for (int s = 0; s < ns; s++) unir(q->vivoSaida[b], q->vivoEntrada[succ[s]->id], palavras);
+
+            for (int w = 0; w < palavras; w++) {
+                Palavra novo = usados[b][w] | (q->vivoSaida[b][w] & ~definidos[b][w]);
+                mudou |= novo != q->vivoEntrada[b][w];
+                q->vivoEntrada[b][w] = novo;
+            }
+        }
+    }
+
+    liberarConjuntos(usados, f->nBlocos);
+    liberarConjuntos(definidos, f->nBlocos);
+}
+
+// ===================
+// Slots
+// ===================
+
+// Slot de cada endereço (LOCAL, e ELEM/PHI sobre ele) e os slots que ficam
+// vivos na função inteira
+static void rastrearEnderecos(Quadro* q) {
+    const FuncaoIr* f = q->f;
+    for (int v = 0; v < q->nValores; v++) q->origem[v] = -1;
+
+    bool mudou = true;
+    while (mudou) {
+        mudou = false;
+        for (int b = 0; b < f->nBlocos; b++) {
+            for (InstrIr* i = f->blocos[b]->primeira; i; i = i->prox) {
+                if (i->op != IR_LOCAL && i->op != IR_ELEM && i->op != IR_PHI) continue;
+
+                // Cada endereço recebe um slot só uma vez; um phi que junta
+                // slots diferentes deixa todos eles fixos
+                int atual = q->origem[i->id];
+                if (i->op == IR_LOCAL) {
+                    if (atual < 0) {
+                        q->origem[i->id] = i->indice;
+                        mudou = true;
+                    }
+                    continue;
+                }
+
+                int nFontes = i->op == IR_ELEM ? 1 : i->nArgs;
+                for (int a = 0; a < nFontes; a++) {
+                    int o = q->origem[i->args[a]->id];
+                    if (o < 0 || o == atual) continue;
+                    if (atual < 0) {
+                        q->origem[i->id] = atual = o;
+                        mudou = true;
+                    } else {
+                        q->objetos[objetoSlot(q, o)].fixo = true;
+                        q->objetos[objetoSlot(q, atual)].fixo = true;
+                    }
+                }
+            }
+        }
+    }
+
+    // Endereço gravado na memória: não dá para saber quem o usa depois
+    for (int b = 0; b < f->nBlocos; b++) {
+        for (InstrIr* i = f->blocos[b]->primeira; i; i = i->prox) {
+            if (i->op != IR_STORE) continue;
+            int o = q->origem[i->args[1]->id];
+            if (o >= 0) q->objetos[objetoSlot(q, o)].fixo = true;
+        }
+    }
+}
+
+// Slot que a instrução lê ou grava pelo operando a (-1: nenhum). ELEM e
+// PHI só calculam endereços
+static int slotAcessado(const Quadro* q, const InstrIr* i, int a) {
+    if (i->op == IR_ELEM || i->op == IR_PHI) return -1;
+    return q->origem[i->args[a]->id];
+}
+
+// Acessados até o início e a partir do fim de cada bloco
+static void analisarSlots(Quadro* q) {
+    const FuncaoIr* f = q->f;
+    int palavras = q->palavrasSlots;
+    Palavra** acessados = novosConjuntos(f->nBlocos, palavras);
+
+    for (int b = 0; b < f->nBlocos; b++) {
+        for (InstrIr* i = f->blocos[b]->primeira; i; i = i->prox) {
+            for (int a = 0; a < i->nArgs; a++) {
+                int s = slotAcessado(q, i, a);
+                if (s >= 0) marcarBit(acessados[b], s);
+            }
+        }
+    }
+
+    Palavra* aux = malloc((palavras > 0 ? palavras : 1) * sizeof(Palavra));
+    bool mudou = true;
+    while (mudou) {
+        mudou = false;
+        for (int b = 0; b < f->nBlocos; b++) {
+            BlocoIr* bloco = f->blocos[b];
+            for (int p = 0; p < bloco->nPreds; p++) {
+                int pred = bloco->preds[p]->id;
+                memcpy(aux, q->acessoAntes[pred], palavras * sizeof(Palavra));
+                unir(aux, acessados[pred], palavras);
+                mudou |= unir(q->acessoAntes[b], aux, palavras);
+            }
+        }
+        for (int b = f->nBlocos - 1; b >= 0; b--) {
+            BlocoIr* succ[2];
+            int ns = sucessoresIr(f->blocos[b], succ);
+            for (int s = 0; s < ns; s++) {
+                int id = succ[s]->id;
+                memcpy(aux, q->acessoDepois[id], palavras * sizeof(Palavra));
+                unir(aux, acessados[id], palavras);
+                mudou |= unir(q->acessoDepois[b], aux, palavras);
+            }
+        }
+    }
+
+    free(aux);
+    liberarConjuntos(acessados, f->nBlocos);
+}
+
+// ===================
+// Interferência
+// ===================
+
+typedef struct {
+    Trecho* itens;
+    int n;
+    int cap;
+} Trechos;
+
+static void adicionarTrecho(Trechos* t, int objeto, int de, int ate) {
+    if (t->n == t->cap) {
+        t->cap = t->cap ? t->cap * 2 : 64;
+        t->itens = realloc(t->itens, t->cap * sizeof(Trecho));
+    }
+    t->itens[t->n++] = (Trecho){ objeto, de, ate };
+}
+
+static int compararTrechos(const void* a, const void* b) {
+    const Trecho* x = a;
+    const Trecho* y = b;
+    if (x->de != y->de) return x->de - y->de;
+    return x->objeto - y->objeto;
+}
+
+// Trechos vivos do bloco b; 'ultimo' e 'primeiro' são áreas de trabalho (um por objeto)
+static void trechosDoBloco(Quadro* q, const bool* lugar, int b, Trechos* t, int* ultimo, int* primeiro) {
+    const FuncaoIr* f = q->f;
+    BlocoIr* bloco = f->blocos[b];
+    int n = tamanhoBloco(bloco);
+    t->n = 0;
+
+    // Último uso de cada valor e primeiro/último acesso de cada slot
+    int k = 0;
+    for (InstrIr* i = bloco->primeira; i; i = i->prox, k++) {
+        for (int a = 0; a < i->nArgs; a++) {
+            if (i->op != IR_PHI) ultimo[i->args[a]->id] = k;
+            int s = slotAcessado(q, i, a);
+            if (s >= 0) {
+                int o = objetoSlot(q, s);
+                if (primeiro[o] < 0) primeiro[o] = k;
+                ultimo[o] = k;
+            }
+        }
+    }
+
+    BlocoIr* succ[2];
+    int ns = sucessoresIr(bloco, succ);
+    for (int s = 0; s < ns; s++) {
+        int p = indicePredIr(succ[s], bloco);
+        for (InstrIr* phi = succ[s]->primeira; phi && phi->op == IR_PHI; phi = phi->prox) {
+            ultimo[phi->args[p]->id] = n - 1;
+            adicionarTrecho(t, objetoEntrada(q, phi->id), n - 1, n);
+        }
+    }
+
+    // Valores definidos aqui
+    k = 0;
+    for (InstrIr* i = bloco->primeira; i; i = i->prox, k++) {
+        if (i->op == IR_PHI) adicionarTrecho(t, objetoEntrada(q, i->id), 0, 0);
+        if (!lugar[i->id]) continue;
+
+        int de = posicaoDefinicao(i, k);
+        int ate = temBit(q->vivoSaida[b], i->id) ? n : (ultimo[i->id] >= de ? ultimo[i->id] : de);
+        adicionarTrecho(t, i->id, de, ate);
+        ultimo[i->id] = -1;
+    }
+
+    // Valores que chegam vivos
+    for (int w = 0; w < q->palavrasValores; w++) {
+        for (Palavra m = q->vivoEntrada[b][w]; m; m &= m - 1) {
+            int v = w * 64 + __builtin_ctzll(m);
+            int ate = temBit(q->vivoSaida[b], v) ? n : (ultimo[v] >= 0 ? ultimo[v] : 0);
+            adicionarTrecho(t, v, 0, ate);
+        }
+    }
+
+    // Slots
+    for (int s = 0; s < f->nSlots; s++) {
+        int o = objetoSlot(q, s);
+        bool antes = temBit(q->acessoAntes[b], s);
+        bool depois = temBit(q->acessoDepois[b], s);
+        if (primeiro[o] >= 0) {
+            adicionarTrecho(t, o, antes ? 0 : primeiro[o], depois ? n : ultimo[o]);
+        } else if (antes && depois) {
+            adicionarTrecho(t, o, 0, n);
+        }
+        primeiro[o] = ultimo[o] = -1;
+    }
+
+    for (int v = 0; v < q->nValores; v++) ultimo[v] = -1;
+}
+
+// Objetos com trechos que se tocam no mesmo bloco são vizinhos
+static void calcularInterferencia(Quadro* q, const bool* lugar) {
+    int* ultimo = malloc(q->nObjetos * sizeof(int));
+    int* primeiro = malloc(q->nObjetos * sizeof(int));
+    for (int o = 0; o < q->nObjetos; o++) ultimo[o] = primeiro[o] = -1;
+    Trechos t = { NULL, 0, 0 };
+
+    for (int b = 0; b < q->f->nBlocos; b++) {
+        trechosDoBloco(q, lugar, b, &t, ultimo, primeiro);
+        qsort(t.itens, t.n, sizeof(Trecho), compararTrechos);
+
+        for (int x = 0; x < t.n; x++) {
+            for (int y = x + 1; y < t.n && t.itens[y].de <= t.itens[x].ate; y++) {
+                int a = t.itens[x].objeto, c = t.itens[y].objeto;
+                if (a == c) continue;
+                adicionarVizinho(&q->objetos[a], c);
+                adicionarVizinho(&q->objetos[c], a);
+            }
+        }
+    }
+
+    free(t.itens);
+    free(ultimo);
+    free(primeiro);
+}
+
+// ===================
+// Distribuição
+// ===================
+
+// Ordem de colocação: fixos, maiores, mais alinhados
+typedef struct {
+    int objeto;
+    bool fixo;
+    int tamanho;
+    int alinhamento;
+} Chave;
+
+static int compararChaves(const void* a, const void* b) {
+    const Chave* x = a;
+    const Chave* y = b;
+    if (x->fixo != y->fixo) return x->fixo ? -1 : 1;
+    if (x->tamanho != y->tamanho) return y->tamanho - x->tamanho;
+    if (x->alinhamento != y->alinhamento) return y->alinhamento - x->alinhamento;
+    return x->objeto - y->objeto;
+}
+
+static int alinharFim(int valor, int alinhamento) {
+    return (valor + alinhamento - 1) / alinhamento * alinhamento;
+}
+
+static bool sobrepoe(const Objeto* a, int fimA, const Objeto* b) {
+    return fimA - a->tamanho < b->fim && b->fim - b->tamanho < fimA;
+}
+
+// Menor fim alinhado em que 'o' não se sobrepõe a nenhum vizinho já colocado
+// nem a um objeto fixo
+static int colocar(const Quadro* q, const Objeto* o, const int* fixos, int nFixos) {
+    int fim = alinharFim(o->tamanho, o->alinhamento);
+    bool livre = false;
+
+    while (!livre) {
+        livre = true;
+        for (int k = 0; k < o->nVizinhos + nFixos; k++) {
+            int v = k < o->nVizinhos ? o->vizinhos[k] : fixos[k - o->nVizinhos];
+            const Objeto* viz = &q->objetos[v];
+            if (viz == o || viz->fim == 0 || !sobrepoe(o, fim, viz)) continue;
+            fim = alinharFim(viz->fim + o->tamanho, o->alinhamento);
+            livre = false;
+        }
+    }
+    return fim;
+}
+
+static void preparar(Quadro* q, const bool* lugar) {
+    const FuncaoIr* f = q->f;
+    q->nValores = f->nValores;
+    q->nObjetos = 2 * f->nValores + f->nSlots;
+    q->objetos = calloc(q->nObjetos > 0 ? q->nObjetos : 1, sizeof(Objeto));
+
+    for (int b = 0; b < f->nBlocos; b++) {
+        for (InstrIr* i = f->blocos[b]->primeira; i; i = i->prox) {
+            if (!lugar[i->id]) continue;
+
+            // Vetores ocupam 16 bytes alinhados (%rbp é múltiplo de 16)
+            int bytes = ehVetorIr(i->tipo) ? 16 : 8;
+            q->objetos[i->id] = (Objeto){ .tamanho = bytes, .alinhamento = bytes, .presente = true };
+            if (i->op == IR_PHI) q->objetos[objetoEntrada(q, i->id)] = q->objetos[i->id];
+
+            // Os parâmetros são guardados na entrada da função, antes do bloco 0
+            if (i->op == IR_PARAM && b != 0) q->objetos[i->id].fixo = true;
+        }
+    }
+    for (int s = 0; s < f->nSlots; s++) {
+        Objeto* o = &q->objetos[objetoSlot(q, s)];
+        o->tamanho = f->slots[s].tamanho > 0 ? f->slots[s].tamanho : 1;
+        o->alinhamento = f->slots[s].alinhamento > 0 ? f->slots[s].alinhamento : 1;
+        o->presente = true;
+    }
+
+    q->palavrasValores = (q->nValores + 63) / 64;
+    q->palavrasSlots = (f->nSlots + 63) / 64;
+    q->vivoEntrada = novosConjuntos(f->nBlocos, q->palavrasValores);
+    q->vivoSaida = novosConjuntos(f->nBlocos, q->palavrasValores);
+    q->acessoAntes = novosConjuntos(f->nBlocos, q->palavrasSlots);
+    q->acessoDepois = novosConjuntos(f->nBlocos, q->palavrasSlots);
+    q->origem = malloc((q->nValores > 0 ? q->nValores : 1) * sizeof(int));
+}
+
+static void liberarQuadro(Quadro* q) {
+    for (int o = 0; o < q->nObjetos; o++) free(q->objetos[o].vizinhos);
+    free(q->objetos);
+    liberarConjuntos(q->vivoEntrada, q->f->nBlocos);
+    liberarConjuntos(q->vivoSaida, q->f->nBlocos);
+    liberarConjuntos(q->acessoAntes, q->f->nBlocos);
+    liberarConjuntos(q->acessoDepois, q->f->nBlocos);
+    free(q->origem);
+}
+
+int montarQuadroIr(const FuncaoIr* f, const bool* lugar, int* offsetSlot, int* offsetValor, int* offsetEntrada) {
+    Quadro q = { .f = f };
+    preparar(&q, lugar);
+    rastrearEnderecos(&q);
+    analisarValores(&q, lugar);
+    analisarSlots(&q);
+    calcularInterferencia(&q, lugar);
+
+    Chave* ordem = malloc((q.nObjetos > 0 ? q.nObjetos : 1) * sizeof(Chave));
+    int* fixos = malloc((q.nObjetos > 0 ? q.nObjetos : 1) * sizeof(int));
+    int nOrdem = 0, nFixos = 0;
+    for (int o = 0; o < q.nObjetos; o++) {
+        const Objeto* obj = &q.objetos[o];
+        if (obj->presente) ordem[nOrdem++] = (Chave){ o, obj->fixo, obj->tamanho, obj->alinhamento };
+    }
+    qsort(ordem, nOrdem, sizeof(Chave), compararChaves);
+
+    // Os fixos vêm primeiro e todo objeto depois deles os evita
+    int tam = 0;
+    for (int k = 0; k < nOrdem; k++) {
+        Objeto* o = &q.objetos[ordem[k].objeto];
+        o->fim = colocar(&q, o, fixos, nFixos);
+        if (o->fixo) fixos[nFixos++] = ordem[k].objeto;
+        if (o->fim > tam) tam = o->fim;
+    }
+
+    for (int v = 0; v < f->nValores; v++) {
+        offsetValor[v] = -q.objetos[v].fim;
+        offsetEntrada[v] = -q.objetos[objetoEntrada(&q, v)].fim;
+    }
+    for (int s = 0; s < f->nSlots; s++) offsetSlot[s] = -q.objetos[objetoSlot(&q, s)].fim;
+
+    free(ordem);
+    free(fixos);
+    liberarQuadro(&q);
+    return tam;
+}
@@ -1,24 +1,48 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdarg.h>
+#include <setjmp.h>
 
 #include "semantic.h"
 #include "symbols.h"
-#include "lexer.h" 
-#include "parser.h"
-
-static const char* nomeFuncaoAtual = NULL;
-
-static bool encontrouReturnComValor = false;
-
-// Armazena o tipo da variável no lado esquerdo da atribuição 
-static const char* tipoAtribuido = NULL;
-
-// Armazena o tipo da expressão do lado direito da atribuição 
-static const char* tipoExpressao = NULL;
-
-// Escopo atual de análise (global ou local)
-extern Escopo escopoAtual;
+#include "lexer.h"
+#include "threadpool.h"
+#include "xref.h"
+#include "ir.h"
+
+// Ocorrência de símbolo guardada até a reprodução em ordem no índice de referências
+typedef struct {
+    int simbolo;
+    long offset;
+    TipoRefXref tipo;
+} RefPendente;
+
+// Estado da análise de uma declaração de nível superior
+typedef struct {
+    NoAst* decl;             // nó da declaração (variável global ou função)
+    int indice;              // posição da declaração no programa
+    int simboloFuncao;       // índice da função na tabela (-1 para variáveis)
+    int inicioLocais;        // parâmetros e locais ocupam [inicioLocais, fimLocais)
+    int fimLocais;
+    bool encontrouReturnComValor;
+    int profundidadeQuebra;  // laços e switches abertos (onde 'break' é válido)
+
+    // Diagnósticos acumulados (impressos em ordem ao final)
+    char* mensagens;
+    size_t tamMensagens;
+    size_t capMensagens;
+    bool houveErro;          // algum erro (mesmo não fatal) nesta declaração
+    bool fatal;
+
+    RefPendente* refs;
+    int nRefs;
+    int capRefs;
+
+    jmp_buf salto;           // retorno ao primeiro erro fatal da declaração
+} ContextoSemantico;
+
+static ContextoSemantico* contextos = NULL;
 
 // ==============================================
 // INTERFACE DO ANALISADOR SEMÂNTICO - C.SHORT
@@ -34,380 +58,874 @@ void erroSemantico(const char* msg, const char* nome) {
     exit(1);
 }
 
-// Finaliza a análise semântica com mensagem de sucesso (placeholder)
-void verificarSemantica() {
-    printf("[OK] Análise semântica concluída com sucesso.\n");
+// Acrescenta texto formatado aos diagnósticos da declaração
+static void anotar(ContextoSemantico* ctx, const char* formato, ...) {
+    va_list args;
+    va_start(args, formato);
+    va_list copia;
+    va_copy(copia, args);
+    int n = vsnprintf(NULL, 0, formato, copia);
+    va_end(copia);
+
+    if (n > 0) {
+        if (ctx->tamMensagens + n + 1 > ctx->capMensagens) {
+            size_t novaCap = ctx->capMensagens ? ctx->capMensagens * 2 : 256;
+            while (novaCap < ctx->tamMensagens + n + 1) novaCap *= 2;
+            ctx->mensagens = realloc(ctx->mensagens, novaCap);
+            ctx->capMensagens = novaCap;
+        }
+        vsnprintf(ctx->mensagens + ctx->tamMensagens, n + 1, formato, args);
+        ctx->tamMensagens += n;
+    }
+
+    va_end(args);
+}
+
+// Erro que não interrompe a análise (a expressão passa a ter tipo 'erro')
+static void erroNaoFatal(ContextoSemantico* ctx, const char* msg) {
+    anotar(ctx, "[ERRO SEMÂNTICO] %s\n", msg);
+    ctx->houveErro = true;
+}
+
+// Erro que encerra a análise da declaração (e a compilação, na ordem do fonte)
+static void erroFatal(ContextoSemantico* ctx, const char* msg, const char* nome) {
+    anotar(ctx, "[ERRO SEMÂNTICO] %s: %s\n", nome, msg);
+    ctx->houveErro = true;
+    ctx->fatal = true;
+    longjmp(ctx->salto, 1);
+}
+
+// Guarda uma ocorrência (contada nos usos do símbolo e, se ativo, levada ao índice de referências)
+static void registrarRef(ContextoSemantico* ctx, int simbolo, long offset, TipoRefXref tipo) {
+    if (ctx->nRefs == ctx->capRefs) {
+        ctx->capRefs = ctx->capRefs ? ctx->capRefs * 2 : 64;
+        ctx->refs = realloc(ctx->refs, ctx->capRefs * sizeof(RefPendente));
+    }
+
+    ctx->refs[ctx->nRefs].simbolo = simbolo;
+    ctx->refs[ctx->nRefs].offset = offset;
+    ctx->refs[ctx->nRefs].tipo = tipo;
+    ctx->nRefs++;
+}
+
+// Verifica se o tipo de uma variável ou função está corretamente definido
+static void garantirTipoDefinido(ContextoSemantico* ctx, TipoId tipo, const char* nome) {
+    if (tipo == TIPO_NENHUM || tipo == TIPO_INDEFINIDO) {
+        erroFatal(ctx, "Tipo da variável ou função não foi definido corretamente", nome);
+    }
+}
+
+// Tipo efetivo de uma declaração (vetores usam o tipo vetor correspondente)
+static TipoId tipoDeclarado(const NoAst* no) {
+    return no->ehVetor ? tipoVetorDe(no->tipoDecl) : no->tipoDecl;
 }
 
 // ----------------------------------------------
-// 1. Declaração e uso de variáveis
+// Fase 1 - Declarações (sequencial)
 // ----------------------------------------------
 
-// Verifica se uma variável (ou vetor) foi previamente declarada
-void verificarVariavelDeclarada(const char* nome) {
-    Simbolo* s = buscarSimboloEmEscopos(nome); // <- agora passando escopo
-    if (s == NULL) {
-        erroSemantico("Variável não declarada", nome);
+// Verifica se identificador global já foi declarado (protótipos podem ser completados)
+static void verificarRedeclaracao(ContextoSemantico* ctx, const char* nome) {
+    int idx = buscarIndiceGlobal(nome);
+    if (idx < 0) return;
+
+    Simbolo* existente = &getTabela()[idx];
+
+    // Permite função que ainda não foi definida (ou seja, é um protótipo)
+    if (existente->classe == CLASSE_FUNCAO && !existente->foiDefinida) {
+        return;
     }
+
+    // Caso contrário, é erro
+    erroFatal(ctx, "Identificador já declarado no mesmo escopo", nome);
 }
 
-// Verifica se identificador já foi declarado no mesmo escopo
-void verificarRedeclaracao(const char* nome) {
-    Simbolo* existente = buscarSimbolo(nome, escopoAtual);
+// Strings são valores compactos no runtime; não há vetores de string
+static void verificarVetorDeString(ContextoSemantico* ctx, const NoAst* no) {
+    if (no->ehVetor && no->tipoDecl == TIPO_STRING) {
+        erroFatal(ctx, "Vetores de string não são suportados", no->nome);
+    }
+}
 
-    if (existente != NULL) {
-        // Se for função:
-        if (existente->classe == CLASSE_FUNCAO) {
-            // Permite se ainda não foi definida (ou seja, é um protótipo)
-            if (!existente->foiDefinida) {
-                return;  // ok, vai ser marcada como definida depois
+// Expressão constante com a aritmética int do código gerado (calcularOperacaoIr)
+static bool avaliarConstante(const NoAst* no, int32_t* valor) {
+    ValorIr args[2], r;
+    OpIr op;
+
+    switch (no->tipo) {
+        case NO_CONST_INT:
+            *valor = no->valor.intVal;
+            return true;
+        case NO_CONST_CHAR:
+            *valor = no->valor.charVal;
+            return true;
+        case NO_UNARIO:
+            if (no->op != TOKEN_PLUS && no->op != TOKEN_MINUS) return false;
+            if (!avaliarConstante(no->filhos[0], &args[0].i)) return false;
+            if (no->op == TOKEN_PLUS) {
+                *valor = args[0].i;
+                return true;
             }
-        }
+            op = IR_NEG;
+            break;
+        case NO_BINARIO:
+            switch (no->op) {
+                case TOKEN_PLUS:  op = IR_ADD; break;
+                case TOKEN_MINUS: op = IR_SUB; break;
+                case TOKEN_MUL:   op = IR_MUL; break;
+                case TOKEN_DIV:   op = IR_DIV; break;
+                default:          return false;
+            }
+            if (!avaliarConstante(no->filhos[0], &args[0].i) || !avaliarConstante(no->filhos[1], &args[1].i)) return false;
+            break;
+        default:
+            return false;
+    }
 
-        // Caso contrário, é erro
-        erroSemantico("Identificador já declarado no mesmo escopo", nome);
+    if (!calcularOperacaoIr(op, COND_EQ, IR_I32, IR_I32, args, &r)) return false;
+    *valor = r.i;
+    return true;
+}
+
+// Tamanho de vetor dado por expressão: precisa ser constante e positivo
+static void calcularTamanho(ContextoSemantico* ctx, NoAst* no) {
+    if (!no->filhos[0]) return;
+
+    int32_t valor;
+    if (!avaliarConstante(no->filhos[0], &valor)) {
+        erroFatal(ctx, "Tamanho de vetor não é expressão inteira constante", no->nome);
+    }
+    if (valor <= 0) {
+        erroFatal(ctx, "Tamanho de vetor precisa ser positivo", no->nome);
     }
+
+    no->tamanho = valor;
+    liberarAst(no->filhos[0]);
+    no->filhos[0] = NULL;
 }
 
-// Inicia verificação de atribuição (armazenando o tipo da variável à esquerda)
-void iniciarAtribuicao(const char* nome) {
-    Simbolo* s = buscarSimboloEmEscopos(nome);
-    if (s == NULL) {
-        erroSemantico("Identificador não declarado antes da atribuição", nome);
+// Registra as funções embutidas de string, visíveis em todo o programa
+static void registrarEmbutidas(void) {
+    static const struct {
+        const char* nome;
+        const char* retorno;
+        int nParams;
+    } embutidas[] = {
+        { "strlen", "int",    1 },   // tamanho
+        { "strcmp", "int",    2 },   // comparação: -1, 0 ou 1
+        { "strcat", "string", 2 },   // concatenação
+    };
+    char tiposParams[MAX_PARAM][10] = { "string", "string" };
+
+    for (size_t i = 0; i < sizeof(embutidas) / sizeof(embutidas[0]); i++) {
+        registrarFuncao(embutidas[i].retorno, embutidas[i].nome, embutidas[i].nParams, tiposParams);
+
+        Simbolo* s = &getTabela()[getNumSimbolos() - 1];
+        s->foiDefinida = true;
+        s->embutida = true;
+        s->declaracao = -1;
     }
+}
 
-    if (s->classe == CLASSE_FUNCAO) {
-        erroSemantico("Função usada como variável na atribuição", nome);
+// Registra uma variável global
+static void declararVariavelGlobal(ContextoSemantico* ctx, NoAst* no) {
+    verificarVetorDeString(ctx, no);
+    calcularTamanho(ctx, no);
+
+    // Um protótipo pendente também ocupa o nome
+    if (buscarIndiceGlobal(no->nome) >= 0) {
+        erroFatal(ctx, "Identificador já declarado no mesmo escopo", no->nome);
     }
 
-    garantirTipoDefinido(s->tipo, s->nome);
+    registrarVariavelGlobal(nomeTipo(no->tipoDecl), no->nome, no->ehVetor, no->tamanho);
 
-    tipoAtribuido = s->tipo;
-    tipoExpressao = NULL; 
+    no->simbolo = getNumSimbolos() - 1;
+    getTabela()[no->simbolo].declaracao = ctx->indice;
+    registrarRef(ctx, no->simbolo, no->offset, XREF_DECLARACAO);
 }
 
-// Registra o tipo da expressão analisada (lado direito da atribuição)
-void registrarTipoExpressao(const char* tipo) {
-    tipoExpressao = tipo;
-}
+// Verifica se assinatura da declaração bate com o protótipo anterior
+static void verificarAssinaturaCompativel(ContextoSemantico* ctx, const NoAst* func, int nParams,
+                                          char tiposParams[][10], const ModoParam* modos) {
+    int idx = buscarIndiceGlobal(func->nome);
+    if (idx < 0) return;
 
-// Verifica se tipos na atribuição (esquerda e direita) são compatíveis
-void verificarTipoExpr() {
-    if (tipoAtribuido == NULL || tipoExpressao == NULL) return;
+    Simbolo* s = &getTabela()[idx];
+    if (s->classe != CLASSE_FUNCAO) return;
 
-    if (!tiposSaoCompatíveis(tipoAtribuido, tipoExpressao)) {
-        char msg[128];
-        snprintf(msg, sizeof(msg),
-            "Tipo incompatível na atribuição: esperado '%s', mas recebeu '%s'",
-            tipoAtribuido, tipoExpressao);
-        erroSemantico(msg, "");
+    if (s->tipoId != func->tipoDecl) {
+        erroFatal(ctx, "Tipo de retorno da definição não bate com o protótipo", func->nome);
     }
-}
 
-// Registra tipo de constante literal (int, float, char, bool)
-void registrarTipoConstante(Token token) {
-    switch (token.type) {
-        case TOKEN_INTCON:
-            registrarTipoExpressao("int");
-            break;
-        case TOKEN_REALCON:
-            registrarTipoExpressao("float");
-            break;
-        case TOKEN_CHARCON:
-        case TOKEN_CHARCON_0:
-        case TOKEN_CHARCON_N:
-            registrarTipoExpressao("char");
-            break;
-        case TOKEN_BOOLCON:
-            registrarTipoExpressao("bool");
-            break;
-        case TOKEN_STRINGCON:
-            registrarTipoExpressao("char[]");
-            break;
-        default:
-            break;
+    if (s->nParams != nParams) {
+        erroFatal(ctx, "Número de parâmetros da definição não bate com o protótipo", func->nome);
     }
-}
 
-// Analisa token atual e registra tipo, se aplicável (constantes ou identificadores)
-void analisarTokenAtual(Token token) {
-    // Constante literal? Registra o tipo normalmente
-    registrarTipoConstante(token);
+    for (int i = 0; i < nParams; i++) {
+        if (strcmp(s->tiposParams[i], tiposParams[i]) != 0) {
+            erroFatal(ctx, "Tipo de parâmetro incompatível com o protótipo", func->nome);
+        }
+        if (s->modosParams[i] != modos[i]) {
+            erroFatal(ctx, "Forma de passagem de parâmetro incompatível com o protótipo", func->nome);
+        }
+    }
+}
 
-    // Identificador? Pode ser variável OU função chamada numa expressão
-    if (token.type == TOKEN_ID) {
-        Simbolo* s = buscarSimboloEmEscopos(token.lexeme);
+// Registra parâmetros e variáveis locais de uma definição de função
+static void declararLocais(ContextoSemantico* ctx, NoAst* func) {
+    Simbolo* tabela;
+    int pos = 0;
 
-        if (s == NULL) {
-            erroSemantico("Identificador usado mas não declarado", token.lexeme);
-        }
+    ctx->inicioLocais = getNumSimbolos();
 
-        garantirTipoDefinido(s->tipo, s->nome);
+    for (NoAst* p = func->filhos[0]; p; p = p->prox, pos++) {
+        const char* tipo = nomeTipo(p->tipoDecl);
+        verificarVetorDeString(ctx, p);
+        ModoParam modo;
 
-        // Se for vetor (tipo termina com "[]"), registrar tipo base
-        if (strstr(s->tipo, "[]") != NULL) {
-            char tipoBase[10];
-            strncpy(tipoBase, s->tipo, strlen(s->tipo) - 2);
-            tipoBase[strlen(s->tipo) - 2] = '\0';
-            registrarTipoExpressao(tipoBase);
+        if (p->ehVetor) {
+            registrarParametro(tipo, p->nome, CLASSE_VETOR, ESC_LOCAL, 0);
+            modo = PARAM_VETOR;
+        } else if (p->porReferencia) {
+            registrarParametro(tipo, p->nome, CLASSE_PARAM, ESC_LOCAL, 0);
+            modo = PARAM_REFERENCIA;
         } else {
-            registrarTipoExpressao(s->tipo);
+            registrarParametro(tipo, p->nome, CLASSE_PARAM, ESC_LOCAL, 1);
+            modo = PARAM_VALOR;
         }
+        definirModoParametro(p->nome, pos, modo);
+
+        p->simbolo = getNumSimbolos() - 1;
+        tabela = getTabela();
+        tabela[p->simbolo].declaracao = ctx->indice;
+        registrarRef(ctx, p->simbolo, p->offset, XREF_DECLARACAO);
     }
-}
 
-// ----------------------------------------------
-// 2. Funções - declarações e uso
-// ----------------------------------------------
+    for (NoAst* v = func->filhos[1]; v; v = v->prox) {
+        verificarVetorDeString(ctx, v);
+        calcularTamanho(ctx, v);
+        tabela = getTabela();
+        for (int i = ctx->inicioLocais; i < getNumSimbolos(); i++) {
+            if (strcmp(tabela[i].nome, v->nome) == 0) {
+                erroFatal(ctx, "Identificador já declarado no mesmo escopo", v->nome);
+            }
+        }
 
-// Verifica se identificador chamado é uma função válida
-void registrarChamadaDeFuncao(const char* nome) {
-    Simbolo* s = buscarSimboloEmEscopos(nome);
-    if (s == NULL) {
-        erroSemantico("Função chamada mas não declarada", nome);
-    }
-    if (s->classe != CLASSE_FUNCAO) {
-        erroSemantico("Identificador chamado como função, mas não é uma função", nome);
+        registrarVariavelLocal(nomeTipo(v->tipoDecl), v->nome, v->ehVetor, v->tamanho);
+
+        v->simbolo = getNumSimbolos() - 1;
+        getTabela()[v->simbolo].declaracao = ctx->indice;
+        registrarRef(ctx, v->simbolo, v->offset, XREF_DECLARACAO);
     }
 
-    garantirTipoDefinido(s->tipo, s->nome);
+    ctx->fimLocais = getNumSimbolos();
 
-    registrarTipoExpressao(s->tipo); // permite verificar o tipo de retorno em atribuições
+    // O corpo só é verificado na fase 2, pelo intervalo [inicioLocais, fimLocais)
+    limparEscopo(ESC_LOCAL);
 }
 
-// Verifica se definição de função está correta e marca como "definida"
-void verificarDefinicaoDeFuncao(const char* nome) {
-    Simbolo* s = buscarSimbolo(nome, ESC_GLOBAL);
-
-    if (s != NULL) {
-        if (s->classe != CLASSE_FUNCAO) {
-            erroSemantico("Identificador já declarado como não função", nome);
+// Registra uma função (protótipo ou definição) e valida sua assinatura
+static void declararFuncao(ContextoSemantico* ctx, NoAst* func) {
+    char tiposParams[MAX_PARAM][10];
+    ModoParam modos[MAX_PARAM];
+    int nParams = 0;
+
+    // Verifica se há parâmetro repetido na lista de parâmetros formais
+    for (NoAst* p = func->filhos[0]; p; p = p->prox) {
+        for (NoAst* q = func->filhos[0]; q != p; q = q->prox) {
+            if (strcmp(p->nome, q->nome) == 0) {
+                erroFatal(ctx, "Parâmetro repetido na lista de parâmetros formais", p->nome);
+            }
         }
-        if (s->foiDefinida) {
-            erroSemantico("Função já foi definida anteriormente", nome);
+
+        if (nParams == MAX_PARAM) {
+            erroFatal(ctx, "Número excessivo de parâmetros na função", func->nome);
         }
 
-        // Protótipo já existia, marca como definida agora
-        s->foiDefinida = true;
+        strncpy(tiposParams[nParams], nomeTipo(tipoDeclarado(p)), sizeof(tiposParams[nParams]) - 1);
+        tiposParams[nParams][sizeof(tiposParams[nParams]) - 1] = '\0';
+        modos[nParams] = p->ehVetor ? PARAM_VETOR : (p->porReferencia ? PARAM_REFERENCIA : PARAM_VALOR);
+        nParams++;
+    }
+
+    verificarAssinaturaCompativel(ctx, func, nParams, tiposParams, modos);
+    verificarRedeclaracao(ctx, func->nome);
+
+    bool nova = buscarIndiceGlobal(func->nome) < 0;
+    registrarFuncao(nomeTipo(func->tipoDecl), func->nome, nParams, tiposParams);
+
+    func->simbolo = buscarIndiceGlobal(func->nome);
+    ctx->simboloFuncao = func->simbolo;
+
+    Simbolo* s = &getTabela()[func->simbolo];
+    if (nova) s->declaracao = ctx->indice;
+    memcpy(s->modosParams, modos, nParams * sizeof(ModoParam));
+    registrarRef(ctx, func->simbolo, func->offset, XREF_DECLARACAO);
+
+    if (!func->temCorpo) {
+        // Verifica se função sem parâmetros declarou `void` explicitamente
+        if (nParams == 0 && !func->paramsVoid) {
+            erroFatal(ctx, "Função sem parâmetros deve declarar void explicitamente", func->nome);
+        }
         return;
     }
 
-    // Se não existia antes, é uma definição nova
-    int ok = inserirSimbolo(nome, "tipo", CLASSE_FUNCAO, ESC_GLOBAL, 0);
-    if (!ok) {
-        erroSemantico("Erro ao definir função", nome);
+    // Verifica se a função já foi definida antes e marca como definida
+    if (s->foiDefinida) {
+        erroFatal(ctx, "Função já foi definida anteriormente", func->nome);
     }
+    s->foiDefinida = true;
+
+    declararLocais(ctx, func);
+}
+
+// ----------------------------------------------
+// Fase 2 - Corpos das funções (paralela)
+// ----------------------------------------------
 
-    // Marcar como definida o último símbolo real da tabela
+// Resolve um nome visível na função: locais e parâmetros primeiro, depois globais
+// declarados até esta declaração (preserva a visibilidade da passada única)
+static int resolverNome(const ContextoSemantico* ctx, const char* nome) {
     Simbolo* tabela = getTabela();
-    int n = getNumSimbolos();
-    tabela[n - 1].foiDefinida = true;
+
+    for (int i = ctx->fimLocais - 1; i >= ctx->inicioLocais; i--) {
+        if (strcmp(tabela[i].nome, nome) == 0) return i;
+    }
+
+    int g = buscarIndiceGlobal(nome);
+    if (g >= 0 && tabela[g].declaracao <= ctx->indice) return g;
+    return -1;
 }
 
-// Verifica se assinatura da definição bate com o protótipo anterior
-void verificarAssinaturaCompatível(const char* nome, const char* tipoRetorno, int nParams, char tiposParams[][10]) {
-    Simbolo* s = buscarSimbolo(nome, ESC_GLOBAL);
-    if (!s || s->classe != CLASSE_FUNCAO) return;
-   
-    if (strcmp(s->tipo, tipoRetorno) != 0) {
-        erroSemantico("Tipo de retorno da definição não bate com o protótipo", nome);
+static TipoId verificarExpr(ContextoSemantico* ctx, NoAst* no);
+
+// Verifica os argumentos de uma chamada contra os parâmetros da função. Um
+// argumento de '&id' ou 'id[]' conta como leitura e escrita: a função chamada
+// recebe o valor atual e pode gravar por ele
+static void verificarArgumentos(ContextoSemantico* ctx, NoAst* chamada, const Simbolo* func) {
+    int i = 0;
+
+    for (NoAst* a = chamada->filhos[0]; a; a = a->prox, i++) {
+        TipoId tipoArg = verificarExpr(ctx, a);
+
+        if (i >= func->nParams) continue;
+
+        TipoId tipoParam = tipoIdDeNome(func->tiposParams[i]);
+
+        switch (func->modosParams[i]) {
+            case PARAM_VETOR:
+                // Vetores são passados pelo endereço: só um vetor do mesmo tipo serve
+                if (a->tipo != NO_ID || tipoArg != tipoParam) {
+                    erroFatal(ctx, "Argumento para parâmetro vetor deve ser um vetor do mesmo tipo", chamada->nome);
+                }
+                registrarRef(ctx, a->simbolo, a->offset, XREF_ESCRITA);
+                break;
+
+            case PARAM_REFERENCIA:
+                // '&id' precisa de uma variável (ou elemento) com exatamente o mesmo tipo;
+                // caracteres de string são somente leitura
+                if ((a->tipo != NO_ID && a->tipo != NO_INDEXACAO) || tipoArg != tipoParam
+                    || (a->tipo == NO_INDEXACAO && getTabela()[a->simbolo].tipoId == TIPO_STRING)) {
+                    erroFatal(ctx, "Argumento por referência deve ser uma variável do mesmo tipo", chamada->nome);
+                }
+                registrarRef(ctx, a->simbolo, a->offset, XREF_ESCRITA);
+                break;
+
+            default:
+                if (!tipoCompativel(tipoParam, tipoArg)) {
+                    char msg[128];
+                    snprintf(msg, sizeof(msg),
+                        "Tipo de argumento incompatível na chamada: esperado '%s', mas recebeu '%s'",
+                        nomeTipo(tipoParam), nomeTipo(tipoArg));
+                    erroFatal(ctx, msg, chamada->nome);
+                }
+                break;
+        }
     }
 
-    if (s->nParams != nParams) {
-        erroSemantico("Número de parâmetros da definição não bate com o protótipo", nome);
+    if (i != func->nParams) {
+        erroFatal(ctx, "Número de argumentos incompatível com a declaração da função", chamada->nome);
     }
+}
 
-    for (int i = 0; i < nParams; i++) {
-        if (strcmp(s->tiposParams[i], tiposParams[i]) != 0) {
-            erroSemantico("Tipo de parâmetro incompatível com o protótipo", nome);
-        }
+// Verifica se identificador chamado é uma função válida e registra a chamada
+static Simbolo* resolverFuncaoChamada(ContextoSemantico* ctx, NoAst* no) {
+    no->simbolo = resolverNome(ctx, no->nome);
+    Simbolo* s = no->simbolo >= 0 ? &getTabela()[no->simbolo] : NULL;
+
+    if (!s || s->classe != CLASSE_FUNCAO) {
+        erroFatal(ctx, "Identificador chamado como função, mas não é uma função", no->nome);
     }
+
+    registrarRef(ctx, no->simbolo, no->offset, XREF_CHAMADA);
+    garantirTipoDefinido(ctx, s->tipoId, s->nome);
+    return s;
 }
 
-// Verifica se há parâmetro repetido na lista de parâmetros formais
-void verificarParametroRepetido(const char* nome) {
-    for (int i = 0; i < numParamsTemp; i++) {
-        if (strcmp(nomesParamsTemp[i], nome) == 0) {
-            erroSemantico("Parâmetro repetido na lista de parâmetros formais", nome);
+// Tipo resultante de + - * / (o erro não interrompe a análise)
+static TipoId tipoDominanteAritmetico(ContextoSemantico* ctx, TipoId t1, TipoId t2) {
+    // Regra da tabela: int + char → int; char + char → char; o resto é erro
+    TipoId resultado = tipoAritmetico(t1, t2);
+
+    if (resultado == TIPO_ERRO) {
+        // Se algum dos dois for vetor, não é permitido
+        if (tipoIdEhVetor(t1) || tipoIdEhVetor(t2)) {
+            erroNaoFatal(ctx, "Operações aritméticas não são permitidas com vetores");
+        } else {
+            char msg[128];
+            snprintf(msg, sizeof(msg), "Tipos incompatíveis para operação aritmética: %s e %s",
+                     nomeTipo(t1), nomeTipo(t2));
+            erroNaoFatal(ctx, msg);
         }
     }
+
+    return resultado;
 }
 
-// Verifica se função sem parâmetros declarou `void` explicitamente
-void verificarVoidEmFuncaoSemParametros(int nParams, char tiposParams[][10], const char* nome) {
-    if (nParams == 0) {
-        erroSemantico("Função sem parâmetros deve declarar void explicitamente", nome);
+// Verifica uma expressão binária
+static TipoId verificarBinario(ContextoSemantico* ctx, NoAst* no) {
+    TipoId esq = verificarExpr(ctx, no->filhos[0]);
+    TipoId dir = verificarExpr(ctx, no->filhos[1]);
+
+    switch (no->op) {
+        case TOKEN_EQ: case TOKEN_NEQ:
+        case TOKEN_LT: case TOKEN_GT:
+        case TOKEN_LEQ: case TOKEN_GEQ:
+            if (tipoRelacional(esq, dir) == TIPO_ERRO) {
+                erroNaoFatal(ctx, "Operadores relacionais requerem operandos do tipo int, char ou float (não bool)");
+                return TIPO_ERRO;
+            }
+            return TIPO_BOOL;
+
+        case TOKEN_OR:
+            if (tipoLogico(esq, dir) == TIPO_ERRO) {
+                erroNaoFatal(ctx, "Operador || requer operandos do tipo bool");
+                return TIPO_ERRO;
+            }
+            return TIPO_BOOL;
+
+        case TOKEN_AND:
+            if (tipoLogico(esq, dir) == TIPO_ERRO) {
+                erroNaoFatal(ctx, "Operador && requer operandos do tipo bool");
+                return TIPO_ERRO;
+            }
+            return TIPO_BOOL;
+
+        default:
+            return tipoDominanteAritmetico(ctx, esq, dir);
     }
+}
+
+// Verifica uma expressão e anota seu tipo no nó
+static TipoId verificarExpr(ContextoSemantico* ctx, NoAst* no) {
+    TipoId tipo = TIPO_ERRO;
+    Simbolo* s;
+
+    switch (no->tipo) {
+        case NO_CONST_INT:  tipo = TIPO_INT; break;
+        case NO_CONST_REAL: tipo = TIPO_FLOAT; break;
+        case NO_CONST_CHAR: tipo = TIPO_CHAR; break;
+        case NO_CONST_BOOL: tipo = TIPO_BOOL; break;
+        case NO_CONST_STRING: tipo = TIPO_STRING; break;
+
+        case NO_ID:
+            no->simbolo = resolverNome(ctx, no->nome);
+            if (no->simbolo < 0) {
+                erroFatal(ctx, "Variável não declarada", no->nome);
+            }
+            s = &getTabela()[no->simbolo];
+            if (s->classe == CLASSE_FUNCAO) {
+                erroFatal(ctx, "Função usada como variável na expressão", no->nome);
+            }
+            garantirTipoDefinido(ctx, s->tipoId, s->nome);
+            registrarRef(ctx, no->simbolo, no->offset, XREF_LEITURA);
+
+            // Vetores ficam com o tipo vetor; o acesso indexado converte para o elemento
+            tipo = s->tipoId;
+            break;
+
+        case NO_INDEXACAO:
+            no->simbolo = resolverNome(ctx, no->nome);
+            if (no->simbolo < 0) {
+                erroFatal(ctx, "Variável não declarada", no->nome);
+            }
+            s = &getTabela()[no->simbolo];
+            garantirTipoDefinido(ctx, s->tipoId, s->nome);
+            registrarRef(ctx, no->simbolo, no->offset, XREF_LEITURA);
 
-    if (nParams == 1 && strcmp(tiposParams[0], "void") == 0) {
-        return; // ok
+            verificarExpr(ctx, no->filhos[0]);
+            tipo = tipoElemento(s->tipoId);
+            break;
+
+        case NO_CHAMADA:
+            s = resolverFuncaoChamada(ctx, no);
+            if (s->tipoId == TIPO_VOID) {
+                erroFatal(ctx, "Função 'void' não pode ser usada como expressão", no->nome);
+            }
+            verificarArgumentos(ctx, no, s);
+            tipo = s->tipoId;
+            break;
+
+        case NO_BINARIO:
+            tipo = verificarBinario(ctx, no);
+            break;
+
+        case NO_UNARIO:
+            tipo = verificarExpr(ctx, no->filhos[0]);
+            if (no->op == TOKEN_NOT) {
+                if (tipo != TIPO_BOOL) {
+                    erroNaoFatal(ctx, "Operador ! requer operando do tipo bool");
+                    tipo = TIPO_ERRO;
+                }
+            } else if (tipo != TIPO_ERRO && tipoAritmetico(tipo, TIPO_INT) == TIPO_ERRO) {
+                // Sinal unário só vale para int, char e float
+                erroNaoFatal(ctx, "Operador de sinal requer operando do tipo int, char ou float");
+                tipo = TIPO_ERRO;
+            }
+            break;
+
+        default:
+            break;
     }
+
+    no->tipoExpr = tipo;
+    return tipo;
 }
 
-// Verifica se o tipo de uma variável ou função está corretamente definido
-void garantirTipoDefinido(const char* tipo, const char* nome) {
-    if (tipo == NULL || strcmp(tipo, "") == 0 || strcmp(tipo, "tipo") == 0) {
-        erroSemantico("Tipo da variável ou função não foi definido corretamente", nome);
+static void verificarCmd(ContextoSemantico* ctx, NoAst* no);
+
+// Condições de if/while/for precisam de um valor escalar (não string nem vetor)
+static void verificarCondicao(ContextoSemantico* ctx, NoAst* cond) {
+    TipoId tipo = verificarExpr(ctx, cond);
+
+    if (tipo == TIPO_STRING || tipoIdEhVetor(tipo)) {
+        char msg[128];
+        snprintf(msg, sizeof(msg), "Tipo inválido na condição: '%s'", nomeTipo(tipo));
+        erroNaoFatal(ctx, msg);
     }
 }
 
-// Retorna se dois tipos são semanticamente compatíveis
-bool tiposSaoCompatíveis(const char* tipo1, const char* tipo2) {
-    // Se algum for "erro", nunca é compatível
-    if (strcmp(tipo1, "erro") == 0 || strcmp(tipo2, "erro") == 0) return false;
+// Verifica uma lista de comandos
+static void verificarListaCmds(ContextoSemantico* ctx, NoAst* lista) {
+    for (NoAst* c = lista; c; c = c->prox) {
+        verificarCmd(ctx, c);
+    }
+}
 
-    // Mesmos tipos
-    if (strcmp(tipo1, tipo2) == 0) return true;
+// switch: expressão int ou char, rótulos constantes sem repetição e no
+// máximo um default
+static void verificarSwitch(ContextoSemantico* ctx, NoAst* no) {
+    TipoId tipo = verificarExpr(ctx, no->filhos[0]);
+
+    if (tipo != TIPO_INT && tipo != TIPO_CHAR) {
+        char msg[128];
+        snprintf(msg, sizeof(msg), "Expressão do 'switch' precisa ser int ou char, mas é '%s'", nomeTipo(tipo));
+        erroFatal(ctx, msg, ctx->decl->nome);
+    }
+
+    bool temDefault = false;
+    for (NoAst* caso = no->filhos[1]; caso; caso = caso->prox) {
+        if (!caso->filhos[0]) {
+            if (temDefault) erroFatal(ctx, "Mais de um 'default' no mesmo switch", ctx->decl->nome);
+            temDefault = true;
+            continue;
+        }
 
-    // int <-> char
-    if ((strcmp(tipo1, "int") == 0 && strcmp(tipo2, "char") == 0) ||
-        (strcmp(tipo1, "char") == 0 && strcmp(tipo2, "int") == 0)) {
-        return true;
+        if (!avaliarConstante(caso->filhos[0], &caso->valor.intVal)) {
+            erroFatal(ctx, "Rótulo de 'case' não é expressão inteira constante", ctx->decl->nome);
+        }
+        for (NoAst* anterior = no->filhos[1]; anterior != caso; anterior = anterior->prox) {
+            if (anterior->filhos[0] && anterior->valor.intVal == caso->valor.intVal) {
+                char msg[128];
+                snprintf(msg, sizeof(msg), "Rótulo de 'case' repetido: %d", caso->valor.intVal);
+                erroFatal(ctx, msg, ctx->decl->nome);
+            }
+        }
     }
 
-    // bool <-> int (permitido em atribuição)
-    if ((strcmp(tipo1, "bool") == 0 && strcmp(tipo2, "int") == 0) ||
-        (strcmp(tipo1, "int") == 0 && strcmp(tipo2, "bool") == 0)) {
-        return true;
+    ctx->profundidadeQuebra++;
+    for (NoAst* caso = no->filhos[1]; caso; caso = caso->prox) {
+        verificarListaCmds(ctx, caso->filhos[1]);
     }
+    ctx->profundidadeQuebra--;
+}
 
-    // Vetores idênticos
-    if ((strcmp(tipo1, "int[]") == 0 && strcmp(tipo2, "int[]") == 0) ||
-        (strcmp(tipo1, "char[]") == 0 && strcmp(tipo2, "char[]") == 0)) {
-        return true;
+// Vetor inteiro (v = w): os dois tamanhos precisam ser conhecidos e iguais,
+// então parâmetros 'id[]' ficam de fora
+static void verificarAtribuicaoVetor(ContextoSemantico* ctx, const NoAst* no, const Simbolo* destino) {
+    const NoAst* valor = no->filhos[1];
+    if (valor->tipo != NO_ID) {
+        erroFatal(ctx, "Um vetor só pode receber outro vetor inteiro", no->nome);
     }
 
-    // Incompatível
-    return false;
+    const Simbolo* origem = &getTabela()[valor->simbolo];
+    if (destino->posParam >= 0 || origem->posParam >= 0) {
+        erroFatal(ctx, "Atribuição de vetor inteiro exige tamanho conhecido (parâmetro 'id[]' não serve)", no->nome);
+    }
+    if (destino->tamanho != origem->tamanho) {
+        char msg[128];
+        snprintf(msg, sizeof(msg), "Atribuição entre vetores de tamanhos diferentes: %d e %d",
+            destino->tamanho, origem->tamanho);
+        erroFatal(ctx, msg, no->nome);
+    }
 }
 
-// Verifica se função com retorno está sendo usada como expressão
-void verificarUsoDeFuncaoEmExpressao(const char* nome) {
-    Simbolo* s = buscarSimboloEmEscopos(nome);
-    if (!s || s->classe != CLASSE_FUNCAO) {
-        erroSemantico("Identificador chamado como função, mas não é uma função", nome);
+// Verifica uma atribuição (simples ou indexada)
+static void verificarAtribuicao(ContextoSemantico* ctx, NoAst* no) {
+    no->simbolo = resolverNome(ctx, no->nome);
+    if (no->simbolo < 0) {
+        erroFatal(ctx, "Variável não declarada", no->nome);
     }
 
-    garantirTipoDefinido(s->tipo, s->nome);
+    Simbolo* s = &getTabela()[no->simbolo];
+    registrarRef(ctx, no->simbolo, no->offset, XREF_ESCRITA);
 
-    if (strcmp(s->tipo, "void") == 0) {
-        erroSemantico("Função 'void' não pode ser usada como expressão", nome);
+    if (s->classe == CLASSE_FUNCAO) {
+        erroFatal(ctx, "Função usada como variável na atribuição", no->nome);
     }
 
-    registrarTipoExpressao(s->tipo);
-}
+    garantirTipoDefinido(ctx, s->tipoId, s->nome);
 
-// Verifica se função com valor de retorno está sendo usada como comando
-void verificarUsoDeFuncaoComoComando(const char* nome) {
-    Simbolo* s = buscarSimboloEmEscopos(nome);
-    if (!s || s->classe != CLASSE_FUNCAO) {
-        erroSemantico("Identificador chamado como função, mas não é uma função", nome);
+    // Atribuição indexada (v[i] = ...): o destino passa a ser o tipo do elemento
+    TipoId destino = s->tipoId;
+    if (no->filhos[0]) {
+        if (destino == TIPO_STRING) {
+            erroFatal(ctx, "Caracteres de string não podem ser alterados por atribuição", no->nome);
+        }
+        destino = tipoElemento(destino);
+        verificarExpr(ctx, no->filhos[0]);
     }
+    no->tipoExpr = destino;
 
-    garantirTipoDefinido(s->tipo, s->nome);
+    TipoId origem = verificarExpr(ctx, no->filhos[1]);
 
-    if (strcmp(s->tipo, "void") != 0) {
-        erroSemantico("Função com valor de retorno usada como comando", nome);
+    if (!tipoCompativel(destino, origem)) {
+        char msg[128];
+        snprintf(msg, sizeof(msg),
+            "Tipo incompatível na atribuição: esperado '%s', mas recebeu '%s'",
+            nomeTipo(destino), nomeTipo(origem));
+        erroFatal(ctx, msg, "");
     }
+
+    if (tipoIdEhVetor(destino)) verificarAtribuicaoVetor(ctx, no, s);
 }
 
-// Verifica se há erro de retorno de valor em função `void`
-void verificarReturnComValor() {
-    if (!nomeFuncaoAtual) return;
+// Verifica um comando do corpo da função
+static void verificarCmd(ContextoSemantico* ctx, NoAst* no) {
+    if (!no) return;
 
-    Simbolo* func = buscarSimbolo(nomeFuncaoAtual, ESC_GLOBAL);
-    if (!func || func->classe != CLASSE_FUNCAO) return;
+    TipoId tipoRetorno = getTabela()[ctx->simboloFuncao].tipoId;
+    Simbolo* s;
 
-    if (strcmp(func->tipo, "void") == 0) {
-        erroSemantico("Função 'void' não pode retornar valor", func->nome);
-    }
+    switch (no->tipo) {
+        case NO_IF:
+            verificarCondicao(ctx, no->filhos[0]);
+            verificarCmd(ctx, no->filhos[1]);
+            verificarCmd(ctx, no->filhos[2]);
+            break;
 
-    encontrouReturnComValor = true;  // <-- marca que houve retorno com valor
+        case NO_WHILE:
+            verificarCondicao(ctx, no->filhos[0]);
+            ctx->profundidadeQuebra++;
+            verificarCmd(ctx, no->filhos[1]);
+            ctx->profundidadeQuebra--;
+            break;
 
-}
+        case NO_FOR:
+            verificarCmd(ctx, no->filhos[0]);
+            if (no->filhos[1]) verificarCondicao(ctx, no->filhos[1]);
+            verificarCmd(ctx, no->filhos[2]);
+            ctx->profundidadeQuebra++;
+            verificarCmd(ctx, no->filhos[3]);
+            ctx->profundidadeQuebra--;
+            break;
+
+        case NO_SWITCH:
+            verificarSwitch(ctx, no);
+            break;
+
+        case NO_BREAK:
+            if (ctx->profundidadeQuebra == 0) {
+                erroFatal(ctx, "'break' fora de laço ou switch", ctx->decl->nome);
+            }
+            break;
+
+        case NO_RETURN:
+            if (no->filhos[0]) {
+                TipoId tipoValor = verificarExpr(ctx, no->filhos[0]);
+
+                // Verifica se há erro de retorno de valor em função `void`
+                if (tipoRetorno == TIPO_VOID) {
+                    erroFatal(ctx, "Função 'void' não pode retornar valor", ctx->decl->nome);
+                }
+
+                // O valor retornado segue as mesmas regras da atribuição (int → float é permitido)
+                if (!tipoCompativel(tipoRetorno, tipoValor)) {
+                    char msg[128];
+                    snprintf(msg, sizeof(msg),
+                        "Tipo de retorno incompatível: esperado '%s', mas recebeu '%s'",
+                        nomeTipo(tipoRetorno), nomeTipo(tipoValor));
+                    erroFatal(ctx, msg, ctx->decl->nome);
+                }
+                ctx->encontrouReturnComValor = true;
+            } else if (tipoRetorno != TIPO_VOID) {
+                // Verifica se há erro de `return;` em função com retorno
+                erroFatal(ctx, "Função com valor de retorno exige 'return' com valor", ctx->decl->nome);
+            }
+            break;
 
-// Verifica se há erro de `return;` em função com retorno
-void verificarReturnSemValor() {
-    if (!nomeFuncaoAtual) return;
+        case NO_ATRIB:
+            verificarAtribuicao(ctx, no);
+            break;
 
-    Simbolo* func = buscarSimbolo(nomeFuncaoAtual, ESC_GLOBAL);
-    if (!func || func->classe != CLASSE_FUNCAO) return;
+        case NO_CMD_CHAMADA:
+            s = resolverFuncaoChamada(ctx, no);
+            if (s->tipoId != TIPO_VOID) {
+                erroFatal(ctx, "Função com valor de retorno usada como comando", no->nome);
+            }
+            verificarArgumentos(ctx, no, s);
+            break;
+
+        case NO_BLOCO:
+            verificarListaCmds(ctx, no->filhos[0]);
+            break;
 
-    if (strcmp(func->tipo, "void") != 0) {
-        erroSemantico("Função com valor de retorno exige 'return' com valor", func->nome);
+        default:
+            break;
     }
 }
 
-// Armazena o nome da função atualmente sendo analisada
-void setFuncaoAtual(const char* nome) {
-    nomeFuncaoAtual = nome;
-    encontrouReturnComValor = false;  // reset ao entrar na função
+// Tarefa do pool: verifica o corpo da função da declaração 'indice'
+static void verificarCorpoDeFuncao(int indice, void* arg) {
+    (void)arg;
+    ContextoSemantico* ctx = &contextos[indice];
+    NoAst* func = ctx->decl;
 
-}
+    if (ctx->fatal || func->tipo != NO_FUNCAO || !func->temCorpo) return;
 
-// Verifica se função com tipo de retorno tem pelo menos um `return expr;`
-void verificarFuncaoComRetornoObrigatorio() {
-    if (!nomeFuncaoAtual) return;
+    if (setjmp(ctx->salto)) return;
 
-    Simbolo* func = buscarSimbolo(nomeFuncaoAtual, ESC_GLOBAL);
-    if (!func || func->classe != CLASSE_FUNCAO) return;
+    verificarListaCmds(ctx, func->filhos[2]);
 
-    if (strcmp(func->tipo, "void") != 0 && !encontrouReturnComValor) {
-        erroSemantico("Função com valor de retorno deve conter pelo menos um 'return expr;'", func->nome);
+    // Verifica se função com tipo de retorno tem pelo menos um `return expr;`
+    if (getTabela()[ctx->simboloFuncao].tipoId != TIPO_VOID && !ctx->encontrouReturnComValor) {
+        erroFatal(ctx, "Função com valor de retorno deve conter pelo menos um 'return expr;'", func->nome);
     }
 }
 
-void registrarTipoRelacional() {
-    registrarTipoExpressao("bool");
-}
+// ----------------------------------------------
+// Análise completa
+// ----------------------------------------------
 
-void registrarTipoLogico() {
-    registrarTipoExpressao("bool");
-}
+// Soma as ocorrências da declaração aos contadores de uso dos símbolos
+static void contarUsos(const ContextoSemantico* ctx) {
+    Simbolo* tabela = getTabela();
 
-const char* tipoDominanteAritmetico(const char* t1, const char* t2) {
-    // Se algum dos dois for vetor, não é permitido
-    if (tipoEhVetor(t1) || tipoEhVetor(t2)) {
-        fprintf(stderr, "[ERRO SEMÂNTICO] Operações aritméticas não são permitidas com vetores\n");
-        return "erro";
+    for (int i = 0; i < ctx->nRefs; i++) {
+        Simbolo* s = &tabela[ctx->refs[i].simbolo];
+        switch (ctx->refs[i].tipo) {
+            case XREF_LEITURA: s->leituras++; break;
+            case XREF_ESCRITA: s->escritas++; break;
+            case XREF_CHAMADA: s->chamadas++; break;
+            default: break;
+        }
     }
+}
 
-    // Só aceitamos int e char como tipos válidos
-    bool valido1 = strcmp(t1, "int") == 0 || strcmp(t1, "char") == 0;
-    bool valido2 = strcmp(t2, "int") == 0 || strcmp(t2, "char") == 0;
+// Avisos de declarações sem uso: locais nunca lidos e funções nunca chamadas
+static void avisarSemUso(const ContextoSemantico* ctx) {
+    NoAst* func = ctx->decl;
+    if (func->tipo != NO_FUNCAO || !func->temCorpo) return;
 
-    if (!valido1 || !valido2) {
-        fprintf(stderr, "[ERRO SEMÂNTICO] Tipos incompatíveis para operação aritmética: %s e %s\n", t1, t2);
-        return "erro";
-    }
+    Simbolo* tabela = getTabela();
+    Simbolo* f = &tabela[func->simbolo];
 
-    // Regra: int + char → int
-    if (strcmp(t1, "int") == 0 || strcmp(t2, "int") == 0) {
-        return "int";
+    if (f->chamadas == 0 && strcmp(func->nome, "main") != 0) {
+        fprintf(stderr, "[AVISO] %s: Função definida e nunca chamada\n", func->nome);
     }
 
-    // Se ambos forem char, resultado é char
-    return "char";
+    for (NoAst* v = func->filhos[1]; v; v = v->prox) {
+        Simbolo* s = &tabela[v->simbolo];
+        if (s->leituras > 0) continue;
+        fprintf(stderr, s->escritas > 0 ? "[AVISO] %s: Variável local recebe valores mas nunca é lida\n"
+                                        : "[AVISO] %s: Variável local declarada e nunca usada\n", v->nome);
+    }
 }
 
-const char* getTipoExpressao() {
-    return tipoExpressao;
-}
+// Reproduz as ocorrências da declaração no índice de referências
+static void reproduzirRefs(const ContextoSemantico* ctx) {
+    Simbolo* tabela = getTabela();
+    bool funcao = ctx->decl->tipo == NO_FUNCAO;
 
-void setTipoExpressao(const char* tipo) {
-    tipoExpressao = tipo;
-}
+    if (funcao) xrefEntrarFuncao(ctx->decl->nome, ctx->decl->offset);
 
-bool tipoEhVetor(const char* tipo) {
-    return strstr(tipo, "[]") != NULL;
+    for (int i = 0; i < ctx->nRefs; i++) {
+        registrarReferenciaXref(&tabela[ctx->refs[i].simbolo], ctx->refs[i].offset, ctx->refs[i].tipo);
+    }
+
+    if (funcao) xrefSairFuncao(ctx->decl->offsetFim);
 }
 
-static char ultimoTipoExpr[16] = "";
+// Executa a análise semântica do programa inteiro (anota tipos e símbolos nos nós)
+bool verificarSemantica(NoAst* programa) {
+    int nDecls = tamanhoLista(programa->filhos[0]);
+    int nAnalisadas = 0;
 
-void setUltimoTipoExpr(const char* tipo) {
-    strncpy(ultimoTipoExpr, tipo, sizeof(ultimoTipoExpr));
-}
+    contextos = calloc(nDecls > 0 ? nDecls : 1, sizeof(ContextoSemantico));
+
+    registrarEmbutidas();
+
+    // Fase 1: declarações em ordem; para na primeira declaração com erro fatal
+    for (NoAst* d = programa->filhos[0]; d; d = d->prox) {
+        ContextoSemantico* ctx = &contextos[nAnalisadas];
+        ctx->decl = d;
+        ctx->indice = nAnalisadas;
+        ctx->simboloFuncao = -1;
+        nAnalisadas++;
+
+        if (setjmp(ctx->salto)) break;
+
+        if (d->tipo == NO_FUNCAO) {
+            declararFuncao(ctx, d);
+        } else {
+            declararVariavelGlobal(ctx, d);
+        }
+    }
+
+    // Fase 2: corpos das funções em paralelo
+    executarEmParalelo(nAnalisadas, verificarCorpoDeFuncao, NULL);
 
-const char* getUltimoTipoExpr() {
-    return ultimoTipoExpr;
-}
\ No newline at end of file
+    // Usos de todos os símbolos (uma função pode ser chamada por declarações posteriores)
+    for (int i = 0; i < nAnalisadas; i++) contarUsos(&contextos[i]);
+
+    // Diagnósticos e referências na ordem do código-fonte
+    int codigo = 0;
+    bool semErros = true;
+    for (int i = 0; i < nAnalisadas; i++) {
+        ContextoSemantico* ctx = &contextos[i];
+
+        if (ctx->tamMensagens > 0) fputs(ctx->mensagens, stderr);
+        if (xrefAtivo()) reproduzirRefs(ctx);
+        if (!ctx->fatal) avisarSemUso(ctx);
+        if (ctx->houveErro) semErros = false;
+
+        if (ctx->fatal) {
+            codigo = 1;
+            break;
+        }
+    }
+
+    for (int i = 0; i < nAnalisadas; i++) {
+        free(contextos[i].mensagens);
+        free(contextos[i].refs);
+    }
+    free(contextos);
+    contextos = NULL;
+
+    if (codigo != 0) {
+        exit(codigo);
+    }
+
+    printf("[OK] Análise semântica concluída com sucesso.\n");
+    return semErros;
+}
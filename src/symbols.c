@@ -1,4 +1,5 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include "symbols.h"
 
@@ -6,9 +7,71 @@
 // Escopo atual do compilador (inicia como global)
 Escopo escopoAtual = ESC_GLOBAL;
 
-// Tabela interna real (array estático)
-static Simbolo tabela[MAX_TABELA];
+// Tabela interna real (cresce sob demanda)
+static Simbolo* tabela = NULL;
 static int nSimbolos = 0;
+static int capTabela = 0;
+
+// Índice dos globais por nome: endereçamento aberto, guarda índice + 1 (0 = livre)
+static int* hashGlobais = NULL;
+static int capHash = 0;
+static int nGlobais = 0;
+
+// ===================
+// Índice de globais
+// ===================
+
+static unsigned int hashNome(const char* nome) {
+    unsigned int h = 2166136261u;
+    while (*nome) {
+        h ^= (unsigned char)*nome++;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static void inserirNoHash(int* hash, int cap, int indice) {
+    unsigned int j = hashNome(tabela[indice].nome) & (cap - 1);
+    while (hash[j]) j = (j + 1) & (cap - 1);
+    hash[j] = indice + 1;
+}
+
+static void indexarGlobal(int indice) {
+    if ((nGlobais + 1) * 2 > capHash) {
+        int novaCap = capHash ? capHash * 2 : 1024;
+        int* novo = calloc(novaCap, sizeof(int));
+        for (int i = 0; i < capHash; i++) {
+            if (hashGlobais[i]) inserirNoHash(novo, novaCap, hashGlobais[i] - 1);
+        }
+        free(hashGlobais);
+        hashGlobais = novo;
+        capHash = novaCap;
+    }
+
+    inserirNoHash(hashGlobais, capHash, indice);
+    nGlobais++;
+}
+
+// Índice do símbolo global com o nome dado, ou -1 (consulta em tempo constante)
+int buscarIndiceGlobal(const char* nome) {
+    if (capHash == 0) return -1;
+
+    unsigned int j = hashNome(nome) & (capHash - 1);
+    while (hashGlobais[j]) {
+        if (strcmp(tabela[hashGlobais[j] - 1].nome, nome) == 0) return hashGlobais[j] - 1;
+        j = (j + 1) & (capHash - 1);
+    }
+    return -1;
+}
+
+// Busca entre os locais vivos, que sempre ocupam o fim da tabela
+static Simbolo* buscarLocalVivo(const char* nome) {
+    for (int i = nSimbolos - 1; i >= 0; i--) {
+        if (tabela[i].escopo != ESC_LOCAL || tabela[i].estado != ESTADO_VIVO) break;
+        if (strcmp(tabela[i].nome, nome) == 0) return &tabela[i];
+    }
+    return NULL;
+}
 
 // ===================
 // Inicialização
@@ -17,6 +80,8 @@ static int nSimbolos = 0;
 // Inicializa a tabela de símbolos (zera o contador)
 void inicializarTabela() {
     nSimbolos = 0;
+    nGlobais = 0;
+    if (hashGlobais) memset(hashGlobais, 0, capHash * sizeof(int));
 }
 
 // ===================
@@ -26,25 +91,35 @@ void inicializarTabela() {
 // Insere um novo símbolo na tabela de símbolos
 int inserirSimbolo(const char* nome, const char* tipo, Classe classe, Escopo escopo, int tamanho) {
     // Verifica se já existe símbolo com mesmo nome e escopo e estado ativo
-    for (int i = 0; i < nSimbolos; i++) {
-        if (strcmp(tabela[i].nome, nome) == 0 && 
-            tabela[i].escopo == escopo && 
-            tabela[i].estado == ESTADO_VIVO) {
-            fprintf(stderr, "Erro: símbolo '%s' já declarado neste escopo.\n", nome);
-            return 0;  // erro de duplicação
-        }
+    bool duplicado = (escopo == ESC_GLOBAL) ? buscarIndiceGlobal(nome) >= 0
+                                            : buscarLocalVivo(nome) != NULL;
+    if (duplicado) {
+        fprintf(stderr, "Erro: símbolo '%s' já declarado neste escopo.\n", nome);
+        return 0;  // erro de duplicação
     }
 
-    // Verifica limite
-    if (nSimbolos >= MAX_TABELA) {
-        fprintf(stderr, "Erro: tabela de símbolos cheia.\n");
-        return 0;
+    // Aumenta a tabela se necessário
+    if (nSimbolos >= capTabela) {
+        int novaCap = capTabela ? capTabela * 2 : MAX_TABELA;
+        Simbolo* nova = realloc(tabela, novaCap * sizeof(Simbolo));
+        if (!nova) {
+            fprintf(stderr, "Erro: tabela de símbolos cheia.\n");
+            return 0;
+        }
+        tabela = nova;
+        capTabela = novaCap;
     }
 
+    memset(&tabela[nSimbolos], 0, sizeof(Simbolo));
+
     // Preenche o símbolo
     strncpy(tabela[nSimbolos].nome, nome, sizeof(tabela[nSimbolos].nome));
     strncpy(tabela[nSimbolos].tipo, tipo, sizeof(tabela[nSimbolos].tipo));
     tabela[nSimbolos].classe = classe;
+    tabela[nSimbolos].tipoId = tipoIdDeNome(tipo);
+    if (classe == CLASSE_VETOR) {
+        tabela[nSimbolos].tipoId = tipoVetorDe(tabela[nSimbolos].tipoId);
+    }
     tabela[nSimbolos].escopo = escopo;
     tabela[nSimbolos].tamanho = tamanho;
 
@@ -53,6 +128,11 @@ int inserirSimbolo(const char* nome, const char* tipo, Classe classe, Escopo esc
 
     // Inicializa se já foi definida (para funções, assume que NÃO foi definida ainda)
     tabela[nSimbolos].foiDefinida = false;
+    tabela[nSimbolos].posParam = -1;
+
+    if (escopo == ESC_GLOBAL) {
+        indexarGlobal(nSimbolos);
+    }
 
     nSimbolos++;
     return 1;  // sucesso
@@ -60,23 +140,16 @@ int inserirSimbolo(const char* nome, const char* tipo, Classe classe, Escopo esc
 
 // Busca um símbolo pelo nome e escopo, respeitando zumbificação e sombreamento
 Simbolo* buscarSimbolo(const char* nome, Escopo escopo) {
-    // --- ALTERADO ---
-    // A busca agora ignora zumbis e respeita o sombreamento de escopo.
-    // O parâmetro 'escopo' indica de ONDE a busca se origina.
-    for (int i = nSimbolos - 1; i >= 0; i--) {
-        // Verifica se o nome bate E se o símbolo está ativo
-        if (strcmp(tabela[i].nome, nome) == 0 && tabela[i].estado == ESTADO_VIVO) {
-            // Se encontrou um símbolo ativo com o nome certo, ele é um candidato.
-            // Se a busca partiu de um escopo local, qualquer símbolo encontrado (local ou global) é válido.
-            // Se a busca partiu de um escopo global, apenas um símbolo global é válido.
-            if (escopo == ESC_LOCAL) {
-                return &tabela[i]; // Retorna o primeiro ativo que encontrar (o mais interno)
-            } else if (escopo == ESC_GLOBAL && tabela[i].escopo == ESC_GLOBAL) {
-                return &tabela[i]; // Encontrou um global, como pedido
-            }
-        }
+    // A busca ignora zumbis e respeita o sombreamento de escopo.
+    // O parâmetro 'escopo' indica de ONDE a busca se origina:
+    // de um escopo local, o local mais interno tem prioridade sobre o global.
+    if (escopo == ESC_LOCAL) {
+        Simbolo* local = buscarLocalVivo(nome);
+        if (local) return local;
     }
-    return NULL; 
+
+    int i = buscarIndiceGlobal(nome);
+    return i >= 0 ? &tabela[i] : NULL;
 }
 
 // Zumbifica todos os símbolos locais ativos (limpa o escopo local)
@@ -136,6 +209,7 @@ void registrarFuncao(const char* tipo, const char* nome, int nParams, char tipos
     // Caso já exista como função ainda não definida (protótipo), apenas atualiza assinatura
     if (existente && existente->classe == CLASSE_FUNCAO && !existente->foiDefinida) {
         strncpy(existente->tipo, tipo, sizeof(existente->tipo));
+        existente->tipoId = tipoIdDeNome(tipo);
         existente->nParams = nParams;
 
         for (int i = 0; i < nParams; i++) {
@@ -165,6 +239,15 @@ void registrarParametro(const char* tipo, const char* nome, Classe classe, Escop
 }
 
 
+// Define posição e forma de passagem do parâmetro recém-registrado com o nome dado
+void definirModoParametro(const char* nome, int posicao, ModoParam modo) {
+    Simbolo* s = buscarLocalVivo(nome);
+    if (!s) return;
+
+    s->posParam = posicao;
+    s->modoParam = modo;
+}
+
 // Registra uma variável local (vetor ou não)
 void registrarVariavelLocal(const char* tipo, const char* nome, int isVetor, int tamanho) {
     Classe classe = isVetor ? CLASSE_VETOR : CLASSE_VAR;
@@ -175,12 +258,7 @@ void registrarVariavelLocal(const char* tipo, const char* nome, int isVetor, int
 
 // Busca o símbolo mais interno (prioriza local, depois global)
 Simbolo* buscarSimboloEmEscopos(const char* nome) {
-    for (int i = nSimbolos - 1; i >= 0; i--) {
-        if (strcmp(tabela[i].nome, nome) == 0 && tabela[i].estado == ESTADO_VIVO) {
-            return &tabela[i]; // O primeiro válido encontrado (mais interno)
-        }
-    }
-    return NULL;
+    return buscarSimbolo(nome, ESC_LOCAL);
 }
 
 // symbols.c
@@ -0,0 +1,171 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "threadpool.h"
+
+// Número de threads pedido (0 = automático)
+static int numThreadsPedido = 0;
+
+// Threads auxiliares (a thread que chama é a de número 0)
+static pthread_t* trabalhadores = NULL;
+static int nTrabalhadores = 0;
+static bool iniciado = false;
+static bool encerrando = false;
+
+static pthread_mutex_t trava = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t temLote = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t loteConcluido = PTHREAD_COND_INITIALIZER;
+
+// Lote atual (protegido por 'trava')
+static TarefaParalela tarefaAtual = NULL;
+static void* argAtual = NULL;
+static int proximoIndice = 0;
+static int totalIndices = 0;
+static int emExecucao = 0;
+static unsigned long geracao = 0;
+
+// Marca threads que estão executando uma tarefa (lotes aninhados rodam em sequência)
+static _Thread_local bool dentroDeTarefa = false;
+
+// ===================
+// Configuração
+// ===================
+
+static int contarProcessadores(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (int)info.dwNumberOfProcessors;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+#endif
+}
+
+void definirNumThreads(int n) {
+    numThreadsPedido = n > 0 ? n : 0;
+}
+
+int obterNumThreads(void) {
+    return numThreadsPedido > 0 ? numThreadsPedido : contarProcessadores();
+}
+
+// ===================
+// Execução
+// ===================
+
+// Consome índices do lote atual; chamada com 'trava' adquirida
+static void processarLote(void) {
+    TarefaParalela tarefa = tarefaAtual;
+    void* arg = argAtual;
+
+    emExecucao++;
+    while (proximoIndice < totalIndices) {
+        int i = proximoIndice++;
+        pthread_mutex_unlock(&trava);
+
+        dentroDeTarefa = true;
+        tarefa(i, arg);
+        dentroDeTarefa = false;
+
+        pthread_mutex_lock(&trava);
+    }
+    emExecucao--;
+
+    if (emExecucao == 0) {
+        pthread_cond_broadcast(&loteConcluido);
+    }
+}
+
+static void* executarTrabalhador(void* arg) {
+    (void)arg;
+    unsigned long vista = 0;
+
+    pthread_mutex_lock(&trava);
+    for (;;) {
+        while (!encerrando && geracao == vista) {
+            pthread_cond_wait(&temLote, &trava);
+        }
+        if (encerrando) break;
+
+        vista = geracao;
+        processarLote();
+    }
+    pthread_mutex_unlock(&trava);
+    return NULL;
+}
+
+static void iniciarThreads(void) {
+    iniciado = true;
+    nTrabalhadores = obterNumThreads() - 1;
+    if (nTrabalhadores <= 0) {
+        nTrabalhadores = 0;
+        return;
+    }
+
+    trabalhadores = malloc(nTrabalhadores * sizeof(pthread_t));
+    for (int i = 0; i < nTrabalhadores; i++) {
+        if (pthread_create(&trabalhadores[i], NULL, executarTrabalhador, NULL) != 0) {
+            // Segue com as threads que conseguiu criar
+            nTrabalhadores = i;
+            break;
+        }
+    }
+}
+
+void executarEmParalelo(int n, TarefaParalela tarefa, void* arg) {
+    if (n <= 0) return;
+
+    if (!iniciado) iniciarThreads();
+
+    // Sem threads auxiliares, lote unitário ou chamada aninhada: executa aqui mesmo
+    if (nTrabalhadores == 0 || n == 1 || dentroDeTarefa) {
+        for (int i = 0; i < n; i++) tarefa(i, arg);
+        return;
+    }
+
+    pthread_mutex_lock(&trava);
+    tarefaAtual = tarefa;
+    argAtual = arg;
+    proximoIndice = 0;
+    totalIndices = n;
+    geracao++;
+    pthread_cond_broadcast(&temLote);
+
+    processarLote();
+
+    while (emExecucao > 0 || proximoIndice < totalIndices) {
+        pthread_cond_wait(&loteConcluido, &trava);
+    }
+
+    tarefaAtual = NULL;
+    argAtual = NULL;
+    pthread_mutex_unlock(&trava);
+}
+
+void encerrarThreads(void) {
+    if (!iniciado) return;
+
+    pthread_mutex_lock(&trava);
+    encerrando = true;
+    pthread_cond_broadcast(&temLote);
+    pthread_mutex_unlock(&trava);
+
+    for (int i = 0; i < nTrabalhadores; i++) {
+        pthread_join(trabalhadores[i], NULL);
+    }
+
+    free(trabalhadores);
+    trabalhadores = NULL;
+    nTrabalhadores = 0;
+    iniciado = false;
+    encerrando = false;
+}
@@ -0,0 +1,164 @@
+#include <string.h>
+
+#include "types.h"
+
+// ===================
+// Nomes dos tipos
+// ===================
+
+static const char* const nomes[NUM_TIPOS] = {
+    [TIPO_ERRO]        = "erro",
+    [TIPO_NENHUM]      = "",
+    [TIPO_INDEFINIDO]  = "tipo",
+    [TIPO_VOID]        = "void",
+    [TIPO_INT]         = "int",
+    [TIPO_CHAR]        = "char",
+    [TIPO_FLOAT]       = "float",
+    [TIPO_BOOL]        = "bool",
+    [TIPO_STRING]      = "string",
+    [TIPO_INT_VETOR]   = "int[]",
+    [TIPO_CHAR_VETOR]  = "char[]",
+    [TIPO_FLOAT_VETOR] = "float[]",
+    [TIPO_BOOL_VETOR]  = "bool[]",
+};
+
+// ===================
+// Tabelas pré-calculadas
+// ===================
+
+// compativel[destino][origem]: atribuição, passagem de valor e retorno
+static const bool compativel[NUM_TIPOS][NUM_TIPOS] = {
+    [TIPO_INDEFINIDO][TIPO_INDEFINIDO] = true,
+    [TIPO_VOID][TIPO_VOID] = true,
+
+    // int <-> char e bool <-> int
+    [TIPO_INT][TIPO_INT] = true,
+    [TIPO_INT][TIPO_CHAR] = true,
+    [TIPO_INT][TIPO_BOOL] = true,
+    [TIPO_CHAR][TIPO_CHAR] = true,
+    [TIPO_CHAR][TIPO_INT] = true,
+    [TIPO_BOOL][TIPO_BOOL] = true,
+    [TIPO_BOOL][TIPO_INT] = true,
+    [TIPO_FLOAT][TIPO_FLOAT] = true,
+    [TIPO_STRING][TIPO_STRING] = true,
+
+    // Promoção para float (o caminho inverso perderia a parte fracionária)
+    [TIPO_FLOAT][TIPO_INT] = true,
+    [TIPO_FLOAT][TIPO_CHAR] = true,
+
+    // Vetores só com vetores idênticos
+    [TIPO_INT_VETOR][TIPO_INT_VETOR] = true,
+    [TIPO_CHAR_VETOR][TIPO_CHAR_VETOR] = true,
+    [TIPO_FLOAT_VETOR][TIPO_FLOAT_VETOR] = true,
+    [TIPO_BOOL_VETOR][TIPO_BOOL_VETOR] = true,
+};
+
+// aritmetico[t1][t2]: int + char -> int; char + char -> char; com float -> float; o resto é erro
+static const TipoId aritmetico[NUM_TIPOS][NUM_TIPOS] = {
+    [TIPO_INT][TIPO_INT] = TIPO_INT,
+    [TIPO_INT][TIPO_CHAR] = TIPO_INT,
+    [TIPO_CHAR][TIPO_INT] = TIPO_INT,
+    [TIPO_CHAR][TIPO_CHAR] = TIPO_CHAR,
+
+    [TIPO_FLOAT][TIPO_FLOAT] = TIPO_FLOAT,
+    [TIPO_FLOAT][TIPO_INT] = TIPO_FLOAT,
+    [TIPO_INT][TIPO_FLOAT] = TIPO_FLOAT,
+    [TIPO_FLOAT][TIPO_CHAR] = TIPO_FLOAT,
+    [TIPO_CHAR][TIPO_FLOAT] = TIPO_FLOAT,
+};
+
+// relacional[t1][t2]: operandos int, char ou float produzem bool
+static const TipoId relacional[NUM_TIPOS][NUM_TIPOS] = {
+    [TIPO_INT][TIPO_INT] = TIPO_BOOL,
+    [TIPO_INT][TIPO_CHAR] = TIPO_BOOL,
+    [TIPO_CHAR][TIPO_INT] = TIPO_BOOL,
+    [TIPO_CHAR][TIPO_CHAR] = TIPO_BOOL,
+
+    [TIPO_FLOAT][TIPO_FLOAT] = TIPO_BOOL,
+    [TIPO_FLOAT][TIPO_INT] = TIPO_BOOL,
+    [TIPO_INT][TIPO_FLOAT] = TIPO_BOOL,
+    [TIPO_FLOAT][TIPO_CHAR] = TIPO_BOOL,
+    [TIPO_CHAR][TIPO_FLOAT] = TIPO_BOOL,
+};
+
+// logico[t1][t2]: apenas bool && bool e bool || bool
+static const TipoId logico[NUM_TIPOS][NUM_TIPOS] = {
+    [TIPO_BOOL][TIPO_BOOL] = TIPO_BOOL,
+};
+
+// elemento[t]: tipo base dos vetores; string indexada dá char; escalares mapeiam para si mesmos
+static const TipoId elemento[NUM_TIPOS] = {
+    [TIPO_NENHUM]      = TIPO_NENHUM,
+    [TIPO_INDEFINIDO]  = TIPO_INDEFINIDO,
+    [TIPO_VOID]        = TIPO_VOID,
+    [TIPO_INT]         = TIPO_INT,
+    [TIPO_CHAR]        = TIPO_CHAR,
+    [TIPO_FLOAT]       = TIPO_FLOAT,
+    [TIPO_BOOL]        = TIPO_BOOL,
+    [TIPO_STRING]      = TIPO_CHAR,
+    [TIPO_INT_VETOR]   = TIPO_INT,
+    [TIPO_CHAR_VETOR]  = TIPO_CHAR,
+    [TIPO_FLOAT_VETOR] = TIPO_FLOAT,
+    [TIPO_BOOL_VETOR]  = TIPO_BOOL,
+};
+
+// vetorDe[t]: tipo vetor de cada tipo base
+static const TipoId vetorDe[NUM_TIPOS] = {
+    [TIPO_INT]   = TIPO_INT_VETOR,
+    [TIPO_CHAR]  = TIPO_CHAR_VETOR,
+    [TIPO_FLOAT] = TIPO_FLOAT_VETOR,
+    [TIPO_BOOL]  = TIPO_BOOL_VETOR,
+};
+
+static const bool ehVetor[NUM_TIPOS] = {
+    [TIPO_INT_VETOR] = true,
+    [TIPO_CHAR_VETOR] = true,
+    [TIPO_FLOAT_VETOR] = true,
+    [TIPO_BOOL_VETOR] = true,
+};
+
+// ===================
+// Consultas
+// ===================
+
+// Usada apenas na declaração dos símbolos; as verificações usam os ids
+TipoId tipoIdDeNome(const char* nome) {
+    if (nome == NULL) return TIPO_NENHUM;
+
+    for (int t = 0; t < NUM_TIPOS; t++) {
+        if (strcmp(nomes[t], nome) == 0) return (TipoId)t;
+    }
+    return TIPO_NENHUM;
+}
+
+const char* nomeTipo(TipoId t) {
+    return nomes[t];
+}
+
+bool tipoCompativel(TipoId destino, TipoId origem) {
+    return compativel[destino][origem];
+}
+
+TipoId tipoAritmetico(TipoId t1, TipoId t2) {
+    return aritmetico[t1][t2];
+}
+
+TipoId tipoRelacional(TipoId t1, TipoId t2) {
+    return relacional[t1][t2];
+}
+
+TipoId tipoLogico(TipoId t1, TipoId t2) {
+    return logico[t1][t2];
+}
+
+TipoId tipoElemento(TipoId t) {
+    return elemento[t];
+}
+
+TipoId tipoVetorDe(TipoId t) {
+    return vetorDe[t];
+}
+
+bool tipoIdEhVetor(TipoId t) {
+    return ehVetor[t];
+}
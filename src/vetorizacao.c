@@ -0,0 +1,687 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "otimizacao.h"
+
+// ==============================================
+// VETORIZAÇÃO DE LAÇOS (SSE2)
+// ==============================================
+//
+// Laços contados 'for (i = i0; i < n; i = i + 1)' cujo corpo só lê e grava
+// a[i] (a fixo no laço) e faz contas por elemento ganham uma versão que
+// trata 4 elementos int/float (ou 16 char) por volta. O laço original fica
+// como epílogo: começa de onde a versão vetorial parou e faz o resto.
+//
+// Reduções: 's = s + x' com int (a soma com transbordo dá o mesmo resultado
+// em qualquer ordem) e 'if (x < m) m = x' / 'if (x > m) m = x' com int ou
+// float (minps/maxps escolhem o mesmo operando que a comparação escalar,
+// inclusive com NaN). Soma de float não é vetorizada: a ordem das somas
+// mudaria o arredondamento.
+//
+// Vetores que a análise de alias separa (globais e locais diferentes, ou
+// parâmetros que só recebem vetores distintos) não se sobrepõem; nos outros
+// pares, o pré-cabeçalho confere em tempo de execução se os trechos de 16
+// bytes podem se sobrepor e, se podem, vai direto para o laço original.
+
+#define MAX_REDUCOES 8
+#define MAX_ACESSOS 16
+#define MAX_CONFERENCIAS 8
+
+static bool relatorio = false;
+
+void definirRelatorioVetorizacao(bool ativo) {
+    relatorio = ativo;
+}
+
+typedef struct {
+    InstrIr* phi;           // acumulador no cabeçalho
+    InstrIr* operacao;      // soma: o add; min/max: o phi da junção
+    InstrIr* comparacao;    // min/max: a comparação do if
+    InstrIr* valor;         // o que entra na redução a cada volta
+    OpIr tipo;              // IR_ADD, IR_MIN ou IR_MAX
+} Reducao;
+
+typedef struct {
+    InstrIr* base;
+    bool grava;
+} Acesso;
+
+typedef struct {
+    FuncaoIr* f;
+    LacoIr* l;
+    BlocoIr* blocos[3];     // corpo: [corpo] ou [if, atribuição, junção]
+    int nBlocos;
+    int fora, volta;        // posições do pré-cabeçalho e da volta nos preds do cabeçalho
+    InstrIr* iv;
+    InstrIr* ivProx;
+    InstrIr* limite;
+    InstrIr* condicao;
+    int faixas;
+    TipoIr elemento;        // tipo do primeiro acesso (para o relatório)
+    Reducao reducoes[MAX_REDUCOES];
+    int nReducoes;
+    Acesso acessos[MAX_ACESSOS];
+    int nAcessos;
+    InstrIr* conferencias[MAX_CONFERENCIAS][2];
+    int nConferencias;
+} Vetorizacao;
+
+static bool noLaco(const Vetorizacao* v, const InstrIr* i) {
+    return i->bloco->id < v->f->nBlocos && v->l->contem[i->bloco->id];
+}
+
+static bool ehConstante(const InstrIr* i, int32_t valor) {
+    return i->op == IR_CONST && i->tipo == IR_I32 && i->imm.i == valor;
+}
+
+static int tamanhoTipo(TipoIr t) {
+    return t == IR_I8 || t == IR_I1 ? 1 : 4;
+}
+
+// Mesmo objeto de memória (globais e locais se repetem como instruções diferentes)
+static bool mesmoObjeto(const InstrIr* a, const InstrIr* b) {
+    if (a == b) return true;
+    if (a->op != b->op) return false;
+    if (a->op == IR_GLOBAL) return a->simbolo == b->simbolo;
+    if (a->op == IR_LOCAL) return a->indice == b->indice;
+    return false;
+}
+
+// Dois loads de a[i] do mesmo vetor e tipo
+static bool mesmoValor(const InstrIr* a, const InstrIr* b) {
+    if (a == b) return true;
+    if (a->op != IR_LOAD || b->op != IR_LOAD || a->tipo != b->tipo) return false;
+    const InstrIr* ea = a->args[0];
+    const InstrIr* eb = b->args[0];
+    return ea->op == IR_ELEM && eb->op == IR_ELEM && ea->args[1] == eb->args[1]
+           && ea->escala == eb->escala && mesmoObjeto(ea->args[0], eb->args[0]);
+}
+
+// ===================
+// Análise
+// ===================
+
+static const char* analisarForma(Vetorizacao* v) {
+    LacoIr* l = v->l;
+    BlocoIr* h = l->cabecalho;
+
+    if (h->nPreds != 2) return "forma do laço não reconhecida";
+    v->fora = h->preds[0] == l->preCabecalho ? 0 : 1;
+    v->volta = 1 - v->fora;
+
+    InstrIr* br = terminadorIr(h);
+    InstrIr* cmp = br && br->op == IR_BR ? br->args[0] : NULL;
+    if (!cmp || cmp->op != IR_CMP || cmp->bloco != h || cmp->cond != COND_LT || cmp->nUsos != 1
+        || !l->contem[br->alvos[0]->id] || l->contem[br->alvos[1]->id]) {
+        return "condição de parada não é i < limite";
+    }
+
+    v->condicao = cmp;
+    v->iv = cmp->args[0];
+    v->limite = cmp->args[1];
+    if (v->iv->op != IR_PHI || v->iv->bloco != h || v->iv->tipo != IR_I32) return "condição de parada não é i < limite";
+    if (noLaco(v, v->limite)) return "limite muda dentro do laço";
+
+    for (InstrIr* i = h->primeira; i; i = i->prox) {
+        if (i->op != IR_PHI && i != cmp && i != br) return "cabeçalho com outras contas";
+    }
+
+    InstrIr* prox = v->iv->args[v->volta];
+    if (prox->op != IR_ADD || prox->args[0] != v->iv || !ehConstante(prox->args[1], 1)) {
+        return "variável do laço não avança de 1 em 1";
+    }
+    v->ivProx = prox;
+
+    BlocoIr* corpo = br->alvos[0];
+    InstrIr* fim = terminadorIr(corpo);
+    if (l->nBlocos == 2 && fim->op == IR_JMP && fim->alvos[0] == h) {
+        v->blocos[v->nBlocos++] = corpo;
+        return NULL;
+    }
+
+    // if sem else: corpo -> atribuição -> junção -> cabeçalho
+    if (l->nBlocos == 4 && fim->op == IR_BR) {
+        BlocoIr* atribuicao = fim->alvos[0];
+        BlocoIr* juncao = fim->alvos[1];
+        InstrIr* fimAtrib = terminadorIr(atribuicao);
+        InstrIr* fimJuncao = terminadorIr(juncao);
+        if (atribuicao->nPreds == 1 && fimAtrib->op == IR_JMP && fimAtrib->alvos[0] == juncao
+            && juncao->nPreds == 2 && fimJuncao->op == IR_JMP && fimJuncao->alvos[0] == h) {
+            v->blocos[v->nBlocos++] = corpo;
+            v->blocos[v->nBlocos++] = atribuicao;
+            v->blocos[v->nBlocos++] = juncao;
+            return NULL;
+        }
+    }
+    return "forma do laço não reconhecida";
+}
+
+// if (x < m) m = x: o phi da junção escolhe entre m (sem atribuição) e x
+static const char* analisarMinMax(Vetorizacao* v, InstrIr* phi, InstrIr* juncao, Reducao* r) {
+    BlocoIr* corpo = v->blocos[0];
+    BlocoIr* atribuicao = v->blocos[1];
+    int k = juncao->bloco->preds[0] == atribuicao ? 0 : 1;
+
+    if (juncao->args[1 - k] != phi) return "valor de uma volta usado na seguinte";
+    InstrIr* x = juncao->args[k];
+    InstrIr* cmp = terminadorIr(corpo)->args[0];
+    if (cmp->op != IR_CMP || cmp->nUsos != 1) return "if no corpo que não é mínimo nem máximo";
+
+    bool direto = mesmoValor(cmp->args[0], x) && cmp->args[1] == phi;
+    bool invertido = mesmoValor(cmp->args[1], x) && cmp->args[0] == phi;
+    if (!direto && !invertido) return "if no corpo que não é mínimo nem máximo";
+
+    // Com float só as comparações estritas dão exatamente minps/maxps
+    CondIr c = cmp->cond;
+    if (invertido) c = c == COND_LT ? COND_GT : c == COND_GT ? COND_LT : c == COND_LE ? COND_GE : c == COND_GE ? COND_LE : c;
+    if (c == COND_LT || (c == COND_LE && phi->tipo == IR_I32)) r->tipo = IR_MIN;
+    else if (c == COND_GT || (c == COND_GE && phi->tipo == IR_I32)) r->tipo = IR_MAX;
+    else return "if no corpo que não é mínimo nem máximo";
+
+    r->operacao = juncao;
+    r->comparacao = cmp;
+    r->valor = direto ? cmp->args[0] : cmp->args[1];
+    return NULL;
+}
+
+static const char* analisarReducoes(Vetorizacao* v) {
+    for (InstrIr* phi = v->l->cabecalho->primeira; phi && phi->op == IR_PHI; phi = phi->prox) {
+        if (phi == v->iv) continue;
+        if (v->nReducoes == MAX_REDUCOES) return "reduções demais";
+
+        Reducao* r = &v->reducoes[v->nReducoes];
+        InstrIr* op = phi->args[v->volta];
+        r->phi = phi;
+
+        if (op->op == IR_ADD && noLaco(v, op) && (op->args[0] == phi) != (op->args[1] == phi)) {
+            if (phi->tipo == IR_F32) return "soma de float: a ordem das somas mudaria o arredondamento";
+            if (phi->tipo != IR_I32) return "soma de char ou bool";
+            if (op->nUsos != 1) return "valor de uma volta usado na seguinte";
+            if (v->nBlocos == 3 && op->bloco == v->blocos[1]) return "soma condicional";
+            r->tipo = IR_ADD;
+            r->operacao = op;
+            r->comparacao = NULL;
+            r->valor = op->args[0] == phi ? op->args[1] : op->args[0];
+        } else if (v->nBlocos == 3 && op->op == IR_PHI && op->bloco == v->blocos[2] && op->nUsos == 1
+                   && (phi->tipo == IR_I32 || phi->tipo == IR_F32)) {
+            const char* motivo = analisarMinMax(v, phi, op, r);
+            if (motivo) return motivo;
+        } else {
+            return "valor de uma volta usado na seguinte";
+        }
+        if (r->valor == v->iv || r->valor == v->ivProx) return "variável do laço usada como valor";
+
+        // Dentro do laço o acumulador só pode entrar na própria redução
+        for (int u = 0; u < phi->nUsos; u++) {
+            InstrIr* uso = phi->usos[u];
+            if (noLaco(v, uso) && uso != r->operacao && uso != r->comparacao) {
+                return "valor de uma volta usado na seguinte";
+            }
+        }
+        v->nReducoes++;
+    }
+    return NULL;
+}
+
+static bool ehDaReducao(const Vetorizacao* v, const InstrIr* i) {
+    for (int r = 0; r < v->nReducoes; r++) {
+        if (i == v->reducoes[r].operacao || i == v->reducoes[r].comparacao) return true;
+    }
+    return false;
+}
+
+// Instruções do corpo que não viram operações vetoriais próprias
+static bool ignorada(const Vetorizacao* v, const InstrIr* i) {
+    return ehTerminadorIr(i->op) || i == v->ivProx || ehDaReducao(v, i);
+}
+
+static const char* registrarFaixas(Vetorizacao* v, TipoIr elemento) {
+    TipoIr vetor = vetorDeIr(elemento);
+    if (vetor == IR_VOID) return "tipo sem forma vetorial (bool ou endereço)";
+    int n = faixasIr(vetor);
+    if (v->faixas && v->faixas != n) return "mistura char com int ou float";
+    if (!v->faixas) v->elemento = elemento;
+    v->faixas = n;
+    return NULL;
+}
+
+static const char* registrarAcesso(Vetorizacao* v, InstrIr* endereco, bool grava) {
+    if (v->nAcessos == MAX_ACESSOS) return "acessos à memória demais";
+    v->acessos[v->nAcessos].base = endereco->args[0];
+    v->acessos[v->nAcessos].grava = grava;
+    v->nAcessos++;
+    return NULL;
+}
+
+static const char* analisarInstr(Vetorizacao* v, InstrIr* i, bool condicional) {
+    for (int u = 0; u < i->nUsos; u++) {
+        if (!noLaco(v, i->usos[u])) return "valor calculado no laço usado depois dele";
+    }
+    for (int a = 0; a < i->nArgs; a++) {
+        InstrIr* arg = i->args[a];
+        if ((arg == v->iv && i->op != IR_ELEM) || arg == v->ivProx) return "variável do laço usada como valor";
+    }
+
+    switch (i->op) {
+        case IR_ELEM:
+            if (noLaco(v, i->args[0])) return "base de vetor muda dentro do laço";
+            if (i->args[1] != v->iv) return "índice de vetor diferente da variável do laço";
+            for (int u = 0; u < i->nUsos; u++) {
+                InstrIr* uso = i->usos[u];
+                bool endereco = uso->op == IR_LOAD || (uso->op == IR_STORE && uso->args[0] == i && uso->args[1] != i);
+                if (!endereco) return "endereço de elemento usado como valor";
+            }
+            return NULL;
+
+        case IR_LOAD: {
+            const char* motivo;
+            if (i->args[0]->op != IR_ELEM || !noLaco(v, i->args[0])) return "leitura fora do padrão a[i]";
+            if (i->args[0]->escala != tamanhoTipo(i->tipo)) return "leitura fora do padrão a[i]";
+            if (condicional) return NULL;
+            if ((motivo = registrarFaixas(v, i->tipo))) return motivo;
+            return registrarAcesso(v, i->args[0], false);
+        }
+
+        case IR_STORE: {
+            const char* motivo;
+            if (condicional) return "gravação condicional";
+            if (i->args[0]->op != IR_ELEM || !noLaco(v, i->args[0])) return "gravação fora do padrão a[i]";
+            if (i->args[0]->escala != tamanhoTipo(i->args[1]->tipo)) return "gravação fora do padrão a[i]";
+            if ((motivo = registrarFaixas(v, i->args[1]->tipo))) return motivo;
+            return registrarAcesso(v, i->args[0], true);
+        }
+
+        case IR_ADD:
+        case IR_SUB:
+        case IR_MUL:
+        case IR_DIV:
+        case IR_NEG:
+            if (condicional) return "conta dentro do if";
+            if (i->tipo == IR_I32 && i->op == IR_DIV) return "divisão inteira (sem instrução SSE2)";
+            if (i->tipo == IR_I8 && (i->op == IR_MUL || i->op == IR_DIV)) return "multiplicação ou divisão de char (sem instrução SSE2)";
+            return registrarFaixas(v, i->tipo);
+
+        case IR_CONV:
+            if (condicional) return "conta dentro do if";
+            if (!((i->tipo == IR_I32 && i->args[0]->tipo == IR_F32) || (i->tipo == IR_F32 && i->args[0]->tipo == IR_I32))) {
+                return "conversão entre tipos com números de faixas diferentes";
+            }
+            return registrarFaixas(v, i->tipo);
+
+        case IR_CALL:
+            return "chamada de função no corpo";
+
+        case IR_PHI:
+            return "valor de uma volta usado na seguinte";
+
+        default:
+            return "operação sem forma vetorial";
+    }
+}
+
+static const char* analisarCorpo(Vetorizacao* v) {
+    for (int b = 0; b < v->nBlocos; b++) {
+        bool condicional = v->nBlocos == 3 && b == 1;
+        for (InstrIr* i = v->blocos[b]->primeira; i; i = i->prox) {
+            if (ignorada(v, i)) continue;
+            const char* motivo = analisarInstr(v, i, condicional);
+            if (motivo) return motivo;
+
+            // Na atribuição do if só cabe reler o mesmo x da comparação
+            if (condicional && i->op == IR_LOAD) {
+                bool relido = false;
+                for (int r = 0; r < v->nReducoes; r++) {
+                    if (v->reducoes[r].comparacao && mesmoValor(i, v->reducoes[r].valor)) relido = true;
+                }
+                if (!relido) return "leitura condicional";
+            }
+        }
+    }
+
+    // As reduções também fixam o número de faixas
+    for (int r = 0; r < v->nReducoes; r++) {
+        const char* motivo = registrarFaixas(v, v->reducoes[r].phi->tipo);
+        if (motivo) return motivo;
+        if (!noLaco(v, v->reducoes[r].valor)) return "redução de um valor fixo";
+    }
+    if (v->faixas == 0) return "nada para vetorizar";
+
+    // Com número de voltas conhecido, menos que um vetor não compensa
+    InstrIr* inicio = v->iv->args[v->fora];
+    if (inicio->op == IR_CONST && v->limite->op == IR_CONST
+        && (int64_t)v->limite->imm.i - inicio->imm.i < v->faixas) {
+        return "poucas voltas";
+    }
+    return NULL;
+}
+
+// Pares (gravação, outro acesso) que só dá para separar em tempo de execução
+static const char* analisarDependencias(Vetorizacao* v) {
+    for (int s = 0; s < v->nAcessos; s++) {
+        if (!v->acessos[s].grava) continue;
+        for (int a = 0; a < v->nAcessos; a++) {
+            InstrIr* x = v->acessos[s].base;
+            InstrIr* y = v->acessos[a].base;
+            if (a == s || mesmoObjeto(x, y) || !podemSobreporIr(v->f, x, y)) continue;
+
+            bool repetido = false;
+            for (int c = 0; c < v->nConferencias; c++) {
+                InstrIr** par = v->conferencias[c];
+                if ((par[0] == x && par[1] == y) || (par[0] == y && par[1] == x)) repetido = true;
+            }
+            if (repetido) continue;
+            if (v->nConferencias == MAX_CONFERENCIAS) return "ponteiros demais para conferir sobreposição";
+            v->conferencias[v->nConferencias][0] = x;
+            v->conferencias[v->nConferencias][1] = y;
+            v->nConferencias++;
+        }
+    }
+    return NULL;
+}
+
+static const char* analisar(Vetorizacao* v) {
+    const char* motivo;
+    if ((motivo = analisarForma(v))) return motivo;
+    if ((motivo = analisarReducoes(v))) return motivo;
+    if ((motivo = analisarCorpo(v))) return motivo;
+    return analisarDependencias(v);
+}
+
+// ===================
+// Transformação
+// ===================
+
+static InstrIr* nova(FuncaoIr* f, BlocoIr* b, OpIr op, TipoIr tipo, InstrIr* a, InstrIr* c, int linha) {
+    InstrIr* i = novaInstrIr(f, op, tipo);
+    i->linha = linha;
+    if (a) adicionarArgIr(i, a);
+    if (c) adicionarArgIr(i, c);
+    if (b) anexarInstrIr(b, i);
+    return i;
+}
+
+static InstrIr* constante(FuncaoIr* f, BlocoIr* b, int32_t valor, int linha) {
+    InstrIr* c = nova(f, b, IR_CONST, IR_I32, NULL, NULL, linha);
+    c->imm.i = valor;
+    return c;
+}
+
+static void saltar(FuncaoIr* f, BlocoIr* de, BlocoIr* para, int linha) {
+    InstrIr* jmp = nova(f, de, IR_JMP, IR_VOID, NULL, NULL, linha);
+    jmp->alvos[0] = para;
+    adicionarPredIr(para, de);
+}
+
+// Novo caminho para o cabeçalho escalar, com um valor para cada phi
+static void entrarNoEscalar(Vetorizacao* v, BlocoIr* de, InstrIr** valores) {
+    BlocoIr* h = v->l->cabecalho;
+    adicionarPredIr(h, de);
+    int k = 0;
+    for (InstrIr* phi = h->primeira; phi && phi->op == IR_PHI; phi = phi->prox) adicionarArgIr(phi, valores[k++]);
+}
+
+// O pré-cabeçalho já é predecessor do cabeçalho escalar (entradas == NULL)
+static void desviar(Vetorizacao* v, BlocoIr* de, InstrIr* cond, BlocoIr* sim, InstrIr** entradas, int linha) {
+    InstrIr* br = nova(v->f, de, IR_BR, IR_VOID, cond, NULL, linha);
+    br->alvos[0] = sim;
+    br->alvos[1] = v->l->cabecalho;
+    adicionarPredIr(sim, de);
+    if (entradas) entrarNoEscalar(v, de, entradas);
+}
+
+// Valor vetorial de um operando: do corpo já traduzido ou replicado no pré-cabeçalho vetorial
+static InstrIr* vetorial(Vetorizacao* v, InstrIr** vetor, InstrIr** replica, BlocoIr* pre, InstrIr* x) {
+    if (vetor[x->id]) return vetor[x->id];
+    if (!replica[x->id]) {
+        replica[x->id] = nova(v->f, NULL, IR_REPLICAR, vetorDeIr(x->tipo), x, NULL, x->linha);
+        inserirAntesIr(terminadorIr(pre), replica[x->id]);
+    }
+    return replica[x->id];
+}
+
+static void transformar(Vetorizacao* v) {
+    FuncaoIr* f = v->f;
+    BlocoIr* h = v->l->cabecalho;
+    BlocoIr* pre = v->l->preCabecalho;
+    int linha = v->condicao->linha;
+    int nOriginal = f->nValores;
+
+    // Valores com que o laço escalar começa, na ordem dos phi
+    int nPhis = 0;
+    for (InstrIr* phi = h->primeira; phi && phi->op == IR_PHI; phi = phi->prox) nPhis++;
+    InstrIr** entradas = malloc(nPhis * sizeof(InstrIr*));
+    InstrIr** saidas = malloc(nPhis * sizeof(InstrIr*));
+    nPhis = 0;
+    for (InstrIr* phi = h->primeira; phi && phi->op == IR_PHI; phi = phi->prox) entradas[nPhis++] = phi->args[v->fora];
+
+    BlocoIr* vpre = novoBlocoIr(f);
+    BlocoIr* vcab = novoBlocoIr(f);
+    BlocoIr* vcorpo = novoBlocoIr(f);
+    BlocoIr* vsaida = novoBlocoIr(f);
+
+    // Pré-cabeçalho: o limite menos (faixas - 1) não pode passar de INT_MIN
+    removerInstrIr(terminadorIr(pre));
+    InstrIr* minimo = constante(f, pre, INT32_MIN + v->faixas - 1, linha);
+    InstrIr* cabe = nova(f, pre, IR_CMP, IR_I1, v->limite, minimo, linha);
+    cabe->cond = COND_GE;
+
+    // Sobreposição, um par por vez: x == y, ou x + 16 <= y, ou y + 16 <= x
+    int nc = v->nConferencias;
+    BlocoIr** iguais = malloc((nc > 0 ? nc : 1) * sizeof(BlocoIr*));
+    for (int c = 0; c < nc; c++) iguais[c] = novoBlocoIr(f);
+    desviar(v, pre, cabe, nc > 0 ? iguais[0] : vpre, NULL, linha);
+
+    for (int c = 0; c < nc; c++) {
+        InstrIr* x = v->conferencias[c][0];
+        InstrIr* y = v->conferencias[c][1];
+        BlocoIr* separados = c + 1 < nc ? iguais[c + 1] : vpre;
+        BlocoIr* antes = novoBlocoIr(f);
+        BlocoIr* depois = novoBlocoIr(f);
+
+        InstrIr* eq = nova(f, iguais[c], IR_CMP, IR_I1, x, y, linha);
+        eq->cond = COND_EQ;
+        InstrIr* br = nova(f, iguais[c], IR_BR, IR_VOID, eq, NULL, linha);
+        br->alvos[0] = separados;
+        br->alvos[1] = antes;
+        adicionarPredIr(separados, iguais[c]);
+        adicionarPredIr(antes, iguais[c]);
+
+        InstrIr* fimX = nova(f, antes, IR_ELEM, IR_PTR, x, constante(f, antes, 16, linha), linha);
+        fimX->escala = 1;
+        InstrIr* le = nova(f, antes, IR_CMP, IR_I1, fimX, y, linha);
+        le->cond = COND_LE;
+        br = nova(f, antes, IR_BR, IR_VOID, le, NULL, linha);
+        br->alvos[0] = separados;
+        br->alvos[1] = depois;
+        adicionarPredIr(separados, antes);
+        adicionarPredIr(depois, antes);
+
+        InstrIr* fimY = nova(f, depois, IR_ELEM, IR_PTR, y, constante(f, depois, 16, linha), linha);
+        fimY->escala = 1;
+        InstrIr* ge = nova(f, depois, IR_CMP, IR_I1, fimY, x, linha);
+        ge->cond = COND_LE;
+        desviar(v, depois, ge, separados, entradas, linha);
+    }
+    free(iguais);
+
+    // Pré-cabeçalho vetorial
+    InstrIr* limiteVetor = nova(f, vpre, IR_SUB, IR_I32, v->limite, constante(f, vpre, v->faixas - 1, linha), linha);
+    InstrIr** acumIniciais = malloc((v->nReducoes > 0 ? v->nReducoes : 1) * sizeof(InstrIr*));
+    for (int r = 0; r < v->nReducoes; r++) {
+        Reducao* red = &v->reducoes[r];
+        TipoIr tipo = vetorDeIr(red->phi->tipo);
+        InstrIr* inicio = red->tipo == IR_ADD ? constante(f, vpre, 0, linha) : red->phi->args[v->fora];
+        acumIniciais[r] = nova(f, vpre, IR_REPLICAR, tipo, inicio, NULL, linha);
+    }
+    saltar(f, vpre, vcab, linha);
+
+    // Cabeçalho vetorial
+    InstrIr* ivv = nova(f, vcab, IR_PHI, IR_I32, NULL, NULL, linha);
+    InstrIr** acums = malloc((v->nReducoes > 0 ? v->nReducoes : 1) * sizeof(InstrIr*));
+    for (int r = 0; r < v->nReducoes; r++) {
+        acums[r] = nova(f, vcab, IR_PHI, vetorDeIr(v->reducoes[r].phi->tipo), NULL, NULL, linha);
+    }
+    InstrIr* continua = nova(f, vcab, IR_CMP, IR_I1, ivv, limiteVetor, linha);
+    continua->cond = COND_LT;
+    InstrIr* br = nova(f, vcab, IR_BR, IR_VOID, continua, NULL, linha);
+    br->alvos[0] = vcorpo;
+    br->alvos[1] = vsaida;
+    adicionarPredIr(vcorpo, vcab);
+    adicionarPredIr(vsaida, vcab);
+
+    // Corpo vetorial: cada instrução do corpo escalar com o tipo vetorial
+    InstrIr** vetor = calloc(nOriginal, sizeof(InstrIr*));
+    InstrIr** replica = calloc(nOriginal, sizeof(InstrIr*));
+    for (int b = 0; b < v->nBlocos; b++) {
+        bool condicional = v->nBlocos == 3 && b == 1;
+        for (InstrIr* i = v->blocos[b]->primeira; i; i = i->prox) {
+            if (ignorada(v, i)) continue;
+
+            if (condicional) {
+                // Releitura do x da comparação
+                if (i->op == IR_LOAD) {
+                    for (int r = 0; r < v->nReducoes; r++) {
+                        if (v->reducoes[r].comparacao && mesmoValor(i, v->reducoes[r].valor)) {
+                            vetor[i->id] = vetor[v->reducoes[r].valor->id];
+                        }
+                    }
+                }
+                continue;
+            }
+
+            InstrIr* n;
+            switch (i->op) {
+                case IR_ELEM:
+                    n = nova(f, vcorpo, IR_ELEM, IR_PTR, i->args[0], ivv, i->linha);
+                    n->escala = i->escala;
+                    n->tamanho = i->tamanho;
+                    break;
+                case IR_LOAD:
+                    n = nova(f, vcorpo, IR_LOAD, vetorDeIr(i->tipo), vetor[i->args[0]->id], NULL, i->linha);
+                    break;
+                case IR_STORE:
+                    n = nova(f, vcorpo, IR_STORE, IR_VOID, vetor[i->args[0]->id],
+                             vetorial(v, vetor, replica, vpre, i->args[1]), i->linha);
+                    break;
+                case IR_NEG:
+                case IR_CONV:
+                    n = nova(f, vcorpo, i->op, vetorDeIr(i->tipo),
+                             vetorial(v, vetor, replica, vpre, i->args[0]), NULL, i->linha);
+                    break;
+                default:
+                    n = nova(f, vcorpo, i->op, vetorDeIr(i->tipo),
+                             vetorial(v, vetor, replica, vpre, i->args[0]),
+                             vetorial(v, vetor, replica, vpre, i->args[1]), i->linha);
+                    break;
+            }
+            vetor[i->id] = n;
+        }
+    }
+
+    InstrIr** acumProx = malloc((v->nReducoes > 0 ? v->nReducoes : 1) * sizeof(InstrIr*));
+    for (int r = 0; r < v->nReducoes; r++) {
+        Reducao* red = &v->reducoes[r];
+        InstrIr* x = vetorial(v, vetor, replica, vpre, red->valor);
+        if (red->tipo == IR_ADD) acumProx[r] = nova(f, vcorpo, IR_ADD, acums[r]->tipo, acums[r], x, linha);
+        else acumProx[r] = nova(f, vcorpo, red->tipo, acums[r]->tipo, x, acums[r], linha);
+    }
+    InstrIr* ivvProx = nova(f, vcorpo, IR_ADD, IR_I32, ivv, constante(f, vcorpo, v->faixas, linha), linha);
+    saltar(f, vcorpo, vcab, linha);
+
+    // Phi do cabeçalho vetorial: [vpre, vcorpo]
+    adicionarArgIr(ivv, v->iv->args[v->fora]);
+    adicionarArgIr(ivv, ivvProx);
+    for (int r = 0; r < v->nReducoes; r++) {
+        adicionarArgIr(acums[r], acumIniciais[r]);
+        adicionarArgIr(acums[r], acumProx[r]);
+    }
+
+    // Saída vetorial: junta as faixas e continua no laço escalar
+    int k = 0;
+    for (InstrIr* phi = h->primeira; phi && phi->op == IR_PHI; phi = phi->prox, k++) {
+        if (phi == v->iv) {
+            saidas[k] = ivv;
+            continue;
+        }
+        for (int r = 0; r < v->nReducoes; r++) {
+            Reducao* red = &v->reducoes[r];
+            if (red->phi != phi) continue;
+            InstrIr* total = nova(f, vsaida, IR_REDUZIR, phi->tipo, acums[r], NULL, linha);
+            total->indice = red->tipo;
+            saidas[k] = red->tipo == IR_ADD ? nova(f, vsaida, IR_ADD, phi->tipo, entradas[k], total, linha) : total;
+        }
+    }
+    InstrIr* jmp = nova(f, vsaida, IR_JMP, IR_VOID, NULL, NULL, linha);
+    jmp->alvos[0] = h;
+    entrarNoEscalar(v, vsaida, saidas);
+
+    free(entradas);
+    free(saidas);
+    free(acumIniciais);
+    free(acums);
+    free(acumProx);
+    free(vetor);
+    free(replica);
+}
+
+// ===================
+// Passe
+// ===================
+
+bool vetorizarLacos(FuncaoIr* f) {
+    int capVistos = 8, nVistos = 0;
+    BlocoIr** vistos = malloc(capVistos * sizeof(BlocoIr*));
+    bool mudou = false;
+    bool continuar = true;
+
+    // Cada vetorização cria blocos: os laços são detectados de novo depois dela
+    while (continuar) {
+        continuar = false;
+        int n;
+        LacoIr** lacos = encontrarLacosIr(f, &n);
+
+        for (int k = 0; k < n && !continuar; k++) {
+            LacoIr* l = lacos[k];
+            bool visto = false;
+            for (int j = 0; j < nVistos; j++) visto |= vistos[j] == l->cabecalho;
+            if (visto) continue;
+
+            if (nVistos + 2 > capVistos) vistos = realloc(vistos, (capVistos *= 2) * sizeof(BlocoIr*));
+            vistos[nVistos++] = l->cabecalho;
+
+            Vetorizacao v = { 0 };
+            v.f = f;
+            v.l = l;
+
+            const char* motivo = NULL;
+            for (int j = 0; j < n; j++) {
+                if (lacos[j]->pai == l) motivo = "tem outro laço dentro";
+            }
+            if (!motivo) motivo = analisar(&v);
+
+            InstrIr* br = terminadorIr(l->cabecalho);
+            int linha = br && br->nArgs ? br->args[0]->linha : 0;
+            if (motivo) {
+                if (relatorio) fprintf(stderr, "[VETORIZAÇÃO] %s: laço da linha %d não vetorizado: %s\n", f->nome, linha, motivo);
+                continue;
+            }
+
+            int nBlocosAntes = f->nBlocos;
+            transformar(&v);
+            if (relatorio) {
+                fprintf(stderr, "[VETORIZAÇÃO] %s: laço da linha %d vetorizado (%d faixas de %s)\n",
+                        f->nome, linha, v.faixas, nomeTipoIr(v.elemento));
+            }
+
+            // O laço vetorial novo não é candidato (seu cabeçalho é o segundo bloco criado)
+            vistos[nVistos++] = f->blocos[nBlocosAntes + 1];
+            mudou = true;
+            continuar = true;
+        }
+        liberarLacosIr(lacos, n);
+    }
+
+    free(vistos);
+    return mudou;
+}
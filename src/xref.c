@@ -0,0 +1,530 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "xref.h"
+#include "symbols.h"
+
+// ==============================================
+// FORMATO BINÁRIO DO ÍNDICE (.xref)
+// ==============================================
+//
+// Todos os campos são inteiros de 32 bits little-endian.
+//
+//   Cabeçalho : "CSXR" versao nSimbolos nEntradas nFuncoes tamStrings nomeFonte reservado
+//   Símbolos  : nSimbolos x { nome contexto tipo classeEscopo primeira quantidade }
+//               ordenados por (nome, contexto) -> busca binária pelo nome
+//   Funções   : nFuncoes x { nome inicio fim }, ordenadas por 'inicio'
+//   Entradas  : nEntradas x (offset << 2 | tipo), agrupadas por símbolo e
+//               ordenadas por offset dentro de cada grupo
+//   Strings   : nomes terminados em '\0' (referenciados por deslocamento)
+
+#define XREF_MAGICO "CSXR"
+#define XREF_VERSAO 1
+#define XREF_SEM_CONTEXTO 0xFFFFFFFFu
+#define XREF_OFFSET_MAX (1u << 30)
+
+#define XREF_TAM_CABECALHO 32
+#define XREF_TAM_SIMBOLO 24
+#define XREF_TAM_FUNCAO 12
+
+// Ocorrência coletada durante a análise
+typedef struct {
+    int simbolo;        // índice na tabela de símbolos
+    uint32_t offset;    // deslocamento no arquivo-fonte
+    uint8_t tipo;       // TipoRefXref
+} EntradaXref;
+
+// Função cujo corpo delimita o contexto dos símbolos locais
+typedef struct {
+    char nome[64];
+    long inicio;
+    long fim;
+} FuncaoXref;
+
+static bool ativo = false;
+
+static EntradaXref* entradas = NULL;
+static int nEntradas = 0;
+static int capEntradas = 0;
+
+static FuncaoXref* funcoes = NULL;
+static int nFuncoes = 0;
+static int capFuncoes = 0;
+static int funcaoAtual = -1;
+
+// Função dona de cada símbolo local (-1 para globais), indexada pelo símbolo
+static int* contextoSimbolo = NULL;
+static int capContexto = 0;
+
+static const char* nomesTipoRef[] = { "declaracao", "leitura", "escrita", "chamada" };
+
+// ===================
+// Coleta
+// ===================
+
+void ativarXref(void) {
+    ativo = true;
+}
+
+bool xrefAtivo(void) {
+    return ativo;
+}
+
+void xrefEntrarFuncao(const char* nome, long offsetInicio) {
+    if (!ativo) return;
+
+    if (nFuncoes == capFuncoes) {
+        capFuncoes = capFuncoes ? capFuncoes * 2 : 64;
+        funcoes = realloc(funcoes, capFuncoes * sizeof(FuncaoXref));
+    }
+
+    strncpy(funcoes[nFuncoes].nome, nome, sizeof(funcoes[nFuncoes].nome) - 1);
+    funcoes[nFuncoes].nome[sizeof(funcoes[nFuncoes].nome) - 1] = '\0';
+    funcoes[nFuncoes].inicio = offsetInicio;
+    funcoes[nFuncoes].fim = offsetInicio;
+    funcaoAtual = nFuncoes++;
+}
+
+void xrefSairFuncao(long offsetFim) {
+    if (!ativo || funcaoAtual < 0) return;
+    funcoes[funcaoAtual].fim = offsetFim;
+    funcaoAtual = -1;
+}
+
+void registrarReferenciaXref(const Simbolo* s, long offset, TipoRefXref tipo) {
+    if (!ativo || s == NULL) return;
+
+    int id = (int)(s - getTabela());
+
+    if (id >= capContexto) {
+        int novaCap = capContexto ? capContexto : 256;
+        while (novaCap <= id) novaCap *= 2;
+        contextoSimbolo = realloc(contextoSimbolo, novaCap * sizeof(int));
+        for (int i = capContexto; i < novaCap; i++) contextoSimbolo[i] = -2; // ainda não visto
+        capContexto = novaCap;
+    }
+
+    // O contexto de um símbolo é fixado na primeira ocorrência
+    if (contextoSimbolo[id] == -2) {
+        contextoSimbolo[id] = (s->escopo == ESC_LOCAL) ? funcaoAtual : -1;
+    }
+
+    if (nEntradas == capEntradas) {
+        capEntradas = capEntradas ? capEntradas * 2 : 1024;
+        entradas = realloc(entradas, capEntradas * sizeof(EntradaXref));
+    }
+
+    entradas[nEntradas].simbolo = id;
+    entradas[nEntradas].offset = (uint32_t)offset;
+    entradas[nEntradas].tipo = (uint8_t)tipo;
+    nEntradas++;
+}
+
+// ===================
+// Gravação
+// ===================
+
+// Tabela de strings com internação (nomes de tipos e funções se repetem muito)
+typedef struct {
+    char* dados;
+    uint32_t tam;
+    uint32_t cap;
+    uint32_t* hash;     // deslocamento + 1 de cada string internada (0 = livre)
+    uint32_t capHash;
+    uint32_t usados;
+} TabelaStrings;
+
+static uint32_t hashString(const char* s) {
+    uint32_t h = 2166136261u;
+    while (*s) {
+        h ^= (unsigned char)*s++;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static uint32_t internarString(TabelaStrings* t, const char* s) {
+    if ((t->usados + 1) * 2 > t->capHash) {
+        uint32_t novaCap = t->capHash ? t->capHash * 2 : 256;
+        uint32_t* novo = calloc(novaCap, sizeof(uint32_t));
+        for (uint32_t i = 0; i < t->capHash; i++) {
+            if (!t->hash[i]) continue;
+            uint32_t j = hashString(t->dados + t->hash[i] - 1) & (novaCap - 1);
+            while (novo[j]) j = (j + 1) & (novaCap - 1);
+            novo[j] = t->hash[i];
+        }
+        free(t->hash);
+        t->hash = novo;
+        t->capHash = novaCap;
+    }
+
+    uint32_t j = hashString(s) & (t->capHash - 1);
+    while (t->hash[j]) {
+        if (strcmp(t->dados + t->hash[j] - 1, s) == 0) return t->hash[j] - 1;
+        j = (j + 1) & (t->capHash - 1);
+    }
+
+    uint32_t len = (uint32_t)strlen(s) + 1;
+    if (t->tam + len > t->cap) {
+        t->cap = (t->cap ? t->cap * 2 : 4096);
+        while (t->tam + len > t->cap) t->cap *= 2;
+        t->dados = realloc(t->dados, t->cap);
+    }
+
+    uint32_t off = t->tam;
+    memcpy(t->dados + off, s, len);
+    t->tam += len;
+    t->hash[j] = off + 1;
+    t->usados++;
+    return off;
+}
+
+static void escreverU32(FILE* f, uint32_t v) {
+    unsigned char b[4] = { v & 0xFF, (v >> 8) & 0xFF, (v >> 16) & 0xFF, (v >> 24) & 0xFF };
+    fwrite(b, 1, 4, f);
+}
+
+// Registro temporário de símbolo usado na ordenação
+typedef struct {
+    int id;
+    const char* nome;
+    const char* contexto;
+} SimboloXref;
+
+static int compararSimbolos(const void* a, const void* b) {
+    const SimboloXref* x = a;
+    const SimboloXref* y = b;
+    int c = strcmp(x->nome, y->nome);
+    if (c != 0) return c;
+    // Globais (sem contexto) antes dos locais
+    if (!x->contexto || !y->contexto) return (x->contexto != NULL) - (y->contexto != NULL);
+    c = strcmp(x->contexto, y->contexto);
+    if (c != 0) return c;
+    return x->id - y->id;
+}
+
+// Posição final de cada símbolo após a ordenação (usada para ordenar as entradas)
+static int* posicaoSimbolo = NULL;
+
+static int compararEntradas(const void* a, const void* b) {
+    const EntradaXref* x = a;
+    const EntradaXref* y = b;
+    int px = posicaoSimbolo[x->simbolo];
+    int py = posicaoSimbolo[y->simbolo];
+    if (px != py) return px - py;
+    if (x->offset != y->offset) return x->offset < y->offset ? -1 : 1;
+    return (int)x->tipo - (int)y->tipo;
+}
+
+static int compararFuncoes(const void* a, const void* b) {
+    const FuncaoXref* x = a;
+    const FuncaoXref* y = b;
+    if (x->inicio != y->inicio) return x->inicio < y->inicio ? -1 : 1;
+    return 0;
+}
+
+int gravarXref(const char* caminhoSaida, const char* caminhoFonte) {
+    Simbolo* tabela = getTabela();
+    int nTabela = getNumSimbolos();
+
+    for (int i = 0; i < nEntradas; i++) {
+        if (entradas[i].offset >= XREF_OFFSET_MAX) {
+            fprintf(stderr, "Erro: arquivo-fonte grande demais para o índice de referências.\n");
+            return 0;
+        }
+    }
+
+    // 1. Símbolos que possuem ao menos uma ocorrência
+    bool* visto = calloc(nTabela > 0 ? nTabela : 1, sizeof(bool));
+    for (int i = 0; i < nEntradas; i++) visto[entradas[i].simbolo] = true;
+
+    SimboloXref* simbolos = malloc((nTabela > 0 ? nTabela : 1) * sizeof(SimboloXref));
+    int nSimbolos = 0;
+    for (int id = 0; id < nTabela; id++) {
+        if (!visto[id]) continue;
+        int ctx = contextoSimbolo[id];
+        simbolos[nSimbolos].id = id;
+        simbolos[nSimbolos].nome = tabela[id].nome;
+        simbolos[nSimbolos].contexto = ctx >= 0 ? funcoes[ctx].nome : NULL;
+        nSimbolos++;
+    }
+    free(visto);
+
+    // 2. Ordena por nome e reagrupa as entradas na nova ordem
+    qsort(simbolos, nSimbolos, sizeof(SimboloXref), compararSimbolos);
+
+    posicaoSimbolo = malloc((nTabela > 0 ? nTabela : 1) * sizeof(int));
+    for (int i = 0; i < nSimbolos; i++) posicaoSimbolo[simbolos[i].id] = i;
+    qsort(entradas, nEntradas, sizeof(EntradaXref), compararEntradas);
+
+    qsort(funcoes, nFuncoes, sizeof(FuncaoXref), compararFuncoes);
+
+    // 3. Monta a tabela de strings
+    TabelaStrings strings = {0};
+    internarString(&strings, "");
+    uint32_t nomeFonte = internarString(&strings, caminhoFonte);
+
+    uint32_t* nomesSimbolos = malloc((nSimbolos > 0 ? nSimbolos : 1) * 3 * sizeof(uint32_t));
+    for (int i = 0; i < nSimbolos; i++) {
+        const Simbolo* s = &tabela[simbolos[i].id];
+        nomesSimbolos[3 * i] = internarString(&strings, s->nome);
+        nomesSimbolos[3 * i + 1] = simbolos[i].contexto ? internarString(&strings, simbolos[i].contexto) : XREF_SEM_CONTEXTO;
+        nomesSimbolos[3 * i + 2] = internarString(&strings, s->tipo);
+    }
+
+    uint32_t* nomesFuncoes = malloc((nFuncoes > 0 ? nFuncoes : 1) * sizeof(uint32_t));
+    for (int i = 0; i < nFuncoes; i++) nomesFuncoes[i] = internarString(&strings, funcoes[i].nome);
+
+    FILE* f = fopen(caminhoSaida, "wb");
+    if (!f) {
+        perror("Erro ao criar o índice de referências");
+        free(simbolos); free(posicaoSimbolo); free(nomesSimbolos); free(nomesFuncoes);
+        free(strings.dados); free(strings.hash);
+        posicaoSimbolo = NULL;
+        return 0;
+    }
+
+    // 4. Grava
+    fwrite(XREF_MAGICO, 1, 4, f);
+    escreverU32(f, XREF_VERSAO);
+    escreverU32(f, (uint32_t)nSimbolos);
+    escreverU32(f, (uint32_t)nEntradas);
+    escreverU32(f, (uint32_t)nFuncoes);
+    escreverU32(f, strings.tam);
+    escreverU32(f, nomeFonte);
+    escreverU32(f, 0);
+
+    int e = 0;
+    for (int i = 0; i < nSimbolos; i++) {
+        const Simbolo* s = &tabela[simbolos[i].id];
+        int primeira = e;
+        while (e < nEntradas && posicaoSimbolo[entradas[e].simbolo] == i) e++;
+
+        escreverU32(f, nomesSimbolos[3 * i]);
+        escreverU32(f, nomesSimbolos[3 * i + 1]);
+        escreverU32(f, nomesSimbolos[3 * i + 2]);
+        escreverU32(f, (uint32_t)s->classe | ((uint32_t)s->escopo << 8));
+        escreverU32(f, (uint32_t)primeira);
+        escreverU32(f, (uint32_t)(e - primeira));
+    }
+
+    for (int i = 0; i < nFuncoes; i++) {
+        escreverU32(f, nomesFuncoes[i]);
+        escreverU32(f, (uint32_t)funcoes[i].inicio);
+        escreverU32(f, (uint32_t)funcoes[i].fim);
+    }
+
+    for (int i = 0; i < nEntradas; i++) {
+        escreverU32(f, (entradas[i].offset << 2) | entradas[i].tipo);
+    }
+
+    fwrite(strings.dados, 1, strings.tam, f);
+    fclose(f);
+
+    printf("[XREF] Índice gravado em %s (%d símbolos, %d ocorrências)\n", caminhoSaida, nSimbolos, nEntradas);
+
+    free(simbolos);
+    free(posicaoSimbolo);
+    free(nomesSimbolos);
+    free(nomesFuncoes);
+    free(strings.dados);
+    free(strings.hash);
+    posicaoSimbolo = NULL;
+    return 1;
+}
+
+// ===================
+// Consulta
+// ===================
+
+// Índice carregado em memória (o arquivo inteiro)
+typedef struct {
+    unsigned char* dados;
+    long tam;
+    uint32_t nSimbolos, nEntradas, nFuncoes, tamStrings, nomeFonte;
+    const unsigned char* simbolos;
+    const unsigned char* funcoes;
+    const unsigned char* entradas;
+    const char* strings;
+} IndiceXref;
+
+static uint32_t lerU32(const unsigned char* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint32_t campoSimbolo(const IndiceXref* x, uint32_t i, int campo) {
+    return lerU32(x->simbolos + (size_t)i * XREF_TAM_SIMBOLO + 4 * campo);
+}
+
+static uint32_t campoFuncao(const IndiceXref* x, uint32_t i, int campo) {
+    return lerU32(x->funcoes + (size_t)i * XREF_TAM_FUNCAO + 4 * campo);
+}
+
+static const char* stringIndice(const IndiceXref* x, uint32_t off) {
+    return off < x->tamStrings ? x->strings + off : "?";
+}
+
+static int carregarIndice(const char* caminho, IndiceXref* x) {
+    FILE* f = fopen(caminho, "rb");
+    if (!f) {
+        perror("Erro ao abrir o índice de referências");
+        return 0;
+    }
+
+    fseek(f, 0, SEEK_END);
+    x->tam = ftell(f);
+    fseek(f, 0, SEEK_SET);
+
+    x->dados = malloc(x->tam > 0 ? x->tam : 1);
+    if (fread(x->dados, 1, x->tam, f) != (size_t)x->tam) x->tam = 0;
+    fclose(f);
+
+    if (x->tam < XREF_TAM_CABECALHO || memcmp(x->dados, XREF_MAGICO, 4) != 0 ||
+        lerU32(x->dados + 4) != XREF_VERSAO) {
+        fprintf(stderr, "Erro: '%s' não é um índice de referências válido.\n", caminho);
+        free(x->dados);
+        return 0;
+    }
+
+    x->nSimbolos = lerU32(x->dados + 8);
+    x->nEntradas = lerU32(x->dados + 12);
+    x->nFuncoes = lerU32(x->dados + 16);
+    x->tamStrings = lerU32(x->dados + 20);
+    x->nomeFonte = lerU32(x->dados + 24);
+
+    unsigned long long esperado = XREF_TAM_CABECALHO +
+        (unsigned long long)x->nSimbolos * XREF_TAM_SIMBOLO +
+        (unsigned long long)x->nFuncoes * XREF_TAM_FUNCAO +
+        (unsigned long long)x->nEntradas * 4 + x->tamStrings;
+
+    if (esperado != (unsigned long long)x->tam) {
+        fprintf(stderr, "Erro: índice de referências '%s' corrompido.\n", caminho);
+        free(x->dados);
+        return 0;
+    }
+
+    x->simbolos = x->dados + XREF_TAM_CABECALHO;
+    x->funcoes = x->simbolos + (size_t)x->nSimbolos * XREF_TAM_SIMBOLO;
+    x->entradas = x->funcoes + (size_t)x->nFuncoes * XREF_TAM_FUNCAO;
+    x->strings = (const char*)(x->entradas + (size_t)x->nEntradas * 4);
+    return 1;
+}
+
+// Primeiro símbolo cujo nome é >= 'nome' (busca binária)
+static uint32_t limiteInferior(const IndiceXref* x, const char* nome) {
+    uint32_t lo = 0, hi = x->nSimbolos;
+    while (lo < hi) {
+        uint32_t meio = lo + (hi - lo) / 2;
+        if (strcmp(stringIndice(x, campoSimbolo(x, meio, 0)), nome) < 0) lo = meio + 1;
+        else hi = meio;
+    }
+    return lo;
+}
+
+// Função cujo corpo contém o deslocamento (busca binária), ou NULL
+static const char* funcaoEnvolvente(const IndiceXref* x, uint32_t offset) {
+    uint32_t lo = 0, hi = x->nFuncoes;
+    while (lo < hi) {
+        uint32_t meio = lo + (hi - lo) / 2;
+        if (campoFuncao(x, meio, 1) <= offset) lo = meio + 1;
+        else hi = meio;
+    }
+    if (lo == 0) return NULL;
+    if (offset > campoFuncao(x, lo - 1, 2)) return NULL;
+    return stringIndice(x, campoFuncao(x, lo - 1, 0));
+}
+
+// Início de cada linha do fonte, para converter deslocamentos em linha:coluna
+static long* carregarInicioLinhas(const char* caminhoFonte, int* nLinhas) {
+    FILE* f = fopen(caminhoFonte, "rb");
+    if (!f) return NULL;
+
+    int cap = 1024;
+    long* inicios = malloc(cap * sizeof(long));
+    int n = 0;
+    long pos = 0;
+    int c;
+
+    inicios[n++] = 0;
+    while ((c = fgetc(f)) != EOF) {
+        pos++;
+        if (c == '\n') {
+            if (n == cap) {
+                cap *= 2;
+                inicios = realloc(inicios, cap * sizeof(long));
+            }
+            inicios[n++] = pos;
+        }
+    }
+    fclose(f);
+
+    *nLinhas = n;
+    return inicios;
+}
+
+static void formatarPosicao(char* dest, size_t tam, const long* inicios, int nLinhas, uint32_t offset) {
+    if (!inicios) {
+        snprintf(dest, tam, "@%u", offset);
+        return;
+    }
+
+    int lo = 0, hi = nLinhas;
+    while (lo < hi) {
+        int meio = lo + (hi - lo) / 2;
+        if (inicios[meio] <= (long)offset) lo = meio + 1;
+        else hi = meio;
+    }
+    snprintf(dest, tam, "%d:%ld", lo, (long)offset - inicios[lo - 1] + 1);
+}
+
+int consultarXref(const char* caminhoIndice, const char* nome) {
+    static const char* nomesClasse[] = { "var", "vetor", "funcao", "param" };
+
+    IndiceXref x;
+    if (!carregarIndice(caminhoIndice, &x)) return 0;
+
+    const char* fonte = stringIndice(&x, x.nomeFonte);
+    int nLinhas = 0;
+    long* inicios = carregarInicioLinhas(fonte, &nLinhas);
+
+    uint32_t i = limiteInferior(&x, nome);
+    int encontrados = 0;
+
+    for (; i < x.nSimbolos && strcmp(stringIndice(&x, campoSimbolo(&x, i, 0)), nome) == 0; i++) {
+        uint32_t contexto = campoSimbolo(&x, i, 1);
+        uint32_t classeEscopo = campoSimbolo(&x, i, 3);
+        uint32_t primeira = campoSimbolo(&x, i, 4);
+        uint32_t quantidade = campoSimbolo(&x, i, 5);
+        uint32_t classe = classeEscopo & 0xFF;
+
+        printf("%s (%s %s, %s", nome,
+               classe < 4 ? nomesClasse[classe] : "???",
+               stringIndice(&x, campoSimbolo(&x, i, 2)),
+               (classeEscopo >> 8) == ESC_GLOBAL ? "global" : "local");
+        if (contexto != XREF_SEM_CONTEXTO) printf(" de %s", stringIndice(&x, contexto));
+        printf(")\n");
+
+        for (uint32_t e = primeira; e < primeira + quantidade && e < x.nEntradas; e++) {
+            uint32_t v = lerU32(x.entradas + (size_t)e * 4);
+            uint32_t offset = v >> 2;
+            const char* envolvente = funcaoEnvolvente(&x, offset);
+            char posicao[32];
+
+            formatarPosicao(posicao, sizeof(posicao), inicios, nLinhas, offset);
+            printf("  %s:%-10s %-10s", fonte, posicao, nomesTipoRef[v & 3]);
+            if (envolvente) printf(" em %s", envolvente);
+            printf("\n");
+        }
+        encontrados++;
+    }
+
+    if (!encontrados) {
+        printf("Nenhuma referência encontrada para '%s'.\n", nome);
+    }
+
+    free(inicios);
+    free(x.dados);
+    return encontrados > 0;
+}